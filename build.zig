@@ -9,6 +9,7 @@ const src_files = [_][]const u8{
     "CArena.cpp",
     "CArenaCloser.cpp",
     "CArenaSnapshot.cpp",
+    "CBenchmark.cpp",
     "CBoard.cpp",
     "CBomb.cpp",
     "CBomber.cpp",
@@ -16,6 +17,7 @@ const src_files = [_][]const u8{
     "CClock.cpp",
     "CCloudManager.cpp",
     "CCommandChunk.cpp",
+    "CCommandHistory.cpp",
     "CControls.cpp",
     "CCredits.cpp",
     "CDebug.cpp",
@@ -26,6 +28,8 @@ const src_files = [_][]const u8{
     "CExplosion.cpp",
     "CFloor.cpp",
     "CFont.cpp",
+    "CFrameExporter.cpp",
+    "CFrameScheduler.cpp",
     "CGame.cpp",
     "CHelp.cpp",
     "CHurryMessage.cpp",
@@ -36,6 +40,8 @@ const src_files = [_][]const u8{
     "CLog.cpp",
     "CMainInput.cpp",
     "CMatch.cpp",
+    "CMatchRules.cpp",
+    "CMatchTicks.cpp",
     "CMenu.cpp",
     "CMenuBase.cpp",
     "CMenuBomber.cpp",
@@ -46,10 +52,16 @@ const src_files = [_][]const u8{
     "CMenuYesNo.cpp",
     "CModeScreen.cpp",
     "CMosaic.cpp",
+    "CNetworkClock.cpp",
+    "CNetworkStatistics.cpp",
     "COptions.cpp",
     "CPauseMessage.cpp",
     "CPlayerInput.cpp",
+    "CRandom.cpp",
     "CRandomMosaic.cpp",
+    "CRenderThread.cpp",
+    "CScaler.cpp",
+    "CScalerXBR.cpp",
     "CScores.cpp",
     "CScroller.cpp",
     "CSound.cpp",
@@ -57,9 +69,11 @@ const src_files = [_][]const u8{
     "CTeam.cpp",
     "CVictory.cpp",
     "CVideoSDL.cpp",
+    "CVideoSDL2.cpp",
     "CWall.cpp",
     "CWindow.cpp",
     "CWinner.cpp",
+    "CWorkerPool.cpp",
     "WinMain.cpp",
     "WinReplace.cpp",
     "hqx/HQ2x.cc",
@@ -74,7 +88,6 @@ const c_flags_common = [_][]const u8{
     "-Wno-missing-field-initializers",
     "-Wno-date-time",
     "-DSDL",
-    "-DBOMBERMAAAN_SCALE_2X",
     "-DENABLE_LOG", // Define this if the log file should be enabled
 };
 
@@ -87,14 +100,22 @@ const c_flags_rel = [_][]const u8{
     "-DNDEBUG",
 };
 
+const c_flags_sdl2_video = [_][]const u8{
+    "-DBOMBERMAAAN_SDL2_VIDEO", // Present the display through SDL2 directly instead of sdl12_compat
+};
+
+const c_flags_none = [_][]const u8{};
+
 pub fn build(b: *Build) !void {
     const target = b.standardTargetOptions(.{});
     const optimize = b.standardOptimizeOption(.{});
+    const sdl2_video = b.option(bool, "sdl2-video", "Present the display through SDL2 directly instead of sdl12_compat") orelse false;
 
-    const c_flags: []const []const u8 = if (optimize == .Debug)
-        &(c_flags_common ++ c_flags_dbg)
-    else
-        &(c_flags_common ++ c_flags_rel);
+    const c_flags = try std.mem.concat(b.allocator, []const u8, &.{
+        &c_flags_common,
+        if (optimize == .Debug) &c_flags_dbg else &c_flags_rel,
+        if (sdl2_video) &c_flags_sdl2_video else &c_flags_none,
+    });
 
     const target_emscripten = (target.result.os.tag == .emscripten);
     const emsdk_dep = b.dependency("emsdk", .{});
@@ -155,6 +176,9 @@ pub fn build(b: *Build) !void {
     exe.linkLibC();
     exe.linkLibrary(tinyxml_dep.artifact("tinyxml"));
     exe.linkLibrary(sdl_compat_dep.artifact("sdl12_compat_static"));
+    if (sdl2_video) {
+        exe.linkLibrary(sdl_dep.artifact("SDL2"));
+    }
     exe.linkLibrary(sdl_mixer_dep.artifact("SDL2_mixer"));
     exe.linkLibrary(assets_dep.artifact("bombermaaan_assets"));
 
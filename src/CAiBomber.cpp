@@ -70,6 +70,8 @@ CAiBomber::CAiBomber(void)
 
     m_NumAccessible = 0;
     m_StopTimeLeft = 0.0f;
+    m_Stopped = true;
+    m_RandomState = 1;
     m_ItemGoalBlockX = 0;
     m_ItemGoalBlockY = 0;
     m_ItemDropBomb = false;
@@ -114,13 +116,18 @@ CAiBomber::~CAiBomber(void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CAiBomber::Create(int Player)
+void CAiBomber::Create(int Player, unsigned int Seed)
 {
     ASSERT(m_pArena != NULL);
     m_Player = Player;
 
+    // Each computer player draws its own random numbers, so that
+    // its decisions don't depend on the other players or on rand()
+    m_RandomState = Seed ^ (2654435769U * (unsigned int)(Player + 1));
+
     // Wait a little before thinking for the first time
     m_StopTimeLeft = 0.1f;
+    m_Stopped = true;
 
     // Reset commands variables
     m_BomberMove = BOMBERMOVE_NONE;
@@ -151,12 +158,12 @@ void CAiBomber::Destroy(void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CAiBomber::Update(float DeltaTime)
+void CAiBomber::Tick(void)
 {
     // Pointer to bomber
     m_pBomber = &m_pArena->GetArena()->GetBomber(m_Player);
 
-    // Think and send commands to the bomber only if the bomber is alive
+    // Think only if the bomber is alive
     if (m_pBomber->IsAlive())
     {
         // If the player does not have to stop commanding his bomber
@@ -196,12 +203,12 @@ void CAiBomber::Update(float DeltaTime)
                 // Update the computer player according to its mode
                 switch (m_ComputerMode)
                 {
-                case COMPUTERMODE_ITEM: ModeItem(DeltaTime);    break;
+                case COMPUTERMODE_ITEM: ModeItem(AI_TICK_DURATION);    break;
                 case COMPUTERMODE_ATTACK: ModeAttack();           break;
                 case COMPUTERMODE_THROW: ModeThrow();            break;
                 case COMPUTERMODE_2NDACTION: ModeSecondAction();   break;
-                case COMPUTERMODE_DEFENCE: ModeDefence(DeltaTime); break;
-                case COMPUTERMODE_WALK: ModeWalk(DeltaTime);    break;
+                case COMPUTERMODE_DEFENCE: ModeDefence(AI_TICK_DURATION); break;
+                case COMPUTERMODE_WALK: ModeWalk(AI_TICK_DURATION);    break;
                 default: break;
                 }
 
@@ -218,24 +225,60 @@ void CAiBomber::Update(float DeltaTime)
                 }
             }
 
-            // Send commands to the bomber
-            m_pBomber->Command(m_BomberMove, m_BomberAction);
+            // Send these commands to the bomber until the next tick
+            m_Stopped = false;
 
             // Decrease time left before the bombermove has to be updated
-            m_BomberMoveTimeLeft -= DeltaTime;
+            m_BomberMoveTimeLeft -= AI_TICK_DURATION;
         }
         // If the player has to stop commanding his bomber
         else
         {
-            // Send no command to the bomber
-            m_pBomber->Command(BOMBERMOVE_NONE, BOMBERACTION_NONE);
+            // Send no command to the bomber until the next tick
+            m_Stopped = true;
 
             // Decrease time left before sending commands to the bomber
-            m_StopTimeLeft -= DeltaTime;
+            m_StopTimeLeft -= AI_TICK_DURATION;
         }
     }
 }
 
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The arena steps once per tick, right after the computer players
+ *  thought : the commands decided in this tick drive the bomber until
+ *  the next one.
+ */
+
+void CAiBomber::SendCommands(void)
+{
+    m_pBomber = &m_pArena->GetArena()->GetBomber(m_Player);
+
+    if (m_pBomber->IsAlive())
+    {
+        if (m_Stopped)
+            m_pBomber->Command(BOMBERMOVE_NONE, BOMBERACTION_NONE);
+        else
+            m_pBomber->Command(m_BomberMove, m_BomberAction);
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CAiBomber::Random(int Max)
+{
+    // Same linear congruential generator on every platform, unlike rand()
+    m_RandomState = m_RandomState * 1103515245 + 12345;
+
+    return (int)((m_RandomState >> 8) & 0xFFFFFF) % Max;
+}
+
+
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
@@ -670,7 +713,7 @@ bool CAiBomber::EnemyNear(int BlockX, int BlockY)
             m_pArena->GetArena()->GetBomber(Index).GetTeam()->GetTeamId() != m_pArena->GetArena()->GetBomber(m_Player).GetTeam()->GetTeamId() &&
             ABS(m_pArena->GetArena()->GetBomber(Index).GetBlockX() - BlockX) +
             ABS(m_pArena->GetArena()->GetBomber(Index).GetBlockY() - BlockY) <= 3 &&
-            RANDOM(100) < 90 + Index * 2)
+            Random(100) < 90 + Index * 2)
         {
             // There is an enemy not far from the tested block
             return true;
@@ -717,7 +760,7 @@ bool CAiBomber::EnemyNearRemoteFuseBomb(CBomb& bomb)
             m_pArena->GetArena()->GetBomber(Index).GetTeam()->GetTeamId() != m_pArena->GetArena()->GetBomber(m_Player).GetTeam()->GetTeamId() &&
             ((BomberX == BombX && ABS(BomberY - BombY) <= bomb.GetFlameSize()) ||
             (BomberY == BombY && ABS(BomberX - BombX) <= bomb.GetFlameSize())) &&
-            RANDOM(100) < 70 + Index * 2)
+            Random(100) < 70 + Index * 2)
         {
             // There is an enemy not far from the tested bomb
             return true;
@@ -1197,7 +1240,7 @@ void CAiBomber::ModeThink(void)
     // with quite big probability (not beyond the frontiers)
     if ((EnemyNearAndFront(&EnemyDirection, false) &&
          DropBombOK(m_BlockHereX, m_BlockHereY) &&
-         RANDOM(100) < (60 + (m_pBomber->HasShield() ? 35 : 0))))
+         Random(100) < (60 + (m_pBomber->HasShield() ? 35 : 0))))
     {
         // Switch to the attack mode to drop a bomb
         SetComputerMode(COMPUTERMODE_ATTACK);
@@ -1212,7 +1255,7 @@ void CAiBomber::ModeThink(void)
         EnemyNearAndFront(&EnemyDirection, true) &&
         (DropBombOK(m_BlockHereX, m_BlockHereY) ||
         m_pArena->GetArena()->IsBomb(m_BlockHereX, m_BlockHereY)) &&
-        RANDOM(100) < 50)
+        Random(100) < 50)
     {
         // Switch to the throw to drop a bomb and turn into the right direction
         SetComputerMode(COMPUTERMODE_THROW);
@@ -1239,10 +1282,10 @@ void CAiBomber::ModeThink(void)
                 // It's mine, it's mine! Check for players near it.
                 // If there are none, there is a 10 % chance that we detonate it
                 if (EnemyNearRemoteFuseBomb(m_pArena->GetArena()->GetBomb(Index))
-                    || RANDOM(100) < 50)
+                    || Random(100) < 50)
                 {
                     if (!TeamMateNearRemoteFuseBomb(m_pArena->GetArena()->GetBomb(Index))
-                        || RANDOM(100) > 96)
+                        || Random(100) > 96)
                     {
                         // Let's detonate it.
                         m_BomberAction = BOMBERACTION_ACTION2; // detonate the bomb
@@ -1293,7 +1336,7 @@ void CAiBomber::ModeThink(void)
                 // and its mark is higher than the current best mark
                 // (if its mark is equal to the best mark, half
                 // probability to be the best mark)
-                if (Mark > 0 && (Mark > BestMark || (Mark == BestMark && RANDOM(100) >= 50)))
+                if (Mark > 0 && (Mark > BestMark || (Mark == BestMark && Random(100) >= 50)))
                 {
                     // We found an item to pick up
                     FoundItem = true;
@@ -1394,7 +1437,7 @@ void CAiBomber::ModeThink(void)
                     m_PseudoAccessible[BlockX][BlockY] <= 5 &&
                     (BestDistance > m_PseudoAccessible[BlockX][BlockY] ||
                     (BestDistance == m_PseudoAccessible[BlockX][BlockY] &&
-                    RANDOM(100) >= 50)) &&
+                    Random(100) >= 50)) &&
                     (m_pArena->GetDeadEnd(BlockX, BlockY) == -1 || !EnemyNear(BlockX, BlockY)) &&
                     ((BlockX > 0 && m_pArena->GetWallBurn(BlockX - 1, BlockY)) ||
                     (BlockX < ARENA_WIDTH - 1 && m_pArena->GetWallBurn(BlockX + 1, BlockY)) ||
@@ -1471,7 +1514,7 @@ void CAiBomber::ModeThink(void)
                     && (m_pArena->GetDeadEnd(BlockX, BlockY) == -1 || !EnemyNear(BlockX, BlockY))
                     && m_pArena->GetDanger(BlockX, BlockY) == DANGER_NONE
                     && (BestMark < m_BurnMark[SoftWallNear][m_Accessible[BlockX][BlockY]]
-                        || (BestMark == m_BurnMark[SoftWallNear][m_Accessible[BlockX][BlockY]] && RANDOM(100) >= 50))
+                        || (BestMark == m_BurnMark[SoftWallNear][m_Accessible[BlockX][BlockY]] && Random(100) >= 50))
                     && DropBombOK(BlockX, BlockY))
                 {
                     // Save the coordinates of the best block
@@ -1560,7 +1603,7 @@ void CAiBomber::ModeItem(float DeltaTime)
     if ((
         EnemyNearAndFront() &&
         DropBombOK(m_BlockHereX, m_BlockHereY) &&
-        RANDOM(100) < 70
+        Random(100) < 70
         )
         ||
         (
@@ -1829,7 +1872,7 @@ void CAiBomber::ModeDefence(float DeltaTime)
                 if (m_pArena->GetArena()->GetBomb(Index).Exist() && m_pArena->GetArena()->GetBomb(Index).IsRemote() &&
                     m_pArena->GetArena()->GetBomb(Index).GetOwnerPlayer() == m_Player)
                 {
-                    if (TeamMateNearRemoteFuseBomb(m_pArena->GetArena()->GetBomb(Index)) && RANDOM(100) < 95)
+                    if (TeamMateNearRemoteFuseBomb(m_pArena->GetArena()->GetBomb(Index)) && Random(100) < 95)
                         break;
 
                     // Leave the for-loop, because we found a bomb
@@ -1947,7 +1990,7 @@ void CAiBomber::ModeDefence(float DeltaTime)
     {
         // kick only bomb with 5% of probability (avoid kicking against walls)
         // punch bomb with 25% of probability
-        if ((m_pBomber->CanKickBombs() && RANDOM(100) < 5) || (m_pBomber->CanPunchBombs() && RANDOM(100) < 25))
+        if ((m_pBomber->CanKickBombs() && Random(100) < 5) || (m_pBomber->CanPunchBombs() && Random(100) < 25))
         {
             BestDangerTimeLeft = 0.0f;
 
@@ -2390,7 +2433,7 @@ void CAiBomber::ModeWalk(float DeltaTime)
         MarkDownRight >= MarkUpLeft &&
         MarkDownRight >= MarkUpRight)
     {
-        if (RANDOM(100) >= 50)
+        if (Random(100) >= 50)
         {
             if (DangerDown == DANGER_NONE && m_BomberMove != BOMBERMOVE_UP    && CanMoveDown) m_BomberMove = BOMBERMOVE_DOWN;
             else if (DangerRight == DANGER_NONE && m_BomberMove != BOMBERMOVE_LEFT  && CanMoveRight) m_BomberMove = BOMBERMOVE_RIGHT;
@@ -2413,7 +2456,7 @@ void CAiBomber::ModeWalk(float DeltaTime)
         MarkDownLeft >= MarkUpLeft &&
         MarkDownLeft >= MarkUpRight)
     {
-        if (RANDOM(100) >= 50)
+        if (Random(100) >= 50)
         {
             if (DangerDown == DANGER_NONE && m_BomberMove != BOMBERMOVE_UP    && CanMoveDown) m_BomberMove = BOMBERMOVE_DOWN;
             else if (DangerLeft == DANGER_NONE && m_BomberMove != BOMBERMOVE_RIGHT && CanMoveLeft) m_BomberMove = BOMBERMOVE_LEFT;
@@ -2436,7 +2479,7 @@ void CAiBomber::ModeWalk(float DeltaTime)
         MarkUpLeft >= MarkDownLeft &&
         MarkUpLeft >= MarkUpRight)
     {
-        if (RANDOM(100) >= 50)
+        if (Random(100) >= 50)
         {
             if (DangerUp == DANGER_NONE && m_BomberMove != BOMBERMOVE_DOWN  && CanMoveUp) m_BomberMove = BOMBERMOVE_UP;
             else if (DangerLeft == DANGER_NONE && m_BomberMove != BOMBERMOVE_RIGHT && CanMoveLeft) m_BomberMove = BOMBERMOVE_LEFT;
@@ -2457,7 +2500,7 @@ void CAiBomber::ModeWalk(float DeltaTime)
     }
     else
     {
-        if (RANDOM(100) >= 50)
+        if (Random(100) >= 50)
         {
             if (DangerUp == DANGER_NONE && m_BomberMove != BOMBERMOVE_DOWN  && CanMoveUp) m_BomberMove = BOMBERMOVE_UP;
             else if (DangerRight == DANGER_NONE && m_BomberMove != BOMBERMOVE_LEFT  && CanMoveRight) m_BomberMove = BOMBERMOVE_RIGHT;
@@ -2647,12 +2690,12 @@ void CAiBomber::SetComputerMode(EComputerMode ComputerMode)
 
         switch (m_ComputerMode)
         {
-        case COMPUTERMODE_ITEM: m_StopTimeLeft = 0.080f + RANDOM(40) / 1000.0f; break;
-        case COMPUTERMODE_ATTACK: m_StopTimeLeft = 0.200f + RANDOM(40) / 1000.0f; break;
-        case COMPUTERMODE_THROW: m_StopTimeLeft = 0.200f + RANDOM(40) / 1000.0f; break;
-        case COMPUTERMODE_2NDACTION: m_StopTimeLeft = 0.200f + RANDOM(40) / 1000.0f; break;
-        case COMPUTERMODE_DEFENCE: m_StopTimeLeft = 0.120f + RANDOM(40) / 1000.0f; break;
-        case COMPUTERMODE_WALK: m_StopTimeLeft = 0.220f + RANDOM(40) / 1000.0f; break;
+        case COMPUTERMODE_ITEM: m_StopTimeLeft = 0.080f + Random(40) / 1000.0f; break;
+        case COMPUTERMODE_ATTACK: m_StopTimeLeft = 0.200f + Random(40) / 1000.0f; break;
+        case COMPUTERMODE_THROW: m_StopTimeLeft = 0.200f + Random(40) / 1000.0f; break;
+        case COMPUTERMODE_2NDACTION: m_StopTimeLeft = 0.200f + Random(40) / 1000.0f; break;
+        case COMPUTERMODE_DEFENCE: m_StopTimeLeft = 0.120f + Random(40) / 1000.0f; break;
+        case COMPUTERMODE_WALK: m_StopTimeLeft = 0.220f + Random(40) / 1000.0f; break;
         default: break;
         }
     }
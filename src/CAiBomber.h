@@ -29,6 +29,7 @@
 #define __CAIBOMBER_H__
 
 #include "CBomber.h"
+#include "CMatchTicks.h"
 
 class CAiArena;
 enum EDanger;
@@ -37,6 +38,12 @@ enum EDanger;
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+#define AI_TICK_DURATION            MATCH_TICK_DURATION //!< Duration (in seconds) of a tick of the computer players, which think once per match tick
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 //! Describes the mode of the computer player
 enum EComputerMode
 {
@@ -79,6 +86,8 @@ private:
     int             m_PseudoAccessible [ARENA_WIDTH][ARENA_HEIGHT];
     int             m_NumAccessible;
     float           m_StopTimeLeft;                                     // Number of seconds left before sending commands to the bomber. Stopping the computer bomber from time to time makes the player more human.
+    bool            m_Stopped;                                          // Does the bomber get no command until the next tick?
+    unsigned int    m_RandomState;                                      // State of the random numbers of this computer player, the same on every computer for the same seed
     int             m_ItemGoalBlockX;                                   // Used for item mode only. Coordinates of the block where to go.
     int             m_ItemGoalBlockY;
     bool            m_ItemDropBomb;                                     // Used for item mode only. True if the bomber has to drop a bomb when he gets to the item goal block.
@@ -101,6 +110,7 @@ private:
     int             m_BlockRightY;
     static int      m_BurnMark[4][6];
 
+    int             Random (int Max);                                   // Return a random number between 0 (included) and Max (excluded) from the stream of this computer player
     void            SetComputerMode (EComputerMode ComputerMode);       // Set the mode of the computer player
     void            ModeThink (void);
     void            ModeItem (float DeltaTime);
@@ -124,9 +134,10 @@ public:
     virtual         ~CAiBomber (void);
     inline void     SetArena (CAiArena* pArena);
     inline void     SetDisplay (CDisplay* pDisplay);
-    void            Create (int Player);
+    void            Create (int Player, unsigned int Seed);             // Create the computer player of this bomber, its random numbers start from the seed
     void            Destroy (void);
-    void            Update (float DeltaTime);
+    void            Tick (void);                                        // Think for one tick, from the arena and the random numbers only
+    void            SendCommands (void);                                // Send the commands decided in the latest tick to the bomber
 };
 
 //******************************************************************************************************************************
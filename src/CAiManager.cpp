@@ -61,7 +61,7 @@ CAiManager::~CAiManager (void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CAiManager::Create (COptions* pOptions)
+void CAiManager::Create (COptions* pOptions, unsigned int Seed)
 {
     for (int Player = 0 ; Player < MAX_PLAYERS ; Player++)
     {
@@ -71,7 +71,7 @@ void CAiManager::Create (COptions* pOptions)
             m_pBombers[Player] = new CAiBomber;
             m_pBombers[Player]->SetArena(&m_Arena);
             m_pBombers[Player]->SetDisplay(m_pDisplay);
-            m_pBombers[Player]->Create(Player);
+            m_pBombers[Player]->Create(Player, Seed);
         }
     }
 
@@ -102,13 +102,18 @@ void CAiManager::Destroy (void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CAiManager::Update (float DeltaTime)
+void CAiManager::Tick (void)
 {
-    m_Arena.Update(DeltaTime);
+    m_Arena.Update(AI_TICK_DURATION);
 
     for (int Player = 0 ; Player < MAX_PLAYERS ; Player++)
+    {
         if (m_pBombers[Player] != NULL)
-            m_pBombers[Player]->Update(DeltaTime);
+        {
+            m_pBombers[Player]->Tick();
+            m_pBombers[Player]->SendCommands();
+        }
+    }
 }
 
 //******************************************************************************************************************************
@@ -38,6 +38,18 @@ class CAiBomber;
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+//! Thinks for the computer players.
+
+/**
+ * The computer players think once per tick of the match, which calls
+ * Tick() right before stepping the arena by AI_TICK_DURATION seconds, and
+ * never skips a tick. Their random numbers come from a stream of their own,
+ * drawn from the seed given to Create(), so they don't depend on the other
+ * users of rand(). Their decisions thus only depend on the arena, the tick
+ * and the seed : two computers playing the same ticks make the same ones,
+ * whatever their frame rates.
+ */
+
 class CAiManager
 {
 private:
@@ -52,9 +64,9 @@ public:
     virtual         ~CAiManager (void);
     inline void     SetArena (CArena* pArena);
     inline void     SetDisplay (CDisplay* pDisplay);
-    void            Create (COptions* pOptions);
+    void            Create (COptions* pOptions, unsigned int Seed); //!< Create the computer players, their random numbers start from the seed
     void            Destroy (void);
-    void            Update (float DeltaTime);
+    void            Tick (void);                    //!< Think for one tick on the arena as it is now and send the commands to the bombers
 };
 
 //******************************************************************************************************************************
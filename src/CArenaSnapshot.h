@@ -46,6 +46,10 @@ private:
 
     char        m_Buffer [ARENA_SNAPSHOT_SIZE];
     int         m_Position;
+    int         m_AcknowledgedSequence;     //!< Sequence number of the latest command chunk the server applied before this snapshot
+    int         m_MatchTime;                //!< Match time (in milliseconds) when the server sent this snapshot
+    int         m_EchoedSendTime;           //!< Send time of the latest command chunk the server received from the client, -1 if none
+    int         m_HoldTime;                 //!< Time (in milliseconds) between the reception of that command chunk and the sending of this snapshot
 
     template<typename T>
     void        ReadData(T* pValue);
@@ -67,12 +71,51 @@ public:
     void        WriteInteger(int Value);
     void        WriteFloat(float Value);
     void        WritePointer(const void* Value);
+
+    inline void SetAcknowledgedSequence(int Sequence);
+    inline int  GetAcknowledgedSequence(void);
+    inline void SetClock(int MatchTime, int EchoedSendTime, int HoldTime);
+    inline int  GetMatchTime(void);
+    inline int  GetEchoedSendTime(void);
+    inline int  GetHoldTime(void);
 };
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+inline void CArenaSnapshot::SetAcknowledgedSequence(int Sequence)
+{
+    m_AcknowledgedSequence = Sequence;
+}
+
+inline int CArenaSnapshot::GetAcknowledgedSequence(void)
+{
+    return m_AcknowledgedSequence;
+}
+
+inline void CArenaSnapshot::SetClock(int MatchTime, int EchoedSendTime, int HoldTime)
+{
+    m_MatchTime = MatchTime;
+    m_EchoedSendTime = EchoedSendTime;
+    m_HoldTime = HoldTime;
+}
+
+inline int CArenaSnapshot::GetMatchTime(void)
+{
+    return m_MatchTime;
+}
+
+inline int CArenaSnapshot::GetEchoedSendTime(void)
+{
+    return m_EchoedSendTime;
+}
+
+inline int CArenaSnapshot::GetHoldTime(void)
+{
+    return m_HoldTime;
+}
+
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
@@ -0,0 +1,1076 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CBenchmark.cpp
+ *  \brief Microbenchmarks
+ */
+
+#include <algorithm>
+#include "StdAfx.h"
+#include "CBenchmark.h"
+#include "CVideoSDL.h"
+#include "CScaler.h"
+#include "CScalerXBR.h"
+#include "CDisplay.h"
+#include "COptions.h"
+#include "CArena.h"
+#include "CBoard.h"
+#include "CClock.h"
+#include "CScores.h"
+#include "CAiManager.h"
+#include "CMatchRules.h"
+#include "CMatchTicks.h"
+#include "CSound.h"
+#include "CInput.h"
+#include "CFont.h"
+#include "CMenuBomber.h"
+#include "CMenuMatch.h"
+#include "CMenuTeam.h"
+#include "CMenuLevel.h"
+
+#include <string.h>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A benchmark that can be asked for on the command line
+struct SBenchmark
+{
+    const char*     pName;                          //!< Name given to --benchmark
+    bool            (CBenchmark::*pFunction) (void); //!< Run the benchmark, return false if it failed
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CBenchmark::CBenchmark (void)
+{
+    m_Name[0] = '\0';
+    m_Iterations = BENCHMARK_ITERATIONS;
+    strcpy(m_GoldenFileName, BENCHMARK_GOLDEN_FILE);
+    m_Record = false;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CBenchmark::~CBenchmark (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  --benchmark <name>          Benchmark to run instead of the game, "all" for all of them
+ *  --iterations <count>        Number of times each measured function is executed
+ *  --golden <file>             File of the golden frame hashes of the render benchmark
+ *  --record                    Write the golden frame hashes instead of comparing them
+ */
+
+#ifdef WIN32
+bool CBenchmark::ParseCommandLine (const char* pCommandLine)
+{
+    const char* pOption = strstr(pCommandLine, "--benchmark");
+
+    if (pOption == NULL)
+        return false;
+
+    if (sscanf(pOption + strlen("--benchmark"), "%31s", m_Name) != 1)
+        strcpy(m_Name, "all");
+
+    pOption = strstr(pCommandLine, "--iterations");
+
+    if (pOption != NULL)
+        sscanf(pOption + strlen("--iterations"), "%d", &m_Iterations);
+
+    pOption = strstr(pCommandLine, "--golden");
+
+    if (pOption != NULL)
+        sscanf(pOption + strlen("--golden"), "%259s", m_GoldenFileName);
+
+    m_Record = (strstr(pCommandLine, "--record") != NULL);
+#else
+bool CBenchmark::ParseCommandLine (char** pCommandLine, int pCommandLineCount)
+{
+    bool Benchmark = false;
+
+    for (int i = 1; i < pCommandLineCount; i++)
+    {
+        if (strcmp(pCommandLine[i], "--benchmark") == 0)
+        {
+            Benchmark = true;
+
+            // The name is optional
+            if (i + 1 < pCommandLineCount && pCommandLine[i + 1][0] != '-')
+            {
+                strncpy(m_Name, pCommandLine[++i], BENCHMARK_NAME_LENGTH - 1);
+                m_Name[BENCHMARK_NAME_LENGTH - 1] = '\0';
+            }
+            else
+            {
+                strcpy(m_Name, "all");
+            }
+        }
+        else if (strcmp(pCommandLine[i], "--iterations") == 0 && i + 1 < pCommandLineCount)
+        {
+            m_Iterations = atoi(pCommandLine[++i]);
+        }
+        else if (strcmp(pCommandLine[i], "--golden") == 0 && i + 1 < pCommandLineCount)
+        {
+            strncpy(m_GoldenFileName, pCommandLine[++i], BENCHMARK_FILE_NAME_LENGTH - 1);
+            m_GoldenFileName[BENCHMARK_FILE_NAME_LENGTH - 1] = '\0';
+        }
+        else if (strcmp(pCommandLine[i], "--record") == 0)
+        {
+            m_Record = true;
+        }
+    }
+
+    if (!Benchmark)
+        return false;
+#endif
+
+    if (m_Iterations < 1)
+        m_Iterations = 1;
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CBenchmark::Create (void)
+{
+#ifdef ENABLE_LOG
+    // The results are printed by Report(), don't print the log too
+    theLog.Open("log.txt", false);
+#endif
+
+    theLog.WriteLine("Benchmark       => Running benchmark %s, %d iteration(s).", m_Name, m_Iterations);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CBenchmark::Destroy (void)
+{
+#ifdef ENABLE_LOG
+    theLog.Close();
+#endif
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CBenchmark::Run (void)
+{
+    static const SBenchmark Benchmarks [] =
+    {
+        { "hq2x", &CBenchmark::BenchmarkHQ2x },
+        { "scalers", &CBenchmark::BenchmarkScalers },
+        { "drawing-sort", &CBenchmark::BenchmarkDrawingSort },
+        { "render", &CBenchmark::BenchmarkRender },
+        { NULL, NULL }
+    };
+
+    bool All = (strcmp(m_Name, "all") == 0);
+    bool Found = false;
+    bool Success = true;
+
+    for (int Index = 0; Benchmarks[Index].pName != NULL; Index++)
+    {
+        if (All || strcmp(m_Name, Benchmarks[Index].pName) == 0)
+        {
+            Found = true;
+
+            if (!(this->*Benchmarks[Index].pFunction)())
+            {
+                Report("%s : FAILED", Benchmarks[Index].pName);
+                Success = false;
+            }
+        }
+    }
+
+    if (!Found)
+    {
+        Report("Unknown benchmark %s. The benchmarks are :", m_Name);
+
+        for (int Index = 0; Benchmarks[Index].pName != NULL; Index++)
+            Report("    %s", Benchmarks[Index].pName);
+
+        return false;
+    }
+
+    return Success;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The function is executed once before the measure, so that the caches
+ *  and the allocations of the first call are not measured.
+ */
+
+double CBenchmark::Measure (LPBENCHMARKFUNCTION pFunction, void* pParameter)
+{
+    ASSERT (pFunction != NULL);
+
+    CTimer Timer;
+
+    pFunction(pParameter);
+
+    double StartTime = Timer.GetElapsedTime();
+
+    for (int Iteration = 0; Iteration < m_Iterations; Iteration++)
+        pFunction(pParameter);
+
+    return (Timer.GetElapsedTime() - StartTime) * 1000.0 / m_Iterations;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CBenchmark::Report (const char* pFormat, ...)
+{
+    char Line [256];
+
+    va_list argList;
+    va_start(argList, pFormat);
+    vsnprintf(Line, sizeof(Line), pFormat, argList);
+    va_end(argList);
+
+    printf("%s\n", Line);
+
+    theLog.WriteLine("Benchmark       => %s", Line);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The image looks like an arena : blocks of flat colors, some of them
+ *  with a shaded border, and a few sprites with transparent pixels.
+ *  It is always the same so that the times can be compared.
+ */
+
+static void MakeArenaImage (uint32_t* pImage)
+{
+    static const uint32_t Colors [] = { 0xFF206020, 0xFF30A030, 0xFF808080, 0xFFC0C0C0, 0xFF804020, 0xFFF0F0F0, 0xFF000000, 0xFFE03020 };
+
+    unsigned int RandomState = 1;
+
+    for (int BlockY = 0; BlockY * BLOCK_SIZE < GAME_HEIGHT; BlockY++)
+    {
+        for (int BlockX = 0; BlockX * BLOCK_SIZE < GAME_WIDTH; BlockX++)
+        {
+            RandomState = RandomState * 1103515245 + 12345;
+
+            uint32_t Color = Colors[(RandomState >> 16) % 8];
+            bool Shaded = ((RandomState >> 20) % 2 == 0);
+            bool Sprite = ((RandomState >> 24) % 4 == 0);
+
+            for (int Y = BlockY * BLOCK_SIZE; Y < MIN((BlockY + 1) * BLOCK_SIZE, GAME_HEIGHT); Y++)
+            {
+                for (int X = BlockX * BLOCK_SIZE; X < (BlockX + 1) * BLOCK_SIZE; X++)
+                {
+                    int InBlockX = X - BlockX * BLOCK_SIZE;
+                    int InBlockY = Y - BlockY * BLOCK_SIZE;
+                    uint32_t Pixel = Color;
+
+                    if (Shaded && (InBlockX < 2 || InBlockY < 2))
+                        Pixel = (Color & 0xFF000000) | ((Color >> 1) & 0x007F7F7F);
+
+                    if (Sprite && ABS(InBlockX - 16) + ABS(InBlockY - 16) < 10)
+                        Pixel = ((InBlockX + InBlockY) % 3 == 0 ? 0x00000000 : Colors[(InBlockX * InBlockY) % 8]);
+
+                    pImage[Y * GAME_WIDTH + X] = Pixel;
+                }
+            }
+        }
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! What the HQ2x benchmark gives to the measured functions
+struct SHQ2xBenchmark
+{
+    const HQ2x*     pScaler;                        //!< Scaler to measure
+    uint32_t*       pImage;                         //!< Image of the size of the game view
+    uint32_t*       pOutput;                        //!< Upscaled image
+};
+
+static void ResizeHQ2x (void* pParameter)
+{
+    SHQ2xBenchmark* pBenchmark = (SHQ2xBenchmark*)pParameter;
+
+    pBenchmark->pScaler->resize(pBenchmark->pImage, GAME_WIDTH, GAME_HEIGHT, pBenchmark->pOutput);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CBenchmark::BenchmarkHQ2x (void)
+{
+    uint32_t* pImage = new uint32_t [GAME_WIDTH * GAME_HEIGHT];
+    uint32_t* pReferenceOutput = new uint32_t [GAME_WIDTH * GAME_HEIGHT * 4];
+    uint32_t* pOutput = new uint32_t [GAME_WIDTH * GAME_HEIGHT * 4];
+
+    MakeArenaImage(pImage);
+
+    HQ2x ReferenceScaler(true);
+    HQ2x Scaler;
+
+    SHQ2xBenchmark Reference = { &ReferenceScaler, pImage, pReferenceOutput };
+    SHQ2xBenchmark Fast = { &Scaler, pImage, pOutput };
+
+    double ReferenceTime = Measure(ResizeHQ2x, &Reference);
+    double FastTime = Measure(ResizeHQ2x, &Fast);
+
+    bool Identical = (memcmp(pReferenceOutput, pOutput, GAME_WIDTH * GAME_HEIGHT * 4 * sizeof(uint32_t)) == 0);
+
+    Report("hq2x : %dx%d image, %s kernel", GAME_WIDTH, GAME_HEIGHT, HQ2x::kernelName());
+    Report("hq2x : reference %.3f ms, precomputed YUV %.3f ms, speedup %.2fx, output %s",
+        ReferenceTime, FastTime, (FastTime > 0.0 ? ReferenceTime / FastTime : 0.0), (Identical ? "identical" : "DIFFERENT"));
+
+    delete [] pImage;
+    delete [] pReferenceOutput;
+    delete [] pOutput;
+
+    return Identical;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! What the scalers benchmark gives to the measured functions
+struct SScalerBenchmark
+{
+    const CScaler*  pScaler;                        //!< Scaler to measure
+    uint32_t*       pImage;                         //!< Image of the size of the game view
+    uint32_t*       pOutput;                        //!< Upscaled image
+};
+
+static void ScaleImage (void* pParameter)
+{
+    SScalerBenchmark* pBenchmark = (SScalerBenchmark*)pParameter;
+
+    pBenchmark->pScaler->Scale(pBenchmark->pImage, GAME_WIDTH, GAME_HEIGHT, pBenchmark->pOutput, 0, 0, GAME_WIDTH, GAME_HEIGHT);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Every scaler the display can be enlarged with upscales the whole
+ *  arena once per measured call, as when the whole display changes.
+ *  The output of the nearest scaler is checked pixel by pixel and the
+ *  output of HQ2x is compared with the one of the HQ2x algorithm.
+ */
+
+bool CBenchmark::BenchmarkScalers (void)
+{
+    const int MaxFactor = SCALER_MAX_FACTOR;
+
+    uint32_t* pImage = new uint32_t [GAME_WIDTH * GAME_HEIGHT];
+    uint32_t* pReferenceOutput = new uint32_t [GAME_WIDTH * GAME_HEIGHT * MaxFactor * MaxFactor];
+    uint32_t* pOutput = new uint32_t [GAME_WIDTH * GAME_HEIGHT * MaxFactor * MaxFactor];
+
+    MakeArenaImage(pImage);
+
+    bool Success = true;
+
+    CScalerNearest ScalerNearest;
+
+    for (int Factor = 2; Factor <= MaxFactor; Factor++)
+    {
+        ScalerNearest.SetFactor(Factor);
+
+        SScalerBenchmark Benchmark = { &ScalerNearest, pImage, pOutput };
+
+        double Time = Measure(ScaleImage, &Benchmark);
+
+        bool Identical = true;
+
+        for (int Y = 0; Y < GAME_HEIGHT * Factor && Identical; Y++)
+            for (int X = 0; X < GAME_WIDTH * Factor && Identical; X++)
+                Identical = (pOutput[Y * GAME_WIDTH * Factor + X] == pImage[(Y / Factor) * GAME_WIDTH + X / Factor]);
+
+        Report("scalers : %-8s x%d, %-6s kernel, %.3f ms, output %s",
+            ScalerNearest.GetName(), Factor, ScalerNearest.GetKernelName(), Time, (Identical ? "correct" : "WRONG"));
+
+        Success = Success && Identical;
+    }
+
+    CScalerHQ2x ScalerHQ2x;
+    HQ2x ReferenceScaler;
+
+    ReferenceScaler.resize(pImage, GAME_WIDTH, GAME_HEIGHT, pReferenceOutput);
+
+    SScalerBenchmark BenchmarkHQ2x = { &ScalerHQ2x, pImage, pOutput };
+
+    double TimeHQ2x = Measure(ScaleImage, &BenchmarkHQ2x);
+
+    bool IdenticalHQ2x = (memcmp(pReferenceOutput, pOutput, GAME_WIDTH * GAME_HEIGHT * 4 * sizeof(uint32_t)) == 0);
+
+    Report("scalers : %-8s x%d, %-6s kernel, %.3f ms, output %s",
+        ScalerHQ2x.GetName(), ScalerHQ2x.GetFactor(), ScalerHQ2x.GetKernelName(), TimeHQ2x, (IdenticalHQ2x ? "identical" : "DIFFERENT"));
+
+    Success = Success && IdenticalHQ2x;
+
+    CScalerXBR ScalerXBR;
+
+    SScalerBenchmark BenchmarkXBR = { &ScalerXBR, pImage, pOutput };
+
+    double TimeXBR = Measure(ScaleImage, &BenchmarkXBR);
+
+    Report("scalers : %-8s x%d, %-6s kernel, %.3f ms",
+        ScalerXBR.GetName(), ScalerXBR.GetFactor(), ScalerXBR.GetKernelName(), TimeXBR);
+
+    delete [] pImage;
+    delete [] pReferenceOutput;
+    delete [] pOutput;
+
+    return Success;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define BENCHMARK_FRAME_REQUESTS    650     //!< Number of drawing requests of the frame sorted by the drawing sort benchmark
+
+//! What the drawing sort benchmark gives to the measured functions
+struct SDrawingSortBenchmark
+{
+    bool            Sort;                           //!< Are the requests sorted, or only made?
+    CVideoSDL*      pVideoSDL;                      //!< Video object sorting the requests, NULL to use std::sort
+    const SDrawingRequest* pFrame;                  //!< Drawing requests of a frame, in the order they are made
+    ::portable_stl::vector<SDrawingRequest>* pRequests; //!< Sorted drawing requests
+};
+
+static void SortDrawingRequests (void* pParameter)
+{
+    SDrawingSortBenchmark* pBenchmark = (SDrawingSortBenchmark*)pParameter;
+
+    // Make the requests again, as the game does each frame
+    pBenchmark->pRequests->clear();
+
+    for (int Request = 0; Request < BENCHMARK_FRAME_REQUESTS; Request++)
+        pBenchmark->pRequests->push_back(pBenchmark->pFrame[Request]);
+
+    if (!pBenchmark->Sort)
+        return;
+
+    if (pBenchmark->pVideoSDL != NULL)
+        pBenchmark->pVideoSDL->SortDrawingRequests(*pBenchmark->pRequests);
+    else
+        std::sort(pBenchmark->pRequests->begin().base(), pBenchmark->pRequests->end().base());
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The frame is made like a busy match : the arena objects are displayed
+ *  kind after kind (floors, walls, items, bombs, bombers, explosions...)
+ *  so the layers arrive in blocks, and the board and a message are
+ *  drawn on top. The sorted requests must be the same as the ones of
+ *  std::stable_sort, and in the same layer and priority order as std::sort.
+ */
+
+bool CBenchmark::BenchmarkDrawingSort (void)
+{
+    //! Kinds of drawing requests of the frame : layer, priority (-2 for the Y position) and number of requests
+    static const int Kinds [][3] =
+    {
+        {   0, -1, 221 },       // Floors
+        {   1, -1,  12 },       // Arrows
+        {  20,  0, 150 },       // Walls
+        {  10,  0,  30 },       // Items
+        {  40, -1,  16 },       // Bombs
+        {  50, -2,  16 },       // Bombers
+        {  30, -1, 150 },       // Flames
+        {  50, -2,   5 },       // Flying items and bombs
+        {  20,  1,   5 },       // Shadows of the flying bombs
+        { 100,  0,   1 },       // Board background
+        { 100,  1,  34 },       // Board objects
+        {   1,  1,  10 }        // Message text
+    };
+
+    SDrawingRequest* pFrame = new SDrawingRequest [BENCHMARK_FRAME_REQUESTS];
+
+    unsigned int RandomState = 1;
+    int Request = 0;
+
+    for (unsigned int Kind = 0; Kind < sizeof(Kinds) / sizeof(Kinds[0]); Kind++)
+    {
+        for (int Index = 0; Index < Kinds[Kind][2] && Request < BENCHMARK_FRAME_REQUESTS; Index++)
+        {
+            RandomState = RandomState * 1103515245 + 12345;
+
+            SDrawingRequest &DR = pFrame[Request++];
+
+            DR.PositionX = (RandomState >> 8) % GAME_WIDTH;
+            DR.PositionY = (RandomState >> 16) % GAME_HEIGHT;
+            DR.ZoneX1 = 1;
+            DR.ZoneY1 = 1;
+            DR.ZoneX2 = 33;
+            DR.ZoneY2 = 33;
+            DR.pSurface = NULL;
+            DR.SpriteTable = Kind;
+            DR.Sprite = Index;
+            DR.SpriteLayer = Kinds[Kind][0];
+            DR.PriorityInLayer = (Kinds[Kind][1] == -2 ? DR.PositionY : Kinds[Kind][1]);
+        }
+    }
+
+    ASSERT (Request == BENCHMARK_FRAME_REQUESTS);
+
+    CVideoSDL VideoSDL;
+    ::portable_stl::vector<SDrawingRequest> ReferenceRequests;
+    ::portable_stl::vector<SDrawingRequest> Requests;
+
+    SDrawingSortBenchmark Unsorted = { false, NULL, pFrame, &Requests };
+    SDrawingSortBenchmark Reference = { true, NULL, pFrame, &ReferenceRequests };
+    SDrawingSortBenchmark Bucketed = { true, &VideoSDL, pFrame, &Requests };
+
+    // Don't count the time to make the requests
+    double MakeTime = Measure(SortDrawingRequests, &Unsorted);
+    double ReferenceTime = MAX(Measure(SortDrawingRequests, &Reference) - MakeTime, 0.0);
+    double BucketedTime = MAX(Measure(SortDrawingRequests, &Bucketed) - MakeTime, 0.0);
+
+    // The equal requests may be in any order after std::sort
+    bool SameOrder = true;
+
+    for (Request = 0; Request < BENCHMARK_FRAME_REQUESTS; Request++)
+    {
+        if (!(ReferenceRequests[Request] == Requests[Request]))
+            SameOrder = false;
+    }
+
+    std::stable_sort(pFrame, pFrame + BENCHMARK_FRAME_REQUESTS);
+
+    bool Stable = (memcmp(pFrame, Requests.data(), BENCHMARK_FRAME_REQUESTS * sizeof(SDrawingRequest)) == 0);
+
+    Report("drawing-sort : %d drawing requests, made in %.4f ms", BENCHMARK_FRAME_REQUESTS, MakeTime);
+    Report("drawing-sort : std::sort %.4f ms, bucketed per layer %.4f ms, speedup %.2fx, order %s, %s",
+        ReferenceTime, BucketedTime, (BucketedTime > 0.0 ? ReferenceTime / BucketedTime : 0.0),
+        (SameOrder ? "identical" : "DIFFERENT"), (Stable ? "stable" : "NOT STABLE"));
+
+    delete [] pFrame;
+
+    return SameOrder && Stable;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define BENCHMARK_ARENA_FRAMES      240     //!< Number of frames of the arena scene (four seconds of the match)
+#define BENCHMARK_ARENA_BOMB_FRAME  30      //!< Frame of the arena scene when a bomb is dropped under each bomber
+#define BENCHMARK_ARENA_TEXT        "DEMO"  //!< Text flashing in the corner of the arena scene, as in the demo mode
+#define BENCHMARK_ARENA_TEXT_FRAMES 12      //!< Number of frames the text of the arena scene is drawn, then not drawn
+#define BENCHMARK_MENU_FRAMES       2       //!< Number of frames of each menu scene (the second one is drawn again unchanged)
+#define BENCHMARK_MAX_FRAMES        512     //!< Maximum number of frames of the render benchmark
+#define BENCHMARK_MAX_MISMATCHES    5       //!< Maximum number of frames whose hash mismatch is reported
+
+//! A frame of the render benchmark
+struct SRenderedFrame
+{
+    char            Scene [BENCHMARK_NAME_LENGTH];  //!< Name of the scene the frame belongs to
+    int             Frame;                          //!< Number of the frame in the scene
+    Uint64          Hash;                           //!< Hash of the pixels of the frame
+};
+
+//! State of the render benchmark while it draws the scenes
+struct SRenderBenchmark
+{
+    CDisplay*       pDisplay;                       //!< Display drawing the scenes offscreen
+    SRenderedFrame  GoldenFrames [BENCHMARK_MAX_FRAMES]; //!< Frames read from the golden file
+    int             NumberOfGoldenFrames;           //!< Number of frames read from the golden file, -1 when recording them
+    FILE*           pRecordFile;                    //!< Golden file written by this run, NULL if the frames are compared
+    int             NumberOfFrames;                 //!< Number of frames rendered so far
+    int             NumberOfMismatches;             //!< Number of frames whose hash is not the golden one
+    double          SortTime;                       //!< Time spent sorting the drawing requests since the creation of the display, after the previous frame
+    double          BlitTime;                       //!< Time spent blitting since the creation of the display, after the previous frame
+    double          ScaleTime;                      //!< Time spent upscaling since the creation of the display, after the previous frame
+    int             SceneFrames;                    //!< Number of frames rendered in the current scene
+    double          SceneSortTime;                  //!< Time spent sorting the drawing requests in the current scene
+    double          SceneBlitTime;                  //!< Time spent blitting in the current scene
+    double          SceneScaleTime;                 //!< Time spent upscaling in the current scene
+    double          SceneWorstTime;                 //!< Longest time spent rendering a frame of the current scene
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+static Uint64 HashSurface (const SDL_Surface* pSurface)
+{
+    ASSERT (pSurface->format->BytesPerPixel == 4);
+
+    // The unused bits of the pixels may hold anything
+    Uint32 Mask = pSurface->format->Rmask | pSurface->format->Gmask | pSurface->format->Bmask;
+
+    // FNV-1a, one pixel at a time
+    Uint64 Hash = 14695981039346656037ULL;
+
+    for (int Y = 0; Y < pSurface->h; Y++)
+    {
+        const Uint32* pPixel = (const Uint32*)((const Uint8*)pSurface->pixels + Y * pSurface->pitch);
+
+        for (int X = 0; X < pSurface->w; X++)
+        {
+            Hash ^= pPixel[X] & Mask;
+            Hash *= 1099511628211ULL;
+        }
+    }
+
+    return Hash;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+static void StartScene (SRenderBenchmark& Benchmark)
+{
+    Benchmark.SceneFrames = 0;
+    Benchmark.SceneSortTime = 0.0;
+    Benchmark.SceneBlitTime = 0.0;
+    Benchmark.SceneScaleTime = 0.0;
+    Benchmark.SceneWorstTime = 0.0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CBenchmark::RenderFrame (SRenderBenchmark& Benchmark, const char* pScene, int Frame)
+{
+    CVideoSDL& VideoSDL = Benchmark.pDisplay->GetVideoSDL();
+
+    Benchmark.pDisplay->Update();
+
+    Uint64 Hash = HashSurface(VideoSDL.GetRenderedSurface());
+
+    // Measure the phases of the rendering of this frame
+    double SortTime;
+    double BlitTime;
+    double ScaleTime;
+
+    VideoSDL.GetRenderTimes(SortTime, BlitTime, ScaleTime);
+
+    double FrameSortTime = SortTime - Benchmark.SortTime;
+    double FrameBlitTime = BlitTime - Benchmark.BlitTime;
+    double FrameScaleTime = ScaleTime - Benchmark.ScaleTime;
+
+    Benchmark.SortTime = SortTime;
+    Benchmark.BlitTime = BlitTime;
+    Benchmark.ScaleTime = ScaleTime;
+
+    Benchmark.SceneFrames++;
+    Benchmark.SceneSortTime += FrameSortTime;
+    Benchmark.SceneBlitTime += FrameBlitTime;
+    Benchmark.SceneScaleTime += FrameScaleTime;
+    Benchmark.SceneWorstTime = MAX(Benchmark.SceneWorstTime, FrameSortTime + FrameBlitTime + FrameScaleTime);
+
+    ASSERT (Benchmark.NumberOfFrames < BENCHMARK_MAX_FRAMES);
+
+    if (Benchmark.pRecordFile != NULL)
+    {
+        fprintf(Benchmark.pRecordFile, "%s %d %016llx\n", pScene, Frame, (unsigned long long)Hash);
+    }
+    else
+    {
+        // The golden frames are in the order the scenes draw them
+        int Golden = Benchmark.NumberOfFrames;
+
+        if (Golden >= Benchmark.NumberOfGoldenFrames ||
+            strcmp(Benchmark.GoldenFrames[Golden].Scene, pScene) != 0 ||
+            Benchmark.GoldenFrames[Golden].Frame != Frame)
+        {
+            if (Benchmark.NumberOfMismatches < BENCHMARK_MAX_MISMATCHES)
+                Report("render : %s frame %d is not in the golden file", pScene, Frame);
+
+            Benchmark.NumberOfMismatches++;
+        }
+        else if (Benchmark.GoldenFrames[Golden].Hash != Hash)
+        {
+            if (Benchmark.NumberOfMismatches < BENCHMARK_MAX_MISMATCHES)
+            {
+                Report("render : %s frame %d hash %016llx, golden %016llx", pScene, Frame,
+                    (unsigned long long)Hash, (unsigned long long)Benchmark.GoldenFrames[Golden].Hash);
+            }
+
+            Benchmark.NumberOfMismatches++;
+        }
+    }
+
+    Benchmark.NumberOfFrames++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Draw a few seconds of a match between computer bombers, with the
+ *  board and the flashing demo text, and the main menu screens in a
+ *  memory surface, as the game would draw them with the HQ2x scaler. The scenes don't depend on the configuration file,
+ *  and the random numbers always start from the same seed, so that a
+ *  frame is the same on every run unless the rendering changed.
+ *
+ *  The input menu is not drawn, it shows the devices of the computer.
+ */
+
+bool CBenchmark::BenchmarkRender (void)
+{
+    // Draw in memory, even if there is no screen
+    SDL12_putenv((char*)"SDL_VIDEODRIVER=dummy");
+
+    if (SDL12_Init(SDL_INIT_VIDEO) < 0)
+    {
+        Report("render : could not initialize SDL (%s)", SDL12_GetError());
+        return false;
+    }
+
+    SRenderBenchmark* pBenchmark = new SRenderBenchmark;
+
+    pBenchmark->NumberOfGoldenFrames = -1;
+    pBenchmark->pRecordFile = NULL;
+    pBenchmark->NumberOfFrames = 0;
+    pBenchmark->NumberOfMismatches = 0;
+    pBenchmark->SortTime = 0.0;
+    pBenchmark->BlitTime = 0.0;
+    pBenchmark->ScaleTime = 0.0;
+
+    if (m_Record)
+    {
+        pBenchmark->pRecordFile = fopen(m_GoldenFileName, "w");
+
+        if (pBenchmark->pRecordFile == NULL)
+        {
+            Report("render : could not write the golden file %s", m_GoldenFileName);
+            delete pBenchmark;
+            SDL12_Quit();
+            return false;
+        }
+    }
+    else
+    {
+        FILE* pGoldenFile = fopen(m_GoldenFileName, "r");
+
+        // Without golden hashes, nothing would check the frames
+        if (pGoldenFile == NULL)
+        {
+            Report("render : could not read the golden file %s (--record writes it)", m_GoldenFileName);
+            delete pBenchmark;
+            SDL12_Quit();
+            return false;
+        }
+
+        pBenchmark->NumberOfGoldenFrames = 0;
+
+        unsigned long long Hash;
+        SRenderedFrame* pFrame = pBenchmark->GoldenFrames;
+
+        while (pBenchmark->NumberOfGoldenFrames < BENCHMARK_MAX_FRAMES &&
+               fscanf(pGoldenFile, "%31s %d %llx", pFrame->Scene, &pFrame->Frame, &Hash) == 3)
+        {
+            pFrame->Hash = (Uint64)Hash;
+            pFrame++;
+            pBenchmark->NumberOfGoldenFrames++;
+        }
+
+        fclose(pGoldenFile);
+    }
+
+    // Options that don't depend on the configuration file
+    COptions Options;
+
+    Options.Create("./", "");
+
+    for (int Player = 0; Player < MAX_PLAYERS; Player++)
+    {
+        Options.SetBomberType(Player, BOMBERTYPE_COM);
+        Options.SetBomberTeam(Player, (Player % 2 == 0 ? BOMBERTEAM_A : BOMBERTEAM_B));
+    }
+
+    Options.SetBattleMode(BATTLEMODE_SINGLE);
+    Options.SetBattleCount(3);
+    Options.SetTimeStart(2, 0);
+    Options.SetTimeUp(1, 0);
+    Options.SetLevel(0);
+    Options.SetScaler(SCALER_HQ2X, 2);
+
+    CDisplay Display;
+
+    Display.SetOptions(&Options);
+    Display.GetVideoSDL().SetOffscreen(true);
+
+    if (!Display.Create())
+    {
+        Report("render : could not create the display");
+
+        if (pBenchmark->pRecordFile != NULL)
+            fclose(pBenchmark->pRecordFile);
+
+        delete pBenchmark;
+        Options.Destroy();
+        SDL12_Quit();
+        return false;
+    }
+
+    pBenchmark->pDisplay = &Display;
+
+    // Every frame lasts the same time
+    CTimer Timer;
+
+    Timer.SetFixedDeltaTime(1.0f / 60.0f);
+
+    // The sound and the input are not created : the scenes are silent and only drawn
+    CSound Sound;
+    CInput Input;
+    CFont Font;
+
+    Font.SetDisplay(&Display);
+
+    //---------------------
+    // The arena
+    //---------------------
+
+    SEED_RANDOM(1);
+
+    CArena Arena;
+    CClock Clock;
+    CScores Scores;
+    CBoard Board;
+    CMatchRules Rules;
+    CAiManager AiManager;
+    CMatchTicks Ticks;
+    CFont DemoFont;
+
+    Arena.SetDisplay(&Display);
+    Arena.SetSound(&Sound);
+    Arena.SetOptions(&Options);
+    Arena.Create();
+
+    Clock.Create(CLOCKTYPE_COUNTDOWN, CLOCKMODE_MS, 0, Options.GetTimeStartMinutes(), Options.GetTimeStartSeconds(), 0);
+
+    Scores.SetOptions(&Options);
+    Scores.Reset();
+
+    Board.SetDisplay(&Display);
+    Board.SetOptions(&Options);
+    Board.SetScores(&Scores);
+    Board.SetClock(&Clock);
+    Board.SetTimer(&Timer);
+    Board.SetArena(&Arena);
+    Board.Create();
+
+    // The bombers burnt by the bombs ask their team whether they won
+    Rules.SetArena(&Arena);
+    Rules.SetClock(&Clock);
+    Rules.SetOptions(&Options);
+    Rules.Create();
+
+    // The computer players walk, pick up items and drop bombs
+    AiManager.SetArena(&Arena);
+    AiManager.SetDisplay(&Display);
+    AiManager.Create(&Options, (unsigned int)RANDOM(0x7FFF));
+
+    DemoFont.SetDisplay(&Display);
+    DemoFont.Create();
+    DemoFont.SetShadow(true);
+    DemoFont.SetShadowColor(FONTCOLOR_BLACK);
+    DemoFont.SetShadowDirection(SHADOWDIRECTION_DOWNRIGHT);
+    DemoFont.SetSpriteLayer(800);
+    DemoFont.SetTextColor(FONTCOLOR_WHITE);
+
+    StartScene(*pBenchmark);
+
+    for (int Frame = 0; Frame < BENCHMARK_ARENA_FRAMES; Frame++)
+    {
+        // Make flames, burning walls and items
+        if (Frame == BENCHMARK_ARENA_BOMB_FRAME)
+        {
+            for (int Player = 0; Player < MAX_PLAYERS; Player++)
+            {
+                CBomber& Bomber = Arena.GetBomber(Player);
+
+                if (Bomber.Exist() && Bomber.IsAlive())
+                    Arena.NewBomb(Bomber.GetBlockX(), Bomber.GetBlockY(), 2, 1.0f, Player);
+            }
+        }
+
+        Timer.Update();
+
+        // Step the match the way CMatch does
+        for (int Tick = Ticks.Update(Timer.GetDeltaTime()); Tick > 0; Tick--)
+        {
+            AiManager.Tick();
+            Clock.Update(MATCH_TICK_DURATION);
+            Arena.Update(MATCH_TICK_DURATION);
+        }
+
+        Board.Update();
+
+        Display.Clear();
+        Board.Display();
+        Arena.Display();
+
+        if ((Frame / BENCHMARK_ARENA_TEXT_FRAMES) % 2 == 0)
+            DemoFont.Draw(4, GAME_HEIGHT - 14, BENCHMARK_ARENA_TEXT);
+
+        RenderFrame(*pBenchmark, "arena", Frame);
+    }
+
+    DemoFont.Destroy();
+    AiManager.Destroy();
+    Board.Destroy();
+    Clock.Destroy();
+    Arena.Destroy();
+
+    Report("render : arena %d frames, sort %.3f ms, blit %.3f ms, scale %.3f ms per frame, worst frame %.3f ms",
+        pBenchmark->SceneFrames,
+        pBenchmark->SceneSortTime * 1000.0 / pBenchmark->SceneFrames,
+        pBenchmark->SceneBlitTime * 1000.0 / pBenchmark->SceneFrames,
+        pBenchmark->SceneScaleTime * 1000.0 / pBenchmark->SceneFrames,
+        pBenchmark->SceneWorstTime * 1000.0);
+
+    //---------------------
+    // The menus
+    //---------------------
+
+    CMenuBomber MenuBomber;
+    CMenuMatch MenuMatch;
+    CMenuTeam MenuTeam;
+    CMenuLevel MenuLevel;
+
+    struct
+    {
+        const char* pScene;
+        CMenuBase*  pMenu;
+    }
+    Menus [] =
+    {
+        { "menu-bomber",    &MenuBomber },
+        { "menu-match",     &MenuMatch  },
+        { "menu-team",      &MenuTeam   },
+        { "menu-level",     &MenuLevel  }
+    };
+
+    for (unsigned int Menu = 0; Menu < sizeof(Menus) / sizeof(Menus[0]); Menu++)
+    {
+        CMenuBase* pMenu = Menus[Menu].pMenu;
+
+        pMenu->SetDisplay(&Display);
+        pMenu->SetSound(&Sound);
+        pMenu->SetInput(&Input);
+        pMenu->SetOptions(&Options);
+        pMenu->SetTimer(&Timer);
+        pMenu->SetFont(&Font);
+        pMenu->Create();
+
+        StartScene(*pBenchmark);
+
+        for (int Frame = 0; Frame < BENCHMARK_MENU_FRAMES; Frame++)
+        {
+            Display.Clear();
+            pMenu->Display();
+
+            RenderFrame(*pBenchmark, Menus[Menu].pScene, Frame);
+        }
+
+        pMenu->Destroy();
+
+        Report("render : %s %d frames, sort %.3f ms, blit %.3f ms, scale %.3f ms per frame, worst frame %.3f ms",
+            Menus[Menu].pScene,
+            pBenchmark->SceneFrames,
+            pBenchmark->SceneSortTime * 1000.0 / pBenchmark->SceneFrames,
+            pBenchmark->SceneBlitTime * 1000.0 / pBenchmark->SceneFrames,
+            pBenchmark->SceneScaleTime * 1000.0 / pBenchmark->SceneFrames,
+            pBenchmark->SceneWorstTime * 1000.0);
+    }
+
+    //---------------------
+    // The results
+    //---------------------
+
+    bool Success = true;
+
+    if (pBenchmark->pRecordFile != NULL)
+    {
+        fclose(pBenchmark->pRecordFile);
+
+        Report("render : %d frame hashes recorded in %s", pBenchmark->NumberOfFrames, m_GoldenFileName);
+    }
+    else
+    {
+        // The golden file may also have more frames than this run
+        if (pBenchmark->NumberOfGoldenFrames != pBenchmark->NumberOfFrames && pBenchmark->NumberOfMismatches == 0)
+            pBenchmark->NumberOfMismatches++;
+
+        Success = (pBenchmark->NumberOfMismatches == 0);
+
+        Report("render : %d frames, %d golden, %s", pBenchmark->NumberOfFrames, pBenchmark->NumberOfGoldenFrames,
+            (Success ? "identical" : "DIFFERENT"));
+    }
+
+    Display.Destroy();
+    Options.Destroy();
+
+    delete pBenchmark;
+
+    SDL12_Quit();
+
+    return Success;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,100 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CBenchmark.h
+ *  \brief Header file of the microbenchmarks
+ */
+
+#ifndef __CBENCHMARK_H__
+#define __CBENCHMARK_H__
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define BENCHMARK_ITERATIONS        50      //!< Default number of times each measured function is executed
+#define BENCHMARK_NAME_LENGTH       32      //!< Maximum length of a benchmark name, including the terminating zero
+#define BENCHMARK_FILE_NAME_LENGTH  260     //!< Maximum length of the name of the golden hashes file, including the terminating zero
+#define BENCHMARK_GOLDEN_FILE       "render_golden.txt" //!< Default file the render benchmark compares the frame hashes with
+
+//! Function measured by a benchmark. It receives the parameter given to Measure().
+typedef void (*LPBENCHMARKFUNCTION) (void* pParameter);
+
+struct SRenderBenchmark;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Runs microbenchmarks of the game code without creating the game, and reports their times.
+
+/**
+ * `--benchmark <name>` runs the benchmark of this name (`all` runs all of
+ * them) instead of the game, and `--iterations <count>` sets how many
+ * times each measured function is executed. A benchmark comparing a fast
+ * version of the code with a reference one first checks they give the
+ * same result, and fails if they don't. The results are printed and
+ * written to log.txt.
+ *
+ * The render benchmark draws scripted scenes without any window and
+ * compares a hash of each frame with the golden hashes of the file given
+ * by `--golden <file>`. With `--record`, the file is written with the
+ * hashes of this run instead, to compare the next runs with.
+ */
+
+class CBenchmark
+{
+private:
+
+    char            m_Name [BENCHMARK_NAME_LENGTH]; //!< Name of the benchmark to run
+    int             m_Iterations;                   //!< Number of times each measured function is executed
+    char            m_GoldenFileName [BENCHMARK_FILE_NAME_LENGTH]; //!< File of the golden hashes of the render benchmark
+    bool            m_Record;                       //!< Write the golden hashes of the render benchmark instead of comparing them
+
+    double          Measure (LPBENCHMARKFUNCTION pFunction, void* pParameter); //!< Return the average time (in milliseconds) the function takes
+    void            Report (const char* pFormat, ...); //!< Print a line of results and write it to the log
+    bool            BenchmarkHQ2x (void);           //!< Compare the HQ2x upscaling with the reference one
+    bool            BenchmarkScalers (void);        //!< Measure every scaler the display can be enlarged with
+    bool            BenchmarkDrawingSort (void);    //!< Compare the sort of the drawing requests with std::sort
+    bool            BenchmarkRender (void);         //!< Draw scripted scenes offscreen and compare the frames with the golden hashes
+    void            RenderFrame (SRenderBenchmark& Benchmark, const char* pScene, int Frame); //!< Render the frame the scene drew, hash it and measure it
+
+public:
+
+                    CBenchmark (void);              //!< Constructor. Initialize some members.
+                    ~CBenchmark (void);             //!< Destructor. Does nothing.
+#ifdef WIN32
+    bool            ParseCommandLine (const char* pCommandLine); //!< Read the benchmark to run. Return false if no benchmark was asked for.
+#else
+    bool            ParseCommandLine (char** pCommandLine, int pCommandLineCount); //!< Read the benchmark to run. Return false if no benchmark was asked for.
+#endif
+    void            Create (void);                  //!< Open the log
+    void            Destroy (void);                 //!< Close the log
+    bool            Run (void);                     //!< Run the benchmark. Return false if it does not exist or failed.
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CBENCHMARK_H__
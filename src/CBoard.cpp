@@ -89,6 +89,8 @@
 #define TIME_POSITION_X                 23      // Position of the board time from board origin
 #define TIME_POSITION_Y                 8
 
+#define BOARD_MAX_PARTS                 (7 + 2 * MAX_PLAYERS)   // Maximum number of sprites in a sprite run of the board
+
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
@@ -109,6 +111,9 @@ CBoard::CBoard (void)
     m_ClockBottomSprite = 0;
     m_ClockTopSprite = 0;
     m_AnimateClock = false;
+    m_NumberOfDisplays = 0;
+    m_NumberOfBoardRedraws = 0;
+    m_NumberOfClockRedraws = 0;
     
 }
 
@@ -147,6 +152,10 @@ void CBoard::Create (void)
 
     // Animate the clock
     m_AnimateClock = true;
+
+    m_NumberOfDisplays = 0;
+    m_NumberOfBoardRedraws = 0;
+    m_NumberOfClockRedraws = 0;
 }
 
 
@@ -158,7 +167,13 @@ void CBoard::Create (void)
 
 void CBoard::Destroy (void)
 {
-    // Nothing to do!
+    if (m_NumberOfDisplays > 0)
+    {
+        theLog.WriteLine("Board           => Drawn %d time(s), the board was found in the cache %.1f%% of the time, the clock %.1f%%.",
+            m_NumberOfDisplays,
+            100.0f * (m_NumberOfDisplays - m_NumberOfBoardRedraws) / m_NumberOfDisplays,
+            100.0f * (m_NumberOfDisplays - m_NumberOfClockRedraws) / m_NumberOfDisplays);
+    }
 }
 
 //******************************************************************************************************************************
@@ -244,52 +259,98 @@ void CBoard::Update (void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+// Add a sprite to the parts of a sprite run of the board.
+
+static void AddPart (SSpriteRunPart* pParts, int& NumberOfParts, int PositionX, int PositionY, const void* SpriteTable, int Sprite)
+{
+    ASSERT (NumberOfParts < BOARD_MAX_PARTS);
+
+    pParts[NumberOfParts].SpriteTable = SpriteTable;
+    pParts[NumberOfParts].Sprite = Sprite;
+    pParts[NumberOfParts].PositionX = PositionX;
+    pParts[NumberOfParts].PositionY = PositionY;
+
+    NumberOfParts++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+// Draw the parts as a sprite run cached with the parts as key. Return false if
+// the run was not in the cache.
+
+bool CBoard::DrawParts (const SSpriteRunPart* pParts, int NumberOfParts, int PriorityInLayer)
+{
+    int KeySize = NumberOfParts * sizeof(SSpriteRunPart);
+
+    if (m_pDisplay->DrawSpriteRun (0, 0, pParts, KeySize, BOARD_SPRITELAYER, PriorityInLayer))
+        return true;
+
+    // If the run could not be made, draw each sprite on its own
+    if (!m_pDisplay->CreateSpriteRun (pParts, KeySize, pParts, NumberOfParts) ||
+        !m_pDisplay->DrawSpriteRun (0, 0, pParts, KeySize, BOARD_SPRITELAYER, PriorityInLayer))
+    {
+        for (int Part = 0; Part < NumberOfParts; Part++)
+        {
+            m_pDisplay->DrawSprite (pParts[Part].PositionX, 
+                                    pParts[Part].PositionY, 
+                                    NULL,                            // Draw entire sprite
+                                    NULL,                            // No need to clip
+                                    pParts[Part].SpriteTable, 
+                                    pParts[Part].Sprite, 
+                                    BOARD_SPRITELAYER,
+                                    PriorityInLayer);
+        }
+    }
+
+    return false;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 // This draws every sprite of the board : the background, the clock, 
 // current time left, current player scores with the bomber heads.
+// They are drawn in two cached sprite runs : the clock, which animates,
+// and the rest of the board, which changes at most once per second.
+// A run is only drawn again when its sprites change.
 
 void CBoard::Display (void)
 {
     // Set the origin where to draw
     m_pDisplay->SetOrigin (BOARD_POSITION_X, BOARD_POSITION_Y);
 
-    //-----------------------------------
-    // Draw background
-    //-----------------------------------
+    m_NumberOfDisplays++;
+
+    // The parts are the keys of the runs, so their padding must be the same each time
+    SSpriteRunPart Parts [BOARD_MAX_PARTS];
+    memset (Parts, 0, sizeof(Parts));
+    int NumberOfParts = 0;
 
-    m_pDisplay->DrawSprite (BOARD_BACKGROUND_POSITION_X, 
-                            BOARD_BACKGROUND_POSITION_Y, 
-                            NULL,                            // Draw entire background
-                            NULL,                            // No need to clip
-                            BMP_BOARD_BACKGROUND,
-                            SPRITE_BOARD_BACKGROUND, 
-                            BOARD_SPRITELAYER,
-                            BOARD_BACKGROUND_PRIORITY);
-    
     //-----------------------------------
     // Draw the clock
     //-----------------------------------
 
     // Draw the clock bottom part
-    m_pDisplay->DrawSprite (CLOCKBOTTOM_POSITION_X, 
-                            CLOCKBOTTOM_POSITION_Y, 
-                            NULL,                            // Draw entire sprite
-                            NULL,                            // No need to clip
-                            BMP_BOARD_CLOCK_BOTTOM, 
-                            m_ClockBottomSprite, 
-                            BOARD_SPRITELAYER,
-                            BOARD_OBJECTS_PRIORITY);
+    AddPart (Parts, NumberOfParts, CLOCKBOTTOM_POSITION_X, CLOCKBOTTOM_POSITION_Y, BMP_BOARD_CLOCK_BOTTOM, m_ClockBottomSprite);
 
     // Draw the clock top part
-    m_pDisplay->DrawSprite (CLOCKTOP_POSITION_X, 
-                            CLOCKTOP_POSITION_Y, 
-                            NULL,                            // Draw entire sprite
-                            NULL,                            // No need to clip
-                            BMP_BOARD_CLOCK_TOP, 
-                            m_ClockTopSprite, 
-                            BOARD_SPRITELAYER,
-                            BOARD_OBJECTS_PRIORITY);
+    AddPart (Parts, NumberOfParts, CLOCKTOP_POSITION_X, CLOCKTOP_POSITION_Y, BMP_BOARD_CLOCK_TOP, m_ClockTopSprite);
+
+    if (!DrawParts (Parts, NumberOfParts, BOARD_OBJECTS_PRIORITY))
+        m_NumberOfClockRedraws++;
 
+    memset (Parts, 0, sizeof(Parts));
+    NumberOfParts = 0;
 
+    //-----------------------------------
+    // Draw background
+    //-----------------------------------
+
+    AddPart (Parts, NumberOfParts, BOARD_BACKGROUND_POSITION_X, BOARD_BACKGROUND_POSITION_Y, BMP_BOARD_BACKGROUND, SPRITE_BOARD_BACKGROUND);
+    
     //-----------------------------------
     // Draw the current clock time
     //-----------------------------------
@@ -304,24 +365,10 @@ void CBoard::Display (void)
         ASSERT (Minutes >= 0 && Minutes < 10);
     
         // Draw the number of minutes left
-        m_pDisplay->DrawSprite (TIME_POSITION_X, 
-                                TIME_POSITION_Y, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_BOARD_TIME, 
-                                Minutes, 
-                                BOARD_SPRITELAYER,
-                                BOARD_OBJECTS_PRIORITY);
+        AddPart (Parts, NumberOfParts, TIME_POSITION_X, TIME_POSITION_Y, BMP_BOARD_TIME, Minutes);
     
         // Draw the ":" symbol
-        m_pDisplay->DrawSprite (TIME_POSITION_X + TIME_DIGIT_SPACE, 
-                                TIME_POSITION_Y, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_BOARD_TIME, 
-                                SPRITE_SEMICOLON, 
-                                BOARD_SPRITELAYER,
-                                BOARD_OBJECTS_PRIORITY);
+        AddPart (Parts, NumberOfParts, TIME_POSITION_X + TIME_DIGIT_SPACE, TIME_POSITION_Y, BMP_BOARD_TIME, SPRITE_SEMICOLON);
 
         // Get each digit of the two-digit seconds number
         int Seconds10 = 0;      // Number of seconds 10 (seconds = 25 --> seconds10 = 2)
@@ -340,66 +387,23 @@ void CBoard::Display (void)
         ASSERT (Seconds1 >= 0 && Seconds1 < 10);
 
         // Draw the two characters to draw the number of seconds
-        m_pDisplay->DrawSprite (TIME_POSITION_X + TIME_DIGIT_SPACE * 2, 
-                                TIME_POSITION_Y, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_BOARD_TIME, 
-                                Seconds10, 
-                                BOARD_SPRITELAYER,
-                                BOARD_OBJECTS_PRIORITY);
-
-        m_pDisplay->DrawSprite (TIME_POSITION_X + TIME_DIGIT_SPACE * 3, 
-                                TIME_POSITION_Y, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_BOARD_TIME, 
-                                Seconds1, 
-                                BOARD_SPRITELAYER,
-                                BOARD_OBJECTS_PRIORITY);
+        AddPart (Parts, NumberOfParts, TIME_POSITION_X + TIME_DIGIT_SPACE * 2, TIME_POSITION_Y, BMP_BOARD_TIME, Seconds10);
+        AddPart (Parts, NumberOfParts, TIME_POSITION_X + TIME_DIGIT_SPACE * 3, TIME_POSITION_Y, BMP_BOARD_TIME, Seconds1);
     }
     // If there is an infinite time for the battle
     else
     {
         // Draw the first dash "-"
-        m_pDisplay->DrawSprite (TIME_POSITION_X, 
-                                TIME_POSITION_Y, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_BOARD_TIME, 
-                                SPRITE_DASH, 
-                                BOARD_SPRITELAYER,
-                                BOARD_OBJECTS_PRIORITY);
+        AddPart (Parts, NumberOfParts, TIME_POSITION_X, TIME_POSITION_Y, BMP_BOARD_TIME, SPRITE_DASH);
     
         // Draw the ":" symbol
-        m_pDisplay->DrawSprite (TIME_POSITION_X + TIME_DIGIT_SPACE, 
-                                TIME_POSITION_Y, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_BOARD_TIME, 
-                                SPRITE_SEMICOLON, 
-                                BOARD_SPRITELAYER,
-                                BOARD_OBJECTS_PRIORITY);
+        AddPart (Parts, NumberOfParts, TIME_POSITION_X + TIME_DIGIT_SPACE, TIME_POSITION_Y, BMP_BOARD_TIME, SPRITE_SEMICOLON);
 
         // Draw the second dash "-"
-        m_pDisplay->DrawSprite (TIME_POSITION_X + TIME_DIGIT_SPACE * 2, 
-                                TIME_POSITION_Y, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_BOARD_TIME, 
-                                SPRITE_DASH, 
-                                BOARD_SPRITELAYER,
-                                BOARD_OBJECTS_PRIORITY);
+        AddPart (Parts, NumberOfParts, TIME_POSITION_X + TIME_DIGIT_SPACE * 2, TIME_POSITION_Y, BMP_BOARD_TIME, SPRITE_DASH);
 
         // Draw the third dash "-"
-        m_pDisplay->DrawSprite (TIME_POSITION_X + TIME_DIGIT_SPACE * 3 + 1, // +1 for the look
-                                TIME_POSITION_Y, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_BOARD_TIME, 
-                                SPRITE_DASH, 
-                                BOARD_SPRITELAYER,
-                                BOARD_OBJECTS_PRIORITY);
+        AddPart (Parts, NumberOfParts, TIME_POSITION_X + TIME_DIGIT_SPACE * 3 + 1, TIME_POSITION_Y, BMP_BOARD_TIME, SPRITE_DASH); // +1 for the look
     }
 
     //-----------------------------------
@@ -424,24 +428,10 @@ void CBoard::Display (void)
             int DeadHeadOffset = (m_pArena->GetBomber(Player).IsDead() ? 5 : 0);
 
             // Draw the player's bomber head
-            m_pDisplay->DrawSprite (ScoreX, 
-                                    ScoreY, 
-                                    NULL,                            // Draw entire sprite
-                                    NULL,                            // No need to clip
-                                    BMP_BOARD_HEADS, 
-                                    DeadHeadOffset + Player, 
-                                    BOARD_SPRITELAYER,
-                                    BOARD_OBJECTS_PRIORITY);
+            AddPart (Parts, NumberOfParts, ScoreX, ScoreY, BMP_BOARD_HEADS, DeadHeadOffset + Player);
     
             // Draw the score
-            m_pDisplay->DrawSprite (ScoreX + HEAD_TO_SCORE_X_OFFSET, 
-                                    ScoreY + HEAD_TO_SCORE_Y_OFFSET, 
-                                    NULL,                            // Draw entire sprite
-                                    NULL,                            // No need to clip
-                                    BMP_BOARD_SCORE, 
-                                    m_pScores->GetPlayerScore(Player), 
-                                    BOARD_SPRITELAYER,
-                                    BOARD_OBJECTS_PRIORITY);
+            AddPart (Parts, NumberOfParts, ScoreX + HEAD_TO_SCORE_X_OFFSET, ScoreY + HEAD_TO_SCORE_Y_OFFSET, BMP_BOARD_SCORE, m_pScores->GetPlayerScore(Player));
          
             // Next score to draw on the right
             ScoreX += SCORE_NEXT_X_OFFSET;
@@ -449,24 +439,14 @@ void CBoard::Display (void)
     }
 
     // Display flag
-    m_pDisplay->DrawSprite (ScoreX, 
-                            ScoreY, 
-                            NULL,                            // Draw entire sprite
-                            NULL,                            // No need to clip
-                            BMP_BOARD_DRAWGAME,
-                            0, 
-                            BOARD_SPRITELAYER,
-                            BOARD_OBJECTS_PRIORITY);
+    AddPart (Parts, NumberOfParts, ScoreX, ScoreY, BMP_BOARD_DRAWGAME, 0);
     
     // Draw the number of draw games
-    m_pDisplay->DrawSprite (ScoreX + HEAD_TO_SCORE_X_OFFSET, 
-                            ScoreY + HEAD_TO_SCORE_Y_OFFSET, 
-                            NULL,                            // Draw entire sprite
-                            NULL,                            // No need to clip
-                            BMP_BOARD_SCORE, 
-                            m_pScores->GetDrawGamesCount(), 
-                            BOARD_SPRITELAYER,
-                            BOARD_OBJECTS_PRIORITY);
+    AddPart (Parts, NumberOfParts, ScoreX + HEAD_TO_SCORE_X_OFFSET, ScoreY + HEAD_TO_SCORE_Y_OFFSET, BMP_BOARD_SCORE, m_pScores->GetDrawGamesCount());
+
+    // The board is under the clock
+    if (!DrawParts (Parts, NumberOfParts, BOARD_BACKGROUND_PRIORITY))
+        m_NumberOfBoardRedraws++;
 }
 
 //******************************************************************************************************************************
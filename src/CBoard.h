@@ -34,6 +34,7 @@ class COptions;
 class CTimer;
 class CScores;
 class CArena;
+struct SSpriteRunPart;
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
@@ -56,6 +57,11 @@ private:
     int             m_ClockBottomSprite;        //!< Current clockbottom sprite to draw
     int             m_ClockTopSprite;           //!< Current clocktop sprite to draw
     bool            m_AnimateClock;             //!< Should the clock animate?
+    int             m_NumberOfDisplays;         //!< Number of times the board was displayed since its creation, for the statistics
+    int             m_NumberOfBoardRedraws;     //!< Number of times the board was not in the cache and had to be drawn again
+    int             m_NumberOfClockRedraws;     //!< Number of times the clock was not in the cache and had to be drawn again
+
+    bool            DrawParts (const SSpriteRunPart* pParts, int NumberOfParts, int PriorityInLayer); //!< Draw the parts as a cached sprite run, return false if it was not in the cache
 
 public:
 
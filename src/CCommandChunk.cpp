@@ -54,13 +54,21 @@ void CCommandChunk::Destroy (void)
 void CCommandChunk::Reset (void)
 {
     m_NumberOfSteps = 0;
+    m_Sequence = 0;
+    m_Tick = 0;
+    m_SendTime = 0;
 }
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CCommandChunk::Store (EBomberMove BomberMove, EBomberAction BomberAction, float DeltaTime)
+/**
+ *  \return false if a new step is needed but the chunk is full. Nothing is
+ *  stored then : the chunk has to be sent and reset before storing again.
+ */
+
+bool CCommandChunk::Store (EBomberMove BomberMove, EBomberAction BomberAction, float DeltaTime)
 {
     // If there is no step yet
     if (m_NumberOfSteps == 0)
@@ -79,17 +87,16 @@ void CCommandChunk::Store (EBomberMove BomberMove, EBomberAction BomberAction, f
         if (m_Steps[m_NumberOfSteps - 1].BomberMove != BomberMove ||
             m_Steps[m_NumberOfSteps - 1].BomberAction != BomberAction)
         {
-            ASSERT(m_NumberOfSteps < MAX_STEPS_IN_COMMAND_CHUNK);
+            // Don't lose this step, it will go in the next chunk
+            if (m_NumberOfSteps == MAX_STEPS_IN_COMMAND_CHUNK)
+                return false;
 
-            if (m_NumberOfSteps < MAX_STEPS_IN_COMMAND_CHUNK)
-            {            
-                // This is a new step
-                m_Steps[m_NumberOfSteps].BomberMove = BomberMove;
-                m_Steps[m_NumberOfSteps].BomberAction = BomberAction;
-                m_Steps[m_NumberOfSteps].Duration = DeltaTime;
+            // This is a new step
+            m_Steps[m_NumberOfSteps].BomberMove = BomberMove;
+            m_Steps[m_NumberOfSteps].BomberAction = BomberAction;
+            m_Steps[m_NumberOfSteps].Duration = DeltaTime;
 
-                m_NumberOfSteps++;
-            }
+            m_NumberOfSteps++;
         }
         // If the move and action did not change since latest step
         else
@@ -98,6 +105,8 @@ void CCommandChunk::Store (EBomberMove BomberMove, EBomberAction BomberAction, f
             m_Steps[m_NumberOfSteps - 1].Duration += DeltaTime;
         }
     }
+
+    return true;
 }
 
 //******************************************************************************************************************************
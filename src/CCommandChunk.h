@@ -34,7 +34,7 @@
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-#define MAX_STEPS_IN_COMMAND_CHUNK      8
+#define MAX_STEPS_IN_COMMAND_CHUNK      32
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
@@ -57,19 +57,30 @@ class CCommandChunk
 {
 private:
 
-    SCommandStep            m_Steps [MAX_STEPS_IN_COMMAND_CHUNK];
+    int                     m_Sequence;                         //!< Sequence number of the chunk, used by the server to acknowledge it
+    int                     m_Tick;                             //!< Tick of the match clock the commands were sent for
+    int                     m_SendTime;                         //!< Local time (in milliseconds) of the client when it sent the chunk, echoed by the server
     int                     m_NumberOfSteps;
+    SCommandStep            m_Steps [MAX_STEPS_IN_COMMAND_CHUNK]; //!< Must be the last member : only the used steps are sent
                                                         
 public:                                                 
 
     void                    Create (void);                      //!< 
     void                    Destroy (void);                     //!< 
     void                    Reset (void);                       //!< 
-    void                    Store (EBomberMove BomberMove, EBomberAction BomberAction, float DeltaTime);
+    bool                    Store (EBomberMove BomberMove, EBomberAction BomberAction, float DeltaTime); //!< Return false if the chunk is full and has to be sent first
     inline EBomberMove      GetStepMove (int Step);
     inline EBomberAction    GetStepAction (int Step);
     inline float            GetStepDuration (int Step);
     inline int              GetNumberOfSteps (void);
+    inline void             SetSequence (int Sequence);
+    inline int              GetSequence (void) const;
+    inline void             SetTick (int Tick);
+    inline int              GetTick (void) const;
+    inline void             SetSendTime (int SendTime);
+    inline int              GetSendTime (void) const;
+    inline int              GetSize (void) const;               //!< Number of bytes to send : the header and the used steps
+    static inline int       GetHeaderSize (void);               //!< Number of bytes before the steps
 };
 
 //******************************************************************************************************************************
@@ -102,6 +113,46 @@ inline int CCommandChunk::GetNumberOfSteps (void)
     return m_NumberOfSteps;
 }
 
+inline void CCommandChunk::SetSequence (int Sequence)
+{
+    m_Sequence = Sequence;
+}
+
+inline int CCommandChunk::GetSequence (void) const
+{
+    return m_Sequence;
+}
+
+inline void CCommandChunk::SetTick (int Tick)
+{
+    m_Tick = Tick;
+}
+
+inline int CCommandChunk::GetTick (void) const
+{
+    return m_Tick;
+}
+
+inline void CCommandChunk::SetSendTime (int SendTime)
+{
+    m_SendTime = SendTime;
+}
+
+inline int CCommandChunk::GetSendTime (void) const
+{
+    return m_SendTime;
+}
+
+inline int CCommandChunk::GetSize (void) const
+{
+    return GetHeaderSize() + m_NumberOfSteps * sizeof(SCommandStep);
+}
+
+inline int CCommandChunk::GetHeaderSize (void)
+{
+    return sizeof(CCommandChunk) - MAX_STEPS_IN_COMMAND_CHUNK * sizeof(SCommandStep);
+}
+
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
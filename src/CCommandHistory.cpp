@@ -0,0 +1,297 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CCommandHistory.cpp
+ *  \brief History of command chunks not yet acknowledged by the server
+ */
+
+#include "StdAfx.h"
+#include "CCommandHistory.h"
+#include "CArena.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CCommandHistory::CCommandHistory (void)
+{
+    m_pChunks = NULL;
+    m_MaxChunks = 0;
+    m_FirstChunk = 0;
+    m_NumberOfChunks = 0;
+    m_NextSequence = 1;
+    m_RoundTripTime = INITIAL_ROUND_TRIP_TIME;
+    m_RoundTripVariation = INITIAL_ROUND_TRIP_TIME / 2.0f;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CCommandHistory::~CCommandHistory (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CCommandHistory::Create (void)
+{
+    if (m_pChunks == NULL)
+    {
+        m_MaxChunks = INITIAL_PENDING_COMMAND_CHUNKS;
+        m_pChunks = new SPendingCommandChunk[m_MaxChunks];
+    }
+
+    m_NextSequence = 1;
+    m_RoundTripTime = INITIAL_ROUND_TRIP_TIME;
+    m_RoundTripVariation = INITIAL_ROUND_TRIP_TIME / 2.0f;
+
+    Reset();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CCommandHistory::Destroy (void)
+{
+    Reset();
+
+    delete [] m_pChunks;
+    m_pChunks = NULL;
+    m_MaxChunks = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CCommandHistory::Reset (void)
+{
+    m_FirstChunk = 0;
+    m_NumberOfChunks = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CCommandHistory::Push (CCommandChunk& CommandChunk, double Time)
+{
+    // Give the command chunk its sequence number so that the server can acknowledge it
+    CommandChunk.SetSequence(m_NextSequence++);
+
+    // If the server did not acknowledge anything for a long time, make room
+    // for this command chunk : it must be replayed and sent again until then.
+    if (m_NumberOfChunks == m_MaxChunks)
+        Grow();
+
+    m_NumberOfChunks++;
+
+    SPendingCommandChunk& PendingChunk = GetChunk(m_NumberOfChunks - 1);
+
+    PendingChunk.CommandChunk = CommandChunk;
+    PendingChunk.SendTime = Time;
+    PendingChunk.Resent = false;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CCommandHistory::Grow (void)
+{
+    int MaxChunks = m_MaxChunks * 2;
+    SPendingCommandChunk* pChunks = new SPendingCommandChunk[MaxChunks];
+
+    // Unroll the ring buffer, the oldest command chunk going first
+    for (int Chunk = 0; Chunk < m_NumberOfChunks; Chunk++)
+        pChunks[Chunk] = GetChunk(Chunk);
+
+    delete [] m_pChunks;
+
+    m_pChunks = pChunks;
+    m_MaxChunks = MaxChunks;
+    m_FirstChunk = 0;
+
+    theLog.WriteLine("Network         => %d command chunks are not acknowledged, the history can now hold %d.", m_NumberOfChunks, m_MaxChunks);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CCommandHistory::Acknowledge (int Sequence, double Time)
+{
+    // Forget every command chunk the server already applied
+    while (m_NumberOfChunks > 0 &&
+           GetChunk(0).CommandChunk.GetSequence() <= Sequence)
+    {
+        // Measure the round trip with the acknowledged chunk, unless it was
+        // sent several times : we would not know which send is acknowledged.
+        if (GetChunk(0).CommandChunk.GetSequence() == Sequence && !GetChunk(0).Resent)
+        {
+            float RoundTripTime = (float)(Time - GetChunk(0).SendTime);
+            float Variation = RoundTripTime - m_RoundTripTime;
+
+            if (Variation < 0.0f)
+                Variation = -Variation;
+
+            // Smooth the measures the way TCP does
+            m_RoundTripVariation += (Variation - m_RoundTripVariation) / 4.0f;
+            m_RoundTripTime += (RoundTripTime - m_RoundTripTime) / 8.0f;
+        }
+
+        m_FirstChunk = (m_FirstChunk + 1) % m_MaxChunks;
+        m_NumberOfChunks--;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The commands of the current frame are already stored in the latest step,
+ *  but the arena update of this frame applies them : the end of the latest
+ *  step (SkippedTime seconds) is not replayed.
+ */
+
+void CCommandHistory::Replay (CArena* pArena, int Player, CCommandChunk& UnsentChunk, float SkippedTime)
+{
+    ASSERT(pArena != NULL);
+
+    // Find the latest step, in the chunk not sent yet or else in the latest pending chunk
+    CCommandChunk* pLatestChunk = NULL;
+
+    if (UnsentChunk.GetNumberOfSteps() > 0)
+    {
+        pLatestChunk = &UnsentChunk;
+    }
+    else
+    {
+        for (int Chunk = m_NumberOfChunks - 1; Chunk >= 0 && pLatestChunk == NULL; Chunk--)
+        {
+            CCommandChunk& CommandChunk = GetChunk(Chunk).CommandChunk;
+
+            if (CommandChunk.GetNumberOfSteps() > 0)
+                pLatestChunk = &CommandChunk;
+        }
+    }
+
+    // Apply the pending command chunks from the oldest to the latest one,
+    // exactly as the server will do when it receives them, then the steps
+    // that will be sent in the next command chunk.
+    for (int Chunk = 0; Chunk <= m_NumberOfChunks; Chunk++)
+    {
+        CCommandChunk& CommandChunk = (Chunk < m_NumberOfChunks ? GetChunk(Chunk).CommandChunk : UnsentChunk);
+
+        for (int Step = 0; Step < CommandChunk.GetNumberOfSteps(); Step++)
+        {
+            // Stop if the bomber died during the replay
+            if (!pArena->GetBomber(Player).Exist() || !pArena->GetBomber(Player).IsAlive())
+                return;
+
+            float Duration = CommandChunk.GetStepDuration(Step);
+
+            if (&CommandChunk == pLatestChunk && Step == CommandChunk.GetNumberOfSteps() - 1)
+                Duration = MAX(Duration - SkippedTime, 0.0f);
+
+            pArena->GetBomber(Player).Command(CommandChunk.GetStepMove(Step), CommandChunk.GetStepAction(Step));
+            pArena->UpdateSingleBomber(Player, Duration);
+        }
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return the number of command chunks written in ppChunks
+ *
+ *  The command chunks that were not acknowledged after the round trip time
+ *  and its variation are considered lost. The oldest ones are returned, and
+ *  are considered sent again at the given time.
+ */
+
+int CCommandHistory::GetLateChunks (double Time, CCommandChunk** ppChunks, int MaxChunks)
+{
+    ASSERT(ppChunks != NULL);
+
+    float Timeout = m_RoundTripTime + 4.0f * m_RoundTripVariation;
+
+    if (Timeout < MIN_RESEND_TIMEOUT)
+        Timeout = MIN_RESEND_TIMEOUT;
+
+    int NumberOfLateChunks = 0;
+
+    for (int Chunk = 0; Chunk < m_NumberOfChunks && NumberOfLateChunks < MaxChunks; Chunk++)
+    {
+        SPendingCommandChunk& PendingChunk = GetChunk(Chunk);
+
+        // The next chunks were sent later, they are not late either
+        if (Time - PendingChunk.SendTime < Timeout)
+            break;
+
+        PendingChunk.SendTime = Time;
+        PendingChunk.Resent = true;
+
+        ppChunks[NumberOfLateChunks++] = &PendingChunk.CommandChunk;
+    }
+
+    return NumberOfLateChunks;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+float CCommandHistory::GetSendInterval (void)
+{
+    // Send a few chunks per round trip : a fast connection gets frequent
+    // small chunks, a slow one gets fewer and bigger chunks.
+    float Interval = m_RoundTripTime / COMMAND_CHUNKS_PER_ROUND_TRIP;
+
+    // If the acknowledgements fall behind, the connection or the server is
+    // saturated : send less often.
+    if (m_NumberOfChunks > 2 * COMMAND_CHUNKS_PER_ROUND_TRIP)
+        Interval *= 2.0f;
+
+    if (Interval < MIN_COMMAND_CHUNK_INTERVAL)
+        Interval = MIN_COMMAND_CHUNK_INTERVAL;
+    else if (Interval > MAX_COMMAND_CHUNK_INTERVAL)
+        Interval = MAX_COMMAND_CHUNK_INTERVAL;
+
+    return Interval;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
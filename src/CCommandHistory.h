@@ -0,0 +1,143 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CCommandHistory.h
+ *  \brief Header file of the history of command chunks not yet acknowledged by the server
+ */
+
+#ifndef __CCOMMANDHISTORY_H__
+#define __CCOMMANDHISTORY_H__
+
+#include "CCommandChunk.h"
+
+class CArena;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define INITIAL_PENDING_COMMAND_CHUNKS  64      //!< Number of command chunks the history can hold before it has to grow
+#define COMMAND_CHUNKS_PER_ROUND_TRIP   4       //!< Number of command chunks to send during a round trip
+#define MIN_COMMAND_CHUNK_INTERVAL      (1.0f / 60.0f) //!< Minimum time (in seconds) between two command chunks
+#define MAX_COMMAND_CHUNK_INTERVAL      0.100f  //!< Maximum time (in seconds) between two command chunks
+#define INITIAL_ROUND_TRIP_TIME         0.200f  //!< Round trip time (in seconds) assumed before the first measure
+#define MIN_RESEND_TIMEOUT              0.050f  //!< Minimum time (in seconds) to wait for an acknowledgement before sending a command chunk again
+#define REDUNDANT_COMMAND_CHUNKS        3       //!< Maximum number of late command chunks sent again at once
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A command chunk sent to the server and waiting for an acknowledgement
+struct SPendingCommandChunk
+{
+    CCommandChunk   CommandChunk;       //!< The command chunk as it was sent
+    double          SendTime;           //!< Time when it was sent for the last time
+    bool            Resent;             //!< Was it sent more than once?
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Keeps the command chunks the client sent but the server did not apply yet.
+
+/**
+ * The client applies its own commands immediately. When an authoritative
+ * snapshot arrives, the arena is reset to the server's state, the command
+ * chunks the server already applied are forgotten, and the remaining ones,
+ * followed by the steps stored since the latest command chunk was sent, are
+ * applied again to the client's bomber so that it does not jump back.
+ *
+ * The acknowledgements also give the round trip time, which sets how often
+ * the client sends its command chunks. A command chunk that is not
+ * acknowledged in time is sent again, when the network simulator loses
+ * frames on purpose (TCP itself loses nothing) : the server applies the
+ * chunks in sequence order and ignores the ones it already has, so no
+ * command is lost. If the server does not acknowledge anything for a
+ * long time, the history grows rather than dropping a command chunk.
+ */
+
+class CCommandHistory
+{
+private:
+
+    SPendingCommandChunk*   m_pChunks;                              //!< Ring buffer of the pending command chunks
+    int                     m_MaxChunks;                            //!< Number of command chunks the ring buffer can hold
+    int                     m_FirstChunk;                           //!< Index of the oldest pending command chunk in the ring buffer
+    int                     m_NumberOfChunks;                       //!< Number of pending command chunks
+    int                     m_NextSequence;                         //!< Sequence number to give to the next command chunk
+    float                   m_RoundTripTime;                        //!< Smoothed round trip time (in seconds)
+    float                   m_RoundTripVariation;                   //!< Smoothed variation of the round trip time (in seconds)
+
+    void                    Grow (void);                            //!< Make the ring buffer twice bigger, keeping the pending command chunks
+    inline SPendingCommandChunk& GetChunk (int Chunk);              //!< Get a pending command chunk, 0 being the oldest one
+
+public:
+
+                            CCommandHistory (void);                 //!< Constructor. Initialize some members.
+                            ~CCommandHistory (void);                //!< Destructor. Does nothing.
+    void                    Create (void);                          //!< Initialize the object
+    void                    Destroy (void);                         //!< Uninitialize the object
+    void                    Reset (void);                           //!< Forget every pending command chunk
+    void                    Push (CCommandChunk& CommandChunk, double Time); //!< Number the command chunk and remember it until it is acknowledged, growing the history if needed
+    void                    Acknowledge (int Sequence, double Time); //!< Forget the command chunks up to the given sequence number (included)
+    void                    Replay (CArena* pArena, int Player, CCommandChunk& UnsentChunk, float SkippedTime); //!< Apply the pending command chunks and the steps not sent yet again to the bomber of the player
+    int                     GetLateChunks (double Time, CCommandChunk** ppChunks, int MaxChunks); //!< Get the oldest command chunks that have to be sent again
+    float                   GetSendInterval (void);                 //!< Return the time (in seconds) to wait between two command chunks
+    inline int              GetNumberOfChunks (void);               //!< Return the number of pending command chunks
+    inline float            GetRoundTripTime (void);                //!< Return the smoothed round trip time (in seconds)
+    inline float            GetRoundTripVariation (void);           //!< Return the smoothed variation of the round trip time (in seconds)
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline int CCommandHistory::GetNumberOfChunks (void)
+{
+    return m_NumberOfChunks;
+}
+
+inline SPendingCommandChunk& CCommandHistory::GetChunk (int Chunk)
+{
+    ASSERT(Chunk >= 0 && Chunk < m_NumberOfChunks);
+
+    return m_pChunks[(m_FirstChunk + Chunk) % m_MaxChunks];
+}
+
+inline float CCommandHistory::GetRoundTripTime (void)
+{
+    return m_RoundTripTime;
+}
+
+inline float CCommandHistory::GetRoundTripVariation (void)
+{
+    return m_RoundTripVariation;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CCOMMANDHISTORY_H__
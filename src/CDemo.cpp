@@ -125,7 +125,9 @@ void CDemo::Create (void)
     CreateFont();
 
     m_AiManager.SetDisplay(m_pDisplay);
-    m_AiManager.Create(&m_Options);
+    m_AiManager.Create(&m_Options, (unsigned int)RANDOM(0x7FFF));
+
+    m_Ticks.Reset(0);
 
     for (int i = 0; i < MAX_TEAMS; i++)
     {
@@ -301,7 +303,6 @@ EGameMode CDemo::Update (void)
     else if (!m_MatchOver)
     {
         PlaySong();
-        ProcessPlayerCommands();
         ManageExit();
         UpdateMatch();
         UpdateDemoText();
@@ -312,7 +313,9 @@ EGameMode CDemo::Update (void)
     else if (m_ModeTime <= m_ExitModeTime)
     {
         m_Board.Update ();
-        m_Arena.Update (m_pTimer->GetDeltaTime());
+
+        for (int Ticks = m_Ticks.Update (m_pTimer->GetDeltaTime()); Ticks > 0; Ticks--)
+            m_Arena.Update (MATCH_TICK_DURATION);
     }
     // If the pause is over and we have to make the last black screen
     else if (m_ModeTime <= m_ExitModeTime + BLACKSCREEN_DURATION)
@@ -354,15 +357,6 @@ void CDemo::PlaySong (void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CDemo::ProcessPlayerCommands (void)
-{
-    m_AiManager.Update(m_pTimer->GetDeltaTime());
-}
-
-//******************************************************************************************************************************
-//******************************************************************************************************************************
-//******************************************************************************************************************************
-
 void CDemo::ManageExit (void)
 {
     // If the user activates the break control
@@ -413,9 +407,15 @@ void CDemo::UpdateMatch (void)
     // Update the match components
     //------------------------------------
 
-    m_Clock.Update (m_pTimer->GetDeltaTime());
+    // The computer players think on the arena as it is at each tick, then the arena steps
+    for (int Ticks = m_Ticks.Update (m_pTimer->GetDeltaTime()); Ticks > 0; Ticks--)
+    {
+        m_AiManager.Tick ();
+        m_Clock.Update (MATCH_TICK_DURATION);
+        m_Arena.Update (MATCH_TICK_DURATION);
+    }
+
     m_Board.Update ();
-    m_Arena.Update (m_pTimer->GetDeltaTime());
 }
 
 //******************************************************************************************************************************
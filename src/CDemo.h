@@ -41,6 +41,7 @@ class CHurryMessage;
 #include "CArena.h"
 #include "CClock.h"
 #include "CAiManager.h"
+#include "CMatchTicks.h"
 #include "CFont.h"
 #include "CModeScreen.h"
 #include "COptions.h"
@@ -65,6 +66,7 @@ private:
     CTeam           m_Teams[MAX_TEAMS];         //!< Teams object 
 
     CAiManager      m_AiManager;                //!< Computer brain
+    CMatchTicks     m_Ticks;                    //!< Ticks on which the arena and the computer players are simulated
     bool            m_MatchOver;                //!< Is match over? (ie. there is a result : winner or draw game)
     ESong           m_CurrentSong;              //!< Current song being played
     bool            m_IsSongPlaying;            //!< Is the match song playing?
@@ -87,7 +89,6 @@ private:
     void            DestroyMainComponents (void);
     void            PlaySong (void);
     void            StopSong (void);
-    void            ProcessPlayerCommands (void);
     void            ManageExit (void);
     void            UpdateMatch (void);
     void            UpdateDemoText (void);
@@ -45,21 +45,16 @@ private:
     CVideoSDL       m_VideoSDL;         //!< Object used for display
 
     const ::portable_stl::string& GetProgramFolder(void) const;
-    bool            LoadSprites(int SpriteTableWidth,
-                                int SpriteTableHeight,
-                                int SpriteWidth,
-                                int SpriteHeight,
-                                bool Transparent,
-                                const uint8_t* BitmapData,
-                                uint32_t BitmapSize);  //!< Load a sprite table given its bitmap data and its properties.
 
 public:
                     CDisplay(void);     //!< Initialize some members
                     ~CDisplay(void);    //!< Does nothing
     inline void     SetOptions(const COptions *pOptions);
     inline void     SetWindowHandle(HWND hWnd); //!< Set the handle of the window DirectDraw/SDLVideo has to work with
+    inline void     SetFrameExporter(CFrameExporter* pFrameExporter); //!< Export the frames to a video file instead of presenting them (NULL to present them)
+    inline CVideoSDL& GetVideoSDL(void); //!< Get the display interface, to draw offscreen and measure the rendering
     bool            Create();           //!< (Re)Create the DirectDraw/SDLVideo interface and (re)load the sprite tables given the display mode
-    void            Destroy (void);     //!< Destroy the DirectDraw/SDLVideo interface and the sprite tables
+    void            Destroy (void);     //!< Destroy the DirectDraw/SDLVideo interface, the sprite tables and their surfaces
     inline void     OnWindowMove (void);//!< Has to be called when the window moves (WM_MOVE)
     inline void     OnPaint(void);      //!< Has to be called when the window has to be repainted (WM_PAINT)
     inline void     Clear(void);        //!< Make the window's client area black
@@ -73,6 +68,22 @@ public:
                                int Sprite,
                                int SpriteLayer,
                                int PriorityInLayer); //!< Record a drawing request that will be executed on next call to Update
+    inline void     DrawStaticSprite(int PositionX,
+                                     int PositionY,
+                                     const void* SpriteTable,
+                                     int Sprite,
+                                     int SpriteLayer,
+                                     int PriorityInLayer); //!< Record a sprite that rarely changes and is below the sprites overlapping it, drawn through the cached static layer
+    inline bool     DrawSpriteRun(int PositionX,
+                                  int PositionY,
+                                  const void* pKey,
+                                  int KeySize,
+                                  int SpriteLayer,
+                                  int PriorityInLayer); //!< Record a drawing request for the cached sprite run of the key, return false if it has to be created first
+    inline bool     CreateSpriteRun(const void* pKey,
+                                    int KeySize,
+                                    const SSpriteRunPart* pParts,
+                                    int NumberOfParts); //!< Draw sprites that are always drawn together in a sprite run cached with the key
     inline void     DrawDebugRectangle(int PositionX,
                                        int PositionY,
                                        int w,
@@ -100,6 +111,16 @@ inline void CDisplay::SetWindowHandle(HWND hWnd)
     m_VideoSDL.SetWindowHandle(hWnd);
 }
 
+inline void CDisplay::SetFrameExporter(CFrameExporter* pFrameExporter)
+{
+    m_VideoSDL.SetFrameExporter(pFrameExporter);
+}
+
+inline CVideoSDL& CDisplay::GetVideoSDL(void)
+{
+    return m_VideoSDL;
+}
+
 inline void CDisplay::SetOrigin(int OriginX, int OriginY)
 {
     m_VideoSDL.SetOrigin(OriginX, OriginY);
@@ -122,7 +143,7 @@ inline void CDisplay::OnWindowMove(void)
 
 inline void CDisplay::OnPaint(void)
 {
-    m_VideoSDL.UpdateScreen ();
+    m_VideoSDL.OnPaint ();
 }
 
 inline void CDisplay::DrawSprite(int PositionX,
@@ -137,6 +158,31 @@ inline void CDisplay::DrawSprite(int PositionX,
     m_VideoSDL.DrawSprite(PositionX, PositionY, pZone, pClip, SpriteTable, Sprite, SpriteLayer, PriorityInLayer);
 }
 
+inline void CDisplay::DrawStaticSprite(int PositionX,
+                                       int PositionY,
+                                       const void* SpriteTable,
+                                       int Sprite,
+                                       int SpriteLayer,
+                                       int PriorityInLayer)
+{
+    m_VideoSDL.DrawStaticSprite(PositionX, PositionY, SpriteTable, Sprite, SpriteLayer, PriorityInLayer);
+}
+
+inline bool CDisplay::DrawSpriteRun(int PositionX,
+                                    int PositionY,
+                                    const void* pKey,
+                                    int KeySize,
+                                    int SpriteLayer,
+                                    int PriorityInLayer)
+{
+    return m_VideoSDL.DrawSpriteRun(PositionX, PositionY, pKey, KeySize, SpriteLayer, PriorityInLayer);
+}
+
+inline bool CDisplay::CreateSpriteRun(const void* pKey, int KeySize, const SSpriteRunPart* pParts, int NumberOfParts)
+{
+    return m_VideoSDL.CreateSpriteRun(pKey, KeySize, pParts, NumberOfParts);
+}
+
 inline void CDisplay::DrawDebugRectangle(int PositionX, int PositionY, int w, int h, BYTE r, BYTE g, BYTE b, int SpriteLayer, int PriorityInLayer)
 {
     m_VideoSDL.DrawDebugRectangle (PositionX, PositionY, w, h, r, g, b, SpriteLayer, PriorityInLayer);
@@ -155,14 +155,13 @@ void CFloor::Display (void)
         }
 
         // Add the sprite in the layer. Priority is not used.
-        m_pDisplay->DrawSprite (m_iX, 
-                                m_iY, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_ARENA_FLOOR,
-                                Sprite, 
-                                FLOOR_SPRITELAYER,
-                                PRIORITY_UNUSED);
+        // The floor is below everything, it is drawn in the static layer.
+        m_pDisplay->DrawStaticSprite (m_iX, 
+                                      m_iY, 
+                                      BMP_ARENA_FLOOR,
+                                      Sprite, 
+                                      FLOOR_SPRITELAYER,
+                                      PRIORITY_UNUSED);
 
         Sprite = -1;
 
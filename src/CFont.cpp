@@ -39,6 +39,7 @@
 //******************************************************************************************************************************
 
 #define MAX_STRING_LENGTH               2048    //!< Maximum length for a string to draw
+#define MAX_RUN_LENGTH                  64      //!< Maximum length for a string drawn as a cached sprite run, longer ones are drawn character by character
 #define CHAR_COUNT_PER_FONTCOLOR        46      //!< Number of characters per font color in the font sprite table
 #define CHAR_PIXEL_WIDTH                10      //!< Size (in pixels) of one character
 #define CHAR_PIXEL_HEIGHT               10
@@ -69,6 +70,20 @@
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+//! Key of the sprite run of a string : the string and everything that changes how it looks
+struct SFontRunKey
+{
+    int             TextColorOffset;        //!< Sprite offset of the text color
+    int             ShadowColorOffset;      //!< Sprite offset of the shadow color, -1 if there is no shadow
+    int             ShadowOffsetX;          //!< Position of the shadow from the text
+    int             ShadowOffsetY;
+    char            String [MAX_RUN_LENGTH]; //!< Characters of the string, without the terminating null character
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 CFont::CFont (void)
 {
     // Initialize the pointers to NULL so that we 
@@ -81,6 +96,7 @@ CFont::CFont (void)
     m_ShadowColorOffset = 0;
     m_ShadowOffsetX = 0;
     m_ShadowOffsetY = 0;
+    m_Volatile = false;
 
 }
 
@@ -112,6 +128,9 @@ void CFont::Create (void)
     // By default don't draw any text shadow
     m_DrawShadow = false;
 
+    // By default the strings are cached as sprite runs
+    m_Volatile = false;
+
     // Set default shadow direction
     SetShadowDirection (SHADOWDIRECTION_UP);
 }
@@ -129,55 +148,131 @@ void CFont::Destroy (void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+int CFont::GetCharacterOffset (char Character)
+{
+    // If the character to draw is a lower case letter
+    if (Character >= 'a' && Character <= 'z')
+    {
+        return LETTERS_CHAR_OFFSET_BEGIN + Character - 'a';
+    }
+    // If the character to draw is an upper case letter
+    else if (Character >= 'A' && Character <= 'Z')
+    {
+        return LETTERS_CHAR_OFFSET_BEGIN + Character - 'A';
+    }
+    // If the character to draw is a number
+    else if (Character >= '0' && Character <= '9')
+    {
+        return NUMBERS_CHAR_OFFSET_BEGIN + Character - '0';
+    }
+
+    // Else it's a special character or a character the font doesn't have
+    switch (Character)
+    {
+        case '.' : return SPECIAL_CHAR_OFFSET_BEGIN + PERIOD_CHAR_OFFSET;
+        case ',' : return SPECIAL_CHAR_OFFSET_BEGIN + COMMA_CHAR_OFFSET;
+        case '!' : return SPECIAL_CHAR_OFFSET_BEGIN + EXCLAMATION_CHAR_OFFSET;
+        case '?' : return SPECIAL_CHAR_OFFSET_BEGIN + INTERROGATIVE_CHAR_OFFSET;
+        case '(' : return SPECIAL_CHAR_OFFSET_BEGIN + LEFTPARENTHESIS_CHAR_OFFSET;
+        case ')' : return SPECIAL_CHAR_OFFSET_BEGIN + RIGHTPARENTHESIS_CHAR_OFFSET;
+        case '-' : return SPECIAL_CHAR_OFFSET_BEGIN + MINUS_CHAR_OFFSET;
+        case '+' : return SPECIAL_CHAR_OFFSET_BEGIN + PLUS_CHAR_OFFSET;
+        case '@' : return SPECIAL_CHAR_OFFSET_BEGIN + AT_CHAR_OFFSET;
+        case ':' : return SPECIAL_CHAR_OFFSET_BEGIN + COLON_CHAR_OFFSET;
+    }
+
+    // The character is unsupported by the font, it won't be drawn
+    return -1;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The string is drawn with a cached sprite run : the characters and
+ *  their shadow are drawn once in a surface, which is then drawn with a
+ *  single drawing request as long as the string and the way it looks
+ *  don't change. The shadow of the run is drawn under its characters,
+ *  as when each character is drawn on its own. A volatile font draws
+ *  each character on its own, so that text such as counters and times
+ *  doesn't fill the cache with runs drawn once.
+ */
+
 void CFont::DrawString (int PositionX, int PositionY, const char *pString)
 {
-    int CharacterOffset;        // Character offset to use to get the character sprite to
-                                // draw (not taking font color into account)
-    
-    // While this not the end of string
-    while (*pString != '\0')
+    int Length = strlen(pString);
+
+    // Strings too long for a run, or that would only be drawn a few times
+    // before they change, are drawn character by character
+    if (Length > MAX_RUN_LENGTH || m_Volatile)
     {
-        // If the current character to draw is a lower case letter
-        if (*pString >= 'a' && *pString <= 'z')
-        {
-            // Set the offset of the character to draw (not taking font color into account)
-            CharacterOffset = LETTERS_CHAR_OFFSET_BEGIN + *pString - 'a';
-        }
-        // If the current character to draw is an upper case letter
-        else if (*pString >= 'A' && *pString <= 'Z')
-        {
-            // Set the offset of the character to draw (not taking font color into account)
-            CharacterOffset = LETTERS_CHAR_OFFSET_BEGIN + *pString - 'A';
-        }
-        // If the current character to draw is a number
-        else if (*pString >= '0' && *pString <= '9')
-        {
-            // Set the offset of the character to draw (not taking font color into account)
-            CharacterOffset = NUMBERS_CHAR_OFFSET_BEGIN + *pString - '0';
-        }
-        // Else it's a special character or a character the font doesn't have
-        else
+        DrawCharacters (PositionX, PositionY, pString);
+        return;
+    }
+
+    // The run is identified by the string and everything that changes how it looks
+    SFontRunKey Key;
+    Key.TextColorOffset = m_TextColorOffset;
+    Key.ShadowColorOffset = (m_DrawShadow ? m_ShadowColorOffset : -1);
+    Key.ShadowOffsetX = (m_DrawShadow ? m_ShadowOffsetX : 0);
+    Key.ShadowOffsetY = (m_DrawShadow ? m_ShadowOffsetY : 0);
+    memcpy (Key.String, pString, Length);
+
+    int KeySize = sizeof(Key) - sizeof(Key.String) + Length;
+
+    // If the string was already drawn this way, there is nothing else to do
+    if (m_pDisplay->DrawSpriteRun (PositionX, PositionY, &Key, KeySize, m_SpriteLayer, TEXT_PRIORITY))
+        return;
+
+    // Parse the string once to make the parts of the run
+    SSpriteRunPart Parts [2 * MAX_RUN_LENGTH];
+    int NumberOfParts = 0;
+
+    for (int Pass = (m_DrawShadow ? 0 : 1); Pass < 2; Pass++)
+    {
+        // The shadows are the first parts, so that the characters are drawn over them
+        bool Shadow = (Pass == 0);
+
+        for (int Character = 0; Character < Length; Character++)
         {
-            // Identify the character and set the offset of the character 
-            // to draw (not taking font color into account)
-            switch (*pString)
+            int CharacterOffset = GetCharacterOffset (pString[Character]);
+
+            if (CharacterOffset != -1)
             {
-                case '.' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + PERIOD_CHAR_OFFSET;           break;
-                case ',' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + COMMA_CHAR_OFFSET;            break;
-                case '!' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + EXCLAMATION_CHAR_OFFSET;      break;
-                case '?' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + INTERROGATIVE_CHAR_OFFSET;    break;
-                case '(' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + LEFTPARENTHESIS_CHAR_OFFSET;  break;
-                case ')' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + RIGHTPARENTHESIS_CHAR_OFFSET; break;
-                case '-' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + MINUS_CHAR_OFFSET;            break;
-                case '+' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + PLUS_CHAR_OFFSET;             break;
-                case '@' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + AT_CHAR_OFFSET;               break;
-                case ':' : CharacterOffset = SPECIAL_CHAR_OFFSET_BEGIN + COLON_CHAR_OFFSET;            break;
-
-                // Is it a character that is unsupported by the font?
-                // In that case we won't draw any character.
-                default  : CharacterOffset = -1; break;          // Remember the character is unsupported
+                SSpriteRunPart& Part = Parts[NumberOfParts++];
+
+                Part.SpriteTable = BMP_GLOBAL_FONT;
+                Part.Sprite = (Shadow ? m_ShadowColorOffset : m_TextColorOffset) + CharacterOffset;
+                Part.PositionX = Character * (CHAR_PIXEL_WIDTH + CHAR_PIXEL_SPACE) + (Shadow ? m_ShadowOffsetX : 0);
+                Part.PositionY = (Shadow ? m_ShadowOffsetY : 0);
             }
         }
+    }
+
+    // If none of the characters is drawn
+    if (NumberOfParts == 0)
+        return;
+
+    // If the run could not be made, draw the characters one by one
+    if (!m_pDisplay->CreateSpriteRun (&Key, KeySize, Parts, NumberOfParts) ||
+        !m_pDisplay->DrawSpriteRun (PositionX, PositionY, &Key, KeySize, m_SpriteLayer, TEXT_PRIORITY))
+    {
+        DrawCharacters (PositionX, PositionY, pString);
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CFont::DrawCharacters (int PositionX, int PositionY, const char *pString)
+{
+    // While this not the end of string
+    while (*pString != '\0')
+    {
+        // Offset of the character sprite to draw (not taking font color into account)
+        int CharacterOffset = GetCharacterOffset (*pString);
 
         // If the character to draw is supported
         if (CharacterOffset != -1)
@@ -75,8 +75,11 @@ private:
     bool            m_DrawShadow;           //!< Do we have to draw a shadow under the string we draw?
     int             m_ShadowOffsetX;        //!< Offset to apply to text position in order to get shadow position
     int             m_ShadowOffsetY;
+    bool            m_Volatile;             //!< Does the text change almost every frame? It is then not cached as sprite runs.
 
-    void            DrawString (int PositionX, int PositionY, const char *pString);
+    void            DrawString (int PositionX, int PositionY, const char *pString);     //!< Draw the string as a cached sprite run
+    void            DrawCharacters (int PositionX, int PositionY, const char *pString); //!< Draw each character of the string on its own
+    int             GetCharacterOffset (char Character);    //!< Return the offset of the sprite of the character (not taking font color into account), -1 if the font doesn't have it
     int             GetColorOffset (EFontColor FontColor);
 
 public:
@@ -91,6 +94,7 @@ public:
     inline void     SetShadowColor (EFontColor FontColor);
     void            SetShadowDirection (EShadowDirection ShadowDirection);
     inline void     SetSpriteLayer (int SpriteLayer);
+    inline void     SetVolatile (bool Volatile);    //!< Draw the strings character by character, for text that changes almost every frame
     void            Draw (int PositionX, int PositionY, const char *pString, ...);
     void            DrawCenteredX (int BorderLeft, int BorderRight, int PositionY, const char *pString, ...);
     void            DrawCenteredY (int PositionX, int BorderUp, int BorderDown, const char *pString, ...);
@@ -111,6 +115,11 @@ inline void CFont::SetSpriteLayer (int SpriteLayer)
     m_SpriteLayer = SpriteLayer;
 }
 
+inline void CFont::SetVolatile (bool Volatile)
+{
+    m_Volatile = Volatile;
+}
+
 inline void CFont::SetShadow (bool DrawShadow)
 {
     m_DrawShadow = DrawShadow;
@@ -0,0 +1,384 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+
+/**
+ *  \file CFrameExporter.cpp
+ *  \brief Frame exporter writing the display to a video file
+ */
+
+#include "StdAfx.h"
+#include "CFrameExporter.h"
+
+#include <string.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+struct SFrameExportState
+{
+    std::thread             Thread;                     //!< Writer thread
+    std::mutex              Mutex;                      //!< Protects the number of waiting buffers and the quit flag
+    std::condition_variable FrameQueued;                //!< Signaled when a buffer waits to be written, or when the thread has to quit
+    std::condition_variable BufferFreed;                //!< Signaled when a buffer was written
+    int                     FirstFreeBuffer;            //!< Next buffer to copy a frame into (only used by the thread giving the frames)
+    int                     FirstWaitingBuffer;         //!< Next buffer to write (only used by the writer thread)
+    int                     NumberOfWaitingBuffers;     //!< Number of buffers waiting to be written
+    bool                    Quit;                       //!< Does the writer thread have to quit once the waiting buffers are written?
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CFrameExporter::CFrameExporter (void)
+{
+    m_pState = NULL;
+    m_FileName[0] = '\0';
+    m_Rate = FRAMEEXPORT_DEFAULT_RATE;
+    m_Format = FRAMEEXPORT_RGBA;
+    m_pFile = NULL;
+    m_Width = 0;
+    m_Height = 0;
+    m_RedShift = 0;
+    m_GreenShift = 0;
+    m_BlueShift = 0;
+    m_pBuffers = NULL;
+    m_pOutput = NULL;
+    m_OutputSize = 0;
+    m_WriteTime = 0.0;
+    m_WriteFailed = false;
+    m_NumberOfFrames = 0;
+    m_NumberOfWrittenFrames = 0;
+    m_NumberOfStalls = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CFrameExporter::~CFrameExporter (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  --export <file>             Write the frames to this file instead of presenting them (.y4m for YUV4MPEG2, raw RGBA otherwise)
+ *  --export-fps <rate>         Number of frames per second of the video
+ */
+
+#ifdef WIN32
+void CFrameExporter::ParseCommandLine (const char* pCommandLine)
+{
+    const char* pOption;
+
+    // The space tells --export from --export-fps
+    if ((pOption = strstr(pCommandLine, "--export ")) != NULL)
+    {
+        if (sscanf(pOption + strlen("--export "), "%259s", m_FileName) != 1)
+            m_FileName[0] = '\0';
+    }
+
+    if ((pOption = strstr(pCommandLine, "--export-fps")) != NULL)
+        sscanf(pOption + strlen("--export-fps"), "%f", &m_Rate);
+#else
+void CFrameExporter::ParseCommandLine (char** pCommandLine, int pCommandLineCount)
+{
+    for (int i = 1; i + 1 < pCommandLineCount; i++)
+    {
+        if (strcmp(pCommandLine[i], "--export") == 0)
+        {
+            strncpy(m_FileName, pCommandLine[++i], FRAMEEXPORT_NAME_SIZE - 1);
+            m_FileName[FRAMEEXPORT_NAME_SIZE - 1] = '\0';
+        }
+        else if (strcmp(pCommandLine[i], "--export-fps") == 0)
+        {
+            m_Rate = (float)atof(pCommandLine[++i]);
+        }
+    }
+#endif
+
+    if (m_Rate <= 0.0f)
+        m_Rate = FRAMEEXPORT_DEFAULT_RATE;
+
+    // The extension of the file name gives its format
+    size_t Length = strlen(m_FileName);
+
+    m_Format = (Length >= 4 && strcmp(m_FileName + Length - 4, ".y4m") == 0 ? FRAMEEXPORT_Y4M : FRAMEEXPORT_RGBA);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CFrameExporter::Create (const SDL_Surface* pSurface)
+{
+    ASSERT (m_pState == NULL);
+    ASSERT (pSurface != NULL);
+    ASSERT (IsEnabled());
+
+    // The frames are copied and converted one 32 bits pixel after the other
+    if (pSurface->format->BytesPerPixel != 4)
+    {
+        theLog.WriteLine("FrameExporter   => !!! Only 32 bits displays can be exported.");
+        return false;
+    }
+
+    m_pFile = fopen(m_FileName, "wb");
+
+    if (m_pFile == NULL)
+    {
+        theLog.WriteLine("FrameExporter   => !!! Could not open the video file %s.", m_FileName);
+        return false;
+    }
+
+    m_Width = pSurface->w;
+    m_Height = pSurface->h;
+    m_RedShift = pSurface->format->Rshift;
+    m_GreenShift = pSurface->format->Gshift;
+    m_BlueShift = pSurface->format->Bshift;
+    m_WriteTime = 0.0;
+    m_WriteFailed = false;
+    m_NumberOfFrames = 0;
+    m_NumberOfWrittenFrames = 0;
+    m_NumberOfStalls = 0;
+
+    if (m_Format == FRAMEEXPORT_Y4M)
+    {
+        // The rate is given as a fraction, in thousandths of frames per second
+        fprintf(m_pFile, "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 C444\n", m_Width, m_Height, (int)(m_Rate * 1000.0f + 0.5f));
+
+        m_OutputSize = 3 * m_Width * m_Height;
+    }
+    else
+    {
+        m_OutputSize = 4 * m_Width * m_Height;
+    }
+
+    m_pBuffers = new Uint32 [FRAMEEXPORT_BUFFERS * m_Width * m_Height];
+    m_pOutput = new Uint8 [m_OutputSize];
+
+    m_pState = new SFrameExportState;
+    m_pState->FirstFreeBuffer = 0;
+    m_pState->FirstWaitingBuffer = 0;
+    m_pState->NumberOfWaitingBuffers = 0;
+    m_pState->Quit = false;
+    m_pState->Thread = std::thread(&CFrameExporter::WriterThread, this);
+
+    theLog.WriteLine("FrameExporter   => Writing %dx%d frames at %.2f frames per second to %s (%s).",
+        m_Width, m_Height, m_Rate, m_FileName, (m_Format == FRAMEEXPORT_Y4M ? "YUV4MPEG2" : "raw RGBA"));
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CFrameExporter::Destroy (void)
+{
+    if (m_pState == NULL)
+        return;
+
+    // Let the writer thread write the waiting frames, then quit
+    {
+        std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+        m_pState->Quit = true;
+    }
+
+    m_pState->FrameQueued.notify_one();
+    m_pState->Thread.join();
+
+    delete m_pState;
+    m_pState = NULL;
+
+    fclose(m_pFile);
+    m_pFile = NULL;
+
+    delete [] m_pBuffers;
+    delete [] m_pOutput;
+    m_pBuffers = NULL;
+    m_pOutput = NULL;
+
+    if (m_NumberOfWrittenFrames > 0)
+    {
+        theLog.WriteLine("FrameExporter   => %d frame(s) written (%.1f seconds of video) in %.3f ms each on average, %d frame(s) waited for a free buffer.",
+            m_NumberOfWrittenFrames, m_NumberOfWrittenFrames / m_Rate, m_WriteTime * 1000.0 / m_NumberOfWrittenFrames, m_NumberOfStalls);
+    }
+
+    if (m_NumberOfWrittenFrames < m_NumberOfFrames)
+        theLog.WriteLine("FrameExporter   => !!! %d frame(s) could not be written.", m_NumberOfFrames - m_NumberOfWrittenFrames);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The buffers are used in turn : the frame is copied into the next free
+ *  buffer, which the writer thread writes after the buffers already waiting.
+ *  The buffer being filled is not used by the writer thread, so the copy
+ *  does not need the lock.
+ */
+
+void CFrameExporter::WriteFrame (const SDL_Surface* pSurface)
+{
+    ASSERT (m_pState != NULL);
+    ASSERT (pSurface->w == m_Width && pSurface->h == m_Height);
+
+    m_NumberOfFrames++;
+
+    {
+        std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+
+        if (m_pState->NumberOfWaitingBuffers == FRAMEEXPORT_BUFFERS)
+        {
+            m_NumberOfStalls++;
+
+            while (m_pState->NumberOfWaitingBuffers == FRAMEEXPORT_BUFFERS)
+                m_pState->BufferFreed.wait(Lock);
+        }
+    }
+
+    Uint32* pBuffer = m_pBuffers + m_pState->FirstFreeBuffer * m_Width * m_Height;
+
+    for (int Y = 0; Y < m_Height; Y++)
+        memcpy(pBuffer + Y * m_Width, (const Uint8*)pSurface->pixels + Y * pSurface->pitch, m_Width * 4);
+
+    m_pState->FirstFreeBuffer = (m_pState->FirstFreeBuffer + 1) % FRAMEEXPORT_BUFFERS;
+
+    {
+        std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+        m_pState->NumberOfWaitingBuffers++;
+    }
+
+    m_pState->FrameQueued.notify_one();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CFrameExporter::WriterThread (void)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+
+            while (m_pState->NumberOfWaitingBuffers == 0 && !m_pState->Quit)
+                m_pState->FrameQueued.wait(Lock);
+
+            // Quit only once every frame is written
+            if (m_pState->NumberOfWaitingBuffers == 0)
+                break;
+        }
+
+        WriteBuffer(m_pBuffers + m_pState->FirstWaitingBuffer * m_Width * m_Height);
+
+        m_pState->FirstWaitingBuffer = (m_pState->FirstWaitingBuffer + 1) % FRAMEEXPORT_BUFFERS;
+
+        {
+            std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+            m_pState->NumberOfWaitingBuffers--;
+        }
+
+        m_pState->BufferFreed.notify_one();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The YUV4MPEG2 planes use the BT.601 coefficients in the video range
+ *  (16 to 235 for Y, 16 to 240 for Cb and Cr), with integer arithmetic.
+ */
+
+void CFrameExporter::WriteBuffer (const Uint32* pBuffer)
+{
+    if (m_WriteFailed)
+        return;
+
+    double StartTime = m_Timer.GetElapsedTime();
+
+    int NumberOfPixels = m_Width * m_Height;
+
+    if (m_Format == FRAMEEXPORT_Y4M)
+    {
+        Uint8* pY = m_pOutput;
+        Uint8* pCb = pY + NumberOfPixels;
+        Uint8* pCr = pCb + NumberOfPixels;
+
+        for (int Pixel = 0; Pixel < NumberOfPixels; Pixel++)
+        {
+            int Red = (pBuffer[Pixel] >> m_RedShift) & 0xFF;
+            int Green = (pBuffer[Pixel] >> m_GreenShift) & 0xFF;
+            int Blue = (pBuffer[Pixel] >> m_BlueShift) & 0xFF;
+
+            pY[Pixel] = (Uint8)(((66 * Red + 129 * Green + 25 * Blue + 128) >> 8) + 16);
+            pCb[Pixel] = (Uint8)(((-38 * Red - 74 * Green + 112 * Blue + 128) >> 8) + 128);
+            pCr[Pixel] = (Uint8)(((112 * Red - 94 * Green - 18 * Blue + 128) >> 8) + 128);
+        }
+
+        fputs("FRAME\n", m_pFile);
+    }
+    else
+    {
+        Uint8* pOutput = m_pOutput;
+
+        for (int Pixel = 0; Pixel < NumberOfPixels; Pixel++)
+        {
+            *pOutput++ = (Uint8)(pBuffer[Pixel] >> m_RedShift);
+            *pOutput++ = (Uint8)(pBuffer[Pixel] >> m_GreenShift);
+            *pOutput++ = (Uint8)(pBuffer[Pixel] >> m_BlueShift);
+            *pOutput++ = 0xFF;
+        }
+    }
+
+    if (fwrite(m_pOutput, m_OutputSize, 1, m_pFile) != 1)
+    {
+        theLog.WriteLine("FrameExporter   => !!! Could not write to the video file %s.", m_FileName);
+        m_WriteFailed = true;
+        return;
+    }
+
+    m_WriteTime += m_Timer.GetElapsedTime() - StartTime;
+    m_NumberOfWrittenFrames++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
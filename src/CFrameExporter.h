@@ -0,0 +1,141 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+
+/**
+ *  \file CFrameExporter.h
+ *  \brief Header file of the frame exporter writing the display to a video file
+ */
+
+#ifndef __CFRAMEEXPORTER_H__
+#define __CFRAMEEXPORTER_H__
+
+#include "SDL/SDL.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define FRAMEEXPORT_DEFAULT_RATE    60.0f   //!< Number of frames per second of the video when none is asked for
+#define FRAMEEXPORT_BUFFERS         8       //!< Number of frame buffers waiting to be written, so that a slow disk does not stall the game
+#define FRAMEEXPORT_NAME_SIZE       260     //!< Maximum size of the name of the video file
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Formats the frames can be written in
+enum EFrameExportFormat
+{
+    FRAMEEXPORT_RGBA,                       //!< Raw frames, 4 bytes (red, green, blue, alpha) per pixel
+    FRAMEEXPORT_Y4M                         //!< YUV4MPEG2 stream, full resolution Y, Cb and Cr planes (4:4:4)
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+// The standard thread classes are only used in CFrameExporter.cpp, because
+// the standard headers conflict with the portable STL ones included before.
+struct SFrameExportState;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Writes the frames of the display to a video file instead of presenting them.
+
+/**
+ * The video has a fixed frame rate : the game timer has to advance by
+ * the duration of a video frame each frame (see CTimer::SetFixedDeltaTime),
+ * so that the video does not depend on how long the frames took to run.
+ *
+ * WriteFrame() copies the frame into one of FRAMEEXPORT_BUFFERS buffers
+ * used in turn, and a writer thread converts the waiting buffers and writes
+ * them to the file. The caller only waits when every buffer waits to be
+ * written, when the disk is slower than the game for a long time.
+ * A name ending with .y4m gives a YUV4MPEG2 stream, any other name raw
+ * RGBA frames (their size and rate are written to the log).
+ */
+
+class CFrameExporter
+{
+private:
+
+    SFrameExportState*  m_pState;                       //!< Writer thread and what it shares with the thread giving the frames
+    char                m_FileName [FRAMEEXPORT_NAME_SIZE]; //!< Name of the video file, empty if the frames are not exported
+    float               m_Rate;                         //!< Number of frames per second of the video
+    EFrameExportFormat  m_Format;                       //!< Format of the video file
+    FILE*               m_pFile;                        //!< Video file (only used by the writer thread once created)
+    int                 m_Width;                        //!< Size of the frames in pixels
+    int                 m_Height;
+    int                 m_RedShift;                     //!< Position of the components in the pixels of the frames
+    int                 m_GreenShift;
+    int                 m_BlueShift;
+    Uint32*             m_pBuffers;                     //!< Frame buffers, one after the other
+    Uint8*              m_pOutput;                      //!< Converted frame to write (only used by the writer thread)
+    int                 m_OutputSize;                   //!< Size of a converted frame in bytes
+    CTimer              m_Timer;                        //!< Timer measuring the writing (only used by the writer thread)
+    double              m_WriteTime;                    //!< Time (in seconds) spent converting and writing the frames
+    bool                m_WriteFailed;                  //!< Did writing to the file fail? The next frames are not written.
+    int                 m_NumberOfFrames;               //!< Number of frames given to the exporter
+    int                 m_NumberOfWrittenFrames;        //!< Number of frames written to the file
+    int                 m_NumberOfStalls;               //!< Number of times a frame waited for a free buffer
+
+    void                WriterThread (void);            //!< Main function of the writer thread
+    void                WriteBuffer (const Uint32* pBuffer); //!< Convert a frame buffer and write it to the file
+
+public:
+
+                        CFrameExporter (void);          //!< Constructor. Initialize some members.
+                        ~CFrameExporter (void);         //!< Destructor. Does nothing.
+#ifdef WIN32
+    void                ParseCommandLine (const char* pCommandLine); //!< Read the video file name and frame rate
+#else
+    void                ParseCommandLine (char** pCommandLine, int pCommandLineCount); //!< Read the video file name and frame rate
+#endif
+    bool                Create (const SDL_Surface* pSurface); //!< Open the video file for frames of this surface's size and format and start the writer thread
+    void                Destroy (void);                 //!< Write the waiting frames, close the video file and log what was written
+    void                WriteFrame (const SDL_Surface* pSurface); //!< Copy the frame and let the writer thread write it
+    inline bool         IsEnabled (void);               //!< Were the frames asked to be exported?
+    inline float        GetRate (void);                 //!< Number of frames per second of the video
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline bool CFrameExporter::IsEnabled (void)
+{
+    return m_FileName[0] != '\0';
+}
+
+inline float CFrameExporter::GetRate (void)
+{
+    return m_Rate;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CFRAMEEXPORTER_H__
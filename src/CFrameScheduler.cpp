@@ -0,0 +1,268 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CFrameScheduler.cpp
+ *  \brief Frame scheduler
+ */
+
+#include "StdAfx.h"
+#include "CFrameScheduler.h"
+#include "SDL/SDL.h"
+
+#include <math.h>
+#include <string.h>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CFrameScheduler::CFrameScheduler (void)
+{
+    m_TargetRate = FRAMESCHEDULER_DEFAULT_RATE;
+    m_FrameDuration = 0.0;
+    m_SpinTime = FRAMESCHEDULER_SPIN_TIME;
+    m_StartTime = 0.0;
+    m_NextFrameTime = 0.0;
+    m_FrameTime = -1.0;
+    m_PeriodStartTime = 0.0;
+    m_PeriodFrames = 0;
+    m_PeriodLateFrames = 0;
+    m_PeriodFrameTime = 0.0;
+    m_PeriodSquaredFrameTime = 0.0;
+    m_PeriodWorstFrameTime = 0.0;
+    m_NumberOfFrames = 0;
+    m_LateFrames = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CFrameScheduler::~CFrameScheduler (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  --fps <rate>                Number of frames per second to run at, 0 for no limit
+ *  --uncapped                  Run the frames as fast as possible (same as --fps 0)
+ */
+
+#ifdef WIN32
+void CFrameScheduler::ParseCommandLine (const char* pCommandLine)
+{
+    const char* pOption;
+
+    if ((pOption = strstr(pCommandLine, "--fps")) != NULL)
+        sscanf(pOption + strlen("--fps"), "%f", &m_TargetRate);
+
+    if (strstr(pCommandLine, "--uncapped") != NULL)
+        m_TargetRate = 0.0f;
+#else
+void CFrameScheduler::ParseCommandLine (char** pCommandLine, int pCommandLineCount)
+{
+    for (int i = 1; i < pCommandLineCount; i++)
+    {
+        if (strcmp(pCommandLine[i], "--fps") == 0 && i + 1 < pCommandLineCount)
+            m_TargetRate = (float)atof(pCommandLine[++i]);
+        else if (strcmp(pCommandLine[i], "--uncapped") == 0)
+            m_TargetRate = 0.0f;
+    }
+#endif
+
+    m_TargetRate = MAX(m_TargetRate, 0.0f);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CFrameScheduler::Create (void)
+{
+    m_FrameDuration = (m_TargetRate > 0.0f ? 1.0 / m_TargetRate : 0.0);
+    m_SpinTime = FRAMESCHEDULER_SPIN_TIME;
+    m_StartTime = m_Timer.GetElapsedTime();
+    m_NextFrameTime = m_StartTime + m_FrameDuration;
+    m_FrameTime = -1.0;
+    m_PeriodStartTime = m_StartTime;
+    m_PeriodFrames = 0;
+    m_PeriodLateFrames = 0;
+    m_PeriodFrameTime = 0.0;
+    m_PeriodSquaredFrameTime = 0.0;
+    m_PeriodWorstFrameTime = 0.0;
+    m_NumberOfFrames = 0;
+    m_LateFrames = 0;
+
+    if (m_FrameDuration > 0.0)
+        theLog.WriteLine("FrameScheduler  => Running at %.1f frames per second.", m_TargetRate);
+    else
+        theLog.WriteLine("FrameScheduler  => Running as fast as possible.");
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CFrameScheduler::Destroy (void)
+{
+    double Duration = m_Timer.GetElapsedTime() - m_StartTime;
+
+    if (Duration > 0.0 && m_NumberOfFrames > 0)
+    {
+        theLog.WriteLine("FrameScheduler  => %d frame(s) at %.1f frames per second on average, %d late, %.1f ms spinning margin.",
+            m_NumberOfFrames, m_NumberOfFrames / Duration, m_LateFrames, m_SpinTime * 1000.0);
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Sleeping gives the processor back but may last longer than asked for,
+ *  so the end of the wait is spent spinning on the timer. Each oversleep
+ *  makes the spinning margin longer, up to a whole frame, and it slowly
+ *  shrinks back while the sleeps are accurate.
+ *
+ *  The sleep is an SDL12_Delay, which is where the web build (asyncify)
+ *  gives the control back to the browser to draw the canvas and deliver
+ *  the input. There, a frame that has no time to sleep still delays 0 ms,
+ *  otherwise the page would hang when uncapped or late.
+ */
+
+void CFrameScheduler::Wait (double Time)
+{
+    double SleepStartTime = m_Timer.GetElapsedTime();
+    int SleepTime = (int)((Time - SleepStartTime - m_SpinTime) * 1000.0);
+
+    if (SleepTime > 0)
+    {
+        SDL12_Delay(SleepTime);
+
+        double Oversleep = m_Timer.GetElapsedTime() - SleepStartTime - SleepTime / 1000.0;
+
+        if (Oversleep > m_SpinTime)
+            m_SpinTime = MIN(Oversleep, m_FrameDuration);
+        else
+            m_SpinTime = MAX(m_SpinTime * 0.99, FRAMESCHEDULER_SPIN_TIME);
+    }
+#ifdef __EMSCRIPTEN__
+    else
+    {
+        SDL12_Delay(0);
+    }
+#endif
+
+    while (m_Timer.GetElapsedTime() < Time)
+    {
+        // Spin
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CFrameScheduler::EndFrame (void)
+{
+    // With no limit, or if the game is late, the next frame starts at once
+    double StartTime = m_Timer.GetElapsedTime();
+
+    if (m_FrameDuration > 0.0)
+    {
+        if (StartTime < m_NextFrameTime)
+        {
+            StartTime = m_NextFrameTime;
+        }
+        else if (StartTime - m_NextFrameTime > m_FrameDuration)
+        {
+            // If the game is too late, don't try to catch up
+            m_NextFrameTime = StartTime;
+        }
+
+        m_NextFrameTime += m_FrameDuration;
+    }
+
+    Wait(StartTime);
+
+    double Time = m_Timer.GetElapsedTime();
+
+    // Measure the frame that ends
+    if (m_FrameTime >= 0.0)
+    {
+        double FrameTime = Time - m_FrameTime;
+
+        m_PeriodFrames++;
+        m_PeriodFrameTime += FrameTime;
+        m_PeriodSquaredFrameTime += FrameTime * FrameTime;
+        m_PeriodWorstFrameTime = MAX(m_PeriodWorstFrameTime, FrameTime);
+        m_NumberOfFrames++;
+
+        // A frame is late when it lasted half a frame longer than asked for
+        if (m_FrameDuration > 0.0 && FrameTime > 1.5 * m_FrameDuration)
+        {
+            m_PeriodLateFrames++;
+            m_LateFrames++;
+        }
+    }
+
+    m_FrameTime = Time;
+
+    if (Time - m_PeriodStartTime >= FRAMESCHEDULER_STATISTICS_PERIOD)
+        WriteStatistics(Time);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CFrameScheduler::WriteStatistics (double Time)
+{
+    if (m_PeriodFrames > 0)
+    {
+        double Average = m_PeriodFrameTime / m_PeriodFrames;
+        double Variance = m_PeriodSquaredFrameTime / m_PeriodFrames - Average * Average;
+
+        theLog.WriteLine("FrameScheduler  => %.1f frames per second, frame time %.2f ms on average, %.2f ms deviation, %.2f ms worst, %d late.",
+            m_PeriodFrames / (Time - m_PeriodStartTime), Average * 1000.0, sqrt(MAX(Variance, 0.0)) * 1000.0,
+            m_PeriodWorstFrameTime * 1000.0, m_PeriodLateFrames);
+    }
+
+    m_PeriodStartTime = Time;
+    m_PeriodFrames = 0;
+    m_PeriodLateFrames = 0;
+    m_PeriodFrameTime = 0.0;
+    m_PeriodSquaredFrameTime = 0.0;
+    m_PeriodWorstFrameTime = 0.0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,108 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CFrameScheduler.h
+ *  \brief Header file of the frame scheduler
+ */
+
+#ifndef __CFRAMESCHEDULER_H__
+#define __CFRAMESCHEDULER_H__
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define FRAMESCHEDULER_DEFAULT_RATE         60.0f   //!< Number of frames per second when none is asked for
+#define FRAMESCHEDULER_SPIN_TIME            0.002   //!< Minimum time (in seconds) spent spinning before the end of a frame instead of sleeping
+#define FRAMESCHEDULER_STATISTICS_PERIOD    10.0    //!< Time (in seconds) between two logs of the frame times
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Paces the frames of the game at a target rate and measures how regular they are.
+
+/**
+ * At the end of each frame, the scheduler sleeps until shortly before the
+ * time the next frame has to start, then spins on the timer until that time.
+ * The spinning margin grows to the longest oversleep seen, so that a coarse
+ * system sleep does not make the frames late. With no target rate the
+ * frames follow each other at once, to measure how fast the game can run.
+ * The frame times (average, standard deviation, worst) and the number of
+ * late frames are written to the log periodically. Every frame goes
+ * through SDL12_Delay at least once in the web build, even with no
+ * target rate, so that the browser keeps running.
+ */
+
+class CFrameScheduler
+{
+private:
+
+    CTimer          m_Timer;                        //!< Timer giving the time the frames start at
+    float           m_TargetRate;                   //!< Number of frames per second to run at, 0 for no limit
+    double          m_FrameDuration;                //!< Time (in seconds) between the starts of two frames, 0 for no limit
+    double          m_SpinTime;                     //!< Time (in seconds) spent spinning before the start of a frame
+    double          m_StartTime;                    //!< Time when the scheduler was created
+    double          m_NextFrameTime;                //!< Time when the next frame has to start
+    double          m_FrameTime;                    //!< Time when the current frame started, negative if none started yet
+    double          m_PeriodStartTime;              //!< Time when the current statistics period started
+    int             m_PeriodFrames;                 //!< Number of frames during the current period
+    int             m_PeriodLateFrames;             //!< Number of frames that started late during the current period
+    double          m_PeriodFrameTime;              //!< Total duration (in seconds) of the frames of the current period
+    double          m_PeriodSquaredFrameTime;       //!< Total squared duration of the frames of the current period
+    double          m_PeriodWorstFrameTime;         //!< Longest frame (in seconds) of the current period
+    int             m_NumberOfFrames;               //!< Number of frames since the creation
+    int             m_LateFrames;                   //!< Number of frames that started late since the creation
+
+    void            Wait (double Time);             //!< Sleep then spin until the given time
+    void            WriteStatistics (double Time);  //!< Log the frame times of the current period and start a new one
+
+public:
+
+                    CFrameScheduler (void);         //!< Constructor. Initialize some members.
+                    ~CFrameScheduler (void);        //!< Destructor. Does nothing.
+#ifdef WIN32
+    void            ParseCommandLine (const char* pCommandLine); //!< Read the target frame rate
+#else
+    void            ParseCommandLine (char** pCommandLine, int pCommandLineCount); //!< Read the target frame rate
+#endif
+    void            Create (void);                  //!< Start pacing the frames
+    void            Destroy (void);                 //!< Log the frame times measured since the creation
+    void            EndFrame (void);                //!< Wait until the next frame has to start and measure the frame that ends
+    inline float    GetTargetRate (void);           //!< Number of frames per second to run at, 0 for no limit
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline float CFrameScheduler::GetTargetRate (void)
+{
+    return m_TargetRate;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CFRAMESCHEDULER_H__
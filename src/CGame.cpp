@@ -91,6 +91,7 @@ CGame::CGame (HINSTANCE hInstance, char** pCommandLine)
 {
     m_GameMode = GAMEMODE_NONE;
     m_hModule = NULL;
+    m_FirstFrameDrawn = false;
 #ifdef WIN32
     m_hInstance = hInstance;
 #else
@@ -526,6 +527,21 @@ bool CGame::Create (char **pCommandLine, int pCommandLineCount)
     m_Display.SetWindowHandle(m_hWnd);
 #endif // WIN32
 
+    // Read whether the frames are exported to a video file instead of presented
+#ifdef WIN32
+    m_FrameExporter.ParseCommandLine(pCommandLine);
+#else
+    m_FrameExporter.ParseCommandLine(pCommandLine, pCommandLineCount);
+#endif
+
+    if (m_FrameExporter.IsEnabled())
+    {
+        m_Display.SetFrameExporter(&m_FrameExporter);
+
+        // The game advances by one video frame each frame, however long the frame took
+        m_Timer.SetFixedDeltaTime(1.0f / m_FrameExporter.GetRate());
+    }
+
 #ifdef SDL
     SDL12_WM_SetCaption(m_WindowTitle.c_str(), NULL);
 #elif ALLEGRO
@@ -653,6 +669,15 @@ bool CGame::Create (char **pCommandLine, int pCommandLineCount)
 
     m_MenuYesNo.Create();
 
+    // Read the frame rate to run at and start pacing the frames
+#ifdef WIN32
+    m_FrameScheduler.ParseCommandLine(pCommandLine);
+#else
+    m_FrameScheduler.ParseCommandLine(pCommandLine, pCommandLineCount);
+#endif
+
+    m_FrameScheduler.Create();
+
 #ifdef NETWORK_MODE
     char IpAddressString[32];
     const char *pos;
@@ -676,6 +701,14 @@ bool CGame::Create (char **pCommandLine, int pCommandLineCount)
         }
     }
 
+    pos = strstr(pCommandLine, "--spectate");
+    if (pos != NULL)
+    {
+        strcpy(IpAddressString, pos + 11);
+        OutputDebugString("*** STARTING GAME AS SPECTATOR\n");
+        m_Network.SetNetworkMode(NETWORKMODE_SPECTATOR);
+    }
+
     pos = strstr(pCommandLine, "--host");
     if (pos != NULL)
     {
@@ -710,12 +743,28 @@ bool CGame::Create (char **pCommandLine, int pCommandLineCount)
             printf("*** STARTING GAME AS CLIENT\n");
             m_Network.SetNetworkMode(NETWORKMODE_CLIENT);
 
+            strcpy(IpAddressString, pCommandLine[i+1]);
+            break;
+        }
+        else if (strcmp(pCommandLine[i], "--spectate") == 0 &&
+            pCommandLineCount > i + 1)
+        {
+            printf("*** STARTING GAME AS SPECTATOR\n");
+            m_Network.SetNetworkMode(NETWORKMODE_SPECTATOR);
+
             strcpy(IpAddressString, pCommandLine[i+1]);
             break;
         }
     }
 #endif
 
+    // Read the bad network conditions to simulate, if any
+#ifdef WIN32
+    m_Network.GetSimulator().ParseCommandLine(pCommandLine);
+#else
+    m_Network.GetSimulator().ParseCommandLine(pCommandLine, pCommandLineCount);
+#endif
+
     if (m_Network.NetworkMode() != NETWORKMODE_LOCAL)
     {
         if (!m_Network.Connect(IpAddressString, 1234))
@@ -778,6 +827,8 @@ void CGame::Destroy(void)
     m_Input.Destroy();
     m_Display.Destroy();
 
+    m_FrameScheduler.Destroy();
+
     m_Options.SaveBeforeExit();
     m_Options.Destroy();
     m_MenuYesNo.Destroy();
@@ -897,6 +948,13 @@ void CGame::OnWindowActive(void)
     //! Display everything (CDisplay::Update())
     m_Display.Update();
 
+    //! Log how long the game took to start, the timer started with the game object
+    if (!m_FirstFrameDrawn)
+    {
+        theLog.WriteLine("Game            => First frame drawn %.1f ms after the start.", m_Timer.GetElapsedTime() * 1000.0);
+        m_FirstFrameDrawn = true;
+    }
+
     //! If the next game mode is different from the current game mode
     if (NextGameMode != m_GameMode)
     {
@@ -904,6 +962,9 @@ void CGame::OnWindowActive(void)
         FinishGameMode();                      //!< @see FinishGameMode()
         StartGameMode(NextGameMode);           //!< @see StartGameMode()
     }
+
+    //! Wait until the next frame has to start
+    m_FrameScheduler.EndFrame();
 }
 
 //******************************************************************************************************************************
@@ -1078,6 +1139,14 @@ void CGame::OnKeyUp(WPARAM wParam, LPARAM lParam)
             FinishGameMode();
             StartGameMode(GAMEMODE_EXIT);
         }
+
+#ifdef NETWORK_MODE
+        //! Show or hide the network statistics with Ctrl + F11
+        if (wParam == VK_F11)
+        {
+            m_Network.GetStatistics().SetOverlayVisible(!m_Network.GetStatistics().IsOverlayVisible());
+        }
+#endif
     }
 }
 
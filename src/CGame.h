@@ -32,6 +32,8 @@
 
 #include "CWindow.h"
 #include "CTimer.h"
+#include "CFrameScheduler.h"
+#include "CFrameExporter.h"
 #include "COptions.h"
 #include "CDisplay.h"
 #include "CInput.h"
@@ -74,7 +76,10 @@ private:
     EGameMode       m_GameMode;             //!< Current game mode defining what to update
     HMODULE         m_hModule;              //!< Connection to the resources
     HINSTANCE       m_hInstance;            //!< Application instance handle
+    bool            m_FirstFrameDrawn;      //!< Was the first frame drawn? (to measure how long the game takes to start)
     CTimer          m_Timer;                //!< Timer object for movement, animation, synchronization...
+    CFrameScheduler m_FrameScheduler;       //!< Paces the frames at the target rate
+    CFrameExporter  m_FrameExporter;        //!< Writes the frames to a video file instead of presenting them, if asked for
     CDisplay        m_Display;              //!< Needed to draw sprites and manage display
     CInput          m_Input;                //!< Needed to read the players choices in menus, match, etc
     CSound          m_Sound;                //!< Needed to play sounds and musics
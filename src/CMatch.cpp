@@ -41,26 +41,58 @@
 #include "CGame.h"
 #include "CPauseMessage.h"
 #include "CHurryMessage.h"
+#include "CMatchRules.h"
 
 #include "CCommandChunk.h"
+#include "CCommandHistory.h"
 #include "CArenaSnapshot.h"
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-#define BLACKSCREEN_DURATION    0.750f  //!< Duration (in seconds) of each of the two black screens
-#define PAUSE_BEGIN             1.0f    //!< Duration (in seconds) of the pause at the beginning of a match
-#define PAUSE_DRAWGAME          2.5f    //!< Duration (in seconds) of the pause at match end when there is a draw game
-#define PAUSE_WINNER            2.5f    //!< Duration (in seconds) of the pause at match end when there is a winner
+#define NETWORKSTATISTICS_SPRITELAYER   800     //!< Sprite layer where to draw the network statistics
+#define NETWORKSTATISTICS_POSITION_X    4       //!< Position of the network statistics on the screen
+#define NETWORKSTATISTICS_POSITION_Y    4
+#define NETWORKSTATISTICS_LINE_HEIGHT   12      //!< Space (in pixels) between two lines of the network statistics
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
 CCommandChunk CommandChunk;
+CCommandHistory CommandHistory;
 float TimeElapsedSinceLastCommandChunk = 0.0f;
 CArenaSnapshot Snapshot;
+int HostAcknowledgedSequence = 0;
+int HostLatestChunkSendTime = -1;
+double HostLatestChunkReceiveTime = 0.0;
+
+#ifdef NETWORK_MODE
+
+//! Number the current command chunk, send it to the server and start a new one
+static void SendCommandChunk (CNetwork* pNetwork, double Time)
+{
+    // Tell the server which tick the commands are meant for, and when we
+    // sent them so that it echoes this time to measure the match clock.
+    CommandChunk.SetTick(pNetwork->GetClock().GetTick(Time));
+    CommandChunk.SetSendTime((int)(Time * 1000.0));
+
+    CommandHistory.Push(CommandChunk, Time);
+
+    pNetwork->SendCommandChunk(CommandChunk);
+
+    // Command chunk was sent, reset it.
+    CommandChunk.Reset();
+
+    TimeElapsedSinceLastCommandChunk = 0.0f;
+}
+
+#endif
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
 
 CMatch::CMatch(void) : CModeScreen()
 {
@@ -70,14 +102,15 @@ CMatch::CMatch(void) : CModeScreen()
 
     m_AiManager.SetArena(&m_Arena);
 
+    m_Rules.SetArena(&m_Arena);
+    m_Rules.SetClock(&m_Clock);
+
     m_pPauseMessage = NULL;
     m_pHurryMessage = NULL;
     
     m_MatchOver = false;
-    m_WinnerTeam = NO_WINNER_TEAM;
 
     m_IsSongPlaying = false;
-    m_NoticedTimeUp = false;
     m_ModeTime = 0.0f;
     m_HaveToExit = false;
     m_ForceDrawGame = false;    
@@ -115,10 +148,8 @@ void CMatch::Create(void)
 
     // No match result for the moment
     m_MatchOver = false;
-    m_WinnerTeam = NO_WINNER_TEAM;
 
     m_IsSongPlaying = false;
-    m_NoticedTimeUp = false;
 
     // Reset mode time (no time has been elapsed in this mode yet)
     m_ModeTime = 0.0f;
@@ -140,6 +171,23 @@ void CMatch::Create(void)
         m_pOptions->SetBomberType(4, BOMBERTYPE_OFF);
         m_pOptions->SetBattleCount(3);
 
+        // Start the match without any command chunk in flight
+        CommandChunk.Reset();
+        CommandHistory.Create();
+        TimeElapsedSinceLastCommandChunk = 0.0f;
+        HostAcknowledgedSequence = 0;
+        HostLatestChunkSendTime = -1;
+
+        m_NetworkFont.Create();
+        m_NetworkFont.SetShadow(true);
+        m_NetworkFont.SetShadowColor(FONTCOLOR_BLACK);
+        m_NetworkFont.SetShadowDirection(SHADOWDIRECTION_DOWNRIGHT);
+        m_NetworkFont.SetSpriteLayer(NETWORKSTATISTICS_SPRITELAYER);
+        m_NetworkFont.SetTextColor(FONTCOLOR_WHITE);
+
+        // The statistics change every frame
+        m_NetworkFont.SetVolatile(true);
+
         if (m_pNetwork->NetworkMode() == NETWORKMODE_SERVER)
         {
             m_pOptions->SetBomberType(0, BOMBERTYPE_MAN);
@@ -153,17 +201,68 @@ void CMatch::Create(void)
 
             m_pNetwork->Send(SOCKET_CLIENT, (const char*)&TickCount, sizeof(DWORD));
 
-            SEED_RANDOM(TickCount);
+            // Tell the client which bomber it plays and how many bombers play
+            int ClientPlayer = 1;
+            int NumberOfPlayers = 2;
+
+            m_pNetwork->Send(SOCKET_CLIENT, (const char*)&ClientPlayer, sizeof(int));
+            m_pNetwork->Send(SOCKET_CLIENT, (const char*)&NumberOfPlayers, sizeof(int));
+
+            // The match clock starts now
+            m_pNetwork->GetClock().SetEpoch(m_pTimer->GetElapsedTime());
+
+            // Draw the same random numbers as the client, whatever its platform
+            m_Random.Seed(TickCount);
+            CRandom::SetCurrent(&m_Random);
         }
-        else if (m_pNetwork->NetworkMode() == NETWORKMODE_CLIENT)
+        else if (m_pNetwork->NetworkMode() == NETWORKMODE_CLIENT ||
+                 m_pNetwork->NetworkMode() == NETWORKMODE_SPECTATOR)
         {
-            m_pOptions->SetBomberType(0, BOMBERTYPE_NET);
-            m_pOptions->SetBomberType(1, BOMBERTYPE_MAN);
-
             DWORD TickCount;
 
             m_pNetwork->Receive(SOCKET_SERVER, (char*)&TickCount, sizeof(DWORD));
 
+            // The server (a player or the dedicated server) tells 
+            // which bomber we play and how many bombers play
+            int ClientPlayer = 1;
+            int NumberOfPlayers = 2;
+
+            m_pNetwork->Receive(SOCKET_SERVER, (char*)&ClientPlayer, sizeof(int));
+            m_pNetwork->Receive(SOCKET_SERVER, (char*)&NumberOfPlayers, sizeof(int));
+
+            // The match clock started when the server sent this. Until the
+            // snapshots tell us how long it took to arrive, guess it was instant.
+            m_pNetwork->GetClock().SetEpoch(m_pTimer->GetElapsedTime());
+
+            // Draw the same random numbers as the server : the dedicated server
+            // creates and updates each match with a generator seeded the same way
+            m_Random.Seed(TickCount);
+            CRandom::SetCurrent(&m_Random);
+
+            // A spectator has no bomber : every bomber is played through the network
+            if (m_pNetwork->NetworkMode() == NETWORKMODE_SPECTATOR)
+            {
+                ClientPlayer = -1;
+            }
+            else
+            {
+                if (ClientPlayer < 0 || ClientPlayer >= MAX_PLAYERS)
+                    ClientPlayer = 1;
+
+                // Our bomber is controlled with the input of the second player
+                m_pOptions->SetPlayerInput(ClientPlayer, m_pOptions->GetPlayerInput(1));
+            }
+
+            for (int Player = 0; Player < MAX_PLAYERS; Player++)
+            {
+                if (Player == ClientPlayer)
+                    m_pOptions->SetBomberType(Player, BOMBERTYPE_MAN);
+                else if (Player < NumberOfPlayers)
+                    m_pOptions->SetBomberType(Player, BOMBERTYPE_NET);
+                else
+                    m_pOptions->SetBomberType(Player, BOMBERTYPE_OFF);
+            }
+
         }
     }
 #endif
@@ -180,41 +279,18 @@ void CMatch::Create(void)
 
     if (m_computerPlayersPresent) {
         m_AiManager.SetDisplay(m_pDisplay);
-        m_AiManager.Create(m_pOptions);
-    }
 
-    for (int i = 0; i < MAX_TEAMS; i++)
-    {
-        m_Teams[i].SetTeamId(i);
-        m_Teams[i].SetVictorious(false);
+        // The random numbers are seeded the same way on every computer of a
+        // network match, so the computer players get the same seed everywhere
+        m_AiManager.Create(m_pOptions, (unsigned int)RANDOM(0x7FFF));
     }
 
-#ifdef NETWORK_MODE
+    // Put the bombers in their teams, the same way the dedicated server does
+    m_Rules.Create();
 
-    // Each bomber is its own team
-    for (int i = 0; i < MAX_BOMBERS; i++) {
-        m_Arena.GetBomber(i).SetTeam(&m_Teams[i]);
-    }
-
-#else
-    if (m_pOptions->GetBattleMode() == BATTLEMODE_TEAM)
-    {
-        // Set in selected team
-        for (int i = 0; i < MAX_BOMBERS; i++) {
-            if (m_pOptions->GetBomberTeam(i) == BOMBERTEAM_A)
-                m_Arena.GetBomber(i).SetTeam(&m_Teams[0]);
-            else if (m_pOptions->GetBomberTeam(i) == BOMBERTEAM_B)
-                m_Arena.GetBomber(i).SetTeam(&m_Teams[1]);
-        }
-    }
-    else
-    {
-        // Each bomber is its own team
-        for (int i = 0; i < MAX_BOMBERS; i++) {
-            m_Arena.GetBomber(i).SetTeam(&m_Teams[i]);
-        }
-    }
-#endif
+    // The match is simulated from the end of the first pause. In a network match
+    // these are the ticks of the match clock, which started when the server sent the seed.
+    m_Ticks.Reset((int)((MATCH_BLACKSCREEN_DURATION + MATCH_PAUSE_BEGIN) * NETWORK_TICKS_PER_SECOND));
 
 }
 
@@ -253,6 +329,18 @@ void CMatch::Destroy(void)
     DestroyPauseMessage();
     DestroyMainComponents();
     StopSong();
+
+#ifdef NETWORK_MODE
+    m_NetworkFont.Destroy();
+
+    if (m_pNetwork->NetworkMode() != NETWORKMODE_LOCAL)
+    {
+        // The other screens draw from rand() again
+        CRandom::SetCurrent(NULL);
+
+        CommandHistory.Destroy();
+    }
+#endif
 }
 
 //******************************************************************************************************************************
@@ -398,11 +486,6 @@ void CMatch::ProcessPlayerCommands(void)
     // If the match is not paused
     if (m_pPauseMessage == NULL)
     {
-        // Do the AI stuff only when there are AI players
-        if (m_computerPlayersPresent) {
-            m_AiManager.Update(m_pTimer->GetDeltaTime());
-        }
-
         // Scan the players
         for (int Player = 0; Player < MAX_PLAYERS; Player++)
         {
@@ -469,7 +552,13 @@ void CMatch::ProcessPlayerCommands(void)
 #ifdef NETWORK_MODE
                     if (m_pNetwork->NetworkMode() == NETWORKMODE_CLIENT)
                     {
-                        CommandChunk.Store(BomberMove, BomberAction, m_pTimer->GetDeltaTime());
+                        // If the command chunk is full, send it now rather than losing this command.
+                        // The history grows if the server did not acknowledge anything for a long time.
+                        if (!CommandChunk.Store(BomberMove, BomberAction, m_pTimer->GetDeltaTime()))
+                        {
+                            SendCommandChunk(m_pNetwork, m_pTimer->GetElapsedTime());
+                            CommandChunk.Store(BomberMove, BomberAction, m_pTimer->GetDeltaTime());
+                        }
                     }
 #endif
 
@@ -485,62 +574,188 @@ void CMatch::ProcessPlayerCommands(void)
         }
 
 #ifdef NETWORK_MODE
-        TimeElapsedSinceLastCommandChunk += m_pTimer->GetDeltaTime();
-        if (TimeElapsedSinceLastCommandChunk >= 0.050f)
+        CNetworkStatistics& Statistics = m_pNetwork->GetStatistics();
+
+        Statistics.Update(m_pTimer->GetElapsedTime());
+
+        // Send the frames the network simulator held back long enough
+        m_pNetwork->Update();
+
+        // A spectator sends nothing and follows the snapshots of the dedicated server
+        if (m_pNetwork->NetworkMode() == NETWORKMODE_SPECTATOR)
+        {
+            bool SnapshotReceived = false;
+
+            while (m_pNetwork->IsDataReady(SOCKET_SERVER))
+            {
+                if (m_pNetwork->ReceiveSnapshot(Snapshot))
+                    SnapshotReceived = true;
+                else
+                    break;
+            }
+
+            if (SnapshotReceived)
+            {
+                double DecodeStartTime = m_pTimer->GetElapsedTime();
+
+                m_Arena.ReadSnapshot(Snapshot);
+
+                Statistics.AddDecodeTime((float)(m_pTimer->GetElapsedTime() - DecodeStartTime) * 1000.0f);
+            }
+        }
+        else if (m_pNetwork->NetworkMode() == NETWORKMODE_SERVER)
         {
+            bool CommandChunkApplied = false;
+            double Time = m_pTimer->GetElapsedTime();
+            int Tick = m_pNetwork->GetClock().GetTick(Time);
 
-            if (m_pNetwork->NetworkMode() == NETWORKMODE_SERVER)
+            // Apply every command chunk that already arrived, without waiting for the client
+            while (m_pNetwork->IsDataReady(SOCKET_CLIENT) && m_pNetwork->ReceiveCommandChunk(CommandChunk))
             {
+                // Echo the send time of the latest command chunk in the next snapshot
+                HostLatestChunkSendTime = CommandChunk.GetSendTime();
+                HostLatestChunkReceiveTime = Time;
 
-                if (m_pNetwork->ReceiveCommandChunk(CommandChunk))
+                // Apply the command chunks in sequence order : ignore the ones sent again
+                // that we already applied, and wait for a missing one to be sent again.
+                if (CommandChunk.GetSequence() <= HostAcknowledgedSequence)
+                {
+                    Statistics.AddDuplicateFrame();
+                    continue;
+                }
+                else if (CommandChunk.GetSequence() != HostAcknowledgedSequence + 1)
                 {
+                    Statistics.AddDroppedFrame();
+                    continue;
+                }
+
+                // The commands are still applied, but they come too late to be fair
+                if (CNetworkClock::IsLate(CommandChunk.GetTick(), Tick))
+                    Statistics.AddLateFrame();
 
-                    // Scan all the players
-                    for (int Player = 0; Player < MAX_PLAYERS; Player++)
+                // Scan all the players
+                for (int Player = 0; Player < MAX_PLAYERS; Player++)
+                {
+                    // If this is the client's bomber
+                    if (m_pOptions->GetBomberType(Player) == BOMBERTYPE_NET)
                     {
-                        // If this is the client's bomber
-                        if (m_pOptions->GetBomberType(Player) == BOMBERTYPE_NET)
+                        // If the client's bomber is alive
+                        if (m_Arena.GetBomber(Player).IsAlive())
                         {
-                            // If the client's bomber is alive
-                            if (m_Arena.GetBomber(Player).IsAlive())
+                            // Apply the command chunk to the bomber
+                            for (int Step = 0; Step < CommandChunk.GetNumberOfSteps(); Step++)
                             {
-                                // Apply the command chunk to the bomber
-                                for (int Step = 0; Step < CommandChunk.GetNumberOfSteps(); Step++)
-                                {
-                                    m_Arena.GetBomber(Player).Command(CommandChunk.GetStepMove(Step), CommandChunk.GetStepAction(Step));
-                                    m_Arena.UpdateSingleBomber(Player, CommandChunk.GetStepDuration(Step));
-                                }
-
-                                break;
+                                m_Arena.GetBomber(Player).Command(CommandChunk.GetStepMove(Step), CommandChunk.GetStepAction(Step));
+                                m_Arena.UpdateSingleBomber(Player, CommandChunk.GetStepDuration(Step));
                             }
+
+                            break;
                         }
                     }
+                }
 
-                    // Make a snapshot of the arena and send it to the client
-                    m_Arena.WriteSnapshot(Snapshot);
+                HostAcknowledgedSequence = CommandChunk.GetSequence();
+                CommandChunkApplied = true;
+            }
+
+            if (CommandChunkApplied)
+            {
+                double EncodeStartTime = m_pTimer->GetElapsedTime();
 
-                    // Send snapshot to the client
-                    m_pNetwork->SendSnapshot(Snapshot);
+                // Make a snapshot of the arena and send it to the client
+                m_Arena.WriteSnapshot(Snapshot);
 
-                }
+                Statistics.AddEncodeTime((float)(m_pTimer->GetElapsedTime() - EncodeStartTime) * 1000.0f);
 
+                // Tell the client which of its command chunks is included in this snapshot
+                Snapshot.SetAcknowledgedSequence(HostAcknowledgedSequence);
+
+                // Give the client what it needs to measure the match clock
+                double SendTime = m_pTimer->GetElapsedTime();
+
+                Snapshot.SetClock((int)(m_pNetwork->GetClock().GetMatchTime(SendTime) * 1000.0),
+                                  HostLatestChunkSendTime,
+                                  (int)((SendTime - HostLatestChunkReceiveTime) * 1000.0));
+
+                // Send snapshot to the client
+                m_pNetwork->SendSnapshot(Snapshot);
             }
-            else if (m_pNetwork->NetworkMode() == NETWORKMODE_CLIENT)
+        }
+        else if (m_pNetwork->NetworkMode() == NETWORKMODE_CLIENT)
+        {
+            double Time = m_pTimer->GetElapsedTime();
+
+            // The send rate follows the round trip time measured with the acknowledgements
+            TimeElapsedSinceLastCommandChunk += m_pTimer->GetDeltaTime();
+
+            if (TimeElapsedSinceLastCommandChunk >= CommandHistory.GetSendInterval())
+                SendCommandChunk(m_pNetwork, Time);
+
+            // Send again the command chunks the server did not acknowledge in time. The
+            // connection is TCP : a chunk is only ever late, not lost, unless the network
+            // simulator loses it on purpose. Sending it again would only add traffic.
+            CCommandChunk* pLateChunks[REDUNDANT_COMMAND_CHUNKS];
+            int NumberOfLateChunks = 0;
+
+            if (m_pNetwork->GetSimulator().LosesFrames())
+                NumberOfLateChunks = CommandHistory.GetLateChunks(Time, pLateChunks, REDUNDANT_COMMAND_CHUNKS);
+
+            for (int Chunk = 0; Chunk < NumberOfLateChunks; Chunk++)
             {
+                // The server echoes the time of the copy it received
+                pLateChunks[Chunk]->SetSendTime((int)(Time * 1000.0));
 
-                // Send client command chunk to the server
-                m_pNetwork->SendCommandChunk(CommandChunk);
+                m_pNetwork->SendCommandChunk(*pLateChunks[Chunk]);
+            }
 
-                // Command chunk was sent, reset it.
-                CommandChunk.Reset();
+            // Don't wait for the server : our own bomber was already
+            // moved by the commands we sent. Only read the snapshots
+            // that already arrived, keeping the latest one.
+            bool SnapshotReceived = false;
 
-                // If successfull apply it
+            while (m_pNetwork->IsDataReady(SOCKET_SERVER))
+            {
                 if (m_pNetwork->ReceiveSnapshot(Snapshot))
-                    m_Arena.ReadSnapshot(Snapshot);
-
+                    SnapshotReceived = true;
+                else
+                    break;
             }
 
-            TimeElapsedSinceLastCommandChunk = 0.0f;
+            // If successfull apply it
+            if (SnapshotReceived)
+            {
+                // Go back to the authoritative state of the arena
+                m_Arena.ReadSnapshot(Snapshot);
+
+                Statistics.AddDecodeTime((float)(m_pTimer->GetElapsedTime() - Time) * 1000.0f);
+
+                // Forget the command chunks the server has already applied
+                CommandHistory.Acknowledge(Snapshot.GetAcknowledgedSequence(), Time);
+
+                Statistics.SetRoundTripTime(CommandHistory.GetRoundTripTime(), CommandHistory.GetRoundTripVariation());
+
+                // If the server echoed one of our command chunks, take this round trip into account for the match clock
+                if (Snapshot.GetEchoedSendTime() >= 0)
+                {
+                    double ServerSendTime = Snapshot.GetMatchTime() / 1000.0;
+
+                    m_pNetwork->GetClock().AddSample(Snapshot.GetEchoedSendTime() / 1000.0,
+                                                     ServerSendTime - Snapshot.GetHoldTime() / 1000.0,
+                                                     ServerSendTime,
+                                                     Time);
+
+                    Statistics.SetClock((float)m_pNetwork->GetClock().GetOffset(), (float)m_pNetwork->GetClock().GetDrift());
+                }
+
+                // Apply again the command chunks the server has not applied yet, and the
+                // commands not sent yet, so that our bomber does not jump back to an older
+                // position. The arena update of this frame applies the commands of this frame.
+                for (int Player = 0; Player < MAX_PLAYERS; Player++)
+                {
+                    if (m_pOptions->GetBomberType(Player) == BOMBERTYPE_MAN)
+                        CommandHistory.Replay(&m_Arena, Player, CommandChunk, m_pTimer->GetDeltaTime());
+                }
+            }
         }
 #endif
 
@@ -630,34 +845,35 @@ void CMatch::ManagePauseMessage(void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+/**
+ *  \brief Count the ticks on which the arena is simulated in this update
+ */
+
+int CMatch::CountTicks(void)
+{
+#ifdef NETWORK_MODE
+    // Follow the match clock shared with the server
+    if (m_pNetwork->NetworkMode() != NETWORKMODE_LOCAL)
+        return m_Ticks.Follow(m_pNetwork->GetClock().GetTick(m_pTimer->GetElapsedTime()));
+#endif
+
+    return m_Ticks.Update(m_pTimer->GetDeltaTime());
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 void CMatch::UpdateMatch(void)
 {
     // If the match is not paused
     if (m_pPauseMessage == NULL)
     {
-        int AliveCount_Human = 0;   // Number of alive human bombers
-        int AliveCount_AI = 0;   // Number of alive computer controlled bombers
+        int AliveCount_Human;   // Number of alive human bombers
+        int AliveCount_AI;      // Number of alive computer controlled bombers
 
         // Count human and AI bombers
-        for (int Player = 0; Player < m_Arena.MaxBombers(); Player++)
-        {
-            // If this bomber exists
-            if (m_Arena.GetBomber(Player).Exist())
-            {
-                // If this bomber is alive
-                if (m_Arena.GetBomber(Player).IsAlive())
-                {
-                    // Count number of human and AI alive bombers
-                    switch (m_Arena.GetBomber(Player).GetBomberType()) {
-                    case BOMBERTYPE_MAN:
-                    case BOMBERTYPE_NET:    AliveCount_Human++; break;
-                    case BOMBERTYPE_COM:    AliveCount_AI++;    break;
-                    default:                break; // #3078839
-                    }
-
-                }
-            }
-        }
+        m_Rules.CountAliveBombers(AliveCount_Human, AliveCount_AI);
 
         bool ForceArenaClosing = false;
 
@@ -678,46 +894,37 @@ void CMatch::UpdateMatch(void)
 
         }
 
-        // If the hurry up is enabled
-        if (m_pOptions->GetTimeUpMinutes() != 0 || m_pOptions->GetTimeUpSeconds() != 0 || ForceArenaClosing)
-        {
-            //------------------------------------
-            // Check if arena should close
-            //------------------------------------
-
-            // If the arena is not closing
-            if (!m_NoticedTimeUp && !m_Arena.GetArenaCloser().IsClosing())
-            {
-                // If the clock's current time is less than (or equal to) to the timeup's time
-                if (m_Clock.GetMinutes() < m_pOptions->GetTimeUpMinutes()
-                    ||
-                    (m_Clock.GetMinutes() == m_pOptions->GetTimeUpMinutes() &&
-                    m_Clock.GetSeconds() <= m_pOptions->GetTimeUpSeconds())
-                    ||
-                    ForceArenaClosing)
-                {
-                    // Make the arena start closing
-                    m_Arena.GetArenaCloser().Start();
-
-                    // Start playing the fast match song
-                    m_pSound->PlaySong(SONG_MATCH_MUSIC_1_FAST);
+        //------------------------------------
+        // Check if arena should close
+        //------------------------------------
 
-                    // Save current song number
-                    m_CurrentSong = SONG_MATCH_MUSIC_1_FAST;
+        // If the arena starts closing now
+        if (m_Rules.UpdateTimeUp(ForceArenaClosing))
+        {
+            // Start playing the fast match song
+            m_pSound->PlaySong(SONG_MATCH_MUSIC_1_FAST);
 
-                    // Don't do this more than once
-                    m_NoticedTimeUp = true;
-                }
-            }
+            // Save current song number
+            m_CurrentSong = SONG_MATCH_MUSIC_1_FAST;
         }
 
         //------------------------------------
         // Update the match components
         //------------------------------------
 
-        m_Clock.Update(m_pTimer->GetDeltaTime());
+        // The computer players think on the arena as it is at each tick, then the arena steps
+        for (int Ticks = CountTicks(); Ticks > 0; Ticks--)
+        {
+            // Do the AI stuff only when there are AI players
+            if (m_computerPlayersPresent) {
+                m_AiManager.Tick();
+            }
+
+            m_Clock.Update(MATCH_TICK_DURATION);
+            m_Arena.Update(MATCH_TICK_DURATION);
+        }
+
         m_Board.Update();
-        m_Arena.Update(m_pTimer->GetDeltaTime());
     }
 }
 
@@ -777,222 +984,33 @@ void CMatch::ManageMatchOver(void)
     // If the match is not paused
     if (m_pPauseMessage == NULL)
     {
-        int AliveCount = 0;     // Number of alive bombers
-        int DyingCount = 0;     // Number of dying bombers
-
-        // Count alive bombers and dying bombers
-        for (int Player = 0; Player < m_Arena.MaxBombers(); Player++)
-        {
-            // If this bomber exists
-            if (m_Arena.GetBomber(Player).Exist())
-            {
-                // If this bomber is alive
-                if (m_Arena.GetBomber(Player).IsAlive())
-                {
-                    // Add one alive bomber
-                    AliveCount++;
-                }
-                // If this bomber is dying
-                else if (m_Arena.GetBomber(Player).IsDying())
-                {
-                    // Add one dying bomber
-                    DyingCount++;
-                }
-            }
-        }
-
-        int TeamCountAlive[MAX_TEAMS];     // Number of bombers on each team
-        int TeamCountDying[MAX_TEAMS];     // Number of bombers on each team
-
-        for (int Team = 0; Team < MAX_TEAMS; Team++)
-        {
-            TeamCountAlive[Team] = 0;
-            TeamCountDying[Team] = 0;
-        }
-
-        for (int Player = 0; Player < m_Arena.MaxBombers(); Player++)
-        {
-            // If this bomber exists
-            if (m_Arena.GetBomber(Player).Exist())
-            {
-
-                int Team = m_Arena.GetBomber(Player).GetTeam()->GetTeamId();
-
-                if (m_Arena.GetBomber(Player).IsAlive())
-                {
-                    // Add one alive bomber in that team
-                    TeamCountAlive[Team]++;
-                }
-                else if (m_Arena.GetBomber(Player).IsDying())
-                {
-                    // Add one dying bomber in that team
-                    TeamCountDying[Team]++;
-                }
+        EMatchResult Result = m_Rules.ManageMatchOver(m_ForceDrawGame);
 
-            }
-        }
-
-        int CountTeamsAlive = 0;
-        int CountTeamsDying = 0;
-
-        for (int Team = 0; Team < MAX_TEAMS; Team++)
+        // If a team won or the time is over
+        if (Result == MATCHRESULT_WINNER || Result == MATCHRESULT_TIMEOVER)
         {
-            if (TeamCountAlive[Team] > 0)
-                CountTeamsAlive++;
-
-            if (TeamCountDying[Team] > 0)
-                CountTeamsDying++;
-        }
-
-        // If no bomber is alive and there are only dying bombers
-        if (AliveCount == 0 && DyingCount > 0)
-        {
-            // Stop the match song which was playing
-            m_pSound->StopSong(m_CurrentSong);
+            // Play the bell sound (ding ding ding ding ding!)
+            m_pSound->PlaySample(SAMPLE_RING_DING);
         }
-        // If no bomber is alive or dying then this is a draw game
-        else if (AliveCount == 0 && DyingCount == 0)
-        {
-            // Match is over
-            m_MatchOver = true;
-
-            // There is no winner
-            m_WinnerTeam = NO_WINNER_TEAM;
-
-            // Tell the arena to stop closing if it is
-            m_Arena.GetArenaCloser().Stop();
-
-            // Make the board's clock animation stop
-            m_Board.SetClockAnimation(false);
 
-            // Determine mode time when we have to start the last black screen
-            m_ExitModeTime = m_ModeTime + PAUSE_DRAWGAME;
-        }
-        // If only AI bombers are alive then this is also a draw game
-        else if (m_ForceDrawGame)
+        // If the last bombers are dying or the match is over, stop the match song which was playing
+        // (when no bomber is left at all, it was stopped while they were dying)
+        if (Result != MATCHRESULT_NONE && Result != MATCHRESULT_DRAWGAME)
         {
-            // Stop the match song which was playing
             m_pSound->StopSong(m_CurrentSong);
-
-            // Match is over
-            m_MatchOver = true;
-
-            // There is no winner
-            m_WinnerTeam = NO_WINNER_TEAM;
-
-            // Tell the arena to stop closing if it is
-            m_Arena.GetArenaCloser().Stop();
-
-            // Make the board's clock animation stop
-            m_Board.SetClockAnimation(false);
-
-            // Determine mode time when we have to start the last black screen
-            m_ExitModeTime = m_ModeTime + PAUSE_DRAWGAME;
-
-            // Tell the bombers there is no command
-            for (int Player = 0; Player < m_Arena.MaxBombers(); Player++)
-            {
-                // If the bomber exists and is alive
-                if (m_Arena.GetBomber(Player).Exist() &&
-                    m_Arena.GetBomber(Player).IsAlive())
-                {
-                    // Send him no commands so as to avoid a bug where he keeps walking
-                    m_Arena.GetBomber(Player).Command(BOMBERMOVE_NONE, BOMBERACTION_NONE);
-                }
-            }
         }
-        // If one team is alive then that team has won the match
-        else if (CountTeamsAlive == 1 && CountTeamsDying == 0)
-        {
-
-            // Match is over
-            m_MatchOver = true;
-
-            for (int Team = 0; Team < m_Arena.MaxTeams(); Team++)
-            {
-                if (TeamCountAlive[Team] > 0)
-                {
-
-                    // Save the winner player
-                    m_WinnerTeam = Team;
-
-                    // Tell the team it is victorious
-                    m_Teams[Team].SetVictorious(true);
-
-                    break;
-                }
-            }
-
-            for (int Player = 0; Player < m_Arena.MaxBombers(); Player++)
-            {
-                // If the bomber exists and is alive
-                if (m_Arena.GetBomber(Player).Exist() &&
-                    m_Arena.GetBomber(Player).IsAlive())
-                {
-                    // Send him no commands so as to avoid a bug where he keeps walking
-                    m_Arena.GetBomber(Player).Command(BOMBERMOVE_NONE, BOMBERACTION_NONE);
-                }
-            }
 
-            // Play the bell sound (ding ding ding ding ding!)
-            m_pSound->PlaySample(SAMPLE_RING_DING);
-
-            // Stop the match song which was playing
-            m_pSound->StopSong(m_CurrentSong);
-
-            // Tell the arena to stop closing if it is
-            m_Arena.GetArenaCloser().Stop();
-
-            // Make the board's clock animation stop
-            m_Board.SetClockAnimation(false);
-
-            // Determine mode time when we have to start the last black screen
-            m_ExitModeTime = m_ModeTime + PAUSE_WINNER;
-
-        }
-        else if (m_pOptions->GetTimeUpMinutes() == 0 && m_pOptions->GetTimeUpSeconds() == 0 &&
-            (m_pOptions->GetTimeStartMinutes() != 0 || m_pOptions->GetTimeStartSeconds() != 0) &&
-            m_Clock.GetMinutes() == 0 && m_Clock.GetSeconds() == 0)
+        if (CMatchRules::IsOver(Result))
         {
             // Match is over
             m_MatchOver = true;
 
-            // There is no winner
-            m_WinnerTeam = NO_WINNER_TEAM;
-
-            // Seek the alive bombers
-            for (int Player = 0; Player < m_Arena.MaxBombers(); Player++)
-            {
-                // If the bomber exists and is alive
-                if (m_Arena.GetBomber(Player).Exist() &&
-                    m_Arena.GetBomber(Player).IsAlive())
-                {
-                    // Send him no commands so as to avoid a bug where he keeps walking
-                    m_Arena.GetBomber(Player).Command(BOMBERMOVE_NONE, BOMBERACTION_NONE);
-
-                    // Tell the bomber that his team is "victorious"
-                    m_Arena.GetBomber(Player).GetTeam()->SetVictorious(true);
-                }
-            }
-
-            // Play the bell sound (ding ding ding ding ding!)
-            m_pSound->PlaySample(SAMPLE_RING_DING);
-
-            // Stop the match song which was playing
-            m_pSound->StopSong(m_CurrentSong);
-
-            // Tell the arena to stop closing if it is
-            m_Arena.GetArenaCloser().Stop();
-
             // Make the board's clock animation stop
             m_Board.SetClockAnimation(false);
 
             // Determine mode time when we have to start the last black screen
-            m_ExitModeTime = m_ModeTime + PAUSE_DRAWGAME;
-        }
+            m_ExitModeTime = m_ModeTime + CMatchRules::GetPause(Result);
 
-        if (m_MatchOver)
-        {
             // Set the game speed to normal
             m_pTimer->SetSpeed(1.0f);
         }
@@ -1009,13 +1027,13 @@ EGameMode CMatch::Update(void)
     m_ModeTime += m_pTimer->GetDeltaTime();
 
     // If we have to make the first black screen
-    if (m_ModeTime <= BLACKSCREEN_DURATION)
+    if (m_ModeTime <= MATCH_BLACKSCREEN_DURATION)
     {
 
     }
     // If the first black screen is done and we have to make a little 
     // pause to allow the players to see the arena before playing
-    else if (m_ModeTime <= BLACKSCREEN_DURATION + PAUSE_BEGIN)
+    else if (m_ModeTime <= MATCH_BLACKSCREEN_DURATION + MATCH_PAUSE_BEGIN)
     {
 
     }
@@ -1034,10 +1052,12 @@ EGameMode CMatch::Update(void)
     {
         // Update the match
         m_Board.Update();
-        m_Arena.Update(m_pTimer->GetDeltaTime());
+
+        for (int Ticks = CountTicks(); Ticks > 0; Ticks--)
+            m_Arena.Update(MATCH_TICK_DURATION);
     }
     // If the pause is over and we have to make the last black screen
-    else if (m_ModeTime <= m_ExitModeTime + BLACKSCREEN_DURATION)
+    else if (m_ModeTime <= m_ExitModeTime + MATCH_BLACKSCREEN_DURATION)
     {
 
     }
@@ -1045,7 +1065,7 @@ EGameMode CMatch::Update(void)
     else
     {
         // If it's a draw game
-        if (m_WinnerTeam == NO_WINNER_TEAM)
+        if (m_Rules.GetWinnerTeam() == NO_WINNER_TEAM)
         {
             // Ask for a game mode change to draw game screen
             return GAMEMODE_DRAWGAME;
@@ -1069,12 +1089,12 @@ EGameMode CMatch::Update(void)
 void CMatch::Display(void)
 {
     // If we have to make the first black screen
-    if (m_ModeTime <= BLACKSCREEN_DURATION)
+    if (m_ModeTime <= MATCH_BLACKSCREEN_DURATION)
     {
     }
     // If first black screen is done and we have to make a little 
     // pause to allow the players to see the arena before playing
-    else if (m_ModeTime <= BLACKSCREEN_DURATION + PAUSE_BEGIN)
+    else if (m_ModeTime <= MATCH_BLACKSCREEN_DURATION + MATCH_PAUSE_BEGIN)
     {
         DisplayMatchScreen();
 
@@ -1090,6 +1110,10 @@ void CMatch::Display(void)
         DisplayMatchScreen();
         DisplayHurryUpMessage();
         DisplayPauseMessage();
+
+#ifdef NETWORK_MODE
+        DisplayNetworkStatistics();
+#endif
     }
     // If the match is over and we have make a pause before the last black screen
     else if (m_ModeTime <= m_ExitModeTime)
@@ -1097,7 +1121,7 @@ void CMatch::Display(void)
         DisplayMatchScreen();
     }
     // If the pause is over and we have to make the last black screen
-    else if (m_ModeTime <= m_ExitModeTime + BLACKSCREEN_DURATION)
+    else if (m_ModeTime <= m_ExitModeTime + MATCH_BLACKSCREEN_DURATION)
     {
     }
 }
@@ -1144,6 +1168,54 @@ void CMatch::DisplayPauseMessage(void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+#ifdef NETWORK_MODE
+
+void CMatch::DisplayNetworkStatistics(void)
+{
+    CNetworkStatistics& Statistics = m_pNetwork->GetStatistics();
+
+    // If the statistics are hidden (Ctrl + F11 shows them)
+    if (m_pNetwork->NetworkMode() == NETWORKMODE_LOCAL || !Statistics.IsOverlayVisible())
+        return;
+
+    int PositionY = NETWORKSTATISTICS_POSITION_Y;
+
+    // The round trip is only measured by the clients sending commands
+    if (Statistics.GetRoundTripTime() >= 0.0f)
+    {
+        m_NetworkFont.Draw(NETWORKSTATISTICS_POSITION_X, PositionY, "RTT %d MS JITTER %d MS",
+            (int)(Statistics.GetRoundTripTime() * 1000.0f), (int)(Statistics.GetJitter() * 1000.0f));
+
+        PositionY += NETWORKSTATISTICS_LINE_HEIGHT;
+    }
+
+    m_NetworkFont.Draw(NETWORKSTATISTICS_POSITION_X, PositionY, "UPLOAD %.1f KB PER SEC", Statistics.GetSendRate() / 1024.0f);
+    PositionY += NETWORKSTATISTICS_LINE_HEIGHT;
+
+    m_NetworkFont.Draw(NETWORKSTATISTICS_POSITION_X, PositionY, "DOWNLOAD %.1f KB PER SEC", Statistics.GetReceiveRate() / 1024.0f);
+    PositionY += NETWORKSTATISTICS_LINE_HEIGHT;
+
+    m_NetworkFont.Draw(NETWORKSTATISTICS_POSITION_X, PositionY, "ENCODE %.3f MS DECODE %.3f MS", Statistics.GetEncodeTime(), Statistics.GetDecodeTime());
+    PositionY += NETWORKSTATISTICS_LINE_HEIGHT;
+
+    m_NetworkFont.Draw(NETWORKSTATISTICS_POSITION_X, PositionY, "CHUNKS %d SNAPSHOTS %d",
+        Statistics.GetFrames(NETWORKFRAME_COMMANDCHUNK), Statistics.GetFrames(NETWORKFRAME_SNAPSHOT));
+    PositionY += NETWORKSTATISTICS_LINE_HEIGHT;
+
+    m_NetworkFont.Draw(NETWORKSTATISTICS_POSITION_X, PositionY, "DROPPED %d DUPLICATE %d LATE %d",
+        Statistics.GetDroppedFrames(), Statistics.GetDuplicateFrames(), Statistics.GetLateFrames());
+    PositionY += NETWORKSTATISTICS_LINE_HEIGHT;
+
+    m_NetworkFont.Draw(NETWORKSTATISTICS_POSITION_X, PositionY, "TICK %d DRIFT %d PPM",
+        m_pNetwork->GetClock().GetTick(m_pTimer->GetElapsedTime()), (int)(Statistics.GetClockDrift() * 1000000.0f));
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif
+
 #ifdef BOMBERMAAAN_DEBUG
 
 void CMatch::_Debug_WriteBombsToLog() {
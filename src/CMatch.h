@@ -42,24 +42,21 @@ class CHurryMessage;
 #include "CArena.h"
 #include "CClock.h"
 #include "CAiManager.h"
+#include "CMatchRules.h"
+#include "CMatchTicks.h"
 #include "CModeScreen.h"
 
 #include "CSound.h"
 
 #ifdef NETWORK_MODE
     #include "CNetwork.h"
+    #include "CFont.h"
 #endif
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-#define NO_WINNER_TEAM      -1      //<! Value for a winner team number if there is no winner
-
-//******************************************************************************************************************************
-//******************************************************************************************************************************
-//******************************************************************************************************************************
-
 //! The match screen, managing the arena and the board.
 
 class CMatch : public CModeScreen
@@ -70,20 +67,21 @@ private:
     CClock          m_Clock;                    //!< Clock object
     CArena          m_Arena;                    //!< Arena object
 
-    CTeam           m_Teams[MAX_TEAMS];         //!< Teams object 
+    CMatchRules     m_Rules;                    //!< Rules of the match, shared with the dedicated server
+    CMatchTicks     m_Ticks;                    //!< Ticks on which the arena and the computer players are simulated
 
 #ifdef NETWORK_MODE
     CNetwork*       m_pNetwork;                 //!< Network pointer
+    CFont           m_NetworkFont;              //!< Font object used to draw the network statistics
+    CRandom         m_Random;                   //!< Random numbers of a network match, the same as the server's
 #endif
 
     CAiManager      m_AiManager;                //!< Computer brain
     //! @todo Check why m_NoComputer is there (didn't find references)
     bool            m_NoComputer;               //!< True if no computer is playing in this match
     bool            m_MatchOver;                //!< Is match over? (ie. there is a result : winner or draw game)
-    int             m_WinnerTeam;               //!< Number of the team that won if there is a winner
     ESong           m_CurrentSong;              //!< Current song being played
     bool            m_IsSongPlaying;            //!< Is the match song playing?
-    bool            m_NoticedTimeUp;            //!< Did we notice that time is up and do what is necessary?
     CPauseMessage*  m_pPauseMessage;            //!< Pause message object, instanciated when the match is paused
     CHurryMessage*  m_pHurryMessage;            //!< Hurry up message object, instanciated when the arena starts to close
     float           m_ModeTime;                 //!< Time (in seconds) that elapsed since the mode has started
@@ -99,6 +97,7 @@ private:
     void            PlaySong(void);
     void            StopSong(void);
     void            ProcessPlayerCommands(void);
+    int             CountTicks(void);
     void            UpdateMatch(void);
     void            ManagePauseMessage(void);
     void            ManageHurryUpMessage(void);
@@ -106,6 +105,9 @@ private:
     void            DisplayMatchScreen(void);
     void            DisplayHurryUpMessage(void);
     void            DisplayPauseMessage(void);
+#ifdef NETWORK_MODE
+    void            DisplayNetworkStatistics(void);
+#endif
 
 public:
 
@@ -147,6 +149,10 @@ inline void CMatch::SetDisplay(CDisplay *pDisplay)
 
     m_Board.SetDisplay(pDisplay);
     m_Arena.SetDisplay(pDisplay);
+
+#ifdef NETWORK_MODE
+    m_NetworkFont.SetDisplay(pDisplay);
+#endif
 }
 
 inline void CMatch::SetOptions(COptions *pOptions)
@@ -155,6 +161,7 @@ inline void CMatch::SetOptions(COptions *pOptions)
 
     m_Board.SetOptions(pOptions);
     m_Arena.SetOptions(pOptions);
+    m_Rules.SetOptions(pOptions);
 }
 
 inline void CMatch::SetScores(CScores *pScores)
@@ -191,13 +198,13 @@ inline void CMatch::SetNetwork(CNetwork *pNetwork)
 
 inline int CMatch::GetWinnerTeam(void)
 {
-    return m_WinnerTeam;
+    return m_Rules.GetWinnerTeam();
 }
 
 inline bool CMatch::IsPlayerWinner(int Player)
 {
 
-    if (m_Arena.GetBomber(Player).GetTeam()->GetTeamId() == m_WinnerTeam)
+    if (m_Arena.GetBomber(Player).GetTeam()->GetTeamId() == m_Rules.GetWinnerTeam())
         return true;
     else
         return false;
@@ -0,0 +1,292 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CMatchRules.cpp
+ *  \brief The rules of a match
+ */
+
+#include "StdAfx.h"
+#include "CMatchRules.h"
+#include "CArena.h"
+#include "CArenaCloser.h"
+#include "CClock.h"
+#include "COptions.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CMatchRules::CMatchRules (void)
+{
+    m_pArena = NULL;
+    m_pClock = NULL;
+    m_pOptions = NULL;
+    m_NoticedTimeUp = false;
+    m_WinnerTeam = NO_WINNER_TEAM;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CMatchRules::~CMatchRules (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CMatchRules::Create (void)
+{
+    ASSERT (m_pArena != NULL);
+    ASSERT (m_pClock != NULL);
+    ASSERT (m_pOptions != NULL);
+
+    // No match result for the moment
+    m_NoticedTimeUp = false;
+    m_WinnerTeam = NO_WINNER_TEAM;
+
+    for (int i = 0; i < MAX_TEAMS; i++)
+    {
+        m_Teams[i].SetTeamId(i);
+        m_Teams[i].SetVictorious(false);
+    }
+
+#ifdef NETWORK_MODE
+
+    // Each bomber is its own team
+    for (int i = 0; i < MAX_BOMBERS; i++) {
+        m_pArena->GetBomber(i).SetTeam(&m_Teams[i]);
+    }
+
+#else
+    if (m_pOptions->GetBattleMode() == BATTLEMODE_TEAM)
+    {
+        // Set in selected team
+        for (int i = 0; i < MAX_BOMBERS; i++) {
+            if (m_pOptions->GetBomberTeam(i) == BOMBERTEAM_A)
+                m_pArena->GetBomber(i).SetTeam(&m_Teams[0]);
+            else if (m_pOptions->GetBomberTeam(i) == BOMBERTEAM_B)
+                m_pArena->GetBomber(i).SetTeam(&m_Teams[1]);
+        }
+    }
+    else
+    {
+        // Each bomber is its own team
+        for (int i = 0; i < MAX_BOMBERS; i++) {
+            m_pArena->GetBomber(i).SetTeam(&m_Teams[i]);
+        }
+    }
+#endif
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CMatchRules::CountAliveBombers (int& HumanCount, int& ComputerCount)
+{
+    HumanCount = 0;
+    ComputerCount = 0;
+
+    for (int Player = 0; Player < m_pArena->MaxBombers(); Player++)
+    {
+        // If this bomber exists and is alive
+        if (m_pArena->GetBomber(Player).Exist() &&
+            m_pArena->GetBomber(Player).IsAlive())
+        {
+            // Count number of human and AI alive bombers
+            switch (m_pArena->GetBomber(Player).GetBomberType()) {
+            case BOMBERTYPE_MAN:
+            case BOMBERTYPE_NET:    HumanCount++;       break;
+            case BOMBERTYPE_COM:    ComputerCount++;    break;
+            default:                break; // #3078839
+            }
+        }
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CMatchRules::UpdateTimeUp (bool ForceArenaClosing)
+{
+    // If the hurry up is enabled
+    if (m_pOptions->GetTimeUpMinutes() != 0 || m_pOptions->GetTimeUpSeconds() != 0 || ForceArenaClosing)
+    {
+        // If the arena is not closing
+        if (!m_NoticedTimeUp && !m_pArena->GetArenaCloser().IsClosing())
+        {
+            // If the clock's current time is less than (or equal to) to the timeup's time
+            if (m_pClock->GetMinutes() < m_pOptions->GetTimeUpMinutes()
+                ||
+                (m_pClock->GetMinutes() == m_pOptions->GetTimeUpMinutes() &&
+                m_pClock->GetSeconds() <= m_pOptions->GetTimeUpSeconds())
+                ||
+                ForceArenaClosing)
+            {
+                // Make the arena start closing
+                m_pArena->GetArenaCloser().Start();
+
+                // Don't do this more than once
+                m_NoticedTimeUp = true;
+
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+EMatchResult CMatchRules::ManageMatchOver (bool ForceDrawGame)
+{
+    int AliveCount = 0;                 // Number of alive bombers
+    int DyingCount = 0;                 // Number of dying bombers
+    int TeamCountAlive[MAX_TEAMS];      // Number of alive bombers on each team
+    int TeamCountDying[MAX_TEAMS];      // Number of dying bombers on each team
+
+    for (int Team = 0; Team < MAX_TEAMS; Team++)
+    {
+        TeamCountAlive[Team] = 0;
+        TeamCountDying[Team] = 0;
+    }
+
+    // Count alive and dying bombers in each team
+    for (int Player = 0; Player < m_pArena->MaxBombers(); Player++)
+    {
+        if (m_pArena->GetBomber(Player).Exist())
+        {
+            int Team = m_pArena->GetBomber(Player).GetTeam()->GetTeamId();
+
+            if (m_pArena->GetBomber(Player).IsAlive())
+            {
+                AliveCount++;
+                TeamCountAlive[Team]++;
+            }
+            else if (m_pArena->GetBomber(Player).IsDying())
+            {
+                DyingCount++;
+                TeamCountDying[Team]++;
+            }
+        }
+    }
+
+    int CountTeamsAlive = 0;
+    int CountTeamsDying = 0;
+
+    for (int Team = 0; Team < MAX_TEAMS; Team++)
+    {
+        if (TeamCountAlive[Team] > 0)
+            CountTeamsAlive++;
+
+        if (TeamCountDying[Team] > 0)
+            CountTeamsDying++;
+    }
+
+    EMatchResult Result = MATCHRESULT_NONE;
+
+    // If no bomber is alive and there are only dying bombers
+    if (AliveCount == 0 && DyingCount > 0)
+    {
+        Result = MATCHRESULT_DYING;
+    }
+    // If no bomber is alive or dying then this is a draw game
+    else if (AliveCount == 0 && DyingCount == 0)
+    {
+        Result = MATCHRESULT_DRAWGAME;
+        m_WinnerTeam = NO_WINNER_TEAM;
+    }
+    // If only AI bombers are alive then this is also a draw game
+    else if (ForceDrawGame)
+    {
+        Result = MATCHRESULT_COMPUTERSONLY;
+        m_WinnerTeam = NO_WINNER_TEAM;
+    }
+    // If one team is alive then that team has won the match
+    else if (CountTeamsAlive == 1 && CountTeamsDying == 0)
+    {
+        Result = MATCHRESULT_WINNER;
+
+        for (int Team = 0; Team < m_pArena->MaxTeams(); Team++)
+        {
+            if (TeamCountAlive[Team] > 0)
+            {
+                // Save the winner team and tell it it is victorious
+                m_WinnerTeam = Team;
+                m_Teams[Team].SetVictorious(true);
+                break;
+            }
+        }
+    }
+    // If the time is over and the arena does not close
+    else if (m_pOptions->GetTimeUpMinutes() == 0 && m_pOptions->GetTimeUpSeconds() == 0 &&
+        (m_pOptions->GetTimeStartMinutes() != 0 || m_pOptions->GetTimeStartSeconds() != 0) &&
+        m_pClock->GetMinutes() == 0 && m_pClock->GetSeconds() == 0)
+    {
+        Result = MATCHRESULT_TIMEOVER;
+        m_WinnerTeam = NO_WINNER_TEAM;
+
+        // Tell the alive bombers that their team is "victorious"
+        for (int Player = 0; Player < m_pArena->MaxBombers(); Player++)
+        {
+            if (m_pArena->GetBomber(Player).Exist() &&
+                m_pArena->GetBomber(Player).IsAlive())
+            {
+                m_pArena->GetBomber(Player).GetTeam()->SetVictorious(true);
+            }
+        }
+    }
+
+    if (IsOver(Result))
+    {
+        // Send no commands to the alive bombers so as to avoid a bug where they keep walking
+        for (int Player = 0; Player < m_pArena->MaxBombers(); Player++)
+        {
+            if (m_pArena->GetBomber(Player).Exist() &&
+                m_pArena->GetBomber(Player).IsAlive())
+            {
+                m_pArena->GetBomber(Player).Command(BOMBERMOVE_NONE, BOMBERACTION_NONE);
+            }
+        }
+
+        // Tell the arena to stop closing if it is
+        m_pArena->GetArenaCloser().Stop();
+    }
+
+    return Result;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,141 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CMatchRules.h
+ *  \brief Header file of the rules of a match
+ */
+
+#ifndef __CMATCHRULES_H__
+#define __CMATCHRULES_H__
+
+#include "CArena.h"
+#include "CTeam.h"
+
+class CClock;
+class COptions;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define MATCH_BLACKSCREEN_DURATION  0.750f  //!< Duration (in seconds) of each of the two black screens
+#define MATCH_PAUSE_BEGIN           1.0f    //!< Duration (in seconds) of the pause at the beginning of a match
+#define MATCH_PAUSE_DRAWGAME        2.5f    //!< Duration (in seconds) of the pause at match end when there is a draw game
+#define MATCH_PAUSE_WINNER          2.5f    //!< Duration (in seconds) of the pause at match end when there is a winner
+
+#define NO_WINNER_TEAM              -1      //!< Value for a winner team number if there is no winner
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! What the rules say about the match after an update
+enum EMatchResult
+{
+    MATCHRESULT_NONE,               //!< The match goes on
+    MATCHRESULT_DYING,              //!< No bomber is alive but some are still dying
+    MATCHRESULT_DRAWGAME,           //!< No bomber is alive or dying : draw game
+    MATCHRESULT_COMPUTERSONLY,      //!< Only computer bombers are alive and a draw game is forced
+    MATCHRESULT_WINNER,             //!< Only one team is alive : that team won the match
+    MATCHRESULT_TIMEOVER            //!< The clock reached zero and the arena does not close
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! The rules of a match : the teams, when the arena closes, when the match is over and who won it.
+
+/**
+ * CMatch and the dedicated server's CServerMatch both follow these rules, so
+ * that a network match ends the same way on the server and on the clients.
+ * The rules only touch the arena, the clock and the teams. Sounds, songs and
+ * the board are up to the caller, depending on what the rules returned.
+ */
+
+class CMatchRules
+{
+private:
+
+    CArena*         m_pArena;                   //!< Arena of the match
+    CClock*         m_pClock;                   //!< Clock of the match
+    COptions*       m_pOptions;                 //!< Options of the match (battle mode, teams, times)
+    CTeam           m_Teams[MAX_TEAMS];         //!< Teams object
+    bool            m_NoticedTimeUp;            //!< Did we notice that time is up and make the arena close?
+    int             m_WinnerTeam;               //!< Number of the team that won if there is a winner
+
+public:
+
+                    CMatchRules (void);             //!< Constructor. Initialize some members.
+                    ~CMatchRules (void);            //!< Destructor. Does nothing.
+    inline void     SetArena (CArena* pArena);      //!< Set link to the arena object to use
+    inline void     SetClock (CClock* pClock);      //!< Set link to the clock object to use
+    inline void     SetOptions (COptions* pOptions); //!< Set link to the options object to use
+    void            Create (void);                  //!< Put the bombers of the created arena in their teams and reset the result
+    void            CountAliveBombers (int& HumanCount, int& ComputerCount); //!< Count the alive human (or network) and computer bombers
+    bool            UpdateTimeUp (bool ForceArenaClosing); //!< Make the arena close when time is up. Return true if it starts closing now.
+    EMatchResult    ManageMatchOver (bool ForceDrawGame); //!< Determine if the match is over and who won it
+    inline int      GetWinnerTeam (void);           //!< Get the number of the team that won this match
+    static inline bool IsOver (EMatchResult Result); //!< Does this result end the match?
+    static inline float GetPause (EMatchResult Result); //!< Get the duration (in seconds) of the pause after a match ending with this result
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline void CMatchRules::SetArena (CArena* pArena)
+{
+    m_pArena = pArena;
+}
+
+inline void CMatchRules::SetClock (CClock* pClock)
+{
+    m_pClock = pClock;
+}
+
+inline void CMatchRules::SetOptions (COptions* pOptions)
+{
+    m_pOptions = pOptions;
+}
+
+inline int CMatchRules::GetWinnerTeam (void)
+{
+    return m_WinnerTeam;
+}
+
+inline bool CMatchRules::IsOver (EMatchResult Result)
+{
+    return Result != MATCHRESULT_NONE && Result != MATCHRESULT_DYING;
+}
+
+inline float CMatchRules::GetPause (EMatchResult Result)
+{
+    return (Result == MATCHRESULT_WINNER ? MATCH_PAUSE_WINNER : MATCH_PAUSE_DRAWGAME);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CMATCHRULES_H__
@@ -0,0 +1,103 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CMatchTicks.cpp
+ *  \brief Ticks on which a match is simulated
+ */
+
+#include "StdAfx.h"
+#include "CMatchTicks.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CMatchTicks::CMatchTicks (void)
+{
+    Reset(0);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CMatchTicks::~CMatchTicks (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CMatchTicks::Reset (int Tick)
+{
+    m_TickTime = 0.0f;
+    m_Tick = Tick;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CMatchTicks::Update (float DeltaTime)
+{
+    m_TickTime += DeltaTime;
+
+    int Ticks = 0;
+
+    while (m_TickTime >= MATCH_TICK_DURATION && Ticks < MATCH_MAX_TICKS_PER_UPDATE)
+    {
+        m_TickTime -= MATCH_TICK_DURATION;
+        Ticks++;
+    }
+
+    // Don't simulate a long stall, neither the arena nor the computer players
+    if (m_TickTime >= MATCH_TICK_DURATION)
+        m_TickTime = 0.0f;
+
+    m_Tick += Ticks;
+
+    return Ticks;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CMatchTicks::Follow (int ClockTick)
+{
+    // The ticks beyond the maximum are simulated at the next updates
+    int Ticks = MIN(MAX(ClockTick - m_Tick, 0), MATCH_MAX_TICKS_PER_UPDATE);
+
+    m_Tick += Ticks;
+
+    return Ticks;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,86 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CMatchTicks.h
+ *  \brief Header file of the ticks on which a match is simulated
+ */
+
+#ifndef __CMATCHTICKS_H__
+#define __CMATCHTICKS_H__
+
+#include "CNetworkClock.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define MATCH_TICK_DURATION         (1.0f / NETWORK_TICKS_PER_SECOND)   //!< Duration (in seconds) of a tick of the match simulation
+#define MATCH_MAX_TICKS_PER_UPDATE  30                                  //!< Maximum number of ticks simulated in one update
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Counts the fixed ticks on which the arena and the computer players are simulated.
+
+/**
+ * Each update tells how many whole ticks to simulate, so that the arena,
+ * the clock and the computer players always step by MATCH_TICK_DURATION
+ * together, whatever the frame rate. A local match counts the ticks from
+ * the time elapsed : after a long stall the ticks beyond
+ * MATCH_MAX_TICKS_PER_UPDATE are not simulated at all, as if the match
+ * was paused. A network match follows the tick of the match clock shared
+ * with the server, and catches up over the next updates when it is late.
+ */
+
+class CMatchTicks
+{
+private:
+
+    float           m_TickTime;                     //!< Time (in seconds) elapsed since the latest tick
+    int             m_Tick;                         //!< Number of the next tick to simulate
+
+public:
+
+                    CMatchTicks (void);             //!< Constructor. Initialize some members.
+                    ~CMatchTicks (void);            //!< Destructor. Does nothing.
+    void            Reset (int Tick);               //!< Start simulating from this tick
+    int             Update (float DeltaTime);       //!< Count the ticks to simulate now that this time elapsed
+    int             Follow (int ClockTick);         //!< Count the ticks to simulate to reach the tick of the match clock
+    inline int      GetTick (void);                 //!< Number of the next tick to simulate
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline int CMatchTicks::GetTick (void)
+{
+    return m_Tick;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CMATCHTICKS_H__
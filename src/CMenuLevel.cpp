@@ -54,6 +54,8 @@
 #define MINI_ARENA_POSITION_Y               (73+60)
 #define TILE_POSITION_TO_BOMBER_POSITION    (-4)
 #define MINI_ARENA_TILE_SIZE                16
+#define MINI_ARENA_SPRITELAYER              1       //!< Sprite layer of the mini arena
+#define MINI_ARENA_MAX_PARTS                (3 * ARENA_WIDTH * ARENA_HEIGHT)    //!< Maximum number of sprites in the mini arena (floor or wall, action, bomber)
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
@@ -179,6 +181,62 @@ void CMenuLevel::OnUpdate(void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+// Return the sprite of the bomber whose start point is the block, -1 if none.
+// It is also the number of the player starting there.
+
+static int GetBomberSprite(EBlockType BlockType)
+{
+    switch (BlockType)
+    {
+    case BLOCKTYPE_WHITEBOMBER:       return 0;
+    case BLOCKTYPE_BLACKBOMBER:       return 1;
+    case BLOCKTYPE_REDBOMBER:         return 2;
+    case BLOCKTYPE_BLUEBOMBER:        return 3;
+    case BLOCKTYPE_GREENBOMBER:       return 4;
+    default:                          return -1;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+// Return the sprite of the action or item on the block, -1 if none.
+
+static int GetActionSprite(EBlockType BlockType)
+{
+    switch (BlockType)
+    {
+    case BLOCKTYPE_MOVEBOMB_RIGHT:    return 4;
+    case BLOCKTYPE_MOVEBOMB_DOWN:     return 5;
+    case BLOCKTYPE_MOVEBOMB_LEFT:     return 6;
+    case BLOCKTYPE_MOVEBOMB_UP:       return 7;
+    case BLOCKTYPE_ITEM_BOMB:         return 8;
+    case BLOCKTYPE_ITEM_FLAME:        return 9;
+    case BLOCKTYPE_ITEM_KICK:         return 10;
+    case BLOCKTYPE_ITEM_ROLLER:       return 11;
+    case BLOCKTYPE_ITEM_SKULL:        return 12;
+    case BLOCKTYPE_ITEM_THROW:        return 13;
+    case BLOCKTYPE_ITEM_PUNCH:        return 14;
+    case BLOCKTYPE_ITEM_REMOTES:      return 15;
+    case BLOCKTYPE_ITEM_SHIELD:       return 16;
+    case BLOCKTYPE_ITEM_STRONGWEAK:   return 17;
+    default:                          return -1;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The mini arena is drawn as a cached sprite run, whose key is the blocks
+ *  of the level : it is only made the first time the level is shown (or
+ *  when the cache released it), then drawn with a single drawing request.
+ *  The sprites are added to the run in the order the layers and the
+ *  priorities used to draw them : floors, walls, bombers, then actions.
+ */
+
 void CMenuLevel::OnDisplay(void)
 {
     int Player;
@@ -190,119 +248,94 @@ void CMenuLevel::OnDisplay(void)
     for (Player = 0; Player < MAX_PLAYERS; Player++)
         StartPointAvailable[Player] = false;
 
+    // The mini arena only depends on the blocks of the level
+    EBlockType Blocks[ARENA_WIDTH][ARENA_HEIGHT];
+
     // Scan all the blocks of the arena
     for (int X = 0; X < ARENA_WIDTH; X++)
     {
         for (int Y = 0; Y < ARENA_HEIGHT; Y++)
         {
-            EBlockType BlockType = m_pOptions->GetBlockType(X, Y);
+            Blocks[X][Y] = m_pOptions->GetBlockType(X, Y);
 
-            if (BlockType == BLOCKTYPE_HARDWALL)
-            {
-                m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE,
-                    MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE,
-                    NULL,
-                    NULL,
-                    BMP_LEVEL_MINI_TILES,
-                    0,
-                    1,
-                    1);
-            }
-            else if (BlockType == BLOCKTYPE_SOFTWALL || BlockType == BLOCKTYPE_RANDOM)
-            {
-                m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE,
-                    MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE,
-                    NULL,
-                    NULL,
-                    BMP_LEVEL_MINI_TILES,
-                    1,
-                    1,
-                    1);
-            }
-            else
-            {
-                bool Shadow = (Y - 1 >= 0 &&
-                    (m_pOptions->GetBlockType(X, Y - 1) == BLOCKTYPE_HARDWALL ||
-                    m_pOptions->GetBlockType(X, Y - 1) == BLOCKTYPE_SOFTWALL ||
-                    m_pOptions->GetBlockType(X, Y - 1) == BLOCKTYPE_RANDOM));
+            int BomberSprite = GetBomberSprite(Blocks[X][Y]);
 
-                m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE,
-                    MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE,
-                    NULL,
-                    NULL,
-                    BMP_LEVEL_MINI_TILES,
-                    (Shadow ? 3 : 2),
-                    1,
-                    0);
-
-                int spriteNumberAction = -1;
+            if (BomberSprite != -1)
+                StartPointAvailable[BomberSprite] = true;
+        }
+    }
 
-                switch (m_pOptions->GetBlockType(X, Y))
-                {
-                case BLOCKTYPE_MOVEBOMB_RIGHT:    spriteNumberAction = 4;   break;
-                case BLOCKTYPE_MOVEBOMB_DOWN:     spriteNumberAction = 5;   break;
-                case BLOCKTYPE_MOVEBOMB_LEFT:     spriteNumberAction = 6;   break;
-                case BLOCKTYPE_MOVEBOMB_UP:       spriteNumberAction = 7;   break;
-                case BLOCKTYPE_ITEM_BOMB:         spriteNumberAction = 8;   break;
-                case BLOCKTYPE_ITEM_FLAME:        spriteNumberAction = 9;   break;
-                case BLOCKTYPE_ITEM_KICK:         spriteNumberAction = 10;  break;
-                case BLOCKTYPE_ITEM_ROLLER:       spriteNumberAction = 11;  break;
-                case BLOCKTYPE_ITEM_SKULL:        spriteNumberAction = 12;  break;
-                case BLOCKTYPE_ITEM_THROW:        spriteNumberAction = 13;  break;
-                case BLOCKTYPE_ITEM_PUNCH:        spriteNumberAction = 14;  break;
-                case BLOCKTYPE_ITEM_REMOTES:      spriteNumberAction = 15;  break;
-                case BLOCKTYPE_ITEM_SHIELD:       spriteNumberAction = 16;  break;
-                case BLOCKTYPE_ITEM_STRONGWEAK:   spriteNumberAction = 17;  break;
-                default: break;
-                }
+    if (!m_pDisplay->DrawSpriteRun(MINI_ARENA_POSITION_X, MINI_ARENA_POSITION_Y, Blocks, sizeof(Blocks), MINI_ARENA_SPRITELAYER, 0))
+    {
+        SSpriteRunPart Parts[MINI_ARENA_MAX_PARTS];
+        int NumberOfParts = 0;
 
-                if (spriteNumberAction != -1)
+        for (int Pass = 0; Pass < 4; Pass++)
+        {
+            for (int X = 0; X < ARENA_WIDTH; X++)
+            {
+                for (int Y = 0; Y < ARENA_HEIGHT; Y++)
                 {
-                    m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE,
-                        MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE,
-                        NULL,
-                        NULL,
-                        BMP_LEVEL_MINI_TILES,
-                        spriteNumberAction,
-                        2,
-                        0);
+                    EBlockType BlockType = Blocks[X][Y];
+                    bool Wall = (BlockType == BLOCKTYPE_HARDWALL || BlockType == BLOCKTYPE_SOFTWALL || BlockType == BLOCKTYPE_RANDOM);
+                    int Sprite = -1;
+                    int Offset = 0;
+
+                    // Floors
+                    if (Pass == 0 && !Wall)
+                    {
+                        bool Shadow = (Y - 1 >= 0 &&
+                            (Blocks[X][Y - 1] == BLOCKTYPE_HARDWALL ||
+                            Blocks[X][Y - 1] == BLOCKTYPE_SOFTWALL ||
+                            Blocks[X][Y - 1] == BLOCKTYPE_RANDOM));
+
+                        Sprite = (Shadow ? 3 : 2);
+                    }
+                    // Walls
+                    else if (Pass == 1 && Wall)
+                    {
+                        Sprite = (BlockType == BLOCKTYPE_HARDWALL ? 0 : 1);
+                    }
+                    // Bombers, which overlap the blocks around them
+                    else if (Pass == 2)
+                    {
+                        Sprite = GetBomberSprite(BlockType);
+                        Offset = TILE_POSITION_TO_BOMBER_POSITION;
+                    }
+                    // Actions
+                    else if (Pass == 3)
+                    {
+                        Sprite = GetActionSprite(BlockType);
+                    }
+
+                    if (Sprite != -1)
+                    {
+                        ASSERT(NumberOfParts < MINI_ARENA_MAX_PARTS);
+
+                        Parts[NumberOfParts].SpriteTable = (Pass == 2 ? BMP_LEVEL_MINI_BOMBERS : BMP_LEVEL_MINI_TILES);
+                        Parts[NumberOfParts].Sprite = Sprite;
+                        Parts[NumberOfParts].PositionX = X * MINI_ARENA_TILE_SIZE + Offset;
+                        Parts[NumberOfParts].PositionY = Y * MINI_ARENA_TILE_SIZE + Offset;
+                        NumberOfParts++;
+                    }
                 }
+            }
+        }
 
-                switch (BlockType)
-                {
-                case BLOCKTYPE_WHITEBOMBER:
-                    m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        NULL, NULL, BMP_LEVEL_MINI_BOMBERS, 0, 1, 2);
-                    StartPointAvailable[0] = true;
-                    break;
-                case BLOCKTYPE_BLACKBOMBER:
-                    m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        NULL, NULL, BMP_LEVEL_MINI_BOMBERS, 1, 1, 2);
-                    StartPointAvailable[1] = true;
-                    break;
-                case BLOCKTYPE_REDBOMBER:
-                    m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        NULL, NULL, BMP_LEVEL_MINI_BOMBERS, 2, 1, 2);
-                    StartPointAvailable[2] = true;
-                    break;
-                case BLOCKTYPE_BLUEBOMBER:
-                    m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        NULL, NULL, BMP_LEVEL_MINI_BOMBERS, 3, 1, 2);
-                    StartPointAvailable[3] = true;
-                    break;
-                case BLOCKTYPE_GREENBOMBER:
-                    m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + X * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        MINI_ARENA_POSITION_Y + Y * MINI_ARENA_TILE_SIZE + TILE_POSITION_TO_BOMBER_POSITION,
-                        NULL, NULL, BMP_LEVEL_MINI_BOMBERS, 4, 1, 2);
-                    StartPointAvailable[4] = true;
-                    break;
-                default:
-                    break;
-                }
+        // If the run could not be made, draw each sprite on its own
+        if (!m_pDisplay->CreateSpriteRun(Blocks, sizeof(Blocks), Parts, NumberOfParts) ||
+            !m_pDisplay->DrawSpriteRun(MINI_ARENA_POSITION_X, MINI_ARENA_POSITION_Y, Blocks, sizeof(Blocks), MINI_ARENA_SPRITELAYER, 0))
+        {
+            for (int Part = 0; Part < NumberOfParts; Part++)
+            {
+                m_pDisplay->DrawSprite(MINI_ARENA_POSITION_X + Parts[Part].PositionX,
+                    MINI_ARENA_POSITION_Y + Parts[Part].PositionY,
+                    NULL,
+                    NULL,
+                    Parts[Part].SpriteTable,
+                    Parts[Part].Sprite,
+                    MINI_ARENA_SPRITELAYER,
+                    0);
             }
         }
     }
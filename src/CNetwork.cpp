@@ -28,6 +28,8 @@ along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
 #include "StdAfx.h"
 #include "CNetwork.h"
 
+#include <string.h>
+
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
@@ -121,14 +123,25 @@ bool CNetwork::Connect(const char* IpAddressString, int port)
             Sleep(1000);
 
             if (m_ClientSocket)
-                break;
+            {
+                // Only a player can join : spectators watch the games of the dedicated server
+                char Role = 0;
+
+                if (SDLNet_TCP_Recv(m_ClientSocket, &Role, 1) == 1 && Role == NETWORK_ROLE_PLAYER)
+                    break;
+
+                theLog.Write("refused a client that does not play\n");
+
+                SDLNet_TCP_Close(m_ClientSocket);
+                m_ClientSocket = NULL;
+            }
 
         }
 
         SDLNet_TCP_AddSocket(m_socketSet, m_ClientSocket);
 
     }
-    else if (m_NetworkMode == NETWORKMODE_CLIENT)
+    else if (m_NetworkMode == NETWORKMODE_CLIENT || m_NetworkMode == NETWORKMODE_SPECTATOR)
     {
 
         IPaddress ip;
@@ -153,8 +166,20 @@ bool CNetwork::Connect(const char* IpAddressString, int port)
 
         SDLNet_TCP_AddSocket(m_socketSet, m_Socket);
 
+        // Tell the server whether this client plays or only watches the game
+        char Role = (m_NetworkMode == NETWORKMODE_SPECTATOR ? NETWORK_ROLE_SPECTATOR : NETWORK_ROLE_PLAYER);
+
+        if (!Send(SOCKET_SERVER, &Role, 1))
+            return false;
+
     }
 
+    // Measure the traffic of this connection
+    m_Statistics.Create("network.csv");
+
+    // Make the connection worse if the command line asks to
+    m_Simulator.Create();
+
     return true;
 
 }
@@ -169,6 +194,12 @@ bool CNetwork::Disconnect()
     if (m_NetworkMode != NETWORKMODE_LOCAL)
     {
 
+        // Don't lose the frames the simulator still holds back
+        m_Simulator.Flush(this);
+        m_Simulator.Destroy();
+
+        m_Statistics.Destroy();
+
         SDLNet_TCP_Close(m_Socket);
 
         if (m_NetworkMode == NETWORKMODE_SERVER)
@@ -187,10 +218,31 @@ bool CNetwork::Disconnect()
 /**
 *  \return true, if the send was successful
 *
-*  Send packet
+*  Send packet, after the frames the simulator holds back
 */
 
 bool CNetwork::Send(ESocketType SocketType, const char* buf, int len)
+{
+
+    // Nothing may overtake the frames sent before
+    if (m_Simulator.IsEnabled())
+        m_Simulator.Flush(this);
+
+    return SendNow(SocketType, buf, len);
+
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+*  \return true, if the send was successful
+*
+*  Send packet to the socket right now
+*/
+
+bool CNetwork::SendNow(ESocketType SocketType, const char* buf, int len)
 {
 
     int Sent = 0;
@@ -206,6 +258,44 @@ bool CNetwork::Send(ESocketType SocketType, const char* buf, int len)
         return false;
     }
 
+    m_Statistics.AddBytesSent(Sent);
+
+    return true;
+
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+*  \return true, if the send was successful
+*
+*  Send a frame (its 4 checksum bytes then its content), or give it
+*  to the simulator which will send it later, or never.
+*/
+
+bool CNetwork::SendFrame(ESocketType SocketType, const char* CheckSumBytes, const char* buf, int len)
+{
+
+    if (!m_Simulator.IsEnabled())
+    {
+        if (!SendNow(SocketType, CheckSumBytes, 4))
+            return false;
+
+        return SendNow(SocketType, buf, len);
+    }
+
+    // The simulator handles the whole frame at once
+    char* Frame = new char [4 + len];
+
+    memcpy(Frame, CheckSumBytes, 4);
+    memcpy(Frame + 4, buf, len);
+
+    m_Simulator.SendFrame(SocketType, Frame, 4 + len);
+
+    delete [] Frame;
+
     return true;
 
 }
@@ -214,6 +304,22 @@ bool CNetwork::Send(ESocketType SocketType, const char* buf, int len)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+/**
+*  Send the frames the simulator held back long enough
+*/
+
+void CNetwork::Update()
+{
+
+    if (m_Simulator.IsEnabled())
+        m_Simulator.Update(this);
+
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 /**
 *  \return true, if the send was successful
 *
@@ -223,19 +329,56 @@ bool CNetwork::Send(ESocketType SocketType, const char* buf, int len)
 int CNetwork::Receive(ESocketType SocketType, char* buf, int len)
 {
 
+    int Received = 0;
+
     if (SocketType == SOCKET_SERVER)
-    {
-        return SDLNet_TCP_Recv(m_Socket, buf, len);
-    }
+        Received = SDLNet_TCP_Recv(m_Socket, buf, len);
     else if (SocketType == SOCKET_CLIENT)
+        Received = SDLNet_TCP_Recv(m_ClientSocket, buf, len);
+
+    if (Received > 0)
+        m_Statistics.AddBytesReceived(Received);
+
+    return Received;
+
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+*  \return true, if all the bytes were received
+*
+*  Receive exactly len bytes, waiting for them if needed
+*/
+
+bool CNetwork::ReceiveAll(ESocketType SocketType, char* buf, int len)
+{
+
+    int Received = 0;
+
+    while (Received < len)
     {
-        return SDLNet_TCP_Recv(m_ClientSocket, buf, len);
+        int Result = this->Receive(SocketType, &buf[Received], len - Received);
+
+        if (Result <= 0)
+        {
+            theLog.Write("recieve error: %s\n", SDLNet_GetError());
+            return false;
+        }
+
+        Received += Result;
     }
-    else
-        return 0;
+
+    return true;
 
 }
 
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 /**
 *  \return true, if the send was successful
 *
@@ -252,14 +395,14 @@ int CNetwork::ReceiveNonBlocking(ESocketType SocketType, char* buf, int len)
         if (SocketType == SOCKET_SERVER)
         {
             if (SDLNet_SocketReady(m_Socket))
-                return SDLNet_TCP_Recv(m_Socket, buf, len);
+                return this->Receive(SOCKET_SERVER, buf, len);
             else
                 return 0;
         }
         else if (SocketType == SOCKET_CLIENT)
         {
             if (SDLNet_SocketReady(m_ClientSocket))
-                return SDLNet_TCP_Recv(m_ClientSocket, buf, len);
+                return this->Receive(SOCKET_CLIENT, buf, len);
             else
                 return 0;
         }
@@ -276,6 +419,31 @@ int CNetwork::ReceiveNonBlocking(ESocketType SocketType, char* buf, int len)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+/**
+*  \return true, if there is data waiting on the socket
+*
+*  Check the socket without waiting
+*/
+
+bool CNetwork::IsDataReady(ESocketType SocketType)
+{
+
+    if (SDLNet_CheckSockets(m_socketSet, 0) <= 0)
+        return false;
+
+    if (SocketType == SOCKET_SERVER)
+        return SDLNet_SocketReady(m_Socket) != 0;
+    else if (SocketType == SOCKET_CLIENT)
+        return SDLNet_SocketReady(m_ClientSocket) != 0;
+    else
+        return false;
+
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 bool CNetwork::SendCommandChunk(const CCommandChunk& CommandChunk)
 {
 
@@ -286,12 +454,11 @@ bool CNetwork::SendCommandChunk(const CCommandChunk& CommandChunk)
     } LongBytes;
 
     LongBytes.LongValue = this->CheckSum((const char*)&CommandChunk);
-    this->Send(SOCKET_SERVER, (const char*)&LongBytes.ByteArray, 4);
 
-    // Send client command chunk to the server
-    this->Send(SOCKET_SERVER, (const char*)&CommandChunk, sizeof(CommandChunk));
+    m_Statistics.AddFrame(NETWORKFRAME_COMMANDCHUNK, 4 + CommandChunk.GetSize());
 
-    return true;
+    // Send client command chunk to the server, only with the steps it uses
+    return SendFrame(SOCKET_SERVER, (const char*)&LongBytes.ByteArray, (const char*)&CommandChunk, CommandChunk.GetSize());
 
 }
 
@@ -307,69 +474,38 @@ bool CNetwork::ReceiveCommandChunk(CCommandChunk& CommandChunk)
         char ByteArray[4];
     } LongBytes;
 
-    {
-        int bufsize = 4;
-        int Received = 0;
-
-        // Receive checksum
-        do {
-
-            Received += this->Receive(SOCKET_CLIENT, &LongBytes.ByteArray[Received], bufsize);
+    LongBytes.LongValue = 0;
 
-            if (Received == SDL_ERROR)
-            {
-                theLog.Write("recieve error: %s\n", SDLNet_GetError());
-                break;
-            }
-
-            if (Received > 0)
-                bufsize -= Received;
-            else
-                break;
+    // Receive checksum
+    if (!ReceiveAll(SOCKET_CLIENT, LongBytes.ByteArray, 4))
+        return false;
 
-        } while (bufsize > 0);
+    // Receive the header of the client command chunk, which tells how many steps follow
+    CCommandChunk ReceivedChunk;
 
-    }
+    if (!ReceiveAll(SOCKET_CLIENT, (char*)&ReceivedChunk, CCommandChunk::GetHeaderSize()))
+        return false;
 
-    // Receive client command chunk 
+    if (ReceivedChunk.GetNumberOfSteps() < 0 || ReceivedChunk.GetNumberOfSteps() > MAX_STEPS_IN_COMMAND_CHUNK)
     {
-        int bufsize = sizeof(CommandChunk);
-        int Received = 0;
-
-        char* recvBuf = new char[bufsize];
-
-        do {
-
-            Received += this->Receive(SOCKET_CLIENT, &recvBuf[Received], bufsize);
-
-            if (Received == SDL_ERROR)
-            {
-                theLog.Write("recieve error: %s\n", SDLNet_GetError());
-                delete[] recvBuf;
-                return false;
-            }
-
-            bufsize -= Received;
-
-        } while (Received < sizeof(CommandChunk));
-
-        if (Received == sizeof(CommandChunk))
-        {
-
-            if (this->CheckSum(recvBuf) == LongBytes.LongValue)
-            {
-                memcpy((char *)&CommandChunk, recvBuf, sizeof(CommandChunk));
-                delete[] recvBuf;
-                return true;
-            }
-
-        }
+        theLog.Write("wrong number of steps in a command chunk\n");
+        return false;
+    }
 
-        delete[] recvBuf;
+    // Receive the steps
+    if (!ReceiveAll(SOCKET_CLIENT, (char*)&ReceivedChunk + CCommandChunk::GetHeaderSize(), ReceivedChunk.GetSize() - CCommandChunk::GetHeaderSize()))
+        return false;
 
+    // Only 4 bytes of the checksum are sent
+    if ((this->CheckSum((const char*)&ReceivedChunk) & 0xFFFFFFFF) != (LongBytes.LongValue & 0xFFFFFFFF))
+    {
+        m_Statistics.AddDroppedFrame();
+        return false;
     }
 
-    return false;
+    CommandChunk = ReceivedChunk;
+
+    return true;
 
 }
 
@@ -387,10 +523,11 @@ bool CNetwork::SendSnapshot(const CArenaSnapshot& Snapshot)
     } LongBytes;
 
     LongBytes.LongValue = this->CheckSum((const char*)&Snapshot);
-    this->Send(SOCKET_CLIENT, (const char*)&LongBytes.ByteArray, 4);
+
+    m_Statistics.AddFrame(NETWORKFRAME_SNAPSHOT, 4 + sizeof(Snapshot));
 
     // Send snapshot to the client
-    return this->Send(SOCKET_CLIENT, (const char*)&Snapshot, sizeof(Snapshot));
+    return SendFrame(SOCKET_CLIENT, (const char*)&LongBytes.ByteArray, (const char*)&Snapshot, sizeof(Snapshot));
 
 }
 
@@ -406,6 +543,8 @@ bool CNetwork::ReceiveSnapshot(CArenaSnapshot& Snapshot)
         char ByteArray[4];
     } LongBytes;
 
+    LongBytes.LongValue = 0;
+
     {
         int bufsize = 4;
         int Received = 0;
@@ -458,12 +597,15 @@ bool CNetwork::ReceiveSnapshot(CArenaSnapshot& Snapshot)
         if (Received == sizeof(Snapshot))
         {
 
-            if (this->CheckSum(recvBuf) == LongBytes.LongValue)
+            // Only 4 bytes of the checksum are sent
+            if ((this->CheckSum(recvBuf) & 0xFFFFFFFF) == (LongBytes.LongValue & 0xFFFFFFFF))
             {
                 memcpy((char *)&Snapshot, recvBuf, sizeof(Snapshot));
                 delete[] recvBuf;
                 return true;
             }
+
+            m_Statistics.AddDroppedFrame();
         }
 
         delete[] recvBuf;
@@ -32,6 +32,9 @@ along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "CCommandChunk.h"
 #include "CArenaSnapshot.h"
+#include "CNetworkStatistics.h"
+#include "CNetworkSimulator.h"
+#include "CNetworkClock.h"
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
@@ -41,7 +44,8 @@ enum ENetworkMode
 {
     NETWORKMODE_LOCAL,
     NETWORKMODE_SERVER,
-    NETWORKMODE_CLIENT
+    NETWORKMODE_CLIENT,
+    NETWORKMODE_SPECTATOR   //!< Client of the dedicated server that only receives the snapshots
 };
 
 enum ESocketType
@@ -52,6 +56,9 @@ enum ESocketType
 
 #define SDL_ERROR -1
 
+#define NETWORK_ROLE_PLAYER     'P'     //!< Byte a player sends to the server right after connecting
+#define NETWORK_ROLE_SPECTATOR  'S'     //!< Byte a spectator sends to the dedicated server right after connecting
+
 //! Manages the network communication
 class CNetwork
 {
@@ -63,6 +70,12 @@ private:
     TCPsocket m_ClientSocket;
     SDLNet_SocketSet m_socketSet;
 
+    CNetworkStatistics m_Statistics;
+    CNetworkSimulator m_Simulator;
+    CNetworkClock m_Clock;
+
+    bool           SendFrame(ESocketType SocketType, const char* CheckSumBytes, const char* buf, int len);
+
 public:
 
     CNetwork();
@@ -75,8 +88,12 @@ public:
     bool           Disconnect();
 
     bool           Send(ESocketType SocketType, const char* buf, int len);
+    bool           SendNow(ESocketType SocketType, const char* buf, int len);
+    void           Update();
     int            Receive(ESocketType SocketType, char* buf, int len);
+    bool           ReceiveAll(ESocketType SocketType, char* buf, int len);
     int            ReceiveNonBlocking(ESocketType SocketType, char* buf, int len);
+    bool           IsDataReady(ESocketType SocketType);
 
     bool           SendCommandChunk(const CCommandChunk& CommandChunk);
     bool           ReceiveCommandChunk(CCommandChunk& CommandChunk);
@@ -84,7 +101,11 @@ public:
     bool           SendSnapshot(const CArenaSnapshot& Snapshot);
     bool           ReceiveSnapshot(CArenaSnapshot& Snapshot);
 
-    unsigned long  CheckSum(const char *buf);
+    static unsigned long CheckSum(const char *buf);
+
+    inline CNetworkStatistics& GetStatistics();
+    inline CNetworkSimulator& GetSimulator();
+    inline CNetworkClock& GetClock();
 
 };
 
@@ -92,4 +113,23 @@ public:
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+inline CNetworkStatistics& CNetwork::GetStatistics()
+{
+    return m_Statistics;
+}
+
+inline CNetworkSimulator& CNetwork::GetSimulator()
+{
+    return m_Simulator;
+}
+
+inline CNetworkClock& CNetwork::GetClock()
+{
+    return m_Clock;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 #endif // __CNETWORK_H__
@@ -0,0 +1,211 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CNetworkClock.cpp
+ *  \brief Clock shared by the server and the clients
+ */
+
+#include "StdAfx.h"
+#include "CNetworkClock.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CNetworkClock::CNetworkClock (void)
+{
+    SetEpoch(0.0);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CNetworkClock::~CNetworkClock (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The server calls this when it sends the start of the match. A client
+ *  calls this when it receives it, which is late by the transit time :
+ *  the samples taken during the match correct it.
+ */
+
+void CNetworkClock::SetEpoch (double LocalTime)
+{
+    m_ReferenceTime = LocalTime;
+    m_Offset = -LocalTime;
+    m_Drift = 0.0;
+    m_Delay = -1.0;
+    m_NumberOfSamples = 0;
+    m_FirstPoint = 0;
+    m_NumberOfPoints = 0;
+    m_LatestTick = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The local times are the ones of the client, the server times are match times.
+ */
+
+void CNetworkClock::AddSample (double LocalSendTime, double ServerReceiveTime, double ServerSendTime, double LocalReceiveTime)
+{
+    SClockSample Sample;
+
+    Sample.LocalTime = (LocalSendTime + LocalReceiveTime) / 2.0;
+    Sample.Offset = ((ServerReceiveTime - LocalSendTime) + (ServerSendTime - LocalReceiveTime)) / 2.0;
+    Sample.Delay = (LocalReceiveTime - LocalSendTime) - (ServerSendTime - ServerReceiveTime);
+
+    // The times are rounded to the millisecond
+    if (Sample.Delay < 0.0)
+        Sample.Delay = 0.0;
+
+    // Replace the oldest sample
+    m_Samples[m_NumberOfSamples % NETWORK_CLOCK_SAMPLES] = Sample;
+    m_NumberOfSamples++;
+
+    // The shorter the delay, the less the way there and the way back can differ,
+    // so the best offset is given by the sample with the shortest delay.
+    const SClockSample* pBest = NULL;
+
+    for (int Index = 0; Index < MIN(m_NumberOfSamples, NETWORK_CLOCK_SAMPLES); Index++)
+    {
+        if (pBest == NULL || m_Samples[Index].Delay < pBest->Delay ||
+            (m_Samples[Index].Delay == pBest->Delay && m_Samples[Index].LocalTime > pBest->LocalTime))
+        {
+            pBest = &m_Samples[Index];
+        }
+    }
+
+    ASSERT (pBest != NULL);
+
+    m_ReferenceTime = pBest->LocalTime;
+    m_Offset = pBest->Offset;
+    m_Delay = pBest->Delay;
+
+    // If it is time to keep the offset to estimate the drift
+    if (m_NumberOfPoints == 0 ||
+        Sample.LocalTime - m_Points[(m_FirstPoint + m_NumberOfPoints - 1) % NETWORK_CLOCK_POINTS].LocalTime >= NETWORK_CLOCK_POINT_PERIOD)
+    {
+        // Forget the oldest offset if there is no room left
+        if (m_NumberOfPoints == NETWORK_CLOCK_POINTS)
+        {
+            m_FirstPoint = (m_FirstPoint + 1) % NETWORK_CLOCK_POINTS;
+            m_NumberOfPoints--;
+        }
+
+        m_Points[(m_FirstPoint + m_NumberOfPoints) % NETWORK_CLOCK_POINTS] = *pBest;
+        m_NumberOfPoints++;
+
+        EstimateDrift();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkClock::EstimateDrift (void)
+{
+    const SClockSample& First = m_Points[m_FirstPoint];
+    const SClockSample& Last = m_Points[(m_FirstPoint + m_NumberOfPoints - 1) % NETWORK_CLOCK_POINTS];
+
+    // Keep the previous drift until the offsets cover enough time
+    if (m_NumberOfPoints < 4 || Last.LocalTime - First.LocalTime < MIN_CLOCK_DRIFT_SPAN)
+        return;
+
+    // Use times relative to the oldest offset to keep the sums precise
+    double SumTime = 0.0;
+    double SumOffset = 0.0;
+    double SumTimeTime = 0.0;
+    double SumTimeOffset = 0.0;
+
+    for (int Index = 0; Index < m_NumberOfPoints; Index++)
+    {
+        const SClockSample& Point = m_Points[(m_FirstPoint + Index) % NETWORK_CLOCK_POINTS];
+
+        double Time = Point.LocalTime - First.LocalTime;
+
+        SumTime += Time;
+        SumOffset += Point.Offset;
+        SumTimeTime += Time * Time;
+        SumTimeOffset += Time * Point.Offset;
+    }
+
+    double Denominator = m_NumberOfPoints * SumTimeTime - SumTime * SumTime;
+
+    if (Denominator <= 0.0)
+        return;
+
+    double Drift = (m_NumberOfPoints * SumTimeOffset - SumTime * SumOffset) / Denominator;
+
+    // A larger drift means that the offsets are wrong, not the clocks
+    m_Drift = MIN(MAX(Drift, -MAX_CLOCK_DRIFT), MAX_CLOCK_DRIFT);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+double CNetworkClock::GetMatchTime (double LocalTime)
+{
+    return LocalTime + m_Offset + m_Drift * (LocalTime - m_ReferenceTime);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CNetworkClock::GetTick (double LocalTime)
+{
+    double Ticks = GetMatchTime(LocalTime) * NETWORK_TICKS_PER_SECOND;
+    int Tick = (int)Ticks;
+
+    // Round towards minus infinity
+    if (Ticks < Tick)
+        Tick--;
+
+    // A new offset may move the match time back a little : wait
+    // for the clock to reach the latest tick instead of going back.
+    if (Tick < m_LatestTick)
+        return m_LatestTick;
+
+    m_LatestTick = Tick;
+
+    return Tick;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,133 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+
+/**
+ *  \file CNetworkClock.h
+ *  \brief Header file of the clock shared by the server and the clients
+ */
+
+#ifndef __CNETWORKCLOCK_H__
+#define __CNETWORKCLOCK_H__
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define NETWORK_TICKS_PER_SECOND        60      //!< Number of ticks of the match clock per second
+#define MAX_LATE_TICKS                  30      //!< A command chunk sent more ticks ago than this is out of date when it arrives
+#define NETWORK_CLOCK_SAMPLES           8       //!< Number of latest samples among which the one with the shortest delay gives the offset
+#define NETWORK_CLOCK_POINTS            32      //!< Number of latest offsets used to estimate the drift
+#define NETWORK_CLOCK_POINT_PERIOD      1.0     //!< Time (in seconds) between two offsets used to estimate the drift
+#define MIN_CLOCK_DRIFT_SPAN            4.0     //!< Minimum time (in seconds) the offsets must cover to estimate the drift
+#define MAX_CLOCK_DRIFT                 0.0005  //!< Maximum drift between two clocks (500 parts per million)
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A measure of the offset between the local clock and the match clock
+struct SClockSample
+{
+    double          LocalTime;                      //!< Local time (in seconds) in the middle of the exchange
+    double          Offset;                         //!< Match time minus local time (in seconds)
+    double          Delay;                          //!< Round trip time (in seconds) of the exchange, without the time the server held it
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Gives the server and the clients the same match time and the same tick counter.
+
+/**
+ * The match epoch is the moment the server sends the start of the match :
+ * the match time is zero then, and the tick is the match time multiplied by
+ * NETWORK_TICKS_PER_SECOND. On the server the match time is simply the time
+ * elapsed since the epoch. A client estimates it the way NTP does : each
+ * snapshot echoes the local time at which the client sent its latest command
+ * chunk, with the time the server held it and the match time when it was
+ * sent. The sample with the shortest delay among the latest ones gives the
+ * offset. Once per NETWORK_CLOCK_POINT_PERIOD this offset is kept, and a
+ * least squares fit over the offsets kept gives the drift between the clocks.
+ */
+
+class CNetworkClock
+{
+private:
+
+    double          m_ReferenceTime;                //!< Local time (in seconds) at which the offset was measured
+    double          m_Offset;                       //!< Match time minus local time at the reference time (in seconds)
+    double          m_Drift;                        //!< Seconds the match clock gains on the local clock per second
+    double          m_Delay;                        //!< Delay of the sample giving the offset (in seconds)
+    SClockSample    m_Samples [NETWORK_CLOCK_SAMPLES]; //!< Latest samples, in no particular order
+    int             m_NumberOfSamples;              //!< Number of samples received since the epoch
+    SClockSample    m_Points [NETWORK_CLOCK_POINTS]; //!< Latest offsets kept to estimate the drift, the oldest one first
+    int             m_FirstPoint;                   //!< Index of the oldest offset kept
+    int             m_NumberOfPoints;               //!< Number of offsets kept
+    int             m_LatestTick;                   //!< Latest tick given, so that the tick never goes back
+
+    void            EstimateDrift (void);           //!< Fit a line through the offsets kept
+
+public:
+
+                    CNetworkClock (void);           //!< Constructor. Initialize some members.
+                    ~CNetworkClock (void);          //!< Destructor. Does nothing.
+    void            SetEpoch (double LocalTime);    //!< Start the match clock at this local time and forget the samples
+    void            AddSample (double LocalSendTime, double ServerReceiveTime, double ServerSendTime, double LocalReceiveTime); //!< Take a round trip to the server into account
+    double          GetMatchTime (double LocalTime); //!< Estimate the match time (in seconds) at this local time
+    int             GetTick (double LocalTime);     //!< Estimate the tick at this local time
+    static inline bool IsLate (int Tick, int CurrentTick); //!< Is something meant for this tick out of date?
+    inline double   GetOffset (void);               //!< Match time minus local time (in seconds), at the reference time
+    inline double   GetDrift (void);                //!< Seconds the match clock gains on the local clock per second
+    inline double   GetDelay (void);                //!< Round trip delay (in seconds) of the sample giving the offset, negative if none
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline bool CNetworkClock::IsLate (int Tick, int CurrentTick)
+{
+    return CurrentTick - Tick > MAX_LATE_TICKS;
+}
+
+inline double CNetworkClock::GetOffset (void)
+{
+    return m_Offset;
+}
+
+inline double CNetworkClock::GetDrift (void)
+{
+    return m_Drift;
+}
+
+inline double CNetworkClock::GetDelay (void)
+{
+    return m_Delay;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CNETWORKCLOCK_H__
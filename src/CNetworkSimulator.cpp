@@ -0,0 +1,334 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CNetworkSimulator.cpp
+ *  \brief Network condition simulator
+ */
+
+#include "StdAfx.h"
+#include "CNetworkSimulator.h"
+#include "CNetwork.h"
+
+#include <string.h>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CNetworkSimulator::CNetworkSimulator (void)
+{
+    m_Latency = 0.0f;
+    m_Jitter = 0.0f;
+    m_LossRate = 0.0f;
+    m_ReorderRate = 0.0f;
+    m_Bandwidth = 0.0f;
+    m_Seed = 1;
+    m_RandomState = 1;
+    m_LinkFreeTime = 0.0;
+    m_LatestDeliveryTime = 0.0;
+    m_NumberOfFrames = 0;
+    m_LostFrames = 0;
+    m_ReorderedFrames = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CNetworkSimulator::~CNetworkSimulator (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  --net-latency <ms>          Time a frame takes to arrive
+ *  --net-jitter <ms>           Maximum random time added to or removed from the latency
+ *  --net-loss <percent>        Probability that a frame is lost
+ *  --net-reorder <percent>     Probability that a frame arrives after the next ones
+ *  --net-bandwidth <bytes>     Maximum number of bytes sent per second
+ *  --net-seed <number>         Seed of the random numbers
+ */
+
+#ifdef WIN32
+void CNetworkSimulator::ParseCommandLine (const char* pCommandLine)
+{
+    float Latency = 0.0f;
+    float Jitter = 0.0f;
+    float Loss = 0.0f;
+    float Reorder = 0.0f;
+    const char* pOption;
+
+    if ((pOption = strstr(pCommandLine, "--net-latency")) != NULL)
+        sscanf(pOption + strlen("--net-latency"), "%f", &Latency);
+
+    if ((pOption = strstr(pCommandLine, "--net-jitter")) != NULL)
+        sscanf(pOption + strlen("--net-jitter"), "%f", &Jitter);
+
+    if ((pOption = strstr(pCommandLine, "--net-loss")) != NULL)
+        sscanf(pOption + strlen("--net-loss"), "%f", &Loss);
+
+    if ((pOption = strstr(pCommandLine, "--net-reorder")) != NULL)
+        sscanf(pOption + strlen("--net-reorder"), "%f", &Reorder);
+
+    if ((pOption = strstr(pCommandLine, "--net-bandwidth")) != NULL)
+        sscanf(pOption + strlen("--net-bandwidth"), "%f", &m_Bandwidth);
+
+    if ((pOption = strstr(pCommandLine, "--net-seed")) != NULL)
+        sscanf(pOption + strlen("--net-seed"), "%u", &m_Seed);
+#else
+void CNetworkSimulator::ParseCommandLine (char** pCommandLine, int pCommandLineCount)
+{
+    float Latency = 0.0f;
+    float Jitter = 0.0f;
+    float Loss = 0.0f;
+    float Reorder = 0.0f;
+
+    for (int i = 1; i + 1 < pCommandLineCount; i++)
+    {
+        if (strcmp(pCommandLine[i], "--net-latency") == 0)
+            Latency = (float)atof(pCommandLine[++i]);
+        else if (strcmp(pCommandLine[i], "--net-jitter") == 0)
+            Jitter = (float)atof(pCommandLine[++i]);
+        else if (strcmp(pCommandLine[i], "--net-loss") == 0)
+            Loss = (float)atof(pCommandLine[++i]);
+        else if (strcmp(pCommandLine[i], "--net-reorder") == 0)
+            Reorder = (float)atof(pCommandLine[++i]);
+        else if (strcmp(pCommandLine[i], "--net-bandwidth") == 0)
+            m_Bandwidth = (float)atof(pCommandLine[++i]);
+        else if (strcmp(pCommandLine[i], "--net-seed") == 0)
+            m_Seed = (unsigned int)strtoul(pCommandLine[++i], NULL, 10);
+    }
+#endif
+
+    // The command line gives milliseconds and percents
+    m_Latency = MAX(Latency, 0.0f) / 1000.0f;
+    m_Jitter = MIN(MAX(Jitter, 0.0f) / 1000.0f, m_Latency);
+    m_LossRate = MIN(MAX(Loss, 0.0f), 100.0f) / 100.0f;
+    m_ReorderRate = MIN(MAX(Reorder, 0.0f), 100.0f) / 100.0f;
+    m_Bandwidth = MAX(m_Bandwidth, 0.0f);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkSimulator::Create (void)
+{
+    m_RandomState = m_Seed;
+    m_LinkFreeTime = 0.0;
+    m_LatestDeliveryTime = 0.0;
+    m_NumberOfFrames = 0;
+    m_LostFrames = 0;
+    m_ReorderedFrames = 0;
+
+    if (IsEnabled())
+    {
+        theLog.WriteLine("NetworkSim      => Simulating %.0f ms latency, %.0f ms jitter, %.1f%% loss, %.1f%% reordering, %.0f bytes/s bandwidth (0 = unlimited), seed %u.",
+            m_Latency * 1000.0f, m_Jitter * 1000.0f, m_LossRate * 100.0f, m_ReorderRate * 100.0f, m_Bandwidth, m_Seed);
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkSimulator::Destroy (void)
+{
+    for (unsigned int Frame = 0; Frame < m_Frames.size(); Frame++)
+        delete [] m_Frames[Frame].pData;
+
+    m_Frames.clear();
+
+    if (IsEnabled())
+    {
+        theLog.WriteLine("NetworkSim      => %d frame(s) sent, %d lost, %d reordered.",
+            m_NumberOfFrames, m_LostFrames, m_ReorderedFrames);
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CNetworkSimulator::IsEnabled (void)
+{
+    return m_Latency > 0.0f || m_LossRate > 0.0f || m_ReorderRate > 0.0f || m_Bandwidth > 0.0f;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CNetworkSimulator::LosesFrames (void)
+{
+    return m_LossRate > 0.0f;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+float CNetworkSimulator::Random (void)
+{
+    // Same linear congruential generator on every platform, unlike rand()
+    m_RandomState = m_RandomState * 1103515245 + 12345;
+
+    return ((m_RandomState >> 8) & 0xFFFFFF) / 16777216.0f;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkSimulator::SendFrame (int SocketType, const char* pData, int Size)
+{
+    ASSERT (pData != NULL);
+    ASSERT (Size > 0);
+
+    double Time = m_Timer.GetElapsedTime();
+
+    m_NumberOfFrames++;
+
+    // Always draw the same random numbers for each frame, so that
+    // changing a probability does not change the other conditions
+    float LossDraw = Random();
+    float ReorderDraw = Random();
+    float JitterDraw = Random();
+
+    if (LossDraw < m_LossRate)
+    {
+        m_LostFrames++;
+        return;
+    }
+
+    // The frame leaves when the link is done with the previous ones
+    double SendTime = Time;
+
+    if (m_Bandwidth > 0.0f)
+    {
+        if (m_LinkFreeTime > SendTime)
+            SendTime = m_LinkFreeTime;
+
+        SendTime += Size / m_Bandwidth;
+        m_LinkFreeTime = SendTime;
+    }
+
+    SSimulatedFrame Frame;
+
+    Frame.SocketType = SocketType;
+    Frame.Size = Size;
+    Frame.DeliveryTime = SendTime + m_Latency + (JitterDraw * 2.0f - 1.0f) * m_Jitter;
+
+    if (ReorderDraw < m_ReorderRate)
+    {
+        // Hold the frame back long enough for the next frames to overtake it
+        Frame.DeliveryTime += m_Latency + 2.0f * m_Jitter + 0.020f;
+        m_ReorderedFrames++;
+    }
+    else
+    {
+        // The jitter alone does not change the order of the frames
+        if (Frame.DeliveryTime < m_LatestDeliveryTime)
+            Frame.DeliveryTime = m_LatestDeliveryTime;
+
+        m_LatestDeliveryTime = Frame.DeliveryTime;
+    }
+
+    Frame.pData = new char [Size];
+    memcpy(Frame.pData, pData, Size);
+
+    m_Frames.push_back(Frame);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkSimulator::Update (CNetwork* pNetwork)
+{
+    DeliverFrames(pNetwork, m_Timer.GetElapsedTime());
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkSimulator::Flush (CNetwork* pNetwork)
+{
+    // Deliver every frame, whatever its delivery time
+    DeliverFrames(pNetwork, -1.0);
+
+    // Nothing is on the link anymore
+    m_LinkFreeTime = 0.0;
+    m_LatestDeliveryTime = 0.0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Send the frames whose delivery time is before the given time, in delivery order.
+ *  A negative time sends all the frames.
+ */
+
+void CNetworkSimulator::DeliverFrames (CNetwork* pNetwork, double Time)
+{
+    ASSERT (pNetwork != NULL);
+
+    while (!m_Frames.empty())
+    {
+        // Find the frame to deliver first
+        unsigned int First = 0;
+
+        for (unsigned int Frame = 1; Frame < m_Frames.size(); Frame++)
+        {
+            if (m_Frames[Frame].DeliveryTime < m_Frames[First].DeliveryTime)
+                First = Frame;
+        }
+
+        if (Time >= 0.0 && m_Frames[First].DeliveryTime > Time)
+            break;
+
+        pNetwork->SendNow((ESocketType)m_Frames[First].SocketType, m_Frames[First].pData, m_Frames[First].Size);
+
+        delete [] m_Frames[First].pData;
+
+        // Keep the other frames in the order they were sent
+        for (unsigned int Frame = First + 1; Frame < m_Frames.size(); Frame++)
+            m_Frames[Frame - 1] = m_Frames[Frame];
+
+        m_Frames.pop_back();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,107 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CNetworkSimulator.h
+ *  \brief Header file of the network condition simulator
+ */
+
+#ifndef __CNETWORKSIMULATOR_H__
+#define __CNETWORKSIMULATOR_H__
+
+#include "portable_stl/vector/vector.h"
+
+class CNetwork;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A frame waiting in the simulator until it is delivered to the socket
+struct SSimulatedFrame
+{
+    int             SocketType;                     //!< Socket to send the frame to (an ESocketType value)
+    char*           pData;                          //!< Content of the frame
+    int             Size;                           //!< Size of the frame in bytes
+    double          DeliveryTime;                   //!< Time when the frame has to be sent
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Makes a fast connection (usually a loopback one) behave like a bad one, to test the network game.
+
+/**
+ * The frames CNetwork sends (command chunks and snapshots) are held back
+ * for the latency and a random part of the jitter, limited by the bandwidth,
+ * randomly lost or held back longer so that the next frames overtake them.
+ * The random numbers come from a seed, so that a test can be run again
+ * with the same conditions. Anything else sent by CNetwork (such as the
+ * start of a match) is sent at once, after the frames waiting before it.
+ */
+
+class CNetworkSimulator
+{
+private:
+
+    CTimer          m_Timer;                        //!< Timer giving the time the frames are delivered at
+    float           m_Latency;                      //!< Time (in seconds) a frame takes to arrive
+    float           m_Jitter;                       //!< Maximum random time (in seconds) added to or removed from the latency
+    float           m_LossRate;                     //!< Probability (0 to 1) that a frame is lost
+    float           m_ReorderRate;                  //!< Probability (0 to 1) that a frame arrives after the next ones
+    float           m_Bandwidth;                    //!< Maximum number of bytes sent per second, 0 for no limit
+    unsigned int    m_Seed;                         //!< Seed of the random numbers
+    unsigned int    m_RandomState;                  //!< Current state of the random number generator
+    double          m_LinkFreeTime;                 //!< Time when the frames sent before are all on the link, for the bandwidth limit
+    double          m_LatestDeliveryTime;           //!< Delivery time of the latest frame that was not reordered
+    ::portable_stl::vector<SSimulatedFrame> m_Frames; //!< Frames waiting to be delivered
+    int             m_NumberOfFrames;               //!< Number of frames given to the simulator
+    int             m_LostFrames;                   //!< Number of frames that were lost on purpose
+    int             m_ReorderedFrames;              //!< Number of frames that were delivered after the next ones on purpose
+
+    float           Random (void);                  //!< Return a random number between 0 (included) and 1 (excluded)
+    void            DeliverFrames (CNetwork* pNetwork, double Time); //!< Send the frames whose delivery time has come
+
+public:
+
+                    CNetworkSimulator (void);       //!< Constructor. Initialize some members.
+                    ~CNetworkSimulator (void);      //!< Destructor. Does nothing.
+#ifdef WIN32
+    void            ParseCommandLine (const char* pCommandLine); //!< Read the network conditions to simulate
+#else
+    void            ParseCommandLine (char** pCommandLine, int pCommandLineCount); //!< Read the network conditions to simulate
+#endif
+    void            Create (void);                  //!< Start simulating, if any condition is set
+    void            Destroy (void);                 //!< Forget the waiting frames and log what was simulated
+    bool            IsEnabled (void);               //!< Is there any condition to simulate?
+    bool            LosesFrames (void);             //!< Can frames be lost on purpose?
+    void            SendFrame (int SocketType, const char* pData, int Size); //!< Hold the frame back, or lose it
+    void            Update (CNetwork* pNetwork);    //!< Send the frames whose delivery time has come
+    void            Flush (CNetwork* pNetwork);     //!< Send every waiting frame now, in delivery order
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CNETWORKSIMULATOR_H__
@@ -0,0 +1,292 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CNetworkStatistics.cpp
+ *  \brief Network statistics
+ */
+
+#include "StdAfx.h"
+#include "CNetworkStatistics.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+static const char* FrameNames [NUMBER_OF_NETWORKFRAMES] = { "command_chunks", "snapshots" };
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CNetworkStatistics::CNetworkStatistics (void)
+{
+    m_pDumpFile = NULL;
+    m_OverlayVisible = false;
+
+    Reset();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CNetworkStatistics::~CNetworkStatistics (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CNetworkStatistics::Create (const char* pDumpFileName)
+{
+    ASSERT (m_pDumpFile == NULL);
+
+    Reset();
+
+    if (pDumpFileName != NULL)
+    {
+        m_pDumpFile = fopen(pDumpFileName, "w");
+
+        if (m_pDumpFile == NULL)
+        {
+            theLog.WriteLine("Network         => !!! Could not open the statistics file %s.", pDumpFileName);
+            return false;
+        }
+
+        // Write the names of the columns
+        fprintf(m_pDumpFile, "time,rtt_ms,jitter_ms,sent_bytes_per_s,received_bytes_per_s,encode_ms,decode_ms,dropped_frames,duplicate_frames,late_frames,clock_offset_ms,clock_drift_ppm");
+
+        for (int Frame = 0; Frame < NUMBER_OF_NETWORKFRAMES; Frame++)
+        {
+            fprintf(m_pDumpFile, ",%s", FrameNames[Frame]);
+
+            // Each bucket is named after the smallest size it counts
+            for (int Bucket = 0; Bucket < NETWORK_SIZE_BUCKETS; Bucket++)
+                fprintf(m_pDumpFile, ",%s_%d", FrameNames[Frame], 1 << Bucket);
+        }
+
+        fprintf(m_pDumpFile, "\n");
+    }
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::Destroy (void)
+{
+    if (m_pDumpFile != NULL)
+    {
+        // Don't lose what was measured since the latest dump
+        if (m_PeriodStartTime >= 0.0)
+            WriteDump(m_PeriodStartTime);
+
+        fclose(m_pDumpFile);
+        m_pDumpFile = NULL;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::Reset (void)
+{
+    m_PeriodStartTime = -1.0;
+    m_DumpTime = 0.0;
+    m_PeriodBytesSent = 0;
+    m_PeriodBytesReceived = 0;
+    m_PeriodEncodeTime = 0.0f;
+    m_PeriodEncodeCount = 0;
+    m_PeriodDecodeTime = 0.0f;
+    m_PeriodDecodeCount = 0;
+    m_SendRate = 0.0f;
+    m_ReceiveRate = 0.0f;
+    m_EncodeTime = 0.0f;
+    m_DecodeTime = 0.0f;
+    m_RoundTripTime = -1.0f;
+    m_Jitter = 0.0f;
+    m_DroppedFrames = 0;
+    m_DuplicateFrames = 0;
+    m_LateFrames = 0;
+    m_ClockOffset = 0.0f;
+    m_ClockDrift = 0.0f;
+
+    for (int Frame = 0; Frame < NUMBER_OF_NETWORKFRAMES; Frame++)
+    {
+        m_Frames[Frame] = 0;
+
+        for (int Bucket = 0; Bucket < NETWORK_SIZE_BUCKETS; Bucket++)
+            m_Histograms[Frame][Bucket] = 0;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::Update (double Time)
+{
+    // If this is the first update
+    if (m_PeriodStartTime < 0.0)
+    {
+        m_PeriodStartTime = Time;
+        m_DumpTime = Time;
+        return;
+    }
+
+    if (Time - m_PeriodStartTime >= NETWORK_STATISTICS_PERIOD)
+        EndPeriod(Time);
+
+    if (m_pDumpFile != NULL && Time - m_DumpTime >= NETWORK_DUMP_PERIOD)
+    {
+        WriteDump(Time);
+        m_DumpTime = Time;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::EndPeriod (double Time)
+{
+    float Duration = (float)(Time - m_PeriodStartTime);
+
+    m_SendRate = m_PeriodBytesSent / Duration;
+    m_ReceiveRate = m_PeriodBytesReceived / Duration;
+    m_EncodeTime = (m_PeriodEncodeCount > 0 ? m_PeriodEncodeTime / m_PeriodEncodeCount : 0.0f);
+    m_DecodeTime = (m_PeriodDecodeCount > 0 ? m_PeriodDecodeTime / m_PeriodDecodeCount : 0.0f);
+
+    m_PeriodStartTime = Time;
+    m_PeriodBytesSent = 0;
+    m_PeriodBytesReceived = 0;
+    m_PeriodEncodeTime = 0.0f;
+    m_PeriodEncodeCount = 0;
+    m_PeriodDecodeTime = 0.0f;
+    m_PeriodDecodeCount = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::WriteDump (double Time)
+{
+    ASSERT (m_pDumpFile != NULL);
+
+    fprintf(m_pDumpFile, "%.3f,%.1f,%.1f,%.0f,%.0f,%.3f,%.3f,%d,%d,%d,%.1f,%.1f",
+        Time,
+        (m_RoundTripTime >= 0.0f ? m_RoundTripTime * 1000.0f : 0.0f),
+        m_Jitter * 1000.0f,
+        m_SendRate,
+        m_ReceiveRate,
+        m_EncodeTime,
+        m_DecodeTime,
+        m_DroppedFrames,
+        m_DuplicateFrames,
+        m_LateFrames,
+        m_ClockOffset * 1000.0f,
+        m_ClockDrift * 1000000.0f);
+
+    for (int Frame = 0; Frame < NUMBER_OF_NETWORKFRAMES; Frame++)
+    {
+        fprintf(m_pDumpFile, ",%d", m_Frames[Frame]);
+
+        for (int Bucket = 0; Bucket < NETWORK_SIZE_BUCKETS; Bucket++)
+            fprintf(m_pDumpFile, ",%d", m_Histograms[Frame][Bucket]);
+    }
+
+    fprintf(m_pDumpFile, "\n");
+
+    // Let the file be read while the game runs
+    fflush(m_pDumpFile);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::AddBytesSent (int Bytes)
+{
+    m_PeriodBytesSent += Bytes;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::AddBytesReceived (int Bytes)
+{
+    m_PeriodBytesReceived += Bytes;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::AddFrame (ENetworkFrame Frame, int Size)
+{
+    ASSERT (Frame >= 0 && Frame < NUMBER_OF_NETWORKFRAMES);
+    ASSERT (Size > 0);
+
+    // Find the power of two range of the size
+    int Bucket = 0;
+
+    while (Bucket < NETWORK_SIZE_BUCKETS - 1 && (Size >> (Bucket + 1)) > 0)
+        Bucket++;
+
+    m_Frames[Frame]++;
+    m_Histograms[Frame][Bucket]++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::AddEncodeTime (float Time)
+{
+    m_PeriodEncodeTime += Time;
+    m_PeriodEncodeCount++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CNetworkStatistics::AddDecodeTime (float Time)
+{
+    m_PeriodDecodeTime += Time;
+    m_PeriodDecodeCount++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,245 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CNetworkStatistics.h
+ *  \brief Header file of the network statistics
+ */
+
+#ifndef __CNETWORKSTATISTICS_H__
+#define __CNETWORKSTATISTICS_H__
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define NETWORK_STATISTICS_PERIOD       1.0f    //!< Duration (in seconds) over which the rates and the average times are measured
+#define NETWORK_DUMP_PERIOD             10.0f   //!< Time (in seconds) between two lines of the dump file
+#define NETWORK_SIZE_BUCKETS            17      //!< Number of buckets of the size histograms. Bucket N counts the frames of 2^N to 2^(N+1)-1 bytes, the last one the bigger frames.
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Kinds of frames sent through the network
+enum ENetworkFrame
+{
+    NETWORKFRAME_COMMANDCHUNK,
+    NETWORKFRAME_SNAPSHOT,
+    NUMBER_OF_NETWORKFRAMES
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Counters describing the network traffic, shown in the match and written periodically to a CSV file.
+
+/**
+ * The rates and the average times are measured over periods of
+ * NETWORK_STATISTICS_PERIOD seconds, so that they follow the conditions
+ * of the connection. The frame counters and the histograms count
+ * everything since the connection.
+ */
+
+class CNetworkStatistics
+{
+private:
+
+    FILE*           m_pDumpFile;                    //!< CSV file the statistics are written to, NULL if none
+    double          m_PeriodStartTime;              //!< Time when the current measure period started, negative if none started yet
+    double          m_DumpTime;                     //!< Time when the statistics were written to the dump file for the last time
+    int             m_PeriodBytesSent;              //!< Number of bytes sent during the current period
+    int             m_PeriodBytesReceived;          //!< Number of bytes received during the current period
+    float           m_PeriodEncodeTime;             //!< Total time (in milliseconds) spent encoding snapshots during the current period
+    int             m_PeriodEncodeCount;            //!< Number of snapshots encoded during the current period
+    float           m_PeriodDecodeTime;             //!< Total time (in milliseconds) spent decoding snapshots during the current period
+    int             m_PeriodDecodeCount;            //!< Number of snapshots decoded during the current period
+    float           m_SendRate;                     //!< Bytes sent per second during the latest period
+    float           m_ReceiveRate;                  //!< Bytes received per second during the latest period
+    float           m_EncodeTime;                   //!< Average time (in milliseconds) to encode a snapshot during the latest period
+    float           m_DecodeTime;                   //!< Average time (in milliseconds) to decode a snapshot during the latest period
+    float           m_RoundTripTime;                //!< Smoothed round trip time (in seconds), negative if unknown
+    float           m_Jitter;                       //!< Smoothed variation of the round trip time (in seconds)
+    float           m_ClockOffset;                  //!< Match time minus local time (in seconds)
+    float           m_ClockDrift;                   //!< Seconds the match clock gains on the local clock per second
+    int             m_Frames [NUMBER_OF_NETWORKFRAMES];         //!< Number of frames sent of each kind
+    int             m_Histograms [NUMBER_OF_NETWORKFRAMES][NETWORK_SIZE_BUCKETS]; //!< Sizes of the frames sent of each kind
+    int             m_DroppedFrames;                //!< Number of frames received and ignored because they were wrong or a previous one was missing
+    int             m_DuplicateFrames;              //!< Number of frames received twice
+    int             m_LateFrames;                   //!< Number of command chunks that were out of date when they arrived
+    bool            m_OverlayVisible;               //!< Are the statistics shown in the match?
+
+    void            EndPeriod (double Time);        //!< Compute the rates and the average times of the period that ends
+    void            WriteDump (double Time);        //!< Write a line of statistics to the dump file
+
+public:
+
+                    CNetworkStatistics (void);      //!< Constructor. Initialize some members.
+                    ~CNetworkStatistics (void);     //!< Destructor. Does nothing.
+    bool            Create (const char* pDumpFileName); //!< Reset the statistics and open the dump file (NULL for no dump)
+    void            Destroy (void);                 //!< Write the latest statistics and close the dump file
+    void            Reset (void);                   //!< Reset every counter
+    void            Update (double Time);           //!< Measure the current period and dump the statistics when it is time to
+    void            AddBytesSent (int Bytes);       //!< Count bytes sent through the network
+    void            AddBytesReceived (int Bytes);   //!< Count bytes received through the network
+    void            AddFrame (ENetworkFrame Frame, int Size); //!< Count a frame sent through the network, with its size in bytes (checksum included)
+    void            AddEncodeTime (float Time);     //!< Count the time (in milliseconds) spent encoding a snapshot
+    void            AddDecodeTime (float Time);     //!< Count the time (in milliseconds) spent decoding a snapshot
+    inline void     AddDroppedFrame (void);         //!< Count a frame that was received and ignored
+    inline void     AddDuplicateFrame (void);       //!< Count a frame that was received twice
+    inline void     AddLateFrame (void);            //!< Count a command chunk that was out of date when it arrived
+    inline void     SetClock (float Offset, float Drift); //!< Set the latest estimation of the match clock
+    inline void     SetRoundTripTime (float RoundTripTime, float Jitter); //!< Set the latest estimation of the round trip time and its variation (in seconds)
+    inline float    GetSendRate (void);             //!< Bytes sent per second during the latest period
+    inline float    GetReceiveRate (void);          //!< Bytes received per second during the latest period
+    inline float    GetEncodeTime (void);           //!< Average time (in milliseconds) to encode a snapshot during the latest period
+    inline float    GetDecodeTime (void);           //!< Average time (in milliseconds) to decode a snapshot during the latest period
+    inline float    GetRoundTripTime (void);        //!< Smoothed round trip time (in seconds), negative if unknown
+    inline float    GetJitter (void);               //!< Smoothed variation of the round trip time (in seconds)
+    inline int      GetFrames (ENetworkFrame Frame); //!< Number of frames sent of this kind
+    inline int      GetHistogram (ENetworkFrame Frame, int Bucket); //!< Number of frames sent of this kind whose size falls in the bucket
+    inline int      GetDroppedFrames (void);        //!< Number of frames received and ignored
+    inline int      GetDuplicateFrames (void);      //!< Number of frames received twice
+    inline int      GetLateFrames (void);           //!< Number of command chunks that were out of date when they arrived
+    inline float    GetClockOffset (void);          //!< Match time minus local time (in seconds)
+    inline float    GetClockDrift (void);           //!< Seconds the match clock gains on the local clock per second
+    inline bool     IsOverlayVisible (void);        //!< Are the statistics shown in the match?
+    inline void     SetOverlayVisible (bool Visible); //!< Show or hide the statistics in the match
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline void CNetworkStatistics::AddDroppedFrame (void)
+{
+    m_DroppedFrames++;
+}
+
+inline void CNetworkStatistics::AddDuplicateFrame (void)
+{
+    m_DuplicateFrames++;
+}
+
+inline void CNetworkStatistics::AddLateFrame (void)
+{
+    m_LateFrames++;
+}
+
+inline void CNetworkStatistics::SetClock (float Offset, float Drift)
+{
+    m_ClockOffset = Offset;
+    m_ClockDrift = Drift;
+}
+
+inline void CNetworkStatistics::SetRoundTripTime (float RoundTripTime, float Jitter)
+{
+    m_RoundTripTime = RoundTripTime;
+    m_Jitter = Jitter;
+}
+
+inline float CNetworkStatistics::GetSendRate (void)
+{
+    return m_SendRate;
+}
+
+inline float CNetworkStatistics::GetReceiveRate (void)
+{
+    return m_ReceiveRate;
+}
+
+inline float CNetworkStatistics::GetEncodeTime (void)
+{
+    return m_EncodeTime;
+}
+
+inline float CNetworkStatistics::GetDecodeTime (void)
+{
+    return m_DecodeTime;
+}
+
+inline float CNetworkStatistics::GetRoundTripTime (void)
+{
+    return m_RoundTripTime;
+}
+
+inline float CNetworkStatistics::GetJitter (void)
+{
+    return m_Jitter;
+}
+
+inline int CNetworkStatistics::GetFrames (ENetworkFrame Frame)
+{
+    ASSERT (Frame >= 0 && Frame < NUMBER_OF_NETWORKFRAMES);
+
+    return m_Frames[Frame];
+}
+
+inline int CNetworkStatistics::GetHistogram (ENetworkFrame Frame, int Bucket)
+{
+    ASSERT (Frame >= 0 && Frame < NUMBER_OF_NETWORKFRAMES);
+    ASSERT (Bucket >= 0 && Bucket < NETWORK_SIZE_BUCKETS);
+
+    return m_Histograms[Frame][Bucket];
+}
+
+inline int CNetworkStatistics::GetDroppedFrames (void)
+{
+    return m_DroppedFrames;
+}
+
+inline int CNetworkStatistics::GetDuplicateFrames (void)
+{
+    return m_DuplicateFrames;
+}
+
+inline int CNetworkStatistics::GetLateFrames (void)
+{
+    return m_LateFrames;
+}
+
+inline float CNetworkStatistics::GetClockOffset (void)
+{
+    return m_ClockOffset;
+}
+
+inline float CNetworkStatistics::GetClockDrift (void)
+{
+    return m_ClockDrift;
+}
+
+inline bool CNetworkStatistics::IsOverlayVisible (void)
+{
+    return m_OverlayVisible;
+}
+
+inline void CNetworkStatistics::SetOverlayVisible (bool Visible)
+{
+    m_OverlayVisible = Visible;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CNETWORKSTATISTICS_H__
@@ -85,6 +85,9 @@ COptions::COptions (void)
     m_BattleCount = 0;
 
     m_Level = 0;
+
+    m_Scaler = SCALER_HQ2X;
+    m_Scale = 2;
     
     for (int i = 0; i < MAX_PLAYERS; i++)
     {
@@ -147,6 +150,9 @@ COptions& COptions::operator = (const COptions& Copy)
     
     m_Level = Copy.m_Level;
 
+    m_Scaler = Copy.m_Scaler;
+    m_Scale = Copy.m_Scale;
+
     // Copy all the level data files
     m_Levels = Copy.m_Levels;
 
@@ -268,6 +274,10 @@ void COptions::SetDefaultValues(void)
     // First level file (index=0) is selected
     m_Level = 0;
 
+    // The display is doubled and smoothed
+    m_Scaler = SCALER_HQ2X;
+    m_Scale = 2;
+
     // Set the bomber types
     m_BomberType[0] = BOMBERTYPE_MAN;
     m_BomberType[1] = BOMBERTYPE_COM;
@@ -382,6 +392,15 @@ bool COptions::LoadConfiguration (void)
         
         ReadIntFromXML( configDoc, "LevelFileNumber", "value", &m_Level );
 
+        ReadIntFromXML( configDoc, "Scaler", "value", (int*)&m_Scaler );
+        ReadIntFromXML( configDoc, "Scaler", "factor", &m_Scale );
+
+        // Don't trust the configuration file to choose an existing scaler
+        if ( m_Scaler < 0 || m_Scaler >= NUMBER_OF_SCALERS )
+            m_Scaler = SCALER_HQ2X;
+
+        m_Scale = MIN( MAX( m_Scale, 1 ), SCALER_MAX_FACTOR );
+
         for ( int i = 0; i < MAX_PLAYERS; i++ ) {
             char attributeName[16];
             snprintf(attributeName, 16, "bomber%d", i);
@@ -508,6 +527,12 @@ void COptions::WriteXMLData()
     configLevel->SetAttribute( "value", m_Level );
     config->LinkEndChild( configLevel );
 
+    // Scaler (0 = nearest, 1 = hq2x, 2 = xbr) and its magnification
+    TiXmlElement* configScaler = new TiXmlElement( "Scaler" );
+    configScaler->SetAttribute( "value", (int) m_Scaler );
+    configScaler->SetAttribute( "factor", m_Scale );
+    config->LinkEndChild( configScaler );
+
     int i;
 
     // BomberTypes
@@ -37,6 +37,7 @@
 
 #include "CItem.h"
 #include "CLevel.h"
+#include "CScaler.h"
 #include "CTeam.h"
 #include "tinyxml.h"
 
@@ -120,6 +121,8 @@ private:
     int                 m_PlayerInput [MAX_PLAYERS];    //!< Player input to use for each player
     int                 m_Control[MAX_PLAYER_INPUT][NUM_CONTROLS]; //!< Control number to use for each player input and for each control
     int                 m_Level;
+    EScaler             m_Scaler;                       //!< Algorithm enlarging the display
+    int                 m_Scale;                        //!< Magnification of the display (1 to SCALER_MAX_FACTOR)
     ::portable_stl::vector<CLevel> m_Levels;
     ::portable_stl::string         m_programFolder;     //!< Full path of the directory that the program resides
     ::portable_stl::string         m_configFileName;    //!< Full name of the config file (including path)
@@ -170,6 +173,9 @@ public:
     inline int          GetNumberOfLevels (void);
     inline const char*  GetLevelName (void);
     inline EActionAIAlive GetOption_ActionWhenOnlyAIPlayersLeft();
+    inline EScaler      GetScaler (void) const;         //!< Get the algorithm enlarging the display
+    inline int          GetScale (void) const;          //!< Get the magnification of the display
+    inline void         SetScaler (EScaler Scaler, int Scale); //!< Set the algorithm and the magnification of the display
 
     inline void         SetBattleMode(EBattleMode BattleMode);
     inline EBattleMode  GetBattleMode();
@@ -240,6 +246,22 @@ inline EBattleMode COptions::GetBattleMode(void)
     return m_BattleMode;
 }
 
+inline EScaler COptions::GetScaler (void) const
+{
+    return m_Scaler;
+}
+
+inline int COptions::GetScale (void) const
+{
+    return m_Scale;
+}
+
+inline void COptions::SetScaler (EScaler Scaler, int Scale)
+{
+    m_Scaler = Scaler;
+    m_Scale = MIN(MAX(Scale, 1), SCALER_MAX_FACTOR);
+}
+
 inline int COptions::GetBattleCount (void)
 {
     return m_BattleCount;
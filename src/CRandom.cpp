@@ -0,0 +1,102 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CRandom.cpp
+ *  \brief Random numbers drawn by RANDOM()
+ */
+
+#include "StdAfx.h"
+#include "CRandom.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+static thread_local CRandom* pCurrentRandom = NULL;    //!< Generator RANDOM() draws from on this thread, NULL for rand()
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CRandom::CRandom (void)
+{
+    m_State = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CRandom::Seed (unsigned int Seed)
+{
+    m_State = Seed;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CRandom::Next (void)
+{
+    // Same linear congruential generator on every platform, unlike rand()
+    m_State = m_State * 1103515245 + 12345;
+
+    return (int)((m_State >> 8) & 0xFFFFFF);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CRandom::SetCurrent (CRandom* pRandom)
+{
+    pCurrentRandom = pRandom;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CRandom::SeedCurrent (unsigned int Seed)
+{
+    if (pCurrentRandom != NULL)
+        pCurrentRandom->Seed(Seed);
+    else
+        srand(Seed);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CRandom::NextCurrent (void)
+{
+    return (pCurrentRandom != NULL ? pCurrentRandom->Next() : rand());
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,66 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CRandom.h
+ *  \brief Header file of the random numbers drawn by RANDOM()
+ */
+
+#ifndef __CRANDOM_H__
+#define __CRANDOM_H__
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Random numbers that are the same on every computer for the same seed.
+
+/**
+ * RANDOM() and SEED_RANDOM() use rand() and srand(), unless a generator
+ * was made current on the calling thread with SetCurrent(). A network
+ * match makes its own generator current while it is created and updated,
+ * so that it draws the same numbers on the server and on the clients,
+ * whatever the platform and whatever the other matches updated at the
+ * same time by other threads.
+ */
+
+class CRandom
+{
+private:
+
+    unsigned int    m_State;                        //!< Current state of the linear congruential generator
+
+public:
+
+                    CRandom (void);                 //!< Constructor. Seed the generator with zero.
+    void            Seed (unsigned int Seed);       //!< Start the random numbers from the seed
+    int             Next (void);                    //!< Return the next random number, from 0 to 0xFFFFFF
+    static void     SetCurrent (CRandom* pRandom);  //!< Make RANDOM() draw from the generator on the calling thread, NULL for rand()
+    static void     SeedCurrent (unsigned int Seed); //!< Seed the current generator of the calling thread, or rand() if there is none
+    static int      NextCurrent (void);             //!< Return a number of the current generator of the calling thread, or of rand() if there is none
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CRANDOM_H__
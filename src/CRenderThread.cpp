@@ -0,0 +1,313 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CRenderThread.cpp
+ *  \brief Render thread
+ */
+
+#include "StdAfx.h"
+#include "CRenderThread.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define RENDERFRAME_NEW             4       //!< Flag added to the number of the waiting frame when it was published and not taken yet
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+struct SRenderThreadState
+{
+    std::thread             Thread;                     //!< Render thread, not joinable if the frames are rendered by Publish()
+    std::atomic<int>        WaitingFrame;               //!< Frame between the recorded and the rendered ones, with RENDERFRAME_NEW if it was published and not taken
+    std::atomic<bool>       FrameRendered;              //!< Is a rendered frame waiting to be presented?
+    std::mutex              Mutex;                      //!< Only protects the sleep of the threads, never the frames
+    std::condition_variable WorkAvailable;              //!< Signaled when a frame is published, presented, or when the thread has to quit
+    std::condition_variable WorkDone;                   //!< Signaled when a frame is rendered
+    bool                    Busy;                       //!< Is the render thread rendering a frame?
+    bool                    Quit;                       //!< Does the render thread have to quit?
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CRenderThread::CRenderThread (void)
+{
+    m_pState = NULL;
+    m_pFunction = NULL;
+    m_pParameter = NULL;
+    m_RecordingFrame = 0;
+    m_RenderingFrame = 1;
+    m_RenderTime = 0.0;
+    m_NumberOfRenderedFrames = 0;
+    m_NumberOfPublishedFrames = 0;
+    m_NumberOfDroppedFrames = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CRenderThread::~CRenderThread (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CRenderThread::Create (LPRENDERFUNCTION pFunction, void* pParameter)
+{
+    ASSERT (m_pState == NULL);
+    ASSERT (pFunction != NULL);
+
+    m_pFunction = pFunction;
+    m_pParameter = pParameter;
+    m_RecordingFrame = 0;
+    m_RenderingFrame = 1;
+    m_RenderTime = 0.0;
+    m_NumberOfRenderedFrames = 0;
+    m_NumberOfPublishedFrames = 0;
+    m_NumberOfDroppedFrames = 0;
+
+    m_pState = new SRenderThreadState;
+    m_pState->WaitingFrame = 2;
+    m_pState->FrameRendered = false;
+    m_pState->Busy = false;
+    m_pState->Quit = false;
+
+    // On a single core, the thread would only take turns with the recording thread
+    if (std::thread::hardware_concurrency() > 1)
+        m_pState->Thread = std::thread(&CRenderThread::RenderThread, this);
+
+    theLog.WriteLine("RenderThread    => Frames are rendered %s.", (IsThreaded() ? "on a thread of their own" : "by the recording thread"));
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CRenderThread::Destroy (void)
+{
+    if (m_pState == NULL)
+        return;
+
+    if (IsThreaded())
+    {
+        // Wake the render thread up and tell it to quit
+        {
+            std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+            m_pState->Quit = true;
+        }
+
+        m_pState->WorkAvailable.notify_all();
+        m_pState->Thread.join();
+    }
+
+    if (m_NumberOfRenderedFrames > 0)
+    {
+        theLog.WriteLine("RenderThread    => %d frame(s) rendered in %.3f ms on average, %d of the %d published frame(s) dropped.",
+            m_NumberOfRenderedFrames, m_RenderTime * 1000.0 / m_NumberOfRenderedFrames, m_NumberOfDroppedFrames, m_NumberOfPublishedFrames);
+    }
+
+    delete m_pState;
+    m_pState = NULL;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CRenderThread::IsThreaded (void)
+{
+    return m_pState != NULL && m_pState->Thread.joinable();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The recorded frame becomes the waiting one, and the previous waiting
+ *  frame becomes the one to record in. If the render thread did not take
+ *  the previous waiting frame, it is dropped : the render thread will
+ *  take the newest frame instead.
+ */
+
+bool CRenderThread::Publish (void)
+{
+    ASSERT (m_pState != NULL);
+
+    m_NumberOfPublishedFrames++;
+
+    // Without a thread, render the frame now and record the next one in the same frame
+    if (!IsThreaded())
+    {
+        m_RenderingFrame = m_RecordingFrame;
+        Render();
+        m_pState->FrameRendered = true;
+        return false;
+    }
+
+    int Previous = m_pState->WaitingFrame.exchange(m_RecordingFrame | RENDERFRAME_NEW, std::memory_order_acq_rel);
+
+    m_RecordingFrame = Previous & ~RENDERFRAME_NEW;
+
+    bool Dropped = ((Previous & RENDERFRAME_NEW) != 0);
+
+    if (Dropped)
+        m_NumberOfDroppedFrames++;
+
+    // Lock so that the render thread cannot miss the wake up between its test and its sleep
+    {
+        std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+    }
+
+    m_pState->WorkAvailable.notify_one();
+
+    return Dropped;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CRenderThread::IsFrameRendered (void)
+{
+    return m_pState != NULL && m_pState->FrameRendered.load(std::memory_order_acquire);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CRenderThread::EndPresent (void)
+{
+    ASSERT (m_pState != NULL);
+
+    m_pState->FrameRendered.store(false, std::memory_order_release);
+
+    if (IsThreaded())
+    {
+        {
+            std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+        }
+
+        m_pState->WorkAvailable.notify_one();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The render thread stops either because every published frame is
+ *  rendered and presented, or because it waits for a present. So the
+ *  recording thread has to present and wait again until nothing is
+ *  left to render, before it touches what the frames use.
+ */
+
+void CRenderThread::Wait (void)
+{
+    if (!IsThreaded())
+        return;
+
+    std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+
+    while (m_pState->Busy ||
+           ((m_pState->WaitingFrame.load(std::memory_order_acquire) & RENDERFRAME_NEW) != 0 &&
+            !m_pState->FrameRendered.load(std::memory_order_acquire)))
+    {
+        m_pState->WorkDone.wait(Lock);
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CRenderThread::Render (void)
+{
+    double StartTime = m_Timer.GetElapsedTime();
+
+    m_pFunction(m_pParameter, m_RenderingFrame);
+
+    m_RenderTime += m_Timer.GetElapsedTime() - StartTime;
+    m_NumberOfRenderedFrames++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CRenderThread::RenderThread (void)
+{
+    std::unique_lock<std::mutex> Lock(m_pState->Mutex);
+
+    while (true)
+    {
+        // Wait for a new frame, once the previous one is presented
+        while (!m_pState->Quit &&
+               ((m_pState->WaitingFrame.load(std::memory_order_acquire) & RENDERFRAME_NEW) == 0 ||
+                m_pState->FrameRendered.load(std::memory_order_acquire)))
+        {
+            m_pState->WorkAvailable.wait(Lock);
+        }
+
+        if (m_pState->Quit)
+            break;
+
+        m_pState->Busy = true;
+        Lock.unlock();
+
+        // Take the newest frame and give the rendered one back to the waiting place
+        m_RenderingFrame = m_pState->WaitingFrame.exchange(m_RenderingFrame, std::memory_order_acq_rel) & ~RENDERFRAME_NEW;
+
+        Render();
+
+        m_pState->FrameRendered.store(true, std::memory_order_release);
+
+        Lock.lock();
+        m_pState->Busy = false;
+        m_pState->WorkDone.notify_all();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,115 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CRenderThread.h
+ *  \brief Header file of the render thread
+ */
+
+#ifndef __CRENDERTHREAD_H__
+#define __CRENDERTHREAD_H__
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define RENDER_FRAMES               3       //!< Number of frames : one recorded, one rendered and one waiting between them
+
+//! Function rendering a frame. It receives the parameter given to Create() and the number of the frame to render.
+typedef void (*LPRENDERFUNCTION) (void* pParameter, int Frame);
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+// The standard thread classes are only used in CRenderThread.cpp, because
+// the standard headers conflict with the portable STL ones included before.
+struct SRenderThreadState;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Renders the frames on a thread of its own while the next frames are recorded.
+
+/**
+ * The owner keeps RENDER_FRAMES frames (lists of drawing requests for
+ * instance) and records a frame in the one GetRecordingFrame() gives.
+ * Publish() hands it to the render thread and gives another frame to
+ * record. The frames are exchanged through a triple buffer : publishing
+ * and taking a frame is a single atomic exchange of their numbers, so
+ * the thread recording never waits for the render thread. If it records
+ * faster than the frames are rendered, the frames that were published and
+ * not taken yet are given back to record again (they are dropped).
+ *
+ * Once a frame is rendered, the render thread waits until the recording
+ * thread presented it (IsFrameRendered() then EndPresent()), because the
+ * next frame would be rendered over it. On a single core, there is no
+ * thread : Publish() renders the frame at once.
+ */
+
+class CRenderThread
+{
+private:
+
+    SRenderThreadState*     m_pState;                   //!< Render thread and what it shares with the recording thread
+    LPRENDERFUNCTION        m_pFunction;                //!< Function rendering a frame
+    void*                   m_pParameter;               //!< Parameter to give to the function
+    int                     m_RecordingFrame;           //!< Frame being recorded (only used by the recording thread)
+    int                     m_RenderingFrame;           //!< Frame being rendered (only used by the render thread)
+    CTimer                  m_Timer;                    //!< Timer measuring the rendering (only used by the render thread)
+    double                  m_RenderTime;               //!< Time (in seconds) spent rendering the frames
+    int                     m_NumberOfRenderedFrames;   //!< Number of frames rendered
+    int                     m_NumberOfPublishedFrames;  //!< Number of frames published
+    int                     m_NumberOfDroppedFrames;    //!< Number of frames published and given back before they were rendered
+
+    void                    RenderThread (void);        //!< Main function of the render thread
+    void                    Render (void);              //!< Render the frame taken and measure it
+
+public:
+
+                            CRenderThread (void);       //!< Constructor. Initialize some members.
+                            ~CRenderThread (void);      //!< Destructor. Does nothing.
+    bool                    Create (LPRENDERFUNCTION pFunction, void* pParameter); //!< Start the render thread, if there is more than one core
+    void                    Destroy (void);             //!< Stop the render thread and log what it did. The frames must be finished.
+    bool                    IsThreaded (void);          //!< Are the frames rendered by a thread of their own? (false before Create())
+    inline int              GetRecordingFrame (void);   //!< Return the number of the frame to record in
+    bool                    Publish (void);             //!< Hand the recorded frame to the render thread. Return true if the frame to record in was dropped.
+    bool                    IsFrameRendered (void);     //!< Is a rendered frame waiting to be presented? (false before Create())
+    void                    EndPresent (void);          //!< Tell the render thread the rendered frame was presented
+    void                    Wait (void);                //!< Wait until the render thread has no frame to render, or waits for a present
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline int CRenderThread::GetRecordingFrame (void)
+{
+    return m_RecordingFrame;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CRENDERTHREAD_H__
@@ -0,0 +1,257 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CScaler.cpp
+ *  \brief Scalers enlarging the display
+ */
+
+#include "StdAfx.h"
+#include "CScaler.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CScaler::~CScaler (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CScalerNearest::CScalerNearest (void)
+{
+    m_Factor = 2;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CScalerNearest::~CScalerNearest (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CScalerNearest::SetFactor (int Factor)
+{
+    ASSERT (Factor >= 1 && Factor <= SCALER_MAX_FACTOR);
+
+    m_Factor = Factor;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+const char* CScalerNearest::GetName (void) const
+{
+    return "nearest";
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+const char* CScalerNearest::GetKernelName (void) const
+{
+#if defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CScalerNearest::GetFactor (void) const
+{
+    return m_Factor;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CScalerNearest::GetBorder (void) const
+{
+    // A pixel only gives its own square
+    return 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The first output row of each image row is written, four image pixels
+ *  at a time with SSE2, then copied to the other output rows.
+ */
+
+void CScalerNearest::Scale (const uint32_t* pImage, int Width, int Height, uint32_t* pOutput, int X1, int Y1, int X2, int Y2) const
+{
+    ASSERT (X1 >= 0 && X1 <= X2 && X2 <= Width);
+    ASSERT (Y1 >= 0 && Y1 <= Y2 && Y2 <= Height);
+    (void)Height;   // Only checked in debug builds
+
+    const int Factor = m_Factor;
+    const int OutputWidth = Width * Factor;
+
+    for (int Y = Y1; Y < Y2; Y++)
+    {
+        const uint32_t* pRow = pImage + Y * Width;
+        uint32_t* pOutputRow = pOutput + Y * Factor * OutputWidth;
+        int X = X1;
+
+#if defined(__SSE2__)
+        if (Factor == 2)
+        {
+            for (; X + 4 <= X2; X += 4)
+            {
+                __m128i Pixels = _mm_loadu_si128((const __m128i*)(pRow + X));
+
+                _mm_storeu_si128((__m128i*)(pOutputRow + 2 * X), _mm_unpacklo_epi32(Pixels, Pixels));
+                _mm_storeu_si128((__m128i*)(pOutputRow + 2 * X + 4), _mm_unpackhi_epi32(Pixels, Pixels));
+            }
+        }
+        else if (Factor == 3)
+        {
+            for (; X + 4 <= X2; X += 4)
+            {
+                __m128i Pixels = _mm_loadu_si128((const __m128i*)(pRow + X));
+
+                _mm_storeu_si128((__m128i*)(pOutputRow + 3 * X), _mm_shuffle_epi32(Pixels, 0x40));
+                _mm_storeu_si128((__m128i*)(pOutputRow + 3 * X + 4), _mm_shuffle_epi32(Pixels, 0xA5));
+                _mm_storeu_si128((__m128i*)(pOutputRow + 3 * X + 8), _mm_shuffle_epi32(Pixels, 0xFE));
+            }
+        }
+        else if (Factor == 4)
+        {
+            for (; X + 4 <= X2; X += 4)
+            {
+                __m128i Pixels = _mm_loadu_si128((const __m128i*)(pRow + X));
+
+                _mm_storeu_si128((__m128i*)(pOutputRow + 4 * X), _mm_shuffle_epi32(Pixels, 0x00));
+                _mm_storeu_si128((__m128i*)(pOutputRow + 4 * X + 4), _mm_shuffle_epi32(Pixels, 0x55));
+                _mm_storeu_si128((__m128i*)(pOutputRow + 4 * X + 8), _mm_shuffle_epi32(Pixels, 0xAA));
+                _mm_storeu_si128((__m128i*)(pOutputRow + 4 * X + 12), _mm_shuffle_epi32(Pixels, 0xFF));
+            }
+        }
+#endif
+
+        // The pixels left (or all of them without SSE2)
+        for (; X < X2; X++)
+        {
+            for (int Copy = 0; Copy < Factor; Copy++)
+                pOutputRow[Factor * X + Copy] = pRow[X];
+        }
+
+        for (int Copy = 1; Copy < Factor; Copy++)
+            memcpy(pOutputRow + Copy * OutputWidth + Factor * X1, pOutputRow + Factor * X1, (X2 - X1) * Factor * sizeof(uint32_t));
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CScalerHQ2x::CScalerHQ2x (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CScalerHQ2x::~CScalerHQ2x (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+const char* CScalerHQ2x::GetName (void) const
+{
+    return "hq2x";
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+const char* CScalerHQ2x::GetKernelName (void) const
+{
+    return HQ2x::kernelName();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CScalerHQ2x::GetFactor (void) const
+{
+    return 2;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CScalerHQ2x::GetBorder (void) const
+{
+    // The 8 neighbors give the shape
+    return 1;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CScalerHQ2x::Scale (const uint32_t* pImage, int Width, int Height, uint32_t* pOutput, int X1, int Y1, int X2, int Y2) const
+{
+    m_HQ2x.resizeRect(pImage, Width, Height, pOutput, X1, Y1, X2, Y2);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
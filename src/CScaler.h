@@ -0,0 +1,138 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CScaler.h
+ *  \brief Header file of the scalers enlarging the display
+ */
+
+#ifndef __CSCALER_H__
+#define __CSCALER_H__
+
+#include <stdint.h>
+
+#include "hqx/HQ2x.hh"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define SCALER_MAX_FACTOR           4       //!< Maximum magnification of the display
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Algorithms the display can be enlarged with
+enum EScaler
+{
+    SCALER_NEAREST,         //!< Each pixel becomes a square of the same color, the fastest
+    SCALER_HQ2X,            //!< HQ2x, smooths the edges by looking up the shape of the neighbors
+    SCALER_XBR,             //!< xBR, smooths the edges by comparing their directions
+    NUMBER_OF_SCALERS
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Enlarges an image by an integer factor, one rectangle at a time.
+
+/**
+ * The output is Factor times wider and higher than the image. A scaler
+ * can be asked to scale several rectangles of the same image at the same
+ * time (from different threads) as long as they don't overlap. The
+ * pixels around a rectangle are read as neighbors : the output of the
+ * pixels up to GetBorder() pixels away from a changed pixel changes too.
+ */
+
+class CScaler
+{
+public:
+
+    virtual             ~CScaler (void);            //!< Destructor. Does nothing.
+    virtual const char* GetName (void) const = 0;   //!< Name of the algorithm
+    virtual const char* GetKernelName (void) const = 0; //!< Name of the instructions the algorithm is implemented with
+    virtual int         GetFactor (void) const = 0; //!< Magnification of the image
+    virtual int         GetBorder (void) const = 0; //!< Distance (in pixels) of the farthest neighbor read around a pixel
+    virtual void        Scale (const uint32_t* pImage,
+                               int Width,
+                               int Height,
+                               uint32_t* pOutput,
+                               int X1,
+                               int Y1,
+                               int X2,
+                               int Y2) const = 0;   //!< Scale the pixels of the columns [X1, X2) in the rows [Y1, Y2)
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Repeats each pixel in a square of Factor by Factor pixels.
+
+class CScalerNearest : public CScaler
+{
+private:
+
+    int                 m_Factor;                   //!< Magnification of the image
+
+public:
+
+                        CScalerNearest (void);      //!< Constructor. Initialize some members.
+    virtual             ~CScalerNearest (void);     //!< Destructor. Does nothing.
+    void                SetFactor (int Factor);     //!< Set the magnification (1 to SCALER_MAX_FACTOR)
+    virtual const char* GetName (void) const;
+    virtual const char* GetKernelName (void) const;
+    virtual int         GetFactor (void) const;
+    virtual int         GetBorder (void) const;
+    virtual void        Scale (const uint32_t* pImage, int Width, int Height, uint32_t* pOutput, int X1, int Y1, int X2, int Y2) const;
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Doubles the image with the HQ2x algorithm (see hqx/HQ2x.hh).
+
+class CScalerHQ2x : public CScaler
+{
+private:
+
+    HQ2x                m_HQ2x;                     //!< Implementation of the algorithm
+
+public:
+
+                        CScalerHQ2x (void);         //!< Constructor. Does nothing.
+    virtual             ~CScalerHQ2x (void);        //!< Destructor. Does nothing.
+    virtual const char* GetName (void) const;
+    virtual const char* GetKernelName (void) const;
+    virtual int         GetFactor (void) const;
+    virtual int         GetBorder (void) const;
+    virtual void        Scale (const uint32_t* pImage, int Width, int Height, uint32_t* pOutput, int X1, int Y1, int X2, int Y2) const;
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CSCALER_H__
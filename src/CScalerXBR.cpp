@@ -0,0 +1,320 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CScalerXBR.cpp
+ *  \brief xBR scaler
+ */
+
+#include "StdAfx.h"
+#include "CScalerXBR.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define XBR_EQUAL_THRESHOLD     155     //!< Colors closer than this distance are considered equal
+
+//! Offsets of the neighbors of the pixel for the bottom right corner, the other corners are rotations of it
+/*
+ *          A1 B1 C1
+ *       A0 PA PB PC C4
+ *       D0 PD PE PF F4
+ *       G0 PG PH PI I4
+ *          G5 H5 I5
+ */
+enum EXBRNeighbor
+{
+    XBR_PA, XBR_PB, XBR_PC, XBR_PD, XBR_PF, XBR_PG, XBR_PH, XBR_PI,
+    XBR_A1, XBR_B1, XBR_C1, XBR_A0, XBR_D0, XBR_G0, XBR_C4, XBR_F4, XBR_I4, XBR_G5, XBR_H5, XBR_I5,
+    NUMBER_OF_XBR_NEIGHBORS
+};
+
+static const int NeighborOffsets [NUMBER_OF_XBR_NEIGHBORS][2] =
+{
+    { -1, -1 }, {  0, -1 }, {  1, -1 }, { -1,  0 }, {  1,  0 }, { -1,  1 }, {  0,  1 }, {  1,  1 },
+    { -1, -2 }, {  0, -2 }, {  1, -2 }, { -2, -1 }, { -2,  0 }, { -2,  1 }, {  2, -1 }, {  2,  0 }, {  2,  1 }, { -1,  2 }, {  0,  2 }, {  1,  2 }
+};
+
+//! Rotations turning each corner into the bottom right one : X' = [0] * X + [1] * Y, Y' = [2] * X + [3] * Y
+static const int CornerRotations [4][4] =
+{
+    {  1,  0,  0,  1 },     // Bottom right
+    {  0, -1,  1,  0 },     // Bottom left
+    { -1,  0,  0, -1 },     // Top left
+    {  0,  1, -1,  0 }      // Top right
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CScalerXBR::CScalerXBR (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CScalerXBR::~CScalerXBR (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+const char* CScalerXBR::GetName (void) const
+{
+    return "xbr";
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+const char* CScalerXBR::GetKernelName (void) const
+{
+    return "scalar";
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CScalerXBR::GetFactor (void) const
+{
+    return 2;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CScalerXBR::GetBorder (void) const
+{
+    // The edges are followed two pixels away
+    return 2;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline uint32_t CScalerXBR::Distance (uint32_t YUV1, uint32_t YUV2)
+{
+    int Y = (int)((YUV1 >> 16) & 0xFF) - (int)((YUV2 >> 16) & 0xFF);
+    int U = (int)((YUV1 >> 8) & 0xFF) - (int)((YUV2 >> 8) & 0xFF);
+    int V = (int)(YUV1 & 0xFF) - (int)(YUV2 & 0xFF);
+
+    return 48 * ABS(Y) + 7 * ABS(U) + 6 * ABS(V);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline uint32_t CScalerXBR::Blend (uint32_t Color1, uint32_t Color2, uint32_t Weight2)
+{
+    uint32_t Weight1 = 256 - Weight2;
+
+    // Two components at a time, they can't overflow on each other
+    uint32_t RB = (((Color1 & 0x00FF00FF) * Weight1 + (Color2 & 0x00FF00FF) * Weight2) >> 8) & 0x00FF00FF;
+    uint32_t AG = (((Color1 >> 8) & 0x00FF00FF) * Weight1 + ((Color2 >> 8) & 0x00FF00FF) * Weight2) & 0xFF00FF00;
+
+    return AG | RB;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The 5x5 pixels around the pixel, and their YUV colors, slide along
+ *  the row so that only one new column is read for each pixel. The
+ *  neighbors outside the image are the pixels of its border.
+ */
+
+void CScalerXBR::Scale (const uint32_t* pImage, int Width, int Height, uint32_t* pOutput, int X1, int Y1, int X2, int Y2) const
+{
+    ASSERT (X1 >= 0 && X1 <= X2 && X2 <= Width);
+    ASSERT (Y1 >= 0 && Y1 <= Y2 && Y2 <= Height);
+
+    const int OutputWidth = Width * 2;
+
+    // Position of each neighbor of each corner in the 5x5 pixels
+    int Neighbors [4][NUMBER_OF_XBR_NEIGHBORS];
+
+    for (int Corner = 0; Corner < 4; Corner++)
+    {
+        const int* pRotation = CornerRotations[Corner];
+
+        for (int Neighbor = 0; Neighbor < NUMBER_OF_XBR_NEIGHBORS; Neighbor++)
+        {
+            int OffsetX = pRotation[0] * NeighborOffsets[Neighbor][0] + pRotation[1] * NeighborOffsets[Neighbor][1];
+            int OffsetY = pRotation[2] * NeighborOffsets[Neighbor][0] + pRotation[3] * NeighborOffsets[Neighbor][1];
+
+            Neighbors[Corner][Neighbor] = (OffsetY + 2) * 5 + OffsetX + 2;
+        }
+    }
+
+    for (int Y = Y1; Y < Y2; Y++)
+    {
+        uint32_t Grid [5 * 5];
+        uint32_t GridYUV [5 * 5];
+        const uint32_t* pRows [5];
+
+        for (int Row = 0; Row < 5; Row++)
+            pRows[Row] = pImage + MIN(MAX(Y + Row - 2, 0), Height - 1) * Width;
+
+        // The columns on the left of the first pixel
+        for (int Column = 0; Column < 4; Column++)
+        {
+            int GridX = MIN(MAX(X1 + Column - 2, 0), Width - 1);
+
+            for (int Row = 0; Row < 5; Row++)
+            {
+                Grid[Row * 5 + Column + 1] = pRows[Row][GridX];
+                GridYUV[Row * 5 + Column + 1] = HQ2x::ARGBtoAYUV(pRows[Row][GridX]);
+            }
+        }
+
+        for (int X = X1; X < X2; X++)
+        {
+            // Slide the 5x5 pixels by one column
+            int GridX = MIN(X + 2, Width - 1);
+
+            for (int Row = 0; Row < 5; Row++)
+            {
+                for (int Column = 0; Column < 4; Column++)
+                {
+                    Grid[Row * 5 + Column] = Grid[Row * 5 + Column + 1];
+                    GridYUV[Row * 5 + Column] = GridYUV[Row * 5 + Column + 1];
+                }
+
+                Grid[Row * 5 + 4] = pRows[Row][GridX];
+                GridYUV[Row * 5 + 4] = HQ2x::ARGBtoAYUV(pRows[Row][GridX]);
+            }
+
+            uint32_t PE = Grid[2 * 5 + 2];
+            uint32_t YUVE = GridYUV[2 * 5 + 2];
+
+            // The 2x2 pixels the pixel becomes, [Y][X]
+            uint32_t Output [2][2] = { { PE, PE }, { PE, PE } };
+
+            for (int Corner = 0; Corner < 4; Corner++)
+            {
+                const int* pRotation = CornerRotations[Corner];
+                uint32_t P [NUMBER_OF_XBR_NEIGHBORS];
+                uint32_t YUV [NUMBER_OF_XBR_NEIGHBORS];
+
+                for (int Neighbor = 0; Neighbor < NUMBER_OF_XBR_NEIGHBORS; Neighbor++)
+                {
+                    P[Neighbor] = Grid[Neighbors[Corner][Neighbor]];
+                    YUV[Neighbor] = GridYUV[Neighbors[Corner][Neighbor]];
+                }
+
+                // Nothing to smooth if the corner is inside a flat zone
+                if (PE == P[XBR_PH] || PE == P[XBR_PF])
+                    continue;
+
+                // Sum of the distances along the corner diagonal (an edge there) and across it
+                uint32_t EdgeAlong = Distance(YUVE, YUV[XBR_PC]) + Distance(YUVE, YUV[XBR_PG]) +
+                                     Distance(YUV[XBR_PI], YUV[XBR_H5]) + Distance(YUV[XBR_PI], YUV[XBR_F4]) +
+                                     4 * Distance(YUV[XBR_PH], YUV[XBR_PF]);
+                uint32_t EdgeAcross = Distance(YUV[XBR_PH], YUV[XBR_PD]) + Distance(YUV[XBR_PH], YUV[XBR_I5]) +
+                                      Distance(YUV[XBR_PF], YUV[XBR_I4]) + Distance(YUV[XBR_PF], YUV[XBR_PB]) +
+                                      4 * Distance(YUVE, YUV[XBR_PI]);
+
+                if (EdgeAlong >= EdgeAcross)
+                    continue;
+
+                bool FB = (Distance(YUV[XBR_PF], YUV[XBR_PB]) < XBR_EQUAL_THRESHOLD);
+                bool HD = (Distance(YUV[XBR_PH], YUV[XBR_PD]) < XBR_EQUAL_THRESHOLD);
+                bool EI = (Distance(YUVE, YUV[XBR_PI]) < XBR_EQUAL_THRESHOLD);
+                bool FI4 = (Distance(YUV[XBR_PF], YUV[XBR_I4]) < XBR_EQUAL_THRESHOLD);
+                bool HI5 = (Distance(YUV[XBR_PH], YUV[XBR_I5]) < XBR_EQUAL_THRESHOLD);
+                bool EG = (Distance(YUVE, YUV[XBR_PG]) < XBR_EQUAL_THRESHOLD);
+                bool EC = (Distance(YUVE, YUV[XBR_PC]) < XBR_EQUAL_THRESHOLD);
+
+                // Only smooth real edges, not the corners of thin lines
+                if (!((!FB && !HD) || (EI && !FI4 && !HI5) || EG || EC))
+                    continue;
+
+                // Blend with the closest neighbor of the corner
+                uint32_t Color = (Distance(YUVE, YUV[XBR_PF]) <= Distance(YUVE, YUV[XBR_PH]) ? P[XBR_PF] : P[XBR_PH]);
+
+                // Output pixels of the corner (canonical +1,+1), along F (+1,-1) and along H (-1,+1)
+                int CornerX = (pRotation[0] + pRotation[1] > 0 ? 1 : 0);
+                int CornerY = (pRotation[2] + pRotation[3] > 0 ? 1 : 0);
+                int AlongFX = (pRotation[0] - pRotation[1] > 0 ? 1 : 0);
+                int AlongFY = (pRotation[2] - pRotation[3] > 0 ? 1 : 0);
+                int AlongHX = (pRotation[1] - pRotation[0] > 0 ? 1 : 0);
+                int AlongHY = (pRotation[3] - pRotation[2] > 0 ? 1 : 0);
+
+                // The slope of the edge tells which of the pixels next to the corner it crosses
+                uint32_t KE = Distance(YUV[XBR_PF], YUV[XBR_PG]);
+                uint32_t KI = Distance(YUV[XBR_PH], YUV[XBR_PC]);
+                bool Shallow = (2 * KE <= KI && PE != P[XBR_PG] && P[XBR_PD] != P[XBR_PG]);
+                bool Steep = (KE >= 2 * KI && PE != P[XBR_PC] && P[XBR_PB] != P[XBR_PC]);
+
+                if (Shallow && Steep)
+                {
+                    Output[CornerY][CornerX] = Blend(Output[CornerY][CornerX], Color, 224);
+                    Output[AlongHY][AlongHX] = Blend(Output[AlongHY][AlongHX], Color, 64);
+                    Output[AlongFY][AlongFX] = Output[AlongHY][AlongHX];
+                }
+                else if (Shallow)
+                {
+                    Output[CornerY][CornerX] = Blend(Output[CornerY][CornerX], Color, 192);
+                    Output[AlongHY][AlongHX] = Blend(Output[AlongHY][AlongHX], Color, 64);
+                }
+                else if (Steep)
+                {
+                    Output[CornerY][CornerX] = Blend(Output[CornerY][CornerX], Color, 192);
+                    Output[AlongFY][AlongFX] = Blend(Output[AlongFY][AlongFX], Color, 64);
+                }
+                else
+                {
+                    Output[CornerY][CornerX] = Blend(Output[CornerY][CornerX], Color, 128);
+                }
+            }
+
+            uint32_t* pOutputPixel = pOutput + 2 * Y * OutputWidth + 2 * X;
+
+            pOutputPixel[0] = Output[0][0];
+            pOutputPixel[1] = Output[0][1];
+            pOutputPixel[OutputWidth] = Output[1][0];
+            pOutputPixel[OutputWidth + 1] = Output[1][1];
+        }
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
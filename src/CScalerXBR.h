@@ -0,0 +1,70 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CScalerXBR.h
+ *  \brief Header file of the xBR scaler
+ */
+
+#ifndef __CSCALERXBR_H__
+#define __CSCALERXBR_H__
+
+#include "CScaler.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Doubles the image with the xBR algorithm (level 1) by Hyllian.
+
+/**
+ * Each corner of the square a pixel becomes is looked at on its own : if
+ * the edge along the corner diagonal is more likely than the edge across
+ * it (the sums of the color distances along each direction are compared),
+ * the corner is blended with the closest of the two neighbors of the
+ * corner. The slope of the edge chooses how many of the output pixels are
+ * blended, and how much. The color distances are measured in YUV, like HQ2x.
+ */
+
+class CScalerXBR : public CScaler
+{
+private:
+
+    static inline uint32_t Distance (uint32_t YUV1, uint32_t YUV2); //!< Weighted distance between two YUV colors
+    static inline uint32_t Blend (uint32_t Color1, uint32_t Color2, uint32_t Weight2); //!< Mix Weight2/256 of the second color into the first one
+
+public:
+
+                        CScalerXBR (void);          //!< Constructor. Does nothing.
+    virtual             ~CScalerXBR (void);         //!< Destructor. Does nothing.
+    virtual const char* GetName (void) const;
+    virtual const char* GetKernelName (void) const;
+    virtual int         GetFactor (void) const;
+    virtual int         GetBorder (void) const;
+    virtual void        Scale (const uint32_t* pImage, int Width, int Height, uint32_t* pOutput, int X1, int Y1, int X2, int Y2) const;
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CSCALERXBR_H__
@@ -0,0 +1,987 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CServer.cpp
+ *  \brief Dedicated server hosting many network games
+ */
+
+#include "StdAfx.h"
+#include "CServer.h"
+#include "CNetwork.h"
+
+#include <signal.h>
+#include <string.h>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+static volatile bool ServerHasToQuit = false;      //!< Set when the server is asked to stop (Ctrl+C)
+
+static void OnQuitSignal(int)
+{
+    ServerHasToQuit = true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CServer::CServer (void)
+{
+    m_Port = DEDICATED_SERVER_PORT;
+    m_PlayersPerGame = 2;
+    m_NumberOfThreads = -1;
+    m_ListenSocket = NULL;
+    m_SocketSet = NULL;
+    m_NumberOfClients = 0;
+    m_TickDuration = 1.0f / DEDICATED_SERVER_TICK_RATE;
+    m_StatisticsTime = 0.0;
+    m_NumberOfGamesPlayed = 0;
+    m_SpectatorFramesSent = 0;
+    m_LateCommandChunks = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CServer::~CServer (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return true, if the dedicated server was asked on the command line
+ *
+ *  --dedicated-server [port]   Host network games instead of playing
+ *  --players <count>           Number of clients in each game (2 to 5)
+ *  --threads <count>           Number of worker threads updating the matches
+ */
+
+#ifdef WIN32
+bool CServer::ParseCommandLine (const char* pCommandLine)
+{
+    const char* pOption = strstr(pCommandLine, "--dedicated-server");
+
+    if (pOption == NULL)
+        return false;
+
+    sscanf(pOption + strlen("--dedicated-server"), "%d", &m_Port);
+
+    pOption = strstr(pCommandLine, "--players");
+
+    if (pOption != NULL)
+        sscanf(pOption + strlen("--players"), "%d", &m_PlayersPerGame);
+
+    pOption = strstr(pCommandLine, "--threads");
+
+    if (pOption != NULL)
+        sscanf(pOption + strlen("--threads"), "%d", &m_NumberOfThreads);
+#else
+bool CServer::ParseCommandLine (char** pCommandLine, int pCommandLineCount)
+{
+    bool DedicatedServer = false;
+
+    for (int i = 1; i < pCommandLineCount; i++)
+    {
+        if (strcmp(pCommandLine[i], "--dedicated-server") == 0)
+        {
+            DedicatedServer = true;
+
+            // The port is optional
+            if (i + 1 < pCommandLineCount && pCommandLine[i + 1][0] != '-')
+                m_Port = atoi(pCommandLine[++i]);
+        }
+        else if (strcmp(pCommandLine[i], "--players") == 0 && i + 1 < pCommandLineCount)
+        {
+            m_PlayersPerGame = atoi(pCommandLine[++i]);
+        }
+        else if (strcmp(pCommandLine[i], "--threads") == 0 && i + 1 < pCommandLineCount)
+        {
+            m_NumberOfThreads = atoi(pCommandLine[++i]);
+        }
+    }
+
+    if (!DedicatedServer)
+        return false;
+#endif
+
+    if (m_PlayersPerGame < 2)
+        m_PlayersPerGame = 2;
+    else if (m_PlayersPerGame > MAX_PLAYERS)
+        m_PlayersPerGame = MAX_PLAYERS;
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CServer::Create (void)
+{
+#ifdef ENABLE_LOG
+    theLog.Open("log.txt", true);
+#endif
+
+    theLog.WriteLine("Server          => Starting the dedicated server on port %d, %d players per game.", m_Port, m_PlayersPerGame);
+
+    // Load the levels and the configuration file of the current directory
+    if (!m_Options.Create("./", ""))
+        return false;
+
+    // Same match settings as a network game started from the menu
+    m_Options.SetTimeStart(2, 35);
+    m_Options.SetTimeUp(0, 30);
+    m_Options.SetBattleCount(3);
+
+    if (SDLNet_Init() == SDL_ERROR)
+    {
+        theLog.WriteLine("Server          => !!! Could not initialise SDL_net: %s.", SDLNet_GetError());
+        return false;
+    }
+
+    IPaddress ip;
+
+    if (SDLNet_ResolveHost(&ip, NULL, m_Port) == SDL_ERROR)
+    {
+        theLog.WriteLine("Server          => !!! Could not resolve the host: %s.", SDLNet_GetError());
+        return false;
+    }
+
+    m_ListenSocket = SDLNet_TCP_Open(&ip);
+
+    if (!m_ListenSocket)
+    {
+        theLog.WriteLine("Server          => !!! Could not listen to port %d: %s.", m_Port, SDLNet_GetError());
+        return false;
+    }
+
+    // One socket for each client and spectator, plus the listening socket
+    m_SocketSet = SDLNet_AllocSocketSet(DEDICATED_SERVER_MAX_CLIENTS + 1);
+
+    SDLNet_TCP_AddSocket(m_SocketSet, m_ListenSocket);
+
+    if (!m_WorkerPool.Create(m_NumberOfThreads))
+        return false;
+
+    if (!m_Sender.Create(SERVER_SENDER_THREADS))
+        return false;
+
+    signal(SIGINT, OnQuitSignal);
+    signal(SIGTERM, OnQuitSignal);
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::Destroy (void)
+{
+    // End the games from the latest to the first one
+    while (!m_Games.empty())
+        EndGame(m_Games.size() - 1);
+
+    while (!m_Arrivals.empty())
+    {
+        CloseConnection(m_Arrivals.back());
+        m_Arrivals.pop_back();
+    }
+
+    while (!m_Lobby.empty())
+    {
+        CloseConnection(m_Lobby.back());
+        m_Lobby.pop_back();
+    }
+
+    while (!m_WaitingSpectators.empty())
+    {
+        CloseConnection(m_WaitingSpectators.back());
+        m_WaitingSpectators.pop_back();
+    }
+
+    m_WorkerPool.Destroy();
+
+    if (m_ListenSocket != NULL)
+    {
+        SDLNet_TCP_Close(m_ListenSocket);
+        m_ListenSocket = NULL;
+    }
+
+    if (m_SocketSet != NULL)
+    {
+        SDLNet_FreeSocketSet(m_SocketSet);
+        m_SocketSet = NULL;
+    }
+
+    // A thread still blocked on a client that does not read may use SDL_net until the process ends
+    if (m_Sender.Destroy())
+        SDLNet_Quit();
+    else
+        theLog.WriteLine("Server          => A send is still in progress, SDL_net is not shut down.");
+
+    m_Options.Destroy();
+
+    theLog.WriteLine("Server          => Stopped after %d game(s).", m_NumberOfGamesPlayed);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::Run (void)
+{
+    double NextTickTime = m_Timer.GetElapsedTime();
+
+    m_StatisticsTime = NextTickTime;
+
+    while (!ServerHasToQuit)
+    {
+        double Time = m_Timer.GetElapsedTime();
+
+        // Wait for activity on the sockets, but not after the next match update
+        int Timeout = (int)((NextTickTime - Time) * 1000.0);
+
+        if (Timeout < 0)
+            Timeout = 0;
+
+        if (SDLNet_CheckSockets(m_SocketSet, Timeout) > 0)
+        {
+            AcceptClients();
+            ReceiveRoles();
+            ReceiveCommandChunks();
+        }
+
+        Time = m_Timer.GetElapsedTime();
+
+        if (Time >= NextTickTime)
+        {
+            UpdateGames();
+
+            NextTickTime += m_TickDuration;
+
+            // If the server is too late, don't try to catch up
+            if (Time - NextTickTime > 5 * m_TickDuration)
+                NextTickTime = Time + m_TickDuration;
+        }
+
+        if (Time - m_StatisticsTime >= DEDICATED_SERVER_STATISTICS_PERIOD)
+        {
+            WriteStatistics();
+            m_StatisticsTime = Time;
+        }
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::AcceptClients (void)
+{
+    if (!SDLNet_SocketReady(m_ListenSocket))
+        return;
+
+    TCPsocket Socket;
+
+    while ((Socket = SDLNet_TCP_Accept(m_ListenSocket)) != NULL)
+    {
+        // If there is no room for another client. The closed connections the
+        // sending threads did not delete yet still hold their socket.
+        if (m_Sender.GetNumberOfConnections() >= DEDICATED_SERVER_MAX_CLIENTS)
+        {
+            theLog.WriteLine("Server          => Too many clients, refusing a new one.");
+            SDLNet_TCP_Close(Socket);
+            continue;
+        }
+
+        CServerConnection* pConnection = new CServerConnection(Socket, &m_Sender);
+
+        // The client first tells whether it plays or watches
+        SDLNet_TCP_AddSocket(m_SocketSet, Socket);
+        m_Arrivals.push_back(pConnection);
+        m_NumberOfClients++;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::ReceiveRoles (void)
+{
+    // Scan the new clients in arrival order
+    for (unsigned int Client = 0; Client < m_Arrivals.size(); )
+    {
+        CServerConnection* pConnection = m_Arrivals[Client];
+
+        if (!SDLNet_SocketReady(pConnection->GetSocket()))
+        {
+            Client++;
+            continue;
+        }
+
+        // Remove the client from the arrivals, keeping the others in arrival order
+        for (unsigned int Next = Client + 1; Next < m_Arrivals.size(); Next++)
+            m_Arrivals[Next - 1] = m_Arrivals[Next];
+
+        m_Arrivals.pop_back();
+
+        if (!pConnection->Receive())
+        {
+            CloseConnection(pConnection);
+            continue;
+        }
+
+        // The role is the first received byte
+        char Role = pConnection->GetReceivedData()[0];
+
+        pConnection->Consume(1);
+
+        if (Role == NETWORK_ROLE_PLAYER)
+        {
+            m_Lobby.push_back(pConnection);
+        }
+        else if (Role == NETWORK_ROLE_SPECTATOR)
+        {
+            AttachSpectator(pConnection);
+        }
+        else
+        {
+            theLog.WriteLine("Server          => Unknown client role, closing the connection.");
+            CloseConnection(pConnection);
+        }
+    }
+
+    // Start as many games as possible with the waiting clients
+    while ((int)m_Lobby.size() >= m_PlayersPerGame)
+        StartGame();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::AttachSpectator (CServerConnection* pConnection)
+{
+    // If there is nothing to watch yet
+    if (m_Games.empty())
+    {
+        m_WaitingSpectators.push_back(pConnection);
+        return;
+    }
+
+    // Spread the spectators over the games
+    SServerGame* pGame = m_Games[0];
+
+    for (unsigned int Game = 1; Game < m_Games.size(); Game++)
+    {
+        if (m_Games[Game]->Spectators.size() < pGame->Spectators.size())
+            pGame = m_Games[Game];
+    }
+
+    // The spectator starts the match on its side, then catches up with
+    // the latest snapshot without having to encode it again
+    if (!SendMatchStart(pConnection, pGame, -1) ||
+        (pGame->pSpectatorFrame != NULL && !pConnection->Send(pGame->pSpectatorFrame, true)))
+    {
+        CloseConnection(pConnection);
+        return;
+    }
+
+    pGame->Spectators.push_back(pConnection);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::StartGame (void)
+{
+    SServerGame* pGame = new SServerGame;
+
+    pGame->NumberOfPlayers = m_PlayersPerGame;
+    pGame->NumberOfMatches = 0;
+    pGame->Seed = 0;
+    pGame->pSpectatorFrame = NULL;
+    pGame->SpectatorFramesEncoded = 0;
+
+    for (int Player = 0; Player < MAX_PLAYERS; Player++)
+    {
+        pGame->Connections[Player] = (Player < m_PlayersPerGame ? m_Lobby[Player] : NULL);
+        pGame->Victories[Player] = 0;
+    }
+
+    // Remove these clients from the lobby, keeping the others in arrival order
+    for (unsigned int Client = m_PlayersPerGame; Client < m_Lobby.size(); Client++)
+        m_Lobby[Client - m_PlayersPerGame] = m_Lobby[Client];
+
+    for (int Player = 0; Player < m_PlayersPerGame; Player++)
+        m_Lobby.pop_back();
+
+    m_Games.push_back(pGame);
+
+    StartMatch(pGame);
+
+    // Give the spectators waiting for a game something to watch
+    while (!m_WaitingSpectators.empty())
+    {
+        CServerConnection* pConnection = m_WaitingSpectators.back();
+        m_WaitingSpectators.pop_back();
+
+        AttachSpectator(pConnection);
+    }
+
+    theLog.WriteLine("Server          => Game started, %d game(s) running.", (int)m_Games.size());
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return true, if at least one client is still connected
+ *
+ *  The clients receive the random seed, the number of their bomber and the
+ *  number of bombers, then CMatch starts the match on their side.
+ */
+
+bool CServer::StartMatch (SServerGame* pGame)
+{
+    // The match draws its random numbers from the seed the clients receive
+    pGame->Seed = (DWORD)time(NULL) + pGame->NumberOfMatches;
+
+    pGame->Match.SetTimer(&m_Timer);
+    pGame->Match.Create(m_Options, pGame->NumberOfPlayers, &m_Sound, pGame->Seed);
+
+    // The match clock starts when the clients are told the match starts
+    pGame->Epoch = m_Timer.GetElapsedTime();
+
+    for (int Player = 0; Player < MAX_PLAYERS; Player++)
+        pGame->ChunkSendTimes[Player] = -1;
+
+    // The snapshots of the previous match are useless now
+    if (pGame->pSpectatorFrame != NULL)
+    {
+        pGame->pSpectatorFrame->Release();
+        pGame->pSpectatorFrame = NULL;
+    }
+
+    bool Connected = false;
+
+    for (int Player = 0; Player < pGame->NumberOfPlayers; Player++)
+    {
+        if (pGame->Connections[Player] == NULL)
+            continue;
+
+        if (!SendMatchStart(pGame->Connections[Player], pGame, Player))
+        {
+            CloseConnection(pGame->Connections[Player]);
+            pGame->Connections[Player] = NULL;
+        }
+        else
+        {
+            Connected = true;
+        }
+    }
+
+    for (int Spectator = (int)pGame->Spectators.size() - 1; Spectator >= 0; Spectator--)
+    {
+        if (!SendMatchStart(pGame->Spectators[Spectator], pGame, -1))
+        {
+            CloseConnection(pGame->Spectators[Spectator]);
+
+            pGame->Spectators[Spectator] = pGame->Spectators.back();
+            pGame->Spectators.pop_back();
+        }
+    }
+
+    return Connected;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return true, if the frame was queued
+ */
+
+bool CServer::SendMatchStart (CServerConnection* pConnection, SServerGame* pGame, int Player)
+{
+    int NumberOfPlayers = pGame->NumberOfPlayers;
+
+    // Laid out the way CMatch receives them, one after the other
+    CSharedBuffer* pFrame = new CSharedBuffer(sizeof(DWORD) + 2 * sizeof(int));
+
+    memcpy(pFrame->GetData(), &pGame->Seed, sizeof(DWORD));
+    memcpy(pFrame->GetData() + sizeof(DWORD), &Player, sizeof(int));
+    memcpy(pFrame->GetData() + sizeof(DWORD) + sizeof(int), &NumberOfPlayers, sizeof(int));
+
+    // The match start must never be skipped
+    bool Queued = pConnection->Send(pFrame, false);
+
+    pFrame->Release();
+
+    return Queued;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::EndGame (int Game)
+{
+    ASSERT (Game >= 0 && Game < (int)m_Games.size());
+
+    SServerGame* pGame = m_Games[Game];
+
+    for (int Player = 0; Player < pGame->NumberOfPlayers; Player++)
+    {
+        if (pGame->Connections[Player] != NULL)
+            CloseConnection(pGame->Connections[Player]);
+    }
+
+    for (unsigned int Spectator = 0; Spectator < pGame->Spectators.size(); Spectator++)
+        CloseConnection(pGame->Spectators[Spectator]);
+
+    if (pGame->pSpectatorFrame != NULL)
+        pGame->pSpectatorFrame->Release();
+
+    pGame->Match.Destroy();
+
+    delete pGame;
+
+    // The order of the games does not matter
+    m_Games[Game] = m_Games.back();
+    m_Games.pop_back();
+
+    m_NumberOfGamesPlayed++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::CloseConnection (CServerConnection* pConnection)
+{
+    SDLNet_TCP_DelSocket(m_SocketSet, pConnection->GetSocket());
+    pConnection->Close();
+
+    m_NumberOfClients--;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::ReceiveCommandChunks (void)
+{
+    // The clients in the lobby don't send anything : activity means they left
+    for (int Client = (int)m_Lobby.size() - 1; Client >= 0; Client--)
+    {
+        if (SDLNet_SocketReady(m_Lobby[Client]->GetSocket()))
+        {
+            if (!m_Lobby[Client]->Receive())
+            {
+                CloseConnection(m_Lobby[Client]);
+
+                m_Lobby[Client] = m_Lobby.back();
+                m_Lobby.pop_back();
+            }
+            else
+            {
+                m_Lobby[Client]->Consume(m_Lobby[Client]->GetReceivedSize());
+            }
+        }
+    }
+
+    // Neither do the spectators
+    for (int Spectator = (int)m_WaitingSpectators.size() - 1; Spectator >= 0; Spectator--)
+    {
+        if (SDLNet_SocketReady(m_WaitingSpectators[Spectator]->GetSocket()))
+        {
+            if (!m_WaitingSpectators[Spectator]->Receive())
+            {
+                CloseConnection(m_WaitingSpectators[Spectator]);
+
+                m_WaitingSpectators[Spectator] = m_WaitingSpectators.back();
+                m_WaitingSpectators.pop_back();
+            }
+            else
+            {
+                m_WaitingSpectators[Spectator]->Consume(m_WaitingSpectators[Spectator]->GetReceivedSize());
+            }
+        }
+    }
+
+    for (unsigned int Game = 0; Game < m_Games.size(); Game++)
+    {
+        SServerGame* pGame = m_Games[Game];
+
+        for (int Spectator = (int)pGame->Spectators.size() - 1; Spectator >= 0; Spectator--)
+        {
+            CServerConnection* pConnection = pGame->Spectators[Spectator];
+
+            if (!SDLNet_SocketReady(pConnection->GetSocket()))
+                continue;
+
+            if (!pConnection->Receive())
+            {
+                CloseConnection(pConnection);
+
+                pGame->Spectators[Spectator] = pGame->Spectators.back();
+                pGame->Spectators.pop_back();
+            }
+            else
+            {
+                pConnection->Consume(pConnection->GetReceivedSize());
+            }
+        }
+
+        for (int Player = 0; Player < pGame->NumberOfPlayers; Player++)
+        {
+            CServerConnection* pConnection = pGame->Connections[Player];
+
+            if (pConnection == NULL || !SDLNet_SocketReady(pConnection->GetSocket()))
+                continue;
+
+            if (!pConnection->Receive())
+            {
+                // The client left, its bomber stays in the arena without any command
+                CloseConnection(pConnection);
+                pGame->Connections[Player] = NULL;
+                continue;
+            }
+
+            CCommandChunk CommandChunk;
+            int Result;
+
+            // Read every whole command chunk, the rest waits for the next bytes
+            while ((Result = ReadCommandChunk(pConnection, CommandChunk)) > 0)
+            {
+                double Time = m_Timer.GetElapsedTime();
+
+                // Echo the send time of this command chunk in the next snapshot
+                pGame->ChunkSendTimes[Player] = CommandChunk.GetSendTime();
+                pGame->ChunkReceiveTimes[Player] = Time;
+
+                if (CNetworkClock::IsLate(CommandChunk.GetTick(), (int)((Time - pGame->Epoch) * NETWORK_TICKS_PER_SECOND)))
+                    m_LateCommandChunks++;
+
+                pGame->Match.QueueCommandChunk(Player, CommandChunk);
+            }
+
+            if (Result == SDL_ERROR)
+            {
+                CloseConnection(pConnection);
+                pGame->Connections[Player] = NULL;
+            }
+        }
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::UpdateMatchJob (void* pParameter, int Job)
+{
+    CServer* pServer = (CServer*)pParameter;
+    SServerGame* pGame = pServer->m_Games[Job];
+
+    pGame->Match.Update(pServer->m_TickDuration);
+
+    // Encode the snapshot once for all the spectators, on this worker thread
+    if (pGame->Match.IsSnapshotReady() && !pGame->Spectators.empty())
+    {
+        if (pGame->pSpectatorFrame != NULL)
+            pGame->pSpectatorFrame->Release();
+
+        // Spectators have no command chunk to acknowledge
+        pGame->Match.GetSnapshot().SetAcknowledgedSequence(0);
+        pGame->Match.GetSnapshot().SetClock((int)((pServer->m_Timer.GetElapsedTime() - pGame->Epoch) * 1000.0), -1, 0);
+
+        pGame->pSpectatorFrame = EncodeFrame((const char*)&pGame->Match.GetSnapshot(), sizeof(CArenaSnapshot));
+        pGame->SpectatorFramesEncoded++;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::UpdateGames (void)
+{
+    // Update every match, each one on a single thread
+    m_WorkerPool.Run(UpdateMatchJob, this, m_Games.size());
+
+    // Scan the games from the latest to the first one, so that ending a game is safe
+    for (int Game = (int)m_Games.size() - 1; Game >= 0; Game--)
+    {
+        SServerGame* pGame = m_Games[Game];
+        CServerMatch& Match = pGame->Match;
+        int Connected = 0;
+
+        for (int Player = 0; Player < pGame->NumberOfPlayers; Player++)
+        {
+            if (pGame->Connections[Player] == NULL)
+                continue;
+
+            // Send the snapshot to the client, with the latest of its command chunks it includes
+            if (Match.IsSnapshotReady())
+            {
+                Match.GetSnapshot().SetAcknowledgedSequence(Match.GetAcknowledgedSequence(Player));
+
+                // Give the client what it needs to measure the match clock
+                double Time = m_Timer.GetElapsedTime();
+
+                Match.GetSnapshot().SetClock((int)((Time - pGame->Epoch) * 1000.0),
+                                             pGame->ChunkSendTimes[Player],
+                                             (int)((Time - pGame->ChunkReceiveTimes[Player]) * 1000.0));
+
+                CSharedBuffer* pFrame = EncodeFrame((const char*)&Match.GetSnapshot(), sizeof(CArenaSnapshot));
+
+                // A newer snapshot makes the queued one useless
+                bool Queued = pGame->Connections[Player]->Send(pFrame, true);
+
+                pFrame->Release();
+
+                if (!Queued)
+                {
+                    CloseConnection(pGame->Connections[Player]);
+                    pGame->Connections[Player] = NULL;
+                    continue;
+                }
+            }
+
+            Connected++;
+        }
+
+        if (Match.IsSnapshotReady() && !pGame->Spectators.empty())
+            SendToSpectators(pGame);
+
+        // If nobody plays anymore
+        if (Connected == 0)
+        {
+            EndGame(Game);
+        }
+        // If the match and the pause after it are over
+        else if (Match.GetState() == SERVERMATCHSTATE_FINISHED)
+        {
+            // Each bomber is its own team
+            int Winner = Match.GetWinnerTeam();
+
+            if (Winner >= 0)
+                pGame->Victories[Winner]++;
+
+            pGame->NumberOfMatches++;
+
+            Match.Destroy();
+
+            // If a client won the game or nobody is left to play against
+            if ((Winner >= 0 && pGame->Victories[Winner] >= m_Options.GetBattleCount()) ||
+                Connected < 2 ||
+                !StartMatch(pGame))
+            {
+                EndGame(Game);
+            }
+        }
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::WriteStatistics (void)
+{
+    int NumberOfTicks = 0;
+    float TotalTickTime = 0.0f;
+    float MaxTickTime = 0.0f;
+
+    for (unsigned int Game = 0; Game < m_Games.size(); Game++)
+    {
+        CServerMatch& Match = m_Games[Game]->Match;
+
+#ifdef ENABLE_DEBUG_LOG
+        debugLog.WriteDebugMsg(DEBUGSECT_OTHER, "Game %d : %d ticks, average %.3f ms, max %.3f ms\n",
+            Game, Match.GetNumberOfTicks(), Match.GetAverageTickTime(), Match.GetMaxTickTime());
+#endif
+
+        NumberOfTicks += Match.GetNumberOfTicks();
+        TotalTickTime += Match.GetAverageTickTime() * Match.GetNumberOfTicks();
+
+        if (Match.GetMaxTickTime() > MaxTickTime)
+            MaxTickTime = Match.GetMaxTickTime();
+
+        Match.ResetTickStatistics();
+    }
+
+    int NumberOfSpectators = m_WaitingSpectators.size();
+    int SpectatorFramesEncoded = 0;
+
+    for (unsigned int Game = 0; Game < m_Games.size(); Game++)
+    {
+        NumberOfSpectators += m_Games[Game]->Spectators.size();
+        SpectatorFramesEncoded += m_Games[Game]->SpectatorFramesEncoded;
+
+        m_Games[Game]->SpectatorFramesEncoded = 0;
+    }
+
+    theLog.WriteLine("Server          => %d client(s), %d waiting, %d game(s), match update average %.3f ms, max %.3f ms.",
+        m_NumberOfClients, (int)m_Lobby.size(), (int)m_Games.size(),
+        (NumberOfTicks > 0 ? TotalTickTime / NumberOfTicks : 0.0f), MaxTickTime);
+
+    theLog.WriteLine("Server          => %d spectator(s), %d snapshot(s) encoded and queued %d time(s).",
+        NumberOfSpectators, SpectatorFramesEncoded, m_SpectatorFramesSent);
+
+    theLog.WriteLine("Server          => %d command chunk(s) arrived out of date.", m_LateCommandChunks);
+
+    m_SpectatorFramesSent = 0;
+    m_LateCommandChunks = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServer::SendToSpectators (SServerGame* pGame)
+{
+    CSharedBuffer* pFrame = pGame->pSpectatorFrame;
+
+    ASSERT (pFrame != NULL);
+
+    // Every spectator queues a reference to the very same bytes. A spectator that is
+    // still sending an older snapshot skips the one that waits, instead of being dropped.
+    for (int Spectator = (int)pGame->Spectators.size() - 1; Spectator >= 0; Spectator--)
+    {
+        if (!pGame->Spectators[Spectator]->Send(pFrame, true))
+        {
+            CloseConnection(pGame->Spectators[Spectator]);
+
+            pGame->Spectators[Spectator] = pGame->Spectators.back();
+            pGame->Spectators.pop_back();
+        }
+        else
+        {
+            m_SpectatorFramesSent++;
+        }
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return the frame, with one reference owned by the caller
+ *
+ *  The checksum and the data are laid out in a single buffer, so that the
+ *  frame can be sent to many clients with one send each.
+ */
+
+CSharedBuffer* CServer::EncodeFrame (const char* pData, int Size)
+{
+    union {
+        unsigned long LongValue;
+        char ByteArray[4];
+    } LongBytes;
+
+    LongBytes.LongValue = CNetwork::CheckSum(pData);
+
+    CSharedBuffer* pFrame = new CSharedBuffer(4 + Size);
+
+    memcpy(pFrame->GetData(), LongBytes.ByteArray, 4);
+    memcpy(pFrame->GetData() + 4, pData, Size);
+
+    return pFrame;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return 1 if a command chunk was read, 0 if no whole command chunk was received yet, SDL_ERROR if the stream can't be followed
+ *
+ *  Read the checksum then the command chunk with only its used steps, the way CNetwork sends them.
+ *  The command chunks with a wrong checksum are skipped.
+ */
+
+int CServer::ReadCommandChunk (CServerConnection* pConnection, CCommandChunk& CommandChunk)
+{
+    union {
+        unsigned long LongValue;
+        char ByteArray[4];
+    } LongBytes;
+
+    while (pConnection->GetReceivedSize() >= 4 + CCommandChunk::GetHeaderSize())
+    {
+        const char* pData = pConnection->GetReceivedData();
+
+        LongBytes.LongValue = 0;
+
+        memcpy(LongBytes.ByteArray, pData, 4);
+        memcpy((char*)&CommandChunk, pData + 4, CCommandChunk::GetHeaderSize());
+
+        // The stream can't be followed anymore if the header is wrong
+        if (CommandChunk.GetNumberOfSteps() < 0 || CommandChunk.GetNumberOfSteps() > MAX_STEPS_IN_COMMAND_CHUNK)
+        {
+            theLog.WriteLine("Server          => !!! Wrong number of steps in a command chunk.");
+            return SDL_ERROR;
+        }
+
+        // If the steps did not all arrive yet
+        if (pConnection->GetReceivedSize() < 4 + CommandChunk.GetSize())
+            return 0;
+
+        memcpy((char*)&CommandChunk + CCommandChunk::GetHeaderSize(),
+               pData + 4 + CCommandChunk::GetHeaderSize(),
+               CommandChunk.GetSize() - CCommandChunk::GetHeaderSize());
+
+        pConnection->Consume(4 + CommandChunk.GetSize());
+
+        // Only 4 bytes of the checksum are sent
+        if ((CNetwork::CheckSum((const char*)&CommandChunk) & 0xFFFFFFFF) == (LongBytes.LongValue & 0xFFFFFFFF))
+            return 1;
+
+        theLog.WriteLine("Server          => Wrong checksum, ignoring the data.");
+    }
+
+    return 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
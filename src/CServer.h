@@ -0,0 +1,162 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CServer.h
+ *  \brief Header file of the dedicated server
+ */
+
+#ifndef __CSERVER_H__
+#define __CSERVER_H__
+
+#include "SDL_net.h"
+
+#ifdef WIN32
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+#include "portable_stl/vector/vector.h"
+
+#include "COptions.h"
+#include "CSound.h"
+#include "CServerMatch.h"
+#include "CSharedBuffer.h"
+#include "CServerConnection.h"
+#include "CServerSender.h"
+#include "CWorkerPool.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define DEDICATED_SERVER_PORT               1234    //!< Default port the dedicated server listens to
+#define DEDICATED_SERVER_TICK_RATE          60      //!< Number of match updates per second
+#define DEDICATED_SERVER_STATISTICS_PERIOD  10.0f   //!< Time (in seconds) between two logs of the statistics
+
+// SDL_net waits for the sockets with select(), which can't watch more sockets
+// (or higher descriptors) than FD_SETSIZE. Some room is kept for the listening
+// socket, the standard streams and the log files.
+#define DEDICATED_SERVER_MAX_CLIENTS        (FD_SETSIZE - 32) //!< Maximum number of connected clients
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A game hosted by the dedicated server : matches between the same clients until one of them wins enough matches
+struct SServerGame
+{
+    CServerMatch    Match;                          //!< Current match
+    CServerConnection* Connections[MAX_PLAYERS];    //!< Connection of the client playing each bomber, NULL if disconnected
+    int             NumberOfPlayers;                //!< Number of clients in this game
+    int             Victories[MAX_PLAYERS];         //!< Number of matches won by each client
+    int             NumberOfMatches;                //!< Number of matches played in this game
+    DWORD           Seed;                           //!< Random seed of the current match
+    double          Epoch;                          //!< Server time (in seconds) when the current match started, the match time is zero then
+    int             ChunkSendTimes[MAX_PLAYERS];    //!< Send time of the latest command chunk received from each client, echoed in the snapshots. -1 if none.
+    double          ChunkReceiveTimes[MAX_PLAYERS]; //!< Server time (in seconds) when the latest command chunk of each client was received
+    ::portable_stl::vector<CServerConnection*> Spectators; //!< Clients watching this game
+    CSharedBuffer*  pSpectatorFrame;                //!< Latest snapshot with its checksum, sent as is to every spectator. NULL if none.
+    int             SpectatorFramesEncoded;         //!< Number of snapshots encoded for the spectators since the latest statistics
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Hosts many network games at the same time, without any window, input or sound.
+
+/**
+ * One thread runs the event loop over every socket : it accepts the clients,
+ * gathers them into games, receives the command chunks and queues the
+ * snapshots. It never waits for a client : a few sending threads empty the
+ * queues of the connections, and only the bytes already received are read. The
+ * matches are updated at a fixed rate on a pool of worker threads, each
+ * match being updated by only one thread at a time.
+ *
+ * Spectators only receive the snapshots. The snapshot of a game is encoded
+ * once by the worker thread that updated the match, and the same frame is
+ * then queued for all the spectators of the game. A spectator that reads
+ * slowly skips the snapshots that became out of date in its queue.
+ */
+
+class CServer
+{
+private:
+
+    CTimer          m_Timer;                        //!< Timer used for the fixed update rate and the statistics
+    COptions        m_Options;                      //!< Options every match starts from
+    CSound          m_Sound;                        //!< Sound object that is never created, so that the matches are silent
+    CWorkerPool     m_WorkerPool;                   //!< Threads updating the matches
+    CServerSender   m_Sender;                       //!< Threads sending the frames queued in the connections
+    int             m_Port;                         //!< Port to listen to
+    int             m_PlayersPerGame;               //!< Number of clients to gather before starting a game
+    int             m_NumberOfThreads;              //!< Number of worker threads, negative to use one per core
+    TCPsocket       m_ListenSocket;                 //!< Socket accepting the clients
+    SDLNet_SocketSet m_SocketSet;                   //!< Every socket of the server, to wait for activity on all of them
+    ::portable_stl::vector<CServerConnection*> m_Arrivals; //!< Clients that did not tell yet whether they play or watch
+    ::portable_stl::vector<CServerConnection*> m_Lobby; //!< Clients waiting for a game
+    ::portable_stl::vector<CServerConnection*> m_WaitingSpectators; //!< Spectators waiting for a game to watch
+    int             m_NumberOfClients;              //!< Number of connected clients
+    ::portable_stl::vector<SServerGame*> m_Games;   //!< Games being played
+    float           m_TickDuration;                 //!< Time (in seconds) between two match updates
+    double          m_StatisticsTime;               //!< Time when the statistics were logged for the last time
+    int             m_NumberOfGamesPlayed;          //!< Number of games that ended since the server started
+    int             m_SpectatorFramesSent;          //!< Number of snapshots queued for spectators since the latest statistics
+    int             m_LateCommandChunks;            //!< Number of command chunks that were out of date when they arrived, since the latest statistics
+
+    void            AcceptClients (void);           //!< Accept the connecting clients
+    void            ReceiveRoles (void);            //!< Move the new clients to the lobby or to a game to watch, and start games when enough players are waiting
+    void            AttachSpectator (CServerConnection* pConnection); //!< Let the spectator watch the game with the fewest spectators
+    void            StartGame (void);               //!< Start a game with the first clients of the lobby
+    bool            StartMatch (SServerGame* pGame); //!< Create the next match of the game and tell the clients about it
+    void            EndGame (int Game);             //!< Disconnect the clients and the spectators of the game and delete it
+    bool            SendMatchStart (CServerConnection* pConnection, SServerGame* pGame, int Player); //!< Queue the random seed, the bomber of the client (-1 for a spectator) and the number of bombers
+    void            SendToSpectators (SServerGame* pGame); //!< Queue the latest encoded snapshot of the game for its spectators
+    void            CloseConnection (CServerConnection* pConnection); //!< Remove the socket from the socket set and close the connection
+    void            ReceiveCommandChunks (void);    //!< Receive the bytes available on the sockets and read the whole command chunks
+    void            UpdateGames (void);             //!< Update every match once and queue the snapshots
+    void            WriteStatistics (void);         //!< Log the number of games and the update time of the matches
+    int             ReadCommandChunk (CServerConnection* pConnection, CCommandChunk& CommandChunk); //!< Read a command chunk sent with a checksum by CNetwork out of the received bytes
+    static void     UpdateMatchJob (void* pParameter, int Job); //!< Worker function updating one match and encoding its snapshot for the spectators
+    static CSharedBuffer* EncodeFrame (const char* pData, int Size); //!< Lay the checksum and the data out the way CNetwork receives them
+
+public:
+
+                    CServer (void);                 //!< Constructor. Initialize some members.
+                    ~CServer (void);                //!< Destructor. Does nothing.
+#ifdef WIN32
+    bool            ParseCommandLine (const char* pCommandLine); //!< Read the server options, return whether the dedicated server was asked
+#else
+    bool            ParseCommandLine (char** pCommandLine, int pCommandLineCount); //!< Read the server options, return whether the dedicated server was asked
+#endif
+    bool            Create (void);                  //!< Start listening
+    void            Destroy (void);                 //!< Disconnect everybody and stop listening
+    void            Run (void);                     //!< Event loop, returns when the server has to quit
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CSERVER_H__
@@ -0,0 +1,133 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+/**
+ *  \file CServerConnection.cpp
+ *  \brief Client connection of the dedicated server
+ */
+
+#include "StdAfx.h"
+#include "CServerConnection.h"
+#include "CServerSender.h"
+
+#include <string.h>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CServerConnection::CServerConnection (TCPsocket Socket, CServerSender* pSender)
+{
+    ASSERT (Socket != NULL);
+    ASSERT (pSender != NULL);
+
+    m_Socket = Socket;
+    m_pSender = pSender;
+    m_ReceivedSize = 0;
+    m_FirstFrame = 0;
+    m_NumberOfFrames = 0;
+    m_pNextReady = NULL;
+    m_Ready = false;
+    m_Sending = false;
+    m_Failed = false;
+    m_Closed = false;
+
+    m_pSender->AddConnection(this);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CServerConnection::~CServerConnection (void)
+{
+    ASSERT (m_NumberOfFrames == 0);
+
+    SDLNet_TCP_Close(m_Socket);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerConnection::Close (void)
+{
+    m_pSender->Close(this);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return true, if the frame was queued or replaced the latest queued frame
+ *
+ *  The connection takes its own reference to the frame.
+ */
+
+bool CServerConnection::Send (CSharedBuffer* pFrame, bool Replaceable)
+{
+    return m_pSender->Send(this, pFrame, Replaceable);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return true, if some bytes were received
+ */
+
+bool CServerConnection::Receive (void)
+{
+    // No frame the client sends is that big, the stream can't be followed anymore
+    if (m_ReceivedSize == SERVER_CONNECTION_RECEIVE_BUFFER_SIZE)
+        return false;
+
+    int Result = SDLNet_TCP_Recv(m_Socket, &m_ReceivedData[m_ReceivedSize], SERVER_CONNECTION_RECEIVE_BUFFER_SIZE - m_ReceivedSize);
+
+    if (Result <= 0)
+        return false;
+
+    m_ReceivedSize += Result;
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerConnection::Consume (int Size)
+{
+    ASSERT (Size >= 0 && Size <= m_ReceivedSize);
+
+    m_ReceivedSize -= Size;
+
+    memmove(m_ReceivedData, &m_ReceivedData[Size], m_ReceivedSize);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,124 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+
+/**
+ *  \file CServerConnection.h
+ *  \brief Header file of a client connection of the dedicated server
+ */
+
+#ifndef __CSERVERCONNECTION_H__
+#define __CSERVERCONNECTION_H__
+
+#include "SDL_net.h"
+
+#include "CSharedBuffer.h"
+
+class CServerSender;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define SERVER_CONNECTION_MAX_QUEUED_FRAMES     16      //!< Maximum number of frames waiting to be sent to a client
+#define SERVER_CONNECTION_RECEIVE_BUFFER_SIZE   1024    //!< Maximum number of bytes received from a client and not read yet
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Socket of a client of the dedicated server, which never blocks the event loop.
+
+/**
+ * Send() only queues the frame : the threads of the CServerSender do the
+ * blocking sends. A replaceable frame, such as a snapshot, takes the place
+ * of the replaceable frame queued just before it if that one is not being
+ * sent yet. A client that lets too many frames pile up anyway has to be
+ * disconnected.
+ *
+ * Receive() is called when the socket set says the socket is ready, so
+ * it never waits. The bytes are kept until a whole frame arrived.
+ *
+ * Close() drops the queued frames. The connection is deleted as soon as
+ * no sending thread uses it anymore, and it must not be used after that.
+ */
+
+class CServerConnection
+{
+    friend class CServerSender;
+
+private:
+
+    TCPsocket       m_Socket;                       //!< Socket of the client
+    CServerSender*  m_pSender;                      //!< Threads sending the queued frames
+    char            m_ReceivedData [SERVER_CONNECTION_RECEIVE_BUFFER_SIZE]; //!< Bytes received and not read yet
+    int             m_ReceivedSize;                 //!< Number of bytes received and not read yet
+
+    // Only used with the mutex of the sender locked
+    CSharedBuffer*  m_pFrames [SERVER_CONNECTION_MAX_QUEUED_FRAMES]; //!< Frames waiting to be sent, in a ring buffer
+    bool            m_Replaceable [SERVER_CONNECTION_MAX_QUEUED_FRAMES]; //!< Can each frame be replaced by the next one?
+    int             m_FirstFrame;                   //!< Index of the next frame to send
+    int             m_NumberOfFrames;               //!< Number of frames waiting to be sent
+    CServerConnection* m_pNextReady;                //!< Next connection waiting for a sending thread
+    bool            m_Ready;                        //!< Is the connection waiting for a sending thread?
+    bool            m_Sending;                      //!< Is a thread sending one of its frames?
+    bool            m_Failed;                       //!< Did a send fail?
+    bool            m_Closed;                       //!< Was the connection closed?
+
+                    ~CServerConnection (void);      //!< Destructor. Close the socket. Only the sender deletes the connection.
+
+public:
+
+                    CServerConnection (TCPsocket Socket, CServerSender* pSender); //!< Constructor. The connection owns the socket.
+    void            Close (void);                   //!< Drop the queued frames and close the connection
+    bool            Send (CSharedBuffer* pFrame, bool Replaceable); //!< Queue the frame, return false if the client has to be disconnected
+    bool            Receive (void);                 //!< Receive the bytes available on the ready socket, return false if the client left
+    void            Consume (int Size);             //!< Forget the first received bytes once they are read
+    inline TCPsocket GetSocket (void);              //!< Get the socket, to add it to a socket set
+    inline const char* GetReceivedData (void);      //!< Get the bytes received and not read yet
+    inline int      GetReceivedSize (void);         //!< Get the number of bytes received and not read yet
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline TCPsocket CServerConnection::GetSocket (void)
+{
+    return m_Socket;
+}
+
+inline const char* CServerConnection::GetReceivedData (void)
+{
+    return m_ReceivedData;
+}
+
+inline int CServerConnection::GetReceivedSize (void)
+{
+    return m_ReceivedSize;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CSERVERCONNECTION_H__
@@ -0,0 +1,293 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CServerMatch.cpp
+ *  \brief A match hosted by the dedicated server
+ */
+
+#include "StdAfx.h"
+#include "CServerMatch.h"
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CServerMatch::CServerMatch (void)
+{
+    m_pTimer = NULL;
+    m_State = SERVERMATCHSTATE_FINISHED;
+    m_StateTime = 0.0f;
+    m_SnapshotReady = false;
+
+    m_Rules.SetArena(&m_Arena);
+    m_Rules.SetClock(&m_Clock);
+    m_Rules.SetOptions(&m_Options);
+
+    for (int Player = 0; Player < MAX_PLAYERS; Player++)
+    {
+        m_NumberOfQueuedChunks[Player] = 0;
+        m_AcknowledgedSequence[Player] = 0;
+    }
+
+    ResetTickStatistics();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CServerMatch::~CServerMatch (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerMatch::Create (const COptions& Options, int NumberOfPlayers, CSound* pSound, unsigned int Seed)
+{
+    ASSERT (NumberOfPlayers >= 2 && NumberOfPlayers <= MAX_PLAYERS);
+
+    // The clients seed their own generator with the same seed before creating
+    // their arena, so the walls and the items are the same on every computer
+    m_Random.Seed(Seed);
+    CRandom::SetCurrent(&m_Random);
+
+    // Every connected client plays a network bomber, the other bombers don't play
+    m_Options = Options;
+
+    for (int Player = 0; Player < MAX_PLAYERS; Player++)
+    {
+        m_Options.SetBomberType(Player, (Player < NumberOfPlayers ? BOMBERTYPE_NET : BOMBERTYPE_OFF));
+
+        m_NumberOfQueuedChunks[Player] = 0;
+        m_AcknowledgedSequence[Player] = 0;
+    }
+
+    // There is no screen : the arena never displays anything.
+    // The sound object is never created so it stays silent.
+    m_Arena.SetDisplay(NULL);
+    m_Arena.SetSound(pSound);
+    m_Arena.SetOptions(&m_Options);
+    m_Arena.Create();
+
+    m_Clock.Create(CLOCKTYPE_COUNTDOWN,                    // Time decreases until zero
+        CLOCKMODE_MS,                           // Compute minutes and seconds
+        0,                                      // Start hours
+        m_Options.GetTimeStartMinutes(),        // Start minutes
+        m_Options.GetTimeStartSeconds(),        // Start seconds
+        0);                                     // Start seconds100
+
+    // Put the bombers in their teams, the same way a network CMatch does
+    m_Rules.Create();
+
+    m_State = SERVERMATCHSTATE_STARTING;
+    m_StateTime = 0.0f;
+    m_SnapshotReady = false;
+
+    ResetTickStatistics();
+
+    CRandom::SetCurrent(NULL);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerMatch::Destroy (void)
+{
+    m_Arena.Destroy();
+    m_Clock.Destroy();
+
+    m_State = SERVERMATCHSTATE_FINISHED;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerMatch::QueueCommandChunk (int Player, const CCommandChunk& CommandChunk)
+{
+    ASSERT (Player >= 0 && Player < MAX_PLAYERS);
+
+    int LatestSequence = (m_NumberOfQueuedChunks[Player] > 0 ?
+                          m_QueuedChunks[Player][m_NumberOfQueuedChunks[Player] - 1].GetSequence() :
+                          m_AcknowledgedSequence[Player]);
+
+    // Keep the command chunks in sequence order : ignore the ones sent again that
+    // we already have, and wait for a missing one to be sent again by the client.
+    if (CommandChunk.GetSequence() != LatestSequence + 1)
+        return;
+
+    // If the client sends much faster than the server updates, ignore the
+    // command chunk : the client will send it again since it is not acknowledged.
+    if (m_NumberOfQueuedChunks[Player] == MAX_QUEUED_COMMAND_CHUNKS)
+        return;
+
+    m_QueuedChunks[Player][m_NumberOfQueuedChunks[Player]++] = CommandChunk;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerMatch::ApplyCommandChunks (void)
+{
+    for (int Player = 0; Player < MAX_PLAYERS; Player++)
+    {
+        for (int Chunk = 0; Chunk < m_NumberOfQueuedChunks[Player]; Chunk++)
+        {
+            CCommandChunk& CommandChunk = m_QueuedChunks[Player][Chunk];
+
+            // If the client's bomber is alive
+            if (m_Arena.GetBomber(Player).Exist() && m_Arena.GetBomber(Player).IsAlive())
+            {
+                // Apply the command chunk to the bomber, as CMatch does
+                for (int Step = 0; Step < CommandChunk.GetNumberOfSteps(); Step++)
+                {
+                    m_Arena.GetBomber(Player).Command(CommandChunk.GetStepMove(Step), CommandChunk.GetStepAction(Step));
+                    m_Arena.UpdateSingleBomber(Player, CommandChunk.GetStepDuration(Step));
+                }
+            }
+
+            m_AcknowledgedSequence[Player] = CommandChunk.GetSequence();
+
+            // The client is waiting for a snapshot including this command chunk
+            m_SnapshotReady = true;
+        }
+
+        m_NumberOfQueuedChunks[Player] = 0;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerMatch::ManageMatchOver (void)
+{
+    // No computer bomber plays on the server, so a draw game is never forced
+    EMatchResult Result = m_Rules.ManageMatchOver(false);
+
+    if (CMatchRules::IsOver(Result))
+    {
+        m_State = SERVERMATCHSTATE_OVER;
+        m_StateTime = -CMatchRules::GetPause(Result);
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerMatch::Update (float DeltaTime)
+{
+    double StartTime = (m_pTimer != NULL ? m_pTimer->GetElapsedTime() : 0.0);
+
+    // This thread may update other matches too
+    CRandom::SetCurrent(&m_Random);
+
+    m_SnapshotReady = false;
+    m_StateTime += DeltaTime;
+
+    switch (m_State)
+    {
+        // The clients are showing the black screen and the arena
+        case SERVERMATCHSTATE_STARTING :
+        {
+            if (m_StateTime > MATCH_BLACKSCREEN_DURATION + MATCH_PAUSE_BEGIN)
+            {
+                m_State = SERVERMATCHSTATE_PLAYING;
+                m_StateTime = 0.0f;
+            }
+
+            break;
+        }
+
+        case SERVERMATCHSTATE_PLAYING :
+        {
+            ApplyCommandChunks();
+            m_Rules.UpdateTimeUp(false);
+
+            m_Clock.Update(DeltaTime);
+            m_Arena.Update(DeltaTime);
+
+            ManageMatchOver();
+
+            break;
+        }
+
+        // The state time started negative and counts the pause down
+        case SERVERMATCHSTATE_OVER :
+        {
+            m_Arena.Update(DeltaTime);
+
+            if (m_StateTime >= 0.0f)
+                m_State = SERVERMATCHSTATE_FINISHED;
+
+            break;
+        }
+
+        case SERVERMATCHSTATE_FINISHED :
+        {
+            break;
+        }
+    }
+
+    // Make one snapshot for all the clients of this match
+    if (m_SnapshotReady)
+        m_Arena.WriteSnapshot(m_Snapshot);
+
+    CRandom::SetCurrent(NULL);
+
+    // Measure how long this update took
+    if (m_pTimer != NULL)
+    {
+        float TickTime = (float)((m_pTimer->GetElapsedTime() - StartTime) * 1000.0);
+
+        m_NumberOfTicks++;
+        m_TotalTickTime += TickTime;
+
+        if (TickTime > m_MaxTickTime)
+            m_MaxTickTime = TickTime;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerMatch::ResetTickStatistics (void)
+{
+    m_NumberOfTicks = 0;
+    m_TotalTickTime = 0.0f;
+    m_MaxTickTime = 0.0f;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,176 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CServerMatch.h
+ *  \brief Header file of a match hosted by the dedicated server
+ */
+
+#ifndef __CSERVERMATCH_H__
+#define __CSERVERMATCH_H__
+
+#include "CArena.h"
+#include "CClock.h"
+#include "CMatchRules.h"
+#include "COptions.h"
+#include "CCommandChunk.h"
+#include "CArenaSnapshot.h"
+
+class CSound;
+class CTimer;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define MAX_QUEUED_COMMAND_CHUNKS       16      //!< Maximum number of command chunks waiting to be applied for each player
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! State of a match hosted by the dedicated server
+enum EServerMatchState
+{
+    SERVERMATCHSTATE_STARTING,      //!< The clients are showing the arena before the match starts
+    SERVERMATCHSTATE_PLAYING,       //!< The bombers are playing
+    SERVERMATCHSTATE_OVER,          //!< The match is over, the arena is still updated for a little pause
+    SERVERMATCHSTATE_FINISHED       //!< The match is over and the pause is over too
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A match without any screen, input or sound, hosted by the dedicated server.
+
+/**
+ * It follows the rules of CMatch through the same CMatchRules (time up closing
+ * the arena, one team left winning the match, draw games) but all the bombers
+ * are network players.
+ * The dedicated server feeds it with the command chunks it receives and
+ * sends the snapshots it writes. Update() only touches this object, so
+ * several matches can be updated at the same time by different threads.
+ * Each match draws its random numbers from its own generator, seeded
+ * with the seed the clients receive, so that they draw the same ones.
+ */
+
+class CServerMatch
+{
+private:
+
+    CTimer*         m_pTimer;                       //!< Timer used to measure the update time
+    COptions        m_Options;                      //!< Options of this match (bomber types, times, level)
+    CArena          m_Arena;                        //!< Arena object
+    CClock          m_Clock;                        //!< Clock object
+    CMatchRules     m_Rules;                        //!< Rules of the match, the same as CMatch's
+    CRandom         m_Random;                       //!< Random numbers of this match, drawn by RANDOM() while it is created and updated
+    EServerMatchState m_State;                      //!< Current state of the match
+    float           m_StateTime;                    //!< Time (in seconds) that elapsed since the state started
+    CCommandChunk   m_QueuedChunks[MAX_PLAYERS][MAX_QUEUED_COMMAND_CHUNKS]; //!< Command chunks received and not applied yet
+    int             m_NumberOfQueuedChunks[MAX_PLAYERS];  //!< Number of command chunks received and not applied yet
+    int             m_AcknowledgedSequence[MAX_PLAYERS];  //!< Sequence of the latest command chunk applied for each player
+    bool            m_SnapshotReady;                //!< Was a snapshot written during the latest update?
+    CArenaSnapshot  m_Snapshot;                     //!< Latest snapshot of the arena
+    int             m_NumberOfTicks;                //!< Number of updates since the statistics were reset
+    float           m_TotalTickTime;                //!< Total time (in milliseconds) spent in these updates
+    float           m_MaxTickTime;                  //!< Longest of these updates (in milliseconds)
+
+    void            ApplyCommandChunks (void);      //!< Apply the queued command chunks to the bombers
+    void            ManageMatchOver (void);         //!< Determine if the match is over and who won it
+
+public:
+
+                    CServerMatch (void);                //!< Constructor. Initialize some members.
+                    ~CServerMatch (void);               //!< Destructor. Does nothing.
+    inline void     SetTimer (CTimer* pTimer);          //!< Set link to the timer object to use
+    void            Create (const COptions& Options, int NumberOfPlayers, CSound* pSound, unsigned int Seed); //!< Initialize the match for the given number of network players, with the random seed sent to the clients
+    void            Destroy (void);                     //!< Uninitialize the match
+    void            Update (float DeltaTime);           //!< Update the match. Can be called from any thread.
+    void            QueueCommandChunk (int Player, const CCommandChunk& CommandChunk); //!< Remember a command chunk received from the player
+    void            ResetTickStatistics (void);         //!< Start measuring the update time again
+    inline EServerMatchState GetState (void);           //!< Get the current state of the match
+    inline int      GetWinnerTeam (void);               //!< Get the number of the team that won this match
+    inline bool     IsSnapshotReady (void);             //!< Was a snapshot written during the latest update?
+    inline CArenaSnapshot& GetSnapshot (void);          //!< Get the latest snapshot of the arena
+    inline int      GetAcknowledgedSequence (int Player); //!< Get the sequence of the latest command chunk applied for the player
+    inline int      GetNumberOfTicks (void);            //!< Get the number of updates since the statistics were reset
+    inline float    GetAverageTickTime (void);          //!< Get the average update time (in milliseconds)
+    inline float    GetMaxTickTime (void);              //!< Get the longest update time (in milliseconds)
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline void CServerMatch::SetTimer (CTimer* pTimer)
+{
+    m_pTimer = pTimer;
+}
+
+inline EServerMatchState CServerMatch::GetState (void)
+{
+    return m_State;
+}
+
+inline int CServerMatch::GetWinnerTeam (void)
+{
+    return m_Rules.GetWinnerTeam();
+}
+
+inline bool CServerMatch::IsSnapshotReady (void)
+{
+    return m_SnapshotReady;
+}
+
+inline CArenaSnapshot& CServerMatch::GetSnapshot (void)
+{
+    return m_Snapshot;
+}
+
+inline int CServerMatch::GetAcknowledgedSequence (int Player)
+{
+    ASSERT (Player >= 0 && Player < MAX_PLAYERS);
+
+    return m_AcknowledgedSequence[Player];
+}
+
+inline int CServerMatch::GetNumberOfTicks (void)
+{
+    return m_NumberOfTicks;
+}
+
+inline float CServerMatch::GetAverageTickTime (void)
+{
+    return (m_NumberOfTicks > 0 ? m_TotalTickTime / m_NumberOfTicks : 0.0f);
+}
+
+inline float CServerMatch::GetMaxTickTime (void)
+{
+    return m_MaxTickTime;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CSERVERMATCH_H__
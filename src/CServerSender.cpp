@@ -0,0 +1,375 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+/**
+ *  \file CServerSender.cpp
+ *  \brief Threads sending the frames of the dedicated server
+ */
+
+#include "StdAfx.h"
+#include "CServerSender.h"
+#include "CServerConnection.h"
+
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+struct SServerSenderThreads
+{
+    std::thread*            pThreads;                   //!< Sending threads
+    std::mutex              Mutex;                      //!< Protects the sender and every connection
+    std::condition_variable WorkAvailable;              //!< Signaled when a connection is ready or when the threads have to quit
+    std::condition_variable WorkDone;                   //!< Signaled when a thread finished a send
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CServerSender::CServerSender (void)
+{
+    m_pThreads = NULL;
+    m_NumberOfThreads = 0;
+    m_pFirstReady = NULL;
+    m_pLastReady = NULL;
+    m_NumberOfConnections = 0;
+    m_BusySenders = 0;
+    m_Quit = false;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CServerSender::~CServerSender (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CServerSender::Create (int NumberOfThreads)
+{
+    ASSERT (m_pThreads == NULL);
+    ASSERT (NumberOfThreads > 0);
+
+    m_Quit = false;
+    m_BusySenders = 0;
+
+    m_pThreads = new SServerSenderThreads;
+    m_pThreads->pThreads = new std::thread [NumberOfThreads];
+
+    for (m_NumberOfThreads = 0; m_NumberOfThreads < NumberOfThreads; m_NumberOfThreads++)
+        m_pThreads->pThreads[m_NumberOfThreads] = std::thread(&CServerSender::SenderThread, this);
+
+    theLog.WriteLine("ServerSender    => Started %d sending thread(s).", m_NumberOfThreads);
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return true, if every thread stopped
+ *
+ *  The connections should all be closed first. A thread blocked on a client
+ *  that does not read is left running until the process ends.
+ */
+
+bool CServerSender::Destroy (void)
+{
+    if (m_pThreads == NULL)
+        return true;
+
+    std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+
+    // Wake the threads up and tell them to quit once the list is empty
+    m_Quit = true;
+    m_pThreads->WorkAvailable.notify_all();
+
+    std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::now() +
+        std::chrono::milliseconds((int)(SERVER_SENDER_SHUTDOWN_TIMEOUT * 1000.0f));
+
+    while (m_BusySenders > 0 || m_pFirstReady != NULL)
+    {
+        if (m_pThreads->WorkDone.wait_until(Lock, Deadline) == std::cv_status::timeout)
+            break;
+    }
+
+    // If a thread is still sending, it needs the mutex when its send ends : keep everything alive
+    if (m_BusySenders > 0)
+    {
+        theLog.WriteLine("ServerSender    => %d thread(s) still blocked on a client.", m_BusySenders);
+
+        for (int Thread = 0; Thread < m_NumberOfThreads; Thread++)
+            m_pThreads->pThreads[Thread].detach();
+
+        m_pThreads = NULL;
+        m_NumberOfThreads = 0;
+
+        return false;
+    }
+
+    Lock.unlock();
+
+    for (int Thread = 0; Thread < m_NumberOfThreads; Thread++)
+        m_pThreads->pThreads[Thread].join();
+
+    delete [] m_pThreads->pThreads;
+    delete m_pThreads;
+    m_pThreads = NULL;
+    m_NumberOfThreads = 0;
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerSender::AddConnection (CServerConnection* pConnection)
+{
+    ASSERT (m_pThreads != NULL);
+    ASSERT (pConnection != NULL);
+
+    std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+
+    m_NumberOfConnections++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return true, if the frame was queued or replaced the latest queued frame
+ */
+
+bool CServerSender::Send (CServerConnection* pConnection, CSharedBuffer* pFrame, bool Replaceable)
+{
+    ASSERT (m_pThreads != NULL);
+    ASSERT (pFrame != NULL);
+
+    std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+
+    ASSERT (!pConnection->m_Closed);
+
+    if (pConnection->m_Failed)
+        return false;
+
+    // If the latest queued frame is out of date, send this one instead
+    if (Replaceable && pConnection->m_NumberOfFrames > 0)
+    {
+        int Last = (pConnection->m_FirstFrame + pConnection->m_NumberOfFrames - 1) % SERVER_CONNECTION_MAX_QUEUED_FRAMES;
+
+        if (pConnection->m_Replaceable[Last])
+        {
+            pFrame->AddReference();
+            pConnection->m_pFrames[Last]->Release();
+            pConnection->m_pFrames[Last] = pFrame;
+            return true;
+        }
+    }
+
+    // If the client does not read what it is sent
+    if (pConnection->m_NumberOfFrames == SERVER_CONNECTION_MAX_QUEUED_FRAMES)
+    {
+        pConnection->m_Failed = true;
+        return false;
+    }
+
+    int Next = (pConnection->m_FirstFrame + pConnection->m_NumberOfFrames) % SERVER_CONNECTION_MAX_QUEUED_FRAMES;
+
+    pFrame->AddReference();
+    pConnection->m_pFrames[Next] = pFrame;
+    pConnection->m_Replaceable[Next] = Replaceable;
+    pConnection->m_NumberOfFrames++;
+
+    // A connection being sent to is put back in the list after its send
+    if (!pConnection->m_Ready && !pConnection->m_Sending)
+    {
+        Schedule(pConnection);
+        m_pThreads->WorkAvailable.notify_one();
+    }
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerSender::Close (CServerConnection* pConnection)
+{
+    ASSERT (m_pThreads != NULL);
+
+    std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+
+    ASSERT (!pConnection->m_Closed);
+
+    pConnection->m_Closed = true;
+
+    DropFrames(pConnection);
+
+    // The thread sending to the connection, or the one taking it out of the list, deletes it
+    if (!pConnection->m_Ready && !pConnection->m_Sending)
+    {
+        delete pConnection;
+        m_NumberOfConnections--;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+int CServerSender::GetNumberOfConnections (void)
+{
+    ASSERT (m_pThreads != NULL);
+
+    std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+
+    return m_NumberOfConnections;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerSender::Schedule (CServerConnection* pConnection)
+{
+    pConnection->m_pNextReady = NULL;
+    pConnection->m_Ready = true;
+
+    if (m_pLastReady != NULL)
+        m_pLastReady->m_pNextReady = pConnection;
+    else
+        m_pFirstReady = pConnection;
+
+    m_pLastReady = pConnection;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerSender::DropFrames (CServerConnection* pConnection)
+{
+    while (pConnection->m_NumberOfFrames > 0)
+    {
+        pConnection->m_pFrames[pConnection->m_FirstFrame]->Release();
+        pConnection->m_FirstFrame = (pConnection->m_FirstFrame + 1) % SERVER_CONNECTION_MAX_QUEUED_FRAMES;
+        pConnection->m_NumberOfFrames--;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CServerSender::SenderThread (void)
+{
+    std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+
+    while (true)
+    {
+        // Wait for a connection to send to
+        while (!m_Quit && m_pFirstReady == NULL)
+            m_pThreads->WorkAvailable.wait(Lock);
+
+        // Quit once the closed connections left in the list are deleted
+        if (m_pFirstReady == NULL)
+            break;
+
+        CServerConnection* pConnection = m_pFirstReady;
+
+        m_pFirstReady = pConnection->m_pNextReady;
+
+        if (m_pFirstReady == NULL)
+            m_pLastReady = NULL;
+
+        pConnection->m_Ready = false;
+
+        // If the connection was closed while it waited
+        if (pConnection->m_Closed)
+        {
+            delete pConnection;
+            m_NumberOfConnections--;
+            m_pThreads->WorkDone.notify_all();
+            continue;
+        }
+
+        // Once taken out of the queue, the frame can't be replaced anymore
+        CSharedBuffer* pFrame = pConnection->m_pFrames[pConnection->m_FirstFrame];
+
+        pConnection->m_FirstFrame = (pConnection->m_FirstFrame + 1) % SERVER_CONNECTION_MAX_QUEUED_FRAMES;
+        pConnection->m_NumberOfFrames--;
+        pConnection->m_Sending = true;
+        m_BusySenders++;
+
+        // Don't hold the lock while sending
+        Lock.unlock();
+
+        bool Sent = (SDLNet_TCP_Send(pConnection->GetSocket(), pFrame->GetData(), pFrame->GetSize()) == pFrame->GetSize());
+
+        pFrame->Release();
+
+        Lock.lock();
+
+        pConnection->m_Sending = false;
+        m_BusySenders--;
+
+        if (pConnection->m_Closed)
+        {
+            delete pConnection;
+            m_NumberOfConnections--;
+        }
+        else if (!Sent)
+        {
+            // Keep the connection until the event loop sees the failure and closes it
+            pConnection->m_Failed = true;
+            DropFrames(pConnection);
+        }
+        // Serve the other clients before sending the next frame of this one
+        else if (pConnection->m_NumberOfFrames > 0)
+        {
+            Schedule(pConnection);
+        }
+
+        m_pThreads->WorkDone.notify_all();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
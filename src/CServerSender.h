@@ -0,0 +1,102 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+
+/**
+ *  \file CServerSender.h
+ *  \brief Header file of the threads sending the frames of the dedicated server
+ */
+
+#ifndef __CSERVERSENDER_H__
+#define __CSERVERSENDER_H__
+
+#include "CSharedBuffer.h"
+
+class CServerConnection;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define SERVER_SENDER_THREADS               4       //!< Number of threads sending the queued frames
+#define SERVER_SENDER_SHUTDOWN_TIMEOUT      1.0f    //!< Time (in seconds) Destroy() waits for the sends in progress
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+// The standard thread classes are only used in CServerSender.cpp, because
+// the standard headers conflict with the portable STL ones included before.
+struct SServerSenderThreads;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A few threads sending the frames the event loop of the dedicated server queued in the connections.
+
+/**
+ * SDL_net sockets only have blocking sends. The connections that have
+ * frames to send wait in a list, and each thread takes the first one,
+ * sends its oldest frame and puts it back at the end of the list if it
+ * has more : the clients are served in turn. A client that does not read
+ * only keeps one thread busy, until it is disconnected because its queue
+ * is full.
+ *
+ * The connections and the list are protected by a single mutex. A closed
+ * connection is deleted by the thread sending to it, or right away if no
+ * thread uses it.
+ */
+
+class CServerSender
+{
+private:
+
+    SServerSenderThreads*   m_pThreads;                 //!< Sending threads and what they use to synchronize
+    int                     m_NumberOfThreads;          //!< Number of sending threads
+    CServerConnection*      m_pFirstReady;              //!< First connection waiting for a thread, NULL if none
+    CServerConnection*      m_pLastReady;               //!< Last connection waiting for a thread, NULL if none
+    int                     m_NumberOfConnections;      //!< Number of connections that are not deleted yet
+    int                     m_BusySenders;              //!< Number of threads sending a frame
+    bool                    m_Quit;                     //!< Do the threads have to quit once the list is empty?
+
+    void                    SenderThread (void);        //!< Main function of each sending thread
+    void                    Schedule (CServerConnection* pConnection); //!< Put the connection at the end of the list. The mutex must be locked.
+    void                    DropFrames (CServerConnection* pConnection); //!< Release the queued frames of the connection. The mutex must be locked.
+
+public:
+
+                            CServerSender (void);       //!< Constructor. Initialize some members.
+                            ~CServerSender (void);      //!< Destructor. Does nothing.
+    bool                    Create (int NumberOfThreads); //!< Start the sending threads
+    bool                    Destroy (void);             //!< Stop the threads once the sends in progress are over. Return false if a thread is still blocked on a client.
+    void                    AddConnection (CServerConnection* pConnection); //!< Count a new connection
+    bool                    Send (CServerConnection* pConnection, CSharedBuffer* pFrame, bool Replaceable); //!< Queue the frame in the connection, return false if the client has to be disconnected
+    void                    Close (CServerConnection* pConnection); //!< Drop the queued frames and delete the connection once no thread uses it
+    int                     GetNumberOfConnections (void); //!< Get the number of connections that are not deleted yet, closed or not
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CSERVERSENDER_H__
@@ -0,0 +1,100 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CSharedBuffer.cpp
+ *  \brief Reference counted buffer
+ */
+
+#include "StdAfx.h"
+#include "CSharedBuffer.h"
+
+#include <mutex>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+static std::mutex ReferencesMutex;                      //!< Protects the number of references of every buffer
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CSharedBuffer::CSharedBuffer (int Size)
+{
+    ASSERT (Size > 0);
+
+    m_pData = new char [Size];
+    m_Size = Size;
+    m_References = 1;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CSharedBuffer::~CSharedBuffer (void)
+{
+    delete [] m_pData;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CSharedBuffer::AddReference (void)
+{
+    std::unique_lock<std::mutex> Lock(ReferencesMutex);
+
+    ASSERT (m_References > 0);
+
+    m_References++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CSharedBuffer::Release (void)
+{
+    bool LastOwner;
+
+    {
+        std::unique_lock<std::mutex> Lock(ReferencesMutex);
+
+        ASSERT (m_References > 0);
+
+        LastOwner = (--m_References == 0);
+    }
+
+    // If this was the last owner
+    if (LastOwner)
+        delete this;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
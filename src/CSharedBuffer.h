@@ -0,0 +1,88 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CSharedBuffer.h
+ *  \brief Header file of a reference counted buffer
+ */
+
+#ifndef __CSHAREDBUFFER_H__
+#define __CSHAREDBUFFER_H__
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A buffer written once and then read by several owners.
+
+/**
+ * The buffer is created with one reference. Each new owner calls
+ * AddReference() and each owner calls Release() when it does not need
+ * the buffer anymore. The last Release() deletes the buffer.
+ * The owners may be on different threads, but the content must not change
+ * once the buffer is shared.
+ */
+
+class CSharedBuffer
+{
+private:
+
+    char*           m_pData;                        //!< Content of the buffer
+    int             m_Size;                         //!< Size of the buffer in bytes
+    int             m_References;                   //!< Number of owners of the buffer
+
+                    ~CSharedBuffer (void);          //!< Destructor. Only Release() can delete the buffer.
+
+public:
+
+                    CSharedBuffer (int Size);       //!< Constructor. Allocate the buffer, with one reference.
+    void            AddReference (void);            //!< One more owner uses the buffer
+    void            Release (void);                 //!< One owner does not use the buffer anymore
+    inline char*    GetData (void);                 //!< Get the content of the buffer
+    inline int      GetSize (void);                 //!< Get the size of the buffer in bytes
+    inline int      GetReferences (void);           //!< Get the number of owners of the buffer
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline char* CSharedBuffer::GetData (void)
+{
+    return m_pData;
+}
+
+inline int CSharedBuffer::GetSize (void)
+{
+    return m_Size;
+}
+
+inline int CSharedBuffer::GetReferences (void)
+{
+    return m_References;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CSHAREDBUFFER_H__
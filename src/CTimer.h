@@ -61,6 +61,7 @@ private:
     bool m_Pause;               // Is the timer paused?
     float m_DeltaTimeAtPause;   // Delta time saved on pause and restored on resume
     float m_Speed;              // Coefficient to apply to the deltatime before returning it
+    float m_FixedDeltaTime;     // Delta time of every update whatever the time spent, 0 to follow the clock
 
 private:
 
@@ -117,18 +118,27 @@ public:
         m_DeltaTimeAtPause = 0.0f;
         m_Pause = false;
         m_Speed = 1.0f;
+        m_FixedDeltaTime = 0.0f;
     }
 
     // This method updates the time value and deltatime
     // value of the timer.
     void Update ()
     {
-        // Without the sleep, the clouds hopped and the mouse pointer froze (tracker item #1870410)
-        Sleep( 1 );
+        // The frames are paced by CFrameScheduler, so that the delta time
+        // is never close to zero (the clouds hopped, tracker item #1870410)
 
         // The timer must not be paused
         ASSERT (!m_Pause);
 
+        // If the time advances by steps, when the frames are exported for instance
+        if (m_FixedDeltaTime > 0.0f)
+        {
+            m_Time += m_FixedDeltaTime;
+            m_DeltaTime = m_FixedDeltaTime;
+            return;
+        }
+
         // Get the current time value
         double Time = GetCurrentTime ();
 
@@ -163,7 +173,8 @@ public:
         if (m_Pause)                                        // Timer must not be already unpaused
         {
             m_Pause = false;                                // Set unpaused
-            m_Time = GetCurrentTime() - m_DeltaTimeAtPause; // Update time
+            if (m_FixedDeltaTime <= 0.0f)                   // The steps do not depend on the pause
+                m_Time = GetCurrentTime() - m_DeltaTimeAtPause; // Update time
             m_DeltaTime = m_DeltaTimeAtPause;               // Update deltatime
         }
     }
@@ -174,9 +185,20 @@ public:
         m_Speed = Speed;
     }
 
+    // Make the time advance by the given delta time on each update, whatever
+    // the time spent since the previous one (0 to follow the clock again)
+    void SetFixedDeltaTime (float DeltaTime)
+    {
+        m_FixedDeltaTime = DeltaTime;
+    }
+
     // These methods are used to get the time and deltatime values
     float GetDeltaTime (void) { ASSERT(!m_Pause); return m_DeltaTime * m_Speed; }
     double GetTime (void) { ASSERT(!m_Pause); return m_Time; }
+
+    // This method returns the time elapsed since the construction of the timer,
+    // right now and without updating the timer. It is used to measure durations.
+    double GetElapsedTime (void) { return GetCurrentTime(); }
 };
 
 
@@ -33,7 +33,6 @@
 #include "BombermaaanAssets.h"
 
 #include "CVideoSDL.h"
-#include "hqx/HQ2x.hh"
 
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
 constexpr Uint32 rmask = 0x0000ff00;
@@ -53,6 +52,16 @@ static const char* GetSDLVideoError();
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+#define SCALE_MIN_BAND_HEIGHT   16      //!< Minimum number of rows in a band of the back buffer, so that a band is worth a thread
+
+#define DIRTY_TILE_SIZE         16      //!< Size (in pixels) of the square tiles the display is compared in from one frame to the next
+#define TILE_HASH_SEED          14695981039346656037ULL     //!< Hash of a tile without any drawing request (FNV-1a offset basis)
+#define TILE_HASH_PRIME         1099511628211ULL            //!< Multiplier of the tile hashes (FNV-1a prime)
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 CVideoSDL::CVideoSDL(void)
 {
     m_hWnd = NULL;
@@ -61,12 +70,59 @@ CVideoSDL::CVideoSDL(void)
     m_Depth = 0;
     m_pPrimary = NULL;
     m_PrimaryRect = SDL_Rect();
-#ifdef BOMBERMAAAN_SCALE_2X
     m_pBackBuffer = NULL;
     m_BackBufferRect = SDL_Rect();
-#endif
+    m_Scaler = SCALER_NEAREST;
+    m_Scale = 1;
+    m_pScaler = NULL;
+    m_NumberOfScalePasses = 0;
+    m_ScalePass = 0;
+    m_pScaleBuffer = NULL;
+    m_NumberOfBands = 1;
+    m_pPresentRects = NULL;
+    m_NumberOfPresentRects = 0;
+    m_PresentAll = false;
     m_OriginX = 0;
     m_OriginY = 0;
+    m_TilesX = 0;
+    m_TilesY = 0;
+    m_pTileHashes = NULL;
+    m_pPreviousTileHashes = NULL;
+    m_pDirtyTiles = NULL;
+    m_pDirtyRects = NULL;
+    m_NumberOfDirtyRects = 0;
+    m_RedrawAll = true;
+    m_PreviousFrameCleared = false;
+    m_NumberOfFrames = 0;
+    m_NumberOfRedrawnTiles = 0;
+    m_pStaticLayer = NULL;
+    m_pStaticTileHashes = NULL;
+    m_pCachedStaticTileHashes = NULL;
+    m_RedrawStaticLayer = true;
+    m_NumberOfStaticTilesDrawn = 0;
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+    m_PresentWithSDL2 = false;
+#endif
+    m_FullPresentTime = 0.0;
+    m_NumberOfFullPresents = 0;
+    m_PartialPresentTime = 0.0;
+    m_NumberOfPartialPresents = 0;
+
+    m_pFrameExporter = NULL;
+    m_Offscreen = false;
+    m_SortTime = 0.0;
+    m_BlitTime = 0.0;
+    m_ScaleTime = 0.0;
+    m_NextSpriteRunSerial = 0;
+    m_NumberOfRecordedFrames = 0;
+    m_NumberOfSpriteRunsDrawn = 0;
+    m_NumberOfSpriteRunsCreated = 0;
+
+    for (int Frame = 0; Frame < RENDER_FRAMES; Frame++)
+        m_Frames[Frame].Clear = false;
+
+    for (int Hash = 0; Hash < 1 << SPRITETABLE_HANDLE_BITS; Hash++)
+        m_SpriteTableHandles[Hash] = -1;
 }
 
 //******************************************************************************************************************************
@@ -82,7 +138,7 @@ CVideoSDL::~CVideoSDL(void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-bool CVideoSDL::Create(int Width, int Height, int Depth)
+bool CVideoSDL::Create(int Width, int Height, int Depth, EScaler Scaler, int Scale)
 {
 
     theLog.WriteLine("CVideoSDL       => rmask: 0x%x", rmask);
@@ -96,60 +152,62 @@ bool CVideoSDL::Create(int Width, int Height, int Depth)
     m_Depth = Depth;
 
     m_pPrimary = NULL;
-#ifdef BOMBERMAAAN_SCALE_2X
     m_pBackBuffer = NULL;
-    constexpr int scale = 2;
-#else
-    constexpr int scale = 1;
-#endif
-
-    bool validMode = false; // is this video mode valid?
 
-    // Enumerate all display modes (without taking refresh rates into account)
-    SDL_Rect** modes = SDL12_ListModes(NULL, SDL_HWSURFACE | SDL_DOUBLEBUF);
+    // Choose the scaler enlarging the back buffer
+    m_Scaler = Scaler;
+    m_Scale = MIN(MAX(Scale, 1), SCALER_MAX_FACTOR);
+    m_pScaler = NULL;
+    m_NumberOfScalePasses = 0;
 
-    // some mode available?
-    if (modes == (SDL_Rect **)0)
+    if (m_Scale > 1)
     {
-        // Log failure
-        theLog.WriteLine("SDLVideo        => !!! Could not find any video modes.");
-        theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
+        const CScaler* pScaler = NULL;
 
-        // Get out
-        return false;
-    }
-    else if (modes == (SDL_Rect **)-1)
-    {
-        // Log success
-        theLog.WriteLine("SDLVideo        => All modes available");
+        switch (m_Scaler)
+        {
+            case SCALER_HQ2X : pScaler = &m_ScalerHQ2x; break;
+            case SCALER_XBR :  pScaler = &m_ScalerXBR; break;
+            default :          break;
+        }
 
-        // so this mode is possible
-        validMode = true;
-    }
-    else
-    {
-        // enumerate modes and add certain
-        for (int i = 0; modes[i]; ++i) {
-            // is our requested mode possbile?
-            if (modes[i]->w == m_Width && modes[i]->h == m_Height) {
-                validMode = true;
-            }
+        // A 2x scaler enlarges 4 times by being applied twice
+        if (pScaler != NULL && m_Scale == pScaler->GetFactor())
+        {
+            m_NumberOfScalePasses = 1;
         }
+        else if (pScaler != NULL && m_Scale == pScaler->GetFactor() * pScaler->GetFactor())
+        {
+            m_NumberOfScalePasses = 2;
+        }
+        else
+        {
+            if (pScaler != NULL)
+                theLog.WriteLine("SDLVideo        => !!! The %s scaler cannot enlarge %d times, using the nearest scaler.", pScaler->GetName(), m_Scale);
+
+            m_ScalerNearest.SetFactor(m_Scale);
+            pScaler = &m_ScalerNearest;
+            m_NumberOfScalePasses = 1;
+        }
+
+        m_pScaler = pScaler;
     }
 
-    if (!validMode) {
-        // Log failure
-        theLog.WriteLine("SDLVideo        => !!! Requested video mode %dx%d not found.", m_Width, m_Height);
+    const int scale = m_Scale;
+
+    if (m_Offscreen)
+    {
+        // Nothing is shown, the display is drawn in a surface of its own
+        theLog.WriteLine("SDLVideo        => Drawing the display offscreen in a %dx%d surface.", scale * m_Width, scale * m_Height);
 
+        m_pPrimary = SDL12_CreateRGBSurface(SDL_SWSURFACE, scale * m_Width, scale * m_Height, 32, rmask, gmask, bmask, amask);
+    }
+    else if (!SetVideoMode())
+    {
         // Get out
         return false;
     }
 
-    // Log that windowed mode is being initialized
-    theLog.WriteLine("SDLVideo        => Initializing SDLVideo interface for windowed mode %dx%d.", m_Width, m_Height);
-
-    // Get normal windowed mode
-    m_pPrimary = SDL12_SetVideoMode(scale * m_Width, scale * m_Height, m_Depth, SDL_HWSURFACE | SDL_DOUBLEBUF);
     if (m_pPrimary == NULL) {
         theLog.WriteLine("SDLVideo        => !!! Requested video mode could not be set. (primary surface)");  // Log failure
         return false;   // Get out
@@ -160,17 +218,84 @@ bool CVideoSDL::Create(int Width, int Height, int Depth)
     m_PrimaryRect.w = scale * m_Width;
     m_PrimaryRect.h = scale * m_Height;
 
-#ifdef BOMBERMAAAN_SCALE_2X
-    m_pBackBuffer = SDL12_CreateRGBSurface(SDL_HWSURFACE, m_Width, m_Height, 32, rmask, gmask, bmask, amask);
-    if (m_pBackBuffer == NULL) {
-        theLog.WriteLine("SDLVideo        => !!! Requested buffer could not be made. (back buffer)");  // Log failure
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+    // Present through the SDL2 renderer of the window, or let sdl12_compat do it if that fails
+    m_PresentWithSDL2 = (!m_Offscreen &&
+                         m_pPrimary->format->BitsPerPixel == 32 &&
+                         m_VideoSDL2.Create(m_PrimaryRect.w, m_PrimaryRect.h,
+                                            m_pPrimary->format->Rmask, m_pPrimary->format->Gmask,
+                                            m_pPrimary->format->Bmask, m_pPrimary->format->Amask));
+
+    if (!m_Offscreen && !m_PresentWithSDL2)
+        theLog.WriteLine("SDLVideo        => !!! Could not present through SDL2, presenting through sdl12_compat.");
+#endif
+
+    m_FullPresentTime = 0.0;
+    m_NumberOfFullPresents = 0;
+    m_PartialPresentTime = 0.0;
+    m_NumberOfPartialPresents = 0;
+    m_SortTime = 0.0;
+    m_BlitTime = 0.0;
+    m_ScaleTime = 0.0;
+
+    // The workers decode the sprite tables and upscale the back buffer
+    m_WorkerPool.Create(-1);
+
+    if (m_pScaler != NULL)
+    {
+        // The scalers write the rows of the primary surface one after the other
+        if (m_pPrimary->format->BytesPerPixel != 4 || m_pPrimary->pitch != m_PrimaryRect.w * 4)
+        {
+            theLog.WriteLine("SDLVideo        => !!! The primary surface cannot be written by the scalers.");  // Log failure
+            return false;   // Get out
+        }
+
+        m_pBackBuffer = SDL12_CreateRGBSurface(SDL_HWSURFACE, m_Width, m_Height, 32, rmask, gmask, bmask, amask);
+        if (m_pBackBuffer == NULL) {
+            theLog.WriteLine("SDLVideo        => !!! Requested buffer could not be made. (back buffer)");  // Log failure
+            return false;   // Get out
+        }
+        m_BackBufferRect.x = 0;
+        m_BackBufferRect.y = 0;
+        m_BackBufferRect.w = m_Width;
+        m_BackBufferRect.h = m_Height;
+
+        if (m_NumberOfScalePasses > 1)
+            m_pScaleBuffer = new uint32_t [m_pScaler->GetFactor() * m_Width * m_pScaler->GetFactor() * m_Height];
+
+        // Upscale the back buffer on every core : the calling thread
+        // takes a band too, so there is one band more than workers.
+        m_NumberOfBands = MIN(m_WorkerPool.GetNumberOfThreads() + 1, MAX(m_Height / SCALE_MIN_BAND_HEIGHT, 1));
+
+        theLog.WriteLine("SDLVideo        => Back buffer enlarged %d times by the %s scaler (%s kernel) in %d pass(es) of %d band(s).",
+            m_Scale, m_pScaler->GetName(), m_pScaler->GetKernelName(), m_NumberOfScalePasses, m_NumberOfBands);
+    }
+
+    // Only the tiles whose drawing requests changed are drawn, upscaled and presented again
+    m_TilesX = (m_Width + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+    m_TilesY = (m_Height + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+    m_pTileHashes = new Uint64 [m_TilesX * m_TilesY];
+    m_pPreviousTileHashes = new Uint64 [m_TilesX * m_TilesY];
+    m_pDirtyTiles = new bool [m_TilesX * m_TilesY];
+    m_pDirtyRects = new SDL_Rect [m_TilesX * m_TilesY];
+    m_pPresentRects = new SDL_Rect [m_TilesX * m_TilesY];
+    m_NumberOfPresentRects = 0;
+    m_NumberOfFrames = 0;
+    m_NumberOfRedrawnTiles = 0;
+    m_NumberOfSpriteRunsDrawn = 0;
+    m_NumberOfSpriteRunsCreated = 0;
+
+    // The static sprites are drawn once in the static layer, which is blitted under the other sprites
+    m_pStaticLayer = SDL12_CreateRGBSurface(SDL_SWSURFACE, m_Width, m_Height, 32, rmask, gmask, bmask, amask);
+    if (m_pStaticLayer == NULL) {
+        theLog.WriteLine("SDLVideo        => !!! Requested buffer could not be made. (static layer)");  // Log failure
         return false;   // Get out
     }
-    m_BackBufferRect.x = 0;
-    m_BackBufferRect.y = 0;
-    m_BackBufferRect.w = m_Width;
-    m_BackBufferRect.h = m_Height;
-#endif
+    SDL12_SetColorKey(m_pStaticLayer, SDL_SRCCOLORKEY, SDL12_MapRGB(m_pStaticLayer->format, 0x00, 0xff, 0x00));
+    m_pStaticTileHashes = new Uint64 [m_TilesX * m_TilesY];
+    m_pCachedStaticTileHashes = new Uint64 [m_TilesX * m_TilesY];
+    m_RedrawStaticLayer = true;
+    m_NumberOfStaticTilesDrawn = 0;
 
     // show cursor depending on windowed/fullscreen mode
     SDL12_ShowCursor(true);
@@ -194,6 +319,16 @@ bool CVideoSDL::Create(int Width, int Height, int Depth)
     SDL12_FreeSurface(icon);
     SDL12_FreeRW(rwIcon);
 
+    // Write the frames to the video file instead of presenting them
+    if (m_pFrameExporter != NULL && !m_pFrameExporter->Create(m_pPrimary))
+        return false;
+
+    // Draw the frames on a thread of their own, the first one on a black display
+    for (int Frame = 0; Frame < RENDER_FRAMES; Frame++)
+        m_Frames[Frame].Clear = false;
+
+    m_RenderThread.Create(RenderFrame, this);
+
     // Clear the back buffer surface
     Clear();
 
@@ -209,6 +344,63 @@ bool CVideoSDL::Create(int Width, int Height, int Depth)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+bool CVideoSDL::SetVideoMode(void)
+{
+    bool validMode = false; // is this video mode valid?
+
+    // Enumerate all display modes (without taking refresh rates into account)
+    SDL_Rect** modes = SDL12_ListModes(NULL, SDL_HWSURFACE | SDL_DOUBLEBUF);
+
+    // some mode available?
+    if (modes == (SDL_Rect **)0)
+    {
+        // Log failure
+        theLog.WriteLine("SDLVideo        => !!! Could not find any video modes.");
+        theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
+
+        // Get out
+        return false;
+    }
+    else if (modes == (SDL_Rect **)-1)
+    {
+        // Log success
+        theLog.WriteLine("SDLVideo        => All modes available");
+
+        // so this mode is possible
+        validMode = true;
+    }
+    else
+    {
+        // enumerate modes and add certain
+        for (int i = 0; modes[i]; ++i) {
+            // is our requested mode possbile?
+            if (modes[i]->w == m_Width && modes[i]->h == m_Height) {
+                validMode = true;
+            }
+        }
+    }
+
+    if (!validMode) {
+        // Log failure
+        theLog.WriteLine("SDLVideo        => !!! Requested video mode %dx%d not found.", m_Width, m_Height);
+
+        // Get out
+        return false;
+    }
+
+    // Log that windowed mode is being initialized
+    theLog.WriteLine("SDLVideo        => Initializing SDLVideo interface for windowed mode %dx%d.", m_Width, m_Height);
+
+    // Get normal windowed mode
+    m_pPrimary = SDL12_SetVideoMode(m_Scale * m_Width, m_Scale * m_Height, m_Depth, SDL_HWSURFACE | SDL_DOUBLEBUF);
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 // Destroys the SDLVideo interface
 
 void CVideoSDL::Destroy(void)
@@ -216,7 +408,83 @@ void CVideoSDL::Destroy(void)
     // Free drawing requests, sprite tables, surfaces...
     FreeSprites();
 
-#ifdef BOMBERMAAAN_SCALE_2X
+    // The render thread has nothing left to draw
+    m_RenderThread.Destroy();
+
+    // Write the frames still waiting and close the video file
+    if (m_pFrameExporter != NULL)
+        m_pFrameExporter->Destroy();
+
+    if (m_NumberOfFrames > 0)
+    {
+        theLog.WriteLine("SDLVideo        => %.1f%% of the display was drawn again per frame on average (%d frames).",
+            100.0f * m_NumberOfRedrawnTiles / ((float)m_NumberOfFrames * m_TilesX * m_TilesY), m_NumberOfFrames);
+        theLog.WriteLine("SDLVideo        => %d tile(s) of the static layer were drawn again.", m_NumberOfStaticTilesDrawn);
+        theLog.WriteLine("SDLVideo        => Sorting took %.3f ms, drawing %.3f ms and upscaling %.3f ms per frame on average.",
+            m_SortTime * 1000.0 / m_NumberOfFrames, m_BlitTime * 1000.0 / m_NumberOfFrames, m_ScaleTime * 1000.0 / m_NumberOfFrames);
+    }
+
+    if (m_NumberOfSpriteRunsDrawn > 0)
+    {
+        theLog.WriteLine("SDLVideo        => %d sprite run(s) drawn, %.1f%% found in the cache (%d created).",
+            m_NumberOfSpriteRunsDrawn, 100.0f * (m_NumberOfSpriteRunsDrawn - m_NumberOfSpriteRunsCreated) / m_NumberOfSpriteRunsDrawn,
+            m_NumberOfSpriteRunsCreated);
+    }
+
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+    const char* pPresenter = (m_PresentWithSDL2 ? "SDL2 renderer" : "sdl12_compat");
+#else
+    const char* pPresenter = "sdl12_compat";
+#endif
+
+    if (m_NumberOfFullPresents > 0)
+    {
+        theLog.WriteLine("SDLVideo        => Presenting the whole display took %.3f ms on average (%d frames, %s).",
+            m_FullPresentTime * 1000.0 / m_NumberOfFullPresents, m_NumberOfFullPresents, pPresenter);
+    }
+
+    if (m_NumberOfPartialPresents > 0)
+    {
+        theLog.WriteLine("SDLVideo        => Presenting the dirty zones took %.3f ms on average (%d frames, %s).",
+            m_PartialPresentTime * 1000.0 / m_NumberOfPartialPresents, m_NumberOfPartialPresents, pPresenter);
+    }
+
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+    // The texture belongs to the renderer of the window, release it before the window
+    m_VideoSDL2.Destroy();
+    m_PresentWithSDL2 = false;
+#endif
+
+    if (m_pStaticLayer != NULL)
+    {
+        SDL12_FreeSurface(m_pStaticLayer);
+        m_pStaticLayer = NULL;
+    }
+
+    delete [] m_pStaticTileHashes;
+    delete [] m_pCachedStaticTileHashes;
+    m_pStaticTileHashes = NULL;
+    m_pCachedStaticTileHashes = NULL;
+
+    delete [] m_pTileHashes;
+    delete [] m_pPreviousTileHashes;
+    delete [] m_pDirtyTiles;
+    delete [] m_pDirtyRects;
+    m_pTileHashes = NULL;
+    m_pPreviousTileHashes = NULL;
+    m_pDirtyTiles = NULL;
+    m_pDirtyRects = NULL;
+    m_NumberOfDirtyRects = 0;
+
+    delete [] m_pPresentRects;
+    m_pPresentRects = NULL;
+    m_NumberOfPresentRects = 0;
+
+    m_WorkerPool.Destroy();
+
+    delete [] m_pScaleBuffer;
+    m_pScaleBuffer = NULL;
+
     // If the back buffer surface exists
     if (m_pBackBuffer != NULL)
     {
@@ -227,7 +495,6 @@ void CVideoSDL::Destroy(void)
         // Log release
         theLog.WriteLine("SDLVideo        => Backbuffer surface was released.");
     }
-#endif
 
     // If the primary surface exists
     if (m_pPrimary != NULL)
@@ -248,29 +515,102 @@ void CVideoSDL::Destroy(void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-// Updates the display by blitting the back buffer
-// surface on the primary surface.
+/**
+ *  The rendered frame is presented by the thread that made the window,
+ *  the only one SDL lets present. The render thread waits until it is
+ *  done before drawing the next frame over it.
+ */
 
 void CVideoSDL::UpdateScreen(void)
+{
+    // If the render thread did not finish a frame since the previous present
+    if (!m_RenderThread.IsFrameRendered())
+        return;
+
+    // If the frame was written to the video file instead, or is not shown at all
+    if (m_pFrameExporter != NULL || m_Offscreen)
+    {
+        m_RenderThread.EndPresent();
+        return;
+    }
+
+    // If nothing changed in the rendered frame, the window already shows it
+    if (m_NumberOfPresentRects == 0)
+    {
+        m_RenderThread.EndPresent();
+        return;
+    }
+
+    if (m_PresentAll)
+    {
+        PresentAll();
+        m_RenderThread.EndPresent();
+        return;
+    }
+
+    // Only some zones changed, present them alone
+    double StartTime = m_PresentTimer.GetElapsedTime();
+
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+    if (m_PresentWithSDL2)
+    {
+        for (int Rect = 0; Rect < m_NumberOfPresentRects; Rect++)
+            m_VideoSDL2.Update(m_pPrimary->pixels, m_pPrimary->pitch, m_pPresentRects[Rect].x, m_pPresentRects[Rect].y, m_pPresentRects[Rect].w, m_pPresentRects[Rect].h);
+
+        m_VideoSDL2.Present();
+    }
+    else
+#endif
+    {
+        // sdl12_compat presents the zones later, when the events are pumped.
+        // Pump them now so that the frame is not shown after the frame scheduler waited.
+        SDL12_UpdateRects(m_pPrimary, m_NumberOfPresentRects, m_pPresentRects);
+        SDL12_PumpEvents();
+    }
+
+    m_PartialPresentTime += m_PresentTimer.GetElapsedTime() - StartTime;
+    m_NumberOfPartialPresents++;
+
+    m_RenderThread.EndPresent();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::PresentAll(void)
 {
     HRESULT hRet;
 
-#ifdef BOMBERMAAAN_SCALE_2X
-    HQ2x().resize(reinterpret_cast<uint32_t*>(m_pBackBuffer->pixels),
-                  m_Width,
-                  m_Height,
-                  reinterpret_cast<uint32_t*>(m_pPrimary->pixels));
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+    if (m_PresentWithSDL2)
+    {
+        double StartTime = m_PresentTimer.GetElapsedTime();
+
+        m_VideoSDL2.Update(m_pPrimary->pixels, m_pPrimary->pitch, 0, 0, m_PrimaryRect.w, m_PrimaryRect.h);
+        m_VideoSDL2.Present();
+
+        m_FullPresentTime += m_PresentTimer.GetElapsedTime() - StartTime;
+        m_NumberOfFullPresents++;
+
+        return;
+    }
 #endif
 
     while (true)
     {
+        double StartTime = m_PresentTimer.GetElapsedTime();
+
         // Update the primary surface by flipping backbuffer and primary surface
         hRet = SDL12_Flip(m_pPrimary);
-        SDL12_Delay(5);
+
+        m_FullPresentTime += m_PresentTimer.GetElapsedTime() - StartTime;
 
         // If it worked fine
         if (hRet == 0)
         {
+            m_NumberOfFullPresents++;
+
             // Get out
             break;
         }
@@ -280,6 +620,9 @@ void CVideoSDL::UpdateScreen(void)
             theLog.WriteLine("SDLVideo        => !!! Updating failed (switching primary/backbuffer).");
             theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
         }
+
+        // Give the display some time before trying again
+        SDL12_Delay(5);
     }
 }
 
@@ -287,59 +630,206 @@ void CVideoSDL::UpdateScreen(void)
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-// Updates the object : this updates the drawing zones in case the window moves.
+/**
+ *  Called by the render thread once the dirty zones are drawn on the back
+ *  buffer. The zones to present are kept apart from the dirty zones, which
+ *  the render thread finds again for the next frame while this one waits
+ *  to be presented.
+ */
 
-void CVideoSDL::OnWindowMove()
+void CVideoSDL::ScaleDirtyRects(void)
 {
+    m_NumberOfPresentRects = 0;
+
+    // If nothing changed since the previous frame, there is nothing to present
+    if (m_NumberOfDirtyRects == 0)
+        return;
+
+    // Each band is written by one thread and the image of the pass is only read.
+    // The second pass reads the bands of the first one on both sides of its own.
+    if (m_pScaler != NULL)
+    {
+        for (m_ScalePass = 0; m_ScalePass < m_NumberOfScalePasses; m_ScalePass++)
+            m_WorkerPool.Run(ScaleBand, this, m_NumberOfBands);
+    }
+
+    // If only some zones changed, present them alone
+    m_PresentAll = (m_NumberOfDirtyRects == 1 && m_pDirtyRects[0].w == m_Width && m_pDirtyRects[0].h == m_Height);
+    m_NumberOfPresentRects = m_NumberOfDirtyRects;
+
+    for (int Rect = 0; Rect < m_NumberOfDirtyRects; Rect++)
+    {
+        int X1 = m_pDirtyRects[Rect].x;
+        int Y1 = m_pDirtyRects[Rect].y;
+        int X2 = m_pDirtyRects[Rect].x + m_pDirtyRects[Rect].w;
+        int Y2 = m_pDirtyRects[Rect].y + m_pDirtyRects[Rect].h;
+        int Factor = 1;
+
+        // The upscaled pixels around a dirty zone depend on it too
+        if (m_pScaler != NULL)
+        {
+            GetScaleZone(m_pDirtyRects[Rect], m_NumberOfScalePasses - 1, X1, Y1, X2, Y2);
+            Factor = m_pScaler->GetFactor();
+        }
+
+        m_pPresentRects[Rect].x = Factor * X1;
+        m_pPresentRects[Rect].y = Factor * Y1;
+        m_pPresentRects[Rect].w = Factor * (X2 - X1);
+        m_pPresentRects[Rect].h = Factor * (Y2 - Y1);
+    }
 }
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CVideoSDL::DrawSprite(int PositionX,
-                           int PositionY,
-                           RECT *pZone,
-                           RECT *pClip,
-                           const void* SpriteTable,
-                           int Sprite,
-                           int SpriteLayer,
-                           int PriorityInLayer)
+/**
+ *  The zone of the image of each pass depending on a dirty zone is the
+ *  zone of the previous pass enlarged, with the pixels around it whose
+ *  scaled pixels depend on it too. The zone of the last pass, enlarged,
+ *  is the zone of the primary surface to present.
+ */
+
+void CVideoSDL::GetScaleZone (const SDL_Rect& DirtyRect, int Pass, int& X1, int& Y1, int& X2, int& Y2) const
 {
+    ASSERT (m_pScaler != NULL);
+    ASSERT (Pass >= 0 && Pass < m_NumberOfScalePasses);
 
-    // Prepare a drawing request
-    SDrawingRequest DrawingRequest;
+    const int Factor = m_pScaler->GetFactor();
+    const int Border = m_pScaler->GetBorder();
 
-    // Save the sprite pointer
-    SSprite *pSprite = &m_SpriteTables[SpriteTable][Sprite];
+    int Width = m_Width;
+    int Height = m_Height;
 
-    // If we have to take care of clipping
-    if (pClip != NULL)
+    X1 = DirtyRect.x;
+    Y1 = DirtyRect.y;
+    X2 = DirtyRect.x + DirtyRect.w;
+    Y2 = DirtyRect.y + DirtyRect.h;
+
+    for (int PreviousPass = 0; ; PreviousPass++)
     {
-        // Save the sprite size
-        int SpriteSizeX = pSprite->ZoneX2 - pSprite->ZoneX1;
-        int SpriteSizeY = pSprite->ZoneY2 - pSprite->ZoneY1;
+        X1 = MAX(X1 - Border, 0);
+        Y1 = MAX(Y1 - Border, 0);
+        X2 = MIN(X2 + Border, Width);
+        Y2 = MIN(Y2 + Border, Height);
 
-        // If the sprite is completely out of the clip rect
-        if (PositionX >= pClip->right ||
-            PositionY >= pClip->bottom ||
-            PositionX + SpriteSizeX < pClip->left ||
-            PositionY + SpriteSizeY < pClip->top)
-        {
-            // Get out, don't even register the drawing request
-            return;
-        }
+        if (PreviousPass == Pass)
+            break;
 
-        // If the sprite has to be clipped on the left
-        if (PositionX < pClip->left)
-        {
-            // Clip on the left
-            DrawingRequest.PositionX = pClip->left;
-            DrawingRequest.ZoneX1 = pSprite->ZoneX1 + pClip->left - PositionX;
-        }
-        // If no clip on the left is needed
-        else
-        {
+        X1 *= Factor;
+        Y1 *= Factor;
+        X2 *= Factor;
+        Y2 *= Factor;
+        Width *= Factor;
+        Height *= Factor;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The band reads the rows just above and below it in the image of the
+ *  pass, so the rows on the border of two bands are upscaled as if the
+ *  whole image was upscaled at once. Only the zones of the band that
+ *  depend on the dirty zones are upscaled.
+ */
+
+void CVideoSDL::ScaleBand(void* pParameter, int Band)
+{
+    CVideoSDL* pVideo = (CVideoSDL*)pParameter;
+
+    const int Pass = pVideo->m_ScalePass;
+
+    int Width = pVideo->m_Width;
+    int Height = pVideo->m_Height;
+
+    for (int PreviousPass = 0; PreviousPass < Pass; PreviousPass++)
+    {
+        Width *= pVideo->m_pScaler->GetFactor();
+        Height *= pVideo->m_pScaler->GetFactor();
+    }
+
+    // The first pass reads the back buffer and the last one writes the primary surface
+    const uint32_t* pImage = (Pass == 0 ? reinterpret_cast<uint32_t*>(pVideo->m_pBackBuffer->pixels) : pVideo->m_pScaleBuffer);
+    uint32_t* pOutput = (Pass == pVideo->m_NumberOfScalePasses - 1 ? reinterpret_cast<uint32_t*>(pVideo->m_pPrimary->pixels) : pVideo->m_pScaleBuffer);
+
+    int FirstRow = Band * Height / pVideo->m_NumberOfBands;
+    int LastRow = (Band + 1) * Height / pVideo->m_NumberOfBands;
+
+    for (int Rect = 0; Rect < pVideo->m_NumberOfDirtyRects; Rect++)
+    {
+        int X1, Y1, X2, Y2;
+
+        pVideo->GetScaleZone(pVideo->m_pDirtyRects[Rect], Pass, X1, Y1, X2, Y2);
+
+        Y1 = MAX(Y1, FirstRow);
+        Y2 = MIN(Y2, LastRow);
+
+        if (Y1 < Y2)
+            pVideo->m_pScaler->Scale(pImage, Width, Height, pOutput, X1, Y1, X2, Y2);
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+// Updates the object : this updates the drawing zones in case the window moves.
+
+void CVideoSDL::OnWindowMove()
+{
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::DrawSprite(int PositionX,
+                           int PositionY,
+                           RECT *pZone,
+                           RECT *pClip,
+                           const void* SpriteTable,
+                           int Sprite,
+                           int SpriteLayer,
+                           int PriorityInLayer)
+{
+
+    // Prepare a drawing request
+    SDrawingRequest DrawingRequest;
+
+    // Save the sprite pointer
+    int Handle;
+    const SSprite *pSprite = GetSprite(SpriteTable, Sprite, &Handle);
+
+    // If we have to take care of clipping
+    if (pClip != NULL)
+    {
+        // Save the sprite size
+        int SpriteSizeX = pSprite->ZoneX2 - pSprite->ZoneX1;
+        int SpriteSizeY = pSprite->ZoneY2 - pSprite->ZoneY1;
+
+        // If the sprite is completely out of the clip rect
+        if (PositionX >= pClip->right ||
+            PositionY >= pClip->bottom ||
+            PositionX + SpriteSizeX < pClip->left ||
+            PositionY + SpriteSizeY < pClip->top)
+        {
+            // Get out, don't even register the drawing request
+            return;
+        }
+
+        // If the sprite has to be clipped on the left
+        if (PositionX < pClip->left)
+        {
+            // Clip on the left
+            DrawingRequest.PositionX = pClip->left;
+            DrawingRequest.ZoneX1 = pSprite->ZoneX1 + pClip->left - PositionX;
+        }
+        // If no clip on the left is needed
+        else
+        {
             // Don't clip
             DrawingRequest.PositionX = PositionX;
             DrawingRequest.ZoneX1 = pSprite->ZoneX1;
@@ -403,281 +893,742 @@ void CVideoSDL::DrawSprite(int PositionX,
     // Finish preparing the drawing request
     DrawingRequest.PositionX += m_OriginX;
     DrawingRequest.PositionY += m_OriginY;
-    DrawingRequest.SpriteTable = SpriteTable;
+    DrawingRequest.pSurface = pSprite->pSurface;
+    DrawingRequest.SpriteTable = Handle;
     DrawingRequest.Sprite = Sprite;
     DrawingRequest.SpriteLayer = SpriteLayer;
     DrawingRequest.PriorityInLayer = PriorityInLayer;
 
-    // Store it (automatic sort)
-    m_DrawingRequests.push_back(DrawingRequest);
+    // Store it in the frame being recorded (automatic sort)
+    m_Frames[m_RenderThread.GetRecordingFrame()].DrawingRequests.push_back(DrawingRequest);
 }
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CVideoSDL::DrawDebugRectangle(int PositionX,
-    int PositionY,
-    int w, int h,
-    Uint8 r, Uint8 g, Uint8 b,
-    int SpriteLayer,
-    int PriorityInLayer)
+/**
+ *  A static sprite is drawn in the static layer, which is blitted under
+ *  all the other sprites. So it must only be overlapped by sprites that
+ *  would be drawn over it anyway (i.e. in a higher layer). The static
+ *  layer is only drawn again where the static sprites changed.
+ */
+
+void CVideoSDL::DrawStaticSprite(int PositionX,
+                                 int PositionY,
+                                 const void* SpriteTable,
+                                 int Sprite,
+                                 int SpriteLayer,
+                                 int PriorityInLayer)
 {
     // Prepare a drawing request
-    SDebugDrawingRequest DrawingRequest;
+    SDrawingRequest DrawingRequest;
 
-    // Use the desired position
-    DrawingRequest.PositionX = PositionX;
-    DrawingRequest.PositionY = PositionY;
+    // Save the sprite pointer
+    int Handle;
+    const SSprite *pSprite = GetSprite(SpriteTable, Sprite, &Handle);
 
     // Use the zone of the sprite
-    DrawingRequest.ZoneX1 = 0;
-    DrawingRequest.ZoneY1 = 0;
-    DrawingRequest.ZoneX2 = w;
-    DrawingRequest.ZoneY2 = h;
-
-    // rectangle colour
-    DrawingRequest.R = r;
-    DrawingRequest.G = g;
-    DrawingRequest.B = b;
-
-    // Finish preparing the drawing request
-    DrawingRequest.PositionX += m_OriginX;
-    DrawingRequest.PositionY += m_OriginY;
+    DrawingRequest.PositionX = PositionX + m_OriginX;
+    DrawingRequest.PositionY = PositionY + m_OriginY;
+    DrawingRequest.ZoneX1 = pSprite->ZoneX1;
+    DrawingRequest.ZoneY1 = pSprite->ZoneY1;
+    DrawingRequest.ZoneX2 = pSprite->ZoneX2;
+    DrawingRequest.ZoneY2 = pSprite->ZoneY2;
+    DrawingRequest.pSurface = pSprite->pSurface;
+    DrawingRequest.SpriteTable = Handle;
+    DrawingRequest.Sprite = Sprite;
     DrawingRequest.SpriteLayer = SpriteLayer;
     DrawingRequest.PriorityInLayer = PriorityInLayer;
 
-    // Store it (automatic sort)
-    m_DebugDrawingRequests.push_back(DrawingRequest);
+    // Store it, it is only sorted if the static layer has to be drawn again
+    m_Frames[m_RenderThread.GetRecordingFrame()].StaticDrawingRequests.push_back(DrawingRequest);
 }
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CVideoSDL::RemoveAllDebugRectangles()
+/**
+ *  A sprite run is a group of sprites that are always drawn together at
+ *  the same place from each other, such as the characters of a string.
+ *  The sprites are drawn once in a surface of their own, which is then
+ *  drawn with a single drawing request instead of one per sprite. The
+ *  caller identifies the run with a key describing what it draws.
+ */
+
+bool CVideoSDL::DrawSpriteRun(int PositionX,
+                              int PositionY,
+                              const void* pKey,
+                              int KeySize,
+                              int SpriteLayer,
+                              int PriorityInLayer)
 {
-    m_DebugDrawingRequests.clear();
-}
+    int Run = FindSpriteRun(pKey, KeySize);
 
-//******************************************************************************************************************************
-//******************************************************************************************************************************
-//******************************************************************************************************************************
+    // If the run has to be created first
+    if (Run == -1)
+        return false;
 
-// Makes the display black.
+    SSpriteRun& SpriteRun = m_SpriteRuns[Run];
 
-void CVideoSDL::Clear()
-{
-    SDL12_FillRect(m_pPrimary, &m_PrimaryRect, 0);
-}
+    // The run must stay in the cache while the recorded frame uses it
+    SpriteRun.LastFrame = m_NumberOfRecordedFrames;
+    m_NumberOfSpriteRunsDrawn++;
 
-//******************************************************************************************************************************
-//******************************************************************************************************************************
-//******************************************************************************************************************************
+    // Prepare a drawing request for the whole surface of the run
+    SDrawingRequest DrawingRequest;
 
-WORD CVideoSDL::GetNumberOfBits(DWORD dwMask)
-{
-    WORD wBits = 0;
-    while (dwMask)
-    {
-        dwMask = dwMask & (dwMask - 1);
-        wBits++;
-    }
-    return wBits;
+    DrawingRequest.PositionX = PositionX + SpriteRun.OffsetX + m_OriginX;
+    DrawingRequest.PositionY = PositionY + SpriteRun.OffsetY + m_OriginY;
+    DrawingRequest.ZoneX1 = 0;
+    DrawingRequest.ZoneY1 = 0;
+    DrawingRequest.ZoneX2 = SpriteRun.pSurface->w;
+    DrawingRequest.ZoneY2 = SpriteRun.pSurface->h;
+    DrawingRequest.pSurface = SpriteRun.pSurface;
+    DrawingRequest.SpriteTable = SPRITERUN_SPRITETABLE;
+    DrawingRequest.Sprite = SpriteRun.Serial;
+    DrawingRequest.SpriteLayer = SpriteLayer;
+    DrawingRequest.PriorityInLayer = PriorityInLayer;
+
+    // Store it in the frame being recorded (automatic sort)
+    m_Frames[m_RenderThread.GetRecordingFrame()].DrawingRequests.push_back(DrawingRequest);
+
+    return true;
 }
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-bool CVideoSDL::LoadSprites(int SpriteTableWidth,
-                            int SpriteTableHeight,
-                            int SpriteWidth,
-                            int SpriteHeight,
-                            bool Transparent,
-                            const uint8_t* BitmapData,
-                            uint32_t BitmapSize)
-{
+/**
+ *  The sprites are blitted in the order of the parts, so the last parts
+ *  are drawn over the first ones. They are blitted from copies of the
+ *  sprite tables, which the render thread never uses : it may go on
+ *  drawing the published frames meanwhile.
+ */
 
-    SSurface Surface;
+bool CVideoSDL::CreateSpriteRun(const void* pKey,
+                                int KeySize,
+                                const SSpriteRunPart* pParts,
+                                int NumberOfParts)
+{
+    ASSERT (pKey != NULL);
+    ASSERT (KeySize > 0);
+    ASSERT (pParts != NULL);
+    ASSERT (NumberOfParts > 0);
+    ASSERT (FindSpriteRun(pKey, KeySize) == -1);
+
+    // Make room for the new run
+    if (m_SpriteRuns.size() >= SPRITERUN_CACHE_SIZE)
+        EvictSpriteRuns();
+
+    // Find the zone covered by the sprites of the run
+    int Handle;
+    const SSprite* pFirstSprite = GetSprite(pParts[0].SpriteTable, pParts[0].Sprite, &Handle);
+
+    int X1 = pParts[0].PositionX;
+    int Y1 = pParts[0].PositionY;
+    int X2 = X1 + pFirstSprite->ZoneX2 - pFirstSprite->ZoneX1;
+    int Y2 = Y1 + pFirstSprite->ZoneY2 - pFirstSprite->ZoneY1;
+
+    for (int Part = 1; Part < NumberOfParts; Part++)
+    {
+        const SSprite* pSprite = GetSprite(pParts[Part].SpriteTable, pParts[Part].Sprite, &Handle);
 
-    SDL_RWops *rwBitmap = SDL12_RWFromMem(const_cast<uint8_t*>(BitmapData), BitmapSize);
+        X1 = MIN(X1, pParts[Part].PositionX);
+        Y1 = MIN(Y1, pParts[Part].PositionY);
+        X2 = MAX(X2, pParts[Part].PositionX + pSprite->ZoneX2 - pSprite->ZoneX1);
+        Y2 = MAX(Y2, pParts[Part].PositionY + pSprite->ZoneY2 - pSprite->ZoneY1);
+    }
 
-    // Create a SDLVideo surface for this bitmap
-    SDL_Surface *ddsd = SDL12_LoadBMP_RW(rwBitmap, 0);
+    // Same pixel format as the sprites, without an alpha channel so that the color key is used
+    const SDL_PixelFormat* pFormat = pFirstSprite->pSurface->format;
 
-    SDL12_FreeRW(rwBitmap);
+    SDL_Surface* pSurface = SDL12_CreateRGBSurface(SDL_SWSURFACE, X2 - X1, Y2 - Y1, pFormat->BitsPerPixel,
+                                                   pFormat->Rmask, pFormat->Gmask, pFormat->Bmask, 0);
 
-    // If it failed
-    if (ddsd == NULL)
+    if (pSurface == NULL)
     {
         // Log failure
-        theLog.WriteLine("SDLVideo        => !!! Could not create surface.");
-        theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
+        theLog.WriteLine("SDLVideo        => !!! Could not create surface (sprite run).");
 
-        // Get out
         return false;
     }
 
-    // Blit the bitmap onto the SDLVideo surface
-    Surface.pSurface = ddsd;
+    // Nothing is drawn where there is no sprite
+    Uint32 TransparentColor = SDL12_MapRGB(pSurface->format, 0x00, 0xff, 0x00);
 
-    //----------------------------------------------
-    // Set the surface transparency color if needed
-    //----------------------------------------------
+    SDL12_FillRect(pSurface, NULL, TransparentColor);
 
-    // If the sprite table uses transparency
-    if (Transparent)
+    for (int Part = 0; Part < NumberOfParts; Part++)
     {
-        // Apply the color key to the surface
-        HRESULT hRet = SDL12_SetColorKey(ddsd, SDL_SRCCOLORKEY | SDL_RLEACCEL, SDL12_MapRGBA(ddsd->format, 0x00, 0xff, 0x00, 0xff));
+        GetSprite(pParts[Part].SpriteTable, pParts[Part].Sprite, &Handle);
 
-        // If it failed
-        if (hRet != 0)
+        if (GetRunSource(Handle) == NULL)
         {
-            // Log failure
-            theLog.WriteLine("SDLVideo        => !!! Could not set colorkey.");
-            theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
-
-            // Get out
+            SDL12_FreeSurface(pSurface);
             return false;
         }
     }
 
-    //-----------------------
-    // Store the new surface
-    //-----------------------
+    for (int Part = 0; Part < NumberOfParts; Part++)
+    {
+        const SSprite* pSprite = GetSprite(pParts[Part].SpriteTable, pParts[Part].Sprite, &Handle);
 
-    // Add the surface to the surface container
-    m_Surfaces.push_back(Surface);
+        SDL_Rect SourceRect;
+        SourceRect.x = pSprite->ZoneX1;
+        SourceRect.y = pSprite->ZoneY1;
+        SourceRect.w = pSprite->ZoneX2 - pSprite->ZoneX1;
+        SourceRect.h = pSprite->ZoneY2 - pSprite->ZoneY1;
 
-    //---------------------------
-    // Create the sprite table
-    //---------------------------
+        SDL_Rect DestRect;
+        DestRect.x = pParts[Part].PositionX - X1;
+        DestRect.y = pParts[Part].PositionY - Y1;
+        DestRect.w = 0;
+        DestRect.h = 0;
 
-    // Prepare a sprite table
-    ::portable_stl::vector<SSprite> SpriteTable;
+        if (SDL12_BlitSurface(GetRunSource(Handle), &SourceRect, pSurface, &DestRect) < 0)
+        {
+            // blitting failed
+            theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
+        }
+    }
 
-    // Variable rectangle coordinates that will be passed during sprite creations
-    int ZoneX1 = 1;
-    int ZoneY1 = 1;
-    int ZoneX2 = 1 + SpriteWidth;
-    int ZoneY2 = 1 + SpriteHeight;
+    SDL12_SetColorKey(pSurface, SDL_SRCCOLORKEY | SDL_RLEACCEL, TransparentColor);
 
-    // Scan all the sprites in this surface
-    for (int Y = 0; Y < SpriteTableHeight; Y++)
-    {
-        for (int X = 0; X < SpriteTableWidth; X++)
-        {
-            // Prepare a sprite
-            SSprite Sprite;
-            Sprite.SurfaceNumber = m_Surfaces.size() - 1;       // The surface we just added to the container
-            Sprite.ZoneX1 = ZoneX1;
-            Sprite.ZoneY1 = ZoneY1;
-            Sprite.ZoneX2 = ZoneX2;
-            Sprite.ZoneY2 = ZoneY2;
+    // Store the run with a copy of its key
+    SSpriteRun SpriteRun;
+    SpriteRun.Hash = HashSpriteRunKey(pKey, KeySize);
+    SpriteRun.pKey = new char [KeySize];
+    SpriteRun.KeySize = KeySize;
+    SpriteRun.pSurface = pSurface;
+    SpriteRun.OffsetX = X1;
+    SpriteRun.OffsetY = Y1;
+    SpriteRun.Serial = m_NextSpriteRunSerial++;
+    SpriteRun.LastFrame = m_NumberOfRecordedFrames;
 
-            // Advance the rectangle on the row
-            ZoneX1 += SpriteWidth + 1;
-            ZoneX2 += SpriteWidth + 1;
+    memcpy(SpriteRun.pKey, pKey, KeySize);
 
-            // Add the sprite to the sprite table
-            SpriteTable.push_back(Sprite);
-        }
+    m_SpriteRuns.push_back(SpriteRun);
+    m_NumberOfSpriteRunsCreated++;
 
-        // Back to beginning of row
-        ZoneX1 = 1;
-        ZoneX2 = 1 + SpriteWidth;
+    return true;
+}
 
-        // Make the rectangle go down
-        ZoneY1 += SpriteHeight + 1;
-        ZoneY2 += SpriteHeight + 1;
-    }
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+Uint64 CVideoSDL::HashSpriteRunKey(const void* pKey, int KeySize)
+{
+    const Uint8* pBytes = (const Uint8*)pKey;
 
-    // Store the sprite table
-    m_SpriteTables[BitmapData] = SpriteTable;
+    Uint64 Hash = TILE_HASH_SEED;
 
-    // Everything went right
-    return true;
+    for (int Byte = 0; Byte < KeySize; Byte++)
+        Hash = (Hash ^ pBytes[Byte]) * TILE_HASH_PRIME;
+
+    return Hash;
 }
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CVideoSDL::FreeSprites(void)
+int CVideoSDL::FindSpriteRun(const void* pKey, int KeySize) const
 {
-    // Empty drawing requests queue
-    m_DrawingRequests.clear();
+    ASSERT (pKey != NULL);
+    ASSERT (KeySize > 0);
 
-    // Remove all sprite tables
-    m_SpriteTables.clear();
+    Uint64 Hash = HashSpriteRunKey(pKey, KeySize);
 
-    // Scan all the surfaces
-    for (unsigned int i = 0; i < m_Surfaces.size(); i++)
+    for (unsigned int Run = 0; Run < m_SpriteRuns.size(); Run++)
     {
-        // If the surface exists
-        if (m_Surfaces[i].pSurface != NULL)
+        if (m_SpriteRuns[Run].Hash == Hash &&
+            m_SpriteRuns[Run].KeySize == KeySize &&
+            memcmp(m_SpriteRuns[Run].pKey, pKey, KeySize) == 0)
         {
-            // Release it
-            SDL12_FreeSurface(m_Surfaces[i].pSurface);
-            m_Surfaces[i].pSurface = NULL;
+            return Run;
         }
     }
 
-    // Remove all surfaces
-    m_Surfaces.clear();
+    return -1;
 }
 
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
-void CVideoSDL::UpdateAll(void)
+/**
+ *  The render thread must not be busy with a frame.
+ */
+
+void CVideoSDL::FreeSpriteRuns(void)
 {
-    std::sort(m_DrawingRequests.begin().base(), m_DrawingRequests.end().base());
-    // While all the drawing requests have not been executed
-    for (::portable_stl::vector<SDrawingRequest>::iterator it = m_DrawingRequests.begin(); it != m_DrawingRequests.end(); ++it)
+    for (unsigned int Run = 0; Run < m_SpriteRuns.size(); Run++)
     {
-        // Save the top drawing request
-        const SDrawingRequest &DR = *it;
+        SDL12_FreeSurface(m_SpriteRuns[Run].pSurface);
+        delete [] m_SpriteRuns[Run].pKey;
+    }
 
-        // Save the sprite as specified by this drawing request
-        const SSprite *pSprite = &m_SpriteTables[DR.SpriteTable][DR.Sprite];
+    m_SpriteRuns.clear();
+}
 
-        // Build a RECT structure containing the zone to draw
-        SDL_Rect SourceRect;
-        SourceRect.x = DR.ZoneX1;
-        SourceRect.y = DR.ZoneY1;
-        SourceRect.w = DR.ZoneX2 - DR.ZoneX1;
-        SourceRect.h = DR.ZoneY2 - DR.ZoneY1;
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
 
-        SDL_Rect DestRect;
-        DestRect.x = DR.PositionX;
-        DestRect.y = DR.PositionY;
-        DestRect.w = 0;
-        DestRect.h = 0;
+/**
+ *  The runs drawn the longest time ago are released first, so that the
+ *  runs drawn every few frames, such as the clock of the board, stay in
+ *  the cache. The runs the recorded frame draws are always kept, even if
+ *  this leaves more than SPRITERUN_CACHE_LOW_WATER runs. The render
+ *  thread only has to finish its frames if one of them may draw a run
+ *  that is released.
+ */
 
-        // Blit the surface zone on the back buffer
-#ifdef BOMBERMAAAN_SCALE_2X
-        if (SDL12_BlitSurface(m_Surfaces[pSprite->SurfaceNumber].pSurface, &SourceRect, m_pBackBuffer, &DestRect) < 0)
-#else
-        if (SDL12_BlitSurface(m_Surfaces[pSprite->SurfaceNumber].pSurface, &SourceRect, m_pPrimary, &DestRect) < 0)
-#endif
-        {
-            // blitting failed
-            theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
-        }
-    }
-    m_DrawingRequests.clear();
+void CVideoSDL::EvictSpriteRuns(void)
+{
+    int NumberOfRuns = (int)m_SpriteRuns.size();
 
-    // Debug rectangles?
-    for (::portable_stl::vector<SDebugDrawingRequest>::iterator it = m_DebugDrawingRequests.begin(); it != m_DebugDrawingRequests.end(); it++)
-    {
-        // Save the top drawing request
-        const SDebugDrawingRequest &DR = *it;
+    if (NumberOfRuns <= SPRITERUN_CACHE_LOW_WATER)
+        return;
 
-        // Build a RECT structure containing the zone to draw
+    // Find the latest frame whose runs are released
+    ::portable_stl::vector<int> LastFrames;
+
+    for (int Run = 0; Run < NumberOfRuns; Run++)
+        LastFrames.push_back(m_SpriteRuns[Run].LastFrame);
+
+    std::sort(LastFrames.begin().base(), LastFrames.end().base());
+
+    int NumberToRelease = NumberOfRuns - SPRITERUN_CACHE_LOW_WATER;
+    int LastReleasedFrame = LastFrames[NumberToRelease - 1];
+
+    // Only some of the runs drawn in that frame are released
+    int NumberOfOlderRuns = 0;
+
+    while (LastFrames[NumberOfOlderRuns] < LastReleasedFrame)
+        NumberOfOlderRuns++;
+
+    int NumberOfTiesToRelease = NumberToRelease - NumberOfOlderRuns;
+
+    // The frames published and not presented yet are among the latest ones
+    if (LastReleasedFrame >= m_NumberOfRecordedFrames - (RENDER_FRAMES - 1))
+        FinishRendering();
+
+    unsigned int Kept = 0;
+
+    for (int Run = 0; Run < NumberOfRuns; Run++)
+    {
+        int LastFrame = m_SpriteRuns[Run].LastFrame;
+
+        bool Release = (LastFrame != m_NumberOfRecordedFrames &&
+                        (LastFrame < LastReleasedFrame ||
+                         (LastFrame == LastReleasedFrame && NumberOfTiesToRelease > 0)));
+
+        if (!Release)
+        {
+            m_SpriteRuns[Kept++] = m_SpriteRuns[Run];
+            continue;
+        }
+
+        if (LastFrame == LastReleasedFrame)
+            NumberOfTiesToRelease--;
+
+        SDL12_FreeSurface(m_SpriteRuns[Run].pSurface);
+        delete [] m_SpriteRuns[Run].pKey;
+    }
+
+    while (m_SpriteRuns.size() > Kept)
+        m_SpriteRuns.pop_back();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Blitting a surface on another one changes how SDL blits it, so the
+ *  sprite runs are not drawn from the surface the render thread blits.
+ *  The copy is made the first time a run needs the sprite table : the
+ *  render thread has to finish its frames only then.
+ */
+
+SDL_Surface* CVideoSDL::GetRunSource(int Handle)
+{
+    SSpriteTable& SpriteTable = m_SpriteTables[Handle];
+
+    if (SpriteTable.pRunSource == NULL)
+    {
+        // Copying the surface blits it too
+        FinishRendering();
+
+        SDL_Surface* pSurface = m_Sprites[SpriteTable.FirstSprite].pSurface;
+
+        SpriteTable.pRunSource = SDL12_ConvertSurface(pSurface, pSurface->format, SDL_SWSURFACE);
+
+        if (SpriteTable.pRunSource == NULL)
+        {
+            // Log failure
+            theLog.WriteLine("SDLVideo        => !!! Could not create surface (sprite run source).");
+
+            return NULL;
+        }
+
+        // Same transparent color, the copy is only blitted when a run is made
+        if (pSurface->flags & SDL_SRCCOLORKEY)
+            SDL12_SetColorKey(SpriteTable.pRunSource, SDL_SRCCOLORKEY, pSurface->format->colorkey);
+    }
+
+    return SpriteTable.pRunSource;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::DrawDebugRectangle(int PositionX,
+    int PositionY,
+    int w, int h,
+    Uint8 r, Uint8 g, Uint8 b,
+    int SpriteLayer,
+    int PriorityInLayer)
+{
+    // Prepare a drawing request
+    SDebugDrawingRequest DrawingRequest;
+
+    // Use the desired position
+    DrawingRequest.PositionX = PositionX;
+    DrawingRequest.PositionY = PositionY;
+
+    // Use the zone of the sprite
+    DrawingRequest.ZoneX1 = 0;
+    DrawingRequest.ZoneY1 = 0;
+    DrawingRequest.ZoneX2 = w;
+    DrawingRequest.ZoneY2 = h;
+
+    // rectangle colour
+    DrawingRequest.R = r;
+    DrawingRequest.G = g;
+    DrawingRequest.B = b;
+
+    // Finish preparing the drawing request
+    DrawingRequest.PositionX += m_OriginX;
+    DrawingRequest.PositionY += m_OriginY;
+    DrawingRequest.SpriteLayer = SpriteLayer;
+    DrawingRequest.PriorityInLayer = PriorityInLayer;
+
+    // Store it (automatic sort)
+    m_DebugDrawingRequests.push_back(DrawingRequest);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::RemoveAllDebugRectangles()
+{
+    m_DebugDrawingRequests.clear();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+// Makes the display black.
+
+void CVideoSDL::Clear()
+{
+    // The render thread owns the surfaces : it makes them black (see ClearDisplay)
+    m_Frames[m_RenderThread.GetRecordingFrame()].Clear = true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::InvalidateAll(void)
+{
+    m_RedrawAll = true;
+    m_RedrawStaticLayer = true;
+
+    if (m_pDirtyRects != NULL)
+    {
+        m_pDirtyRects[0].x = 0;
+        m_pDirtyRects[0].y = 0;
+        m_pDirtyRects[0].w = m_Width;
+        m_pDirtyRects[0].h = m_Height;
+        m_NumberOfDirtyRects = 1;
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Each tile gets a hash of the drawing requests drawn on it, in the order
+ *  they are drawn. A tile whose hash is the same as in the previous frame
+ *  would get the same pixels, so it is not drawn again. The sprites are
+ *  color keyed, so drawing the same requests over the previous pixels
+ *  gives the previous pixels again. The debug rectangles are blended over
+ *  the sprites of the tile, so they are part of its hash too : a tile is
+ *  drawn again when a debug rectangle appears, moves or goes away.
+ *
+ *  The dirty tiles are grouped in rectangles : the dirty tiles next to
+ *  each other on a row, then the same groups on the next rows.
+ */
+
+void CVideoSDL::FindDirtyRects(const SRenderFrame& Frame)
+{
+    int NumberOfTiles = m_TilesX * m_TilesY;
+
+    // Keep the hashes of the previous frame
+    Uint64* pHashes = m_pPreviousTileHashes;
+    m_pPreviousTileHashes = m_pTileHashes;
+    m_pTileHashes = pHashes;
+
+    // The static layer is drawn first on each tile
+    bool StaticLayer = !Frame.StaticDrawingRequests.empty();
+
+    for (int Tile = 0; Tile < NumberOfTiles; Tile++)
+        m_pTileHashes[Tile] = (StaticLayer ? (TILE_HASH_SEED ^ m_pCachedStaticTileHashes[Tile]) * TILE_HASH_PRIME : TILE_HASH_SEED);
+
+    for (::portable_stl::vector<SDrawingRequest>::const_iterator it = Frame.DrawingRequests.begin(); it != Frame.DrawingRequests.end(); ++it)
+    {
+        const SDrawingRequest &DR = *it;
+
+        int X1 = MAX(DR.PositionX, 0);
+        int Y1 = MAX(DR.PositionY, 0);
+        int X2 = MIN(DR.PositionX + DR.ZoneX2 - DR.ZoneX1, m_Width);
+        int Y2 = MIN(DR.PositionY + DR.ZoneY2 - DR.ZoneY1, m_Height);
+
+        if (X1 >= X2 || Y1 >= Y2)
+            continue;
+
+        Uint64 Key = HashDrawingRequest(DR);
+
+        for (int TileY = Y1 / DIRTY_TILE_SIZE; TileY <= (Y2 - 1) / DIRTY_TILE_SIZE; TileY++)
+        {
+            for (int TileX = X1 / DIRTY_TILE_SIZE; TileX <= (X2 - 1) / DIRTY_TILE_SIZE; TileX++)
+            {
+                Uint64& Hash = m_pTileHashes[TileY * m_TilesX + TileX];
+                Hash = (Hash ^ Key) * TILE_HASH_PRIME;
+            }
+        }
+    }
+
+    // The debug rectangles are blended after all the sprites
+    for (::portable_stl::vector<SDebugDrawingRequest>::const_iterator it = Frame.DebugDrawingRequests.begin(); it != Frame.DebugDrawingRequests.end(); ++it)
+    {
+        const SDebugDrawingRequest &DR = *it;
+
+        int X1 = MAX(DR.PositionX, 0);
+        int Y1 = MAX(DR.PositionY, 0);
+        int X2 = MIN(DR.PositionX + DR.ZoneX2 - DR.ZoneX1, m_Width);
+        int Y2 = MIN(DR.PositionY + DR.ZoneY2 - DR.ZoneY1, m_Height);
+
+        if (X1 >= X2 || Y1 >= Y2)
+            continue;
+
+        Uint64 Key = HashDebugDrawingRequest(DR);
+
+        for (int TileY = Y1 / DIRTY_TILE_SIZE; TileY <= (Y2 - 1) / DIRTY_TILE_SIZE; TileY++)
+        {
+            for (int TileX = X1 / DIRTY_TILE_SIZE; TileX <= (X2 - 1) / DIRTY_TILE_SIZE; TileX++)
+            {
+                Uint64& Hash = m_pTileHashes[TileY * m_TilesX + TileX];
+                Hash = (Hash ^ Key) * TILE_HASH_PRIME;
+            }
+        }
+    }
+
+    for (int Tile = 0; Tile < NumberOfTiles; Tile++)
+        m_pDirtyTiles[Tile] = (m_RedrawAll || m_pTileHashes[Tile] != m_pPreviousTileHashes[Tile]);
+
+    m_RedrawAll = false;
+    m_NumberOfDirtyRects = GroupDirtyTiles();
+    m_NumberOfFrames++;
+
+    for (int Tile = 0; Tile < NumberOfTiles; Tile++)
+        if (m_pDirtyTiles[Tile])
+            m_NumberOfRedrawnTiles++;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Group the dirty tiles in rectangles : the dirty tiles next to each other
+ *  on a row, then the same groups on the next rows. The rectangles are
+ *  written to m_pDirtyRects, their number is returned.
+ */
+
+int CVideoSDL::GroupDirtyTiles(void)
+{
+    int NumberOfRects = 0;
+
+    for (int TileY = 0; TileY < m_TilesY; TileY++)
+    {
+        int TileX = 0;
+
+        while (TileX < m_TilesX)
+        {
+            if (!m_pDirtyTiles[TileY * m_TilesX + TileX])
+            {
+                TileX++;
+                continue;
+            }
+
+            // Find the dirty tiles following this one on the row
+            int FirstTileX = TileX;
+
+            while (TileX < m_TilesX && m_pDirtyTiles[TileY * m_TilesX + TileX])
+                TileX++;
+
+            SDL_Rect Zone;
+            Zone.x = FirstTileX * DIRTY_TILE_SIZE;
+            Zone.y = TileY * DIRTY_TILE_SIZE;
+            Zone.w = MIN(TileX * DIRTY_TILE_SIZE, m_Width) - Zone.x;
+            Zone.h = MIN((TileY + 1) * DIRTY_TILE_SIZE, m_Height) - Zone.y;
+
+            // Make the same group of the previous row higher if there is one
+            int Rect = 0;
+
+            while (Rect < NumberOfRects &&
+                   !(m_pDirtyRects[Rect].x == Zone.x && m_pDirtyRects[Rect].w == Zone.w && m_pDirtyRects[Rect].y + m_pDirtyRects[Rect].h == Zone.y))
+                Rect++;
+
+            if (Rect < NumberOfRects)
+                m_pDirtyRects[Rect].h += Zone.h;
+            else
+                m_pDirtyRects[NumberOfRects++] = Zone;
+        }
+    }
+
+    return NumberOfRects;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The static layer holds the static sprites drawn over the transparent
+ *  color, so that blitting it gives the same pixels as blitting each
+ *  of them. Each tile of the layer gets a hash of the static requests
+ *  drawn on it. Their order only depends on their layer and priority,
+ *  so the hash does not depend on the order they were recorded in. Only
+ *  the tiles whose hash changed (a wall burnt, a floor got crushed...)
+ *  are drawn again, with the static requests sorted.
+ */
+
+void CVideoSDL::UpdateStaticLayer(SRenderFrame& Frame)
+{
+    // If there is no static sprite (not in a match), the layer is not used
+    if (Frame.StaticDrawingRequests.empty())
+    {
+        m_RedrawStaticLayer = true;
+        return;
+    }
+
+    int NumberOfTiles = m_TilesX * m_TilesY;
+
+    for (int Tile = 0; Tile < NumberOfTiles; Tile++)
+        m_pStaticTileHashes[Tile] = 0;
+
+    for (::portable_stl::vector<SDrawingRequest>::iterator it = Frame.StaticDrawingRequests.begin(); it != Frame.StaticDrawingRequests.end(); ++it)
+    {
+        const SDrawingRequest &DR = *it;
+
+        int X1 = MAX(DR.PositionX, 0);
+        int Y1 = MAX(DR.PositionY, 0);
+        int X2 = MIN(DR.PositionX + DR.ZoneX2 - DR.ZoneX1, m_Width);
+        int Y2 = MIN(DR.PositionY + DR.ZoneY2 - DR.ZoneY1, m_Height);
+
+        if (X1 >= X2 || Y1 >= Y2)
+            continue;
+
+        Uint64 Key = HashDrawingRequest(DR);
+
+        // Adding the keys gives the same hash whatever the order of the requests
+        for (int TileY = Y1 / DIRTY_TILE_SIZE; TileY <= (Y2 - 1) / DIRTY_TILE_SIZE; TileY++)
+            for (int TileX = X1 / DIRTY_TILE_SIZE; TileX <= (X2 - 1) / DIRTY_TILE_SIZE; TileX++)
+                m_pStaticTileHashes[TileY * m_TilesX + TileX] += Key;
+    }
+
+    bool Changed = false;
+
+    for (int Tile = 0; Tile < NumberOfTiles; Tile++)
+    {
+        m_pDirtyTiles[Tile] = (m_RedrawStaticLayer || m_pStaticTileHashes[Tile] != m_pCachedStaticTileHashes[Tile]);
+
+        if (m_pDirtyTiles[Tile])
+        {
+            Changed = true;
+            m_NumberOfStaticTilesDrawn++;
+        }
+    }
+
+    // The layer now holds the static requests of this frame
+    Uint64* pHashes = m_pCachedStaticTileHashes;
+    m_pCachedStaticTileHashes = m_pStaticTileHashes;
+    m_pStaticTileHashes = pHashes;
+    m_RedrawStaticLayer = false;
+
+    if (!Changed)
+        return;
+
+    SortDrawingRequests(Frame.StaticDrawingRequests);
+
+    Uint32 TransparentColor = SDL12_MapRGB(m_pStaticLayer->format, 0x00, 0xff, 0x00);
+
+    // The dirty rectangles of the frame are found later, use them in the meantime
+    int NumberOfRects = GroupDirtyTiles();
+
+    for (int Rect = 0; Rect < NumberOfRects; Rect++)
+    {
+        SDL_Rect Zone = m_pDirtyRects[Rect];
+
+        SDL12_SetClipRect(m_pStaticLayer, &Zone);
+        SDL12_FillRect(m_pStaticLayer, &Zone, TransparentColor);
+
+        BlitDrawingRequests(Frame.StaticDrawingRequests, Zone, m_pStaticLayer);
+    }
+
+    SDL12_SetClipRect(m_pStaticLayer, NULL);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Blit the sorted drawing requests drawn on the zone. The target must be
+ *  clipped to the zone, so that nothing is drawn around it.
+ */
+
+void CVideoSDL::BlitDrawingRequests(::portable_stl::vector<SDrawingRequest>& DrawingRequests, const SDL_Rect& Zone, SDL_Surface* pTarget)
+{
+    // While all the drawing requests have not been executed
+    for (::portable_stl::vector<SDrawingRequest>::iterator it = DrawingRequests.begin(); it != DrawingRequests.end(); ++it)
+    {
+        // Save the top drawing request
+        const SDrawingRequest &DR = *it;
+
+        // If the request is not drawn on this zone
+        if (DR.PositionX >= Zone.x + Zone.w ||
+            DR.PositionY >= Zone.y + Zone.h ||
+            DR.PositionX + DR.ZoneX2 - DR.ZoneX1 <= Zone.x ||
+            DR.PositionY + DR.ZoneY2 - DR.ZoneY1 <= Zone.y)
+        {
+            continue;
+        }
+
+        // Build a RECT structure containing the zone to draw
         SDL_Rect SourceRect;
         SourceRect.x = DR.ZoneX1;
         SourceRect.y = DR.ZoneY1;
@@ -690,53 +1641,768 @@ void CVideoSDL::UpdateAll(void)
         DestRect.w = 0;
         DestRect.h = 0;
 
-        Uint8 r, g, b;
-        r = DR.R;
-        g = DR.G;
-        b = DR.B;
+        // Blit the surface zone on the target
+        if (SDL12_BlitSurface(DR.pSurface, &SourceRect, pTarget, &DestRect) < 0)
+        {
+            // blitting failed
+            theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
+        }
+    }
+}
 
-        // create surface
-        SDL_Surface *rectangle = SDL12_CreateRGBSurface(SDL_HWSURFACE | SDL_SRCALPHA,
-                                                        SourceRect.w,
-                                                        SourceRect.h,
-                                                        32,
-                                                        rmask,
-                                                        gmask,
-                                                        bmask,
-                                                        amask);
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
 
-        SDL_Surface *reals = NULL;
+/**
+ *  The requests are drawn in a few layers, and most of them come almost
+ *  in order. So they are bucketed per layer with a counting sort rather
+ *  than compared to each other. Only a few layers use the priority (the
+ *  bombers and the flying objects give their Y position), and their
+ *  requests are nearly in order, so an insertion pass sorts each layer
+ *  on the priority. Both passes are stable, so the equal requests are
+ *  drawn in the order they were made.
+ */
 
-        SDL12_SetAlpha(rectangle, SDL_SRCALPHA | SDL_RLEACCEL, 128);
+void CVideoSDL::SortDrawingRequests(::portable_stl::vector<SDrawingRequest>& DrawingRequests)
+{
+    int NumberOfRequests = DrawingRequests.size();
 
-        // fill with rectangle
-        if (rectangle != NULL && SDL12_FillRect(rectangle, NULL, SDL12_MapRGBA(rectangle->format, r, g, b, 128)) == 0)
-        {
-            reals = SDL12_DisplayFormatAlpha(rectangle);
+    if (NumberOfRequests < 2)
+        return;
 
-            // Blit the surface zone on the back buffer
-#ifdef BOMBERMAAAN_SCALE_2X
-            if (reals != NULL && SDL12_BlitSurface(reals, &SourceRect, m_pBackBuffer, &DestRect) < 0)
-#else
-            if (reals != NULL && SDL12_BlitSurface(reals, &SourceRect, m_pPrimary, &DestRect) < 0)
-#endif
-            {
-                // blitting failed
-                theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
-            }
-        }
+    const SDrawingRequest* pRequests = DrawingRequests.data();
 
-        SDL12_FreeSurface(rectangle);
-        if (reals != NULL)
-        {
-            SDL12_FreeSurface(reals);
-        }
+    int MinLayer = pRequests[0].SpriteLayer;
+    int MaxLayer = MinLayer;
+    bool Sorted = true;
 
-        // do not Pop the drawing request (there is a separate function)
-        //m_DebugDrawingRequests.pop();
-    }
+    for (int Request = 1; Request < NumberOfRequests; Request++)
+    {
+        const SDrawingRequest &DR = pRequests[Request];
 
+        MinLayer = MIN(MinLayer, DR.SpriteLayer);
+        MaxLayer = MAX(MaxLayer, DR.SpriteLayer);
+
+        if (DR < pRequests[Request - 1])
+            Sorted = false;
+    }
+
+    // If the requests already are in order, there is nothing to do
+    if (Sorted)
+        return;
+
+    // If there are too many layers to count the requests of each one
+    if (MaxLayer - MinLayer >= DRAWING_SORT_MAX_RANGE)
+    {
+        std::stable_sort(DrawingRequests.begin().base(), DrawingRequests.end().base());
+        return;
+    }
+
+    int Range = MaxLayer - MinLayer + 1;
+
+    //------------------------------
+    // Bucket the requests per layer
+    //------------------------------
+
+    for (int Layer = 0; Layer < Range; Layer++)
+        m_SortCounts[Layer] = 0;
+
+    for (int Request = 0; Request < NumberOfRequests; Request++)
+        m_SortCounts[pRequests[Request].SpriteLayer - MinLayer]++;
+
+    // Turn the counts into the index of the first request of each layer
+    int Index = 0;
+
+    for (int Layer = 0; Layer < Range; Layer++)
+    {
+        int Count = m_SortCounts[Layer];
+        m_SortCounts[Layer] = Index;
+        Index += Count;
+    }
+
+    m_SortedDrawingRequests.resize(NumberOfRequests);
+
+    SDrawingRequest* pSorted = m_SortedDrawingRequests.data();
+
+    for (int Request = 0; Request < NumberOfRequests; Request++)
+        pSorted[m_SortCounts[pRequests[Request].SpriteLayer - MinLayer]++] = pRequests[Request];
+
+    //--------------------------------
+    // Sort each layer on the priority
+    //--------------------------------
+
+    // The layers are in order, so only the priorities can move a request back
+    for (int Request = 1; Request < NumberOfRequests; Request++)
+    {
+        if (!(pSorted[Request] < pSorted[Request - 1]))
+            continue;
+
+        SDrawingRequest DR = pSorted[Request];
+        int Place = Request;
+
+        do
+        {
+            pSorted[Place] = pSorted[Place - 1];
+            Place--;
+        }
+        while (Place > 0 && DR < pSorted[Place - 1]);
+
+        pSorted[Place] = DR;
+    }
+
+    // The list of requests keeps its capacity for the next sort
+    DrawingRequests.swap(m_SortedDrawingRequests);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+Uint64 CVideoSDL::HashDrawingRequest(const SDrawingRequest& DR)
+{
+    // Everything that gives the pixels of the request and their order
+    const Uint64 Values [] = { (Uint64)DR.SpriteTable, (Uint64)DR.Sprite,
+                               (Uint64)DR.ZoneX1, (Uint64)DR.ZoneY1, (Uint64)DR.ZoneX2, (Uint64)DR.ZoneY2,
+                               (Uint64)DR.PositionX, (Uint64)DR.PositionY,
+                               (Uint64)DR.SpriteLayer, (Uint64)DR.PriorityInLayer };
+
+    Uint64 Key = TILE_HASH_SEED;
+
+    for (unsigned int Value = 0; Value < sizeof(Values) / sizeof(Values[0]); Value++)
+        Key = (Key ^ Values[Value]) * TILE_HASH_PRIME;
+
+    return Key;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+Uint64 CVideoSDL::HashDebugDrawingRequest(const SDebugDrawingRequest& DR)
+{
+    // Everything that gives the blended pixels of the rectangle
+    const Uint64 Values [] = { (Uint64)DR.ZoneX1, (Uint64)DR.ZoneY1, (Uint64)DR.ZoneX2, (Uint64)DR.ZoneY2,
+                               (Uint64)DR.PositionX, (Uint64)DR.PositionY,
+                               (Uint64)DR.R, (Uint64)DR.G, (Uint64)DR.B };
+
+    Uint64 Key = TILE_HASH_SEED;
+
+    for (unsigned int Value = 0; Value < sizeof(Values) / sizeof(Values[0]); Value++)
+        Key = (Key ^ Values[Value]) * TILE_HASH_PRIME;
+
+    return Key;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+WORD CVideoSDL::GetNumberOfBits(DWORD dwMask)
+{
+    WORD wBits = 0;
+    while (dwMask)
+    {
+        dwMask = dwMask & (dwMask - 1);
+        wBits++;
+    }
+    return wBits;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CVideoSDL::LoadSprites(int SpriteTableWidth,
+                            int SpriteTableHeight,
+                            int SpriteWidth,
+                            int SpriteHeight,
+                            bool Transparent,
+                            const uint8_t* BitmapData,
+                            uint32_t BitmapSize)
+{
+    SSpriteTableFile File = { SpriteTableWidth, SpriteTableHeight, SpriteWidth, SpriteHeight, Transparent, BitmapData, BitmapSize };
+
+    return LoadSpriteTables(&File, 1);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! What the jobs decoding the sprite tables work on
+struct SSpriteTableDecoding
+{
+    const SSpriteTableFile* pFiles;                 //!< Sprite tables to load
+    const int*              pJobs;                  //!< Sprite table to decode in each job
+    SDL_PixelFormat*        pFormat;                //!< Pixel format to convert the bitmaps to, NULL to keep the format of the files
+    SDL_Surface**           ppSurfaces;             //!< Surface decoded for each sprite table, NULL if it failed
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::DecodeSpriteTable(void* pParameter, int Job)
+{
+    SSpriteTableDecoding* pDecoding = (SSpriteTableDecoding*)pParameter;
+
+    int Table = pDecoding->pJobs[Job];
+    const SSpriteTableFile& File = pDecoding->pFiles[Table];
+
+    pDecoding->ppSurfaces[Table] = NULL;
+
+    SDL_RWops *rwBitmap = SDL12_RWFromMem(const_cast<uint8_t*>(File.BitmapData), File.BitmapSize);
+
+    // Create a SDLVideo surface for this bitmap
+    SDL_Surface *pSurface = SDL12_LoadBMP_RW(rwBitmap, 0);
+
+    SDL12_FreeRW(rwBitmap);
+
+    if (pSurface == NULL)
+        return;
+
+    // Convert the bitmap once, instead of converting its pixels each time a sprite is blitted
+    if (pDecoding->pFormat != NULL)
+    {
+        SDL_Surface *pConverted = SDL12_ConvertSurface(pSurface, pDecoding->pFormat, SDL_SWSURFACE);
+
+        SDL12_FreeSurface(pSurface);
+
+        if (pConverted == NULL)
+            return;
+
+        pSurface = pConverted;
+    }
+
+    // If the sprite table uses transparency, apply the color key to the surface
+    if (File.Transparent &&
+        SDL12_SetColorKey(pSurface, SDL_SRCCOLORKEY | SDL_RLEACCEL, SDL12_MapRGBA(pSurface->format, 0x00, 0xff, 0x00, 0xff)) != 0)
+    {
+        SDL12_FreeSurface(pSurface);
+        return;
+    }
+
+    pDecoding->ppSurfaces[Table] = pSurface;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The surfaces decoded from the bitmaps are kept when the display is
+ *  destroyed, so that recreating it (when the scaler changes) does not
+ *  decode them again. The bitmaps that are not in the cache are decoded
+ *  on the worker pool, the sprite tables are then made in the order of
+ *  the files, so that their handles don't depend on the threads.
+ */
+
+bool CVideoSDL::LoadSpriteTables(const SSpriteTableFile* pFiles, int NumberOfFiles)
+{
+    ASSERT (pFiles != NULL);
+    ASSERT (NumberOfFiles > 0);
+
+    double StartTime = m_RenderTimer.GetElapsedTime();
+
+    // The render thread and the worker pool must not be busy with a frame
+    FinishRendering();
+
+    // The sprites are blitted on the back buffer, or on the primary surface if there is none
+    SDL_Surface* pTarget = (m_pBackBuffer != NULL ? m_pBackBuffer : m_pPrimary);
+
+    // Without an alpha channel, so that the color key is used
+    SDL_Surface* pFormatSurface = NULL;
+
+    if (pTarget != NULL && pTarget->format->BytesPerPixel == 4)
+    {
+        pFormatSurface = SDL12_CreateRGBSurface(SDL_SWSURFACE, 1, 1, 32,
+                                                pTarget->format->Rmask, pTarget->format->Gmask, pTarget->format->Bmask, 0);
+    }
+
+    SSpriteTableDecoding Decoding;
+    int* pJobs = new int [NumberOfFiles];
+    SDL_Surface** ppSurfaces = new SDL_Surface* [NumberOfFiles];
+    int NumberOfJobs = 0;
+
+    Decoding.pFiles = pFiles;
+    Decoding.pJobs = pJobs;
+    Decoding.pFormat = (pFormatSurface != NULL ? pFormatSurface->format : NULL);
+    Decoding.ppSurfaces = ppSurfaces;
+
+    for (int Table = 0; Table < NumberOfFiles; Table++)
+    {
+        ppSurfaces[Table] = NULL;
+
+        for (unsigned int Cached = 0; Cached < m_Surfaces.size(); Cached++)
+        {
+            SDL_Surface* pCachedSurface = m_Surfaces[Cached].pSurface;
+
+            if (m_Surfaces[Cached].pBitmapData == pFiles[Table].BitmapData &&
+                m_Surfaces[Cached].Transparent == pFiles[Table].Transparent &&
+                (Decoding.pFormat == NULL ||
+                 (pCachedSurface->format->BitsPerPixel == Decoding.pFormat->BitsPerPixel &&
+                  pCachedSurface->format->Rmask == Decoding.pFormat->Rmask &&
+                  pCachedSurface->format->Gmask == Decoding.pFormat->Gmask &&
+                  pCachedSurface->format->Bmask == Decoding.pFormat->Bmask)))
+            {
+                ppSurfaces[Table] = pCachedSurface;
+                break;
+            }
+        }
+
+        if (ppSurfaces[Table] == NULL)
+            pJobs[NumberOfJobs++] = Table;
+    }
+
+    if (NumberOfJobs > 0)
+        m_WorkerPool.Run(DecodeSpriteTable, &Decoding, NumberOfJobs);
+
+    bool Success = true;
+
+    // Store the new surfaces
+    for (int Job = 0; Job < NumberOfJobs; Job++)
+    {
+        int Table = pJobs[Job];
+
+        if (ppSurfaces[Table] == NULL)
+        {
+            // Log failure
+            theLog.WriteLine("SDLVideo        => !!! Could not create surface (sprite table %d).", Table);
+
+            Success = false;
+            continue;
+        }
+
+        SSurface Surface;
+        Surface.pSurface = ppSurfaces[Table];
+        Surface.BlitParameters = 0;
+        Surface.pBitmapData = pFiles[Table].BitmapData;
+        Surface.Transparent = pFiles[Table].Transparent;
+
+        // Add the surface to the surface container
+        m_Surfaces.push_back(Surface);
+    }
+
+    // Create the sprite tables
+    for (int Table = 0; Table < NumberOfFiles && Success; Table++)
+        Success = AddSpriteTable(pFiles[Table], ppSurfaces[Table]);
+
+    if (Success)
+    {
+        theLog.WriteLine("SDLVideo        => %d sprite table(s) loaded in %.1f ms : %d decoded on %d thread(s), %d found in the cache.",
+            NumberOfFiles, (m_RenderTimer.GetElapsedTime() - StartTime) * 1000.0,
+            NumberOfJobs, m_WorkerPool.GetNumberOfThreads() + 1, NumberOfFiles - NumberOfJobs);
+    }
+
+    if (pFormatSurface != NULL)
+        SDL12_FreeSurface(pFormatSurface);
+
+    delete [] pJobs;
+    delete [] ppSurfaces;
+
+    return Success;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CVideoSDL::AddSpriteTable(const SSpriteTableFile& File, SDL_Surface* pSurface)
+{
+    ASSERT (pSurface != NULL);
+
+    // Find where to store the handle of the new sprite table. If the bitmap
+    // was already loaded, the new sprite table replaces the previous one.
+    int Hash = HashBitmapData(File.BitmapData);
+    int Tries = 0;
+
+    while (m_SpriteTableHandles[Hash] != -1 && m_SpriteTables[m_SpriteTableHandles[Hash]].pBitmapData != File.BitmapData)
+    {
+        // If all the handles are used
+        if (++Tries == 1 << SPRITETABLE_HANDLE_BITS)
+        {
+            // Log failure
+            theLog.WriteLine("SDLVideo        => !!! Too many sprite tables.");
+
+            // Get out
+            return false;
+        }
+
+        Hash = (Hash + 1) & ((1 << SPRITETABLE_HANDLE_BITS) - 1);
+    }
+
+    // Prepare a sprite table, its sprites are added after the others
+    SSpriteTable SpriteTable;
+    SpriteTable.pBitmapData = File.BitmapData;
+    SpriteTable.FirstSprite = m_Sprites.size();
+    SpriteTable.NumberOfSprites = File.SpriteTableWidth * File.SpriteTableHeight;
+    SpriteTable.pRunSource = NULL;
+
+    // Variable rectangle coordinates that will be passed during sprite creations
+    int ZoneX1 = 1;
+    int ZoneY1 = 1;
+    int ZoneX2 = 1 + File.SpriteWidth;
+    int ZoneY2 = 1 + File.SpriteHeight;
+
+    // Scan all the sprites in this surface
+    for (int Y = 0; Y < File.SpriteTableHeight; Y++)
+    {
+        for (int X = 0; X < File.SpriteTableWidth; X++)
+        {
+            // Prepare a sprite
+            SSprite Sprite;
+            Sprite.pSurface = pSurface;                         // The surface decoded from the bitmap
+            Sprite.ZoneX1 = ZoneX1;
+            Sprite.ZoneY1 = ZoneY1;
+            Sprite.ZoneX2 = ZoneX2;
+            Sprite.ZoneY2 = ZoneY2;
+
+            // Advance the rectangle on the row
+            ZoneX1 += File.SpriteWidth + 1;
+            ZoneX2 += File.SpriteWidth + 1;
+
+            // Add the sprite to the sprite table
+            m_Sprites.push_back(Sprite);
+        }
+
+        // Back to beginning of row
+        ZoneX1 = 1;
+        ZoneX2 = 1 + File.SpriteWidth;
+
+        // Make the rectangle go down
+        ZoneY1 += File.SpriteHeight + 1;
+        ZoneY2 += File.SpriteHeight + 1;
+    }
+
+    // Store the sprite table, its handle is its index
+    m_SpriteTableHandles[Hash] = m_SpriteTables.size();
+    m_SpriteTables.push_back(SpriteTable);
+
+    // Everything went right
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::FreeSprites(void)
+{
+    // The render thread must not draw the sprites anymore
+    FinishRendering();
+
+    // Empty drawing requests queues
+    for (int Frame = 0; Frame < RENDER_FRAMES; Frame++)
+    {
+        m_Frames[Frame].DrawingRequests.clear();
+        m_Frames[Frame].StaticDrawingRequests.clear();
+    }
+
+    // The sprites drawn in the previous frame don't exist anymore
+    InvalidateAll();
+
+    // The sprite runs were drawn with the sprites of the display
+    FreeSpriteRuns();
+
+    // Remove all sprite tables, the surfaces stay in the cache
+    for (unsigned int Table = 0; Table < m_SpriteTables.size(); Table++)
+    {
+        if (m_SpriteTables[Table].pRunSource != NULL)
+            SDL12_FreeSurface(m_SpriteTables[Table].pRunSource);
+    }
+
+    m_SpriteTables.clear();
+    m_Sprites.clear();
+
+    for (int Hash = 0; Hash < 1 << SPRITETABLE_HANDLE_BITS; Hash++)
+        m_SpriteTableHandles[Hash] = -1;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::FreeSurfaces(void)
+{
+    // The sprites must not use the surfaces anymore
+    ASSERT (m_Sprites.empty());
+
+    // Scan all the surfaces
+    for (unsigned int i = 0; i < m_Surfaces.size(); i++)
+    {
+        // If the surface exists
+        if (m_Surfaces[i].pSurface != NULL)
+        {
+            // Release it
+            SDL12_FreeSurface(m_Surfaces[i].pSurface);
+            m_Surfaces[i].pSurface = NULL;
+        }
+    }
+
+    // Remove all surfaces
+    m_Surfaces.clear();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The previous frame is presented first : if the render thread did not
+ *  finish it yet, the game waits for it, so that every frame is presented
+ *  and the game is never more than one frame ahead. The recorded frame is
+ *  then handed to the render thread, which draws it while the game updates
+ *  and records the next frame. Without a render thread, the recorded frame
+ *  is drawn at once and presented by the second update of the screen.
+ */
+
+void CVideoSDL::UpdateAll(void)
+{
+    SRenderFrame& Frame = m_Frames[m_RenderThread.GetRecordingFrame()];
+
+    // The debug rectangles stay until they are removed
+    Frame.DebugDrawingRequests = m_DebugDrawingRequests;
+
+    m_RenderThread.Wait();
     UpdateScreen();
+
+    bool Dropped = m_RenderThread.Publish();
+
+    // Present the frame if it is already drawn
+    UpdateScreen();
+
+    // Record the next frame from scratch
+    SRenderFrame& NextFrame = m_Frames[m_RenderThread.GetRecordingFrame()];
+
+    NextFrame.DrawingRequests.clear();
+    NextFrame.StaticDrawingRequests.clear();
+    m_NumberOfRecordedFrames++;
+
+    // The display was not made black for a frame that was not drawn
+    if (!Dropped)
+        NextFrame.Clear = false;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::RenderFrame(void* pParameter, int Frame)
+{
+    CVideoSDL* pVideo = (CVideoSDL*)pParameter;
+
+    pVideo->Render(pVideo->m_Frames[Frame]);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  \return true if the dirty zones have to be made black before they are drawn
+ *
+ *  The display is made black entirely when the frame is cleared and the
+ *  previous one was not. If the previous frame was cleared too, the tiles
+ *  that don't change are still black under their sprites : only the dirty
+ *  tiles are made black, so that a game mode clearing every frame does not
+ *  draw the whole display again.
+ */
+
+bool CVideoSDL::ClearDisplay(const SRenderFrame& Frame, SDL_Surface* pTarget)
+{
+    bool ClearDirtyRects = false;
+
+    if (Frame.Clear)
+    {
+        if (m_PreviousFrameCleared && !m_RedrawAll)
+        {
+            ClearDirtyRects = true;
+        }
+        else
+        {
+            SDL12_FillRect(m_pPrimary, &m_PrimaryRect, 0);
+
+            if (pTarget != m_pPrimary)
+                SDL12_FillRect(pTarget, NULL, 0);
+
+            // The black display has to be drawn over entirely
+            InvalidateAll();
+        }
+    }
+
+    m_PreviousFrameCleared = Frame.Clear;
+
+    return ClearDirtyRects;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  Executed by the render thread. Everything it uses (the tiles, the
+ *  static layer, the back buffer and the primary surface) is only used
+ *  by the render thread while frames are rendered. The game thread only
+ *  presents the primary surface while the render thread waits for it.
+ */
+
+void CVideoSDL::Render(SRenderFrame& Frame)
+{
+    // Without a scaler, the sprites are drawn on the primary surface directly
+    SDL_Surface* pTarget = (m_pBackBuffer != NULL ? m_pBackBuffer : m_pPrimary);
+
+    bool ClearDirtyRects = ClearDisplay(Frame, pTarget);
+
+    double StartTime = m_RenderTimer.GetElapsedTime();
+
+    SortDrawingRequests(Frame.DrawingRequests);
+
+    double SortEndTime = m_RenderTimer.GetElapsedTime();
+
+    UpdateStaticLayer(Frame);
+
+    FindDirtyRects(Frame);
+
+    // Draw each dirty zone with the requests drawn on it, and nothing around it
+    for (int Rect = 0; Rect < m_NumberOfDirtyRects; Rect++)
+    {
+        SDL_Rect DirtyRect = m_pDirtyRects[Rect];
+
+        SDL12_SetClipRect(pTarget, &DirtyRect);
+
+        if (ClearDirtyRects)
+        {
+            SDL_Rect ClearRect = DirtyRect;
+            SDL12_FillRect(pTarget, &ClearRect, 0);
+        }
+
+        // The static sprites are below all the others
+        if (!Frame.StaticDrawingRequests.empty())
+        {
+            SDL_Rect DestRect = DirtyRect;
+
+            if (SDL12_BlitSurface(m_pStaticLayer, &DirtyRect, pTarget, &DestRect) < 0)
+            {
+                // blitting failed
+                theLog.WriteLine("SDLVideo        => !!! SDLVideo error is : %s.", GetSDLVideoError());
+            }
+        }
+
+        BlitDrawingRequests(Frame.DrawingRequests, DirtyRect, pTarget);
+
+        // Debug rectangles? Blend them with what was just drawn under them,
+        // only in the dirty zone : the other zones are already blended.
+        for (::portable_stl::vector<SDebugDrawingRequest>::iterator it = Frame.DebugDrawingRequests.begin(); it != Frame.DebugDrawingRequests.end(); it++)
+            FillTranslucentRect(pTarget, *it, DirtyRect);
+    }
+
+    SDL12_SetClipRect(pTarget, NULL);
+
+    double BlitEndTime = m_RenderTimer.GetElapsedTime();
+
+    ScaleDirtyRects();
+
+    m_SortTime += SortEndTime - StartTime;
+    m_BlitTime += BlitEndTime - SortEndTime;
+    m_ScaleTime += m_RenderTimer.GetElapsedTime() - BlitEndTime;
+
+    // The primary surface holds the whole display, even if only some zones changed
+    if (m_pFrameExporter != NULL)
+        m_pFrameExporter->WriteFrame(m_pPrimary);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::FinishRendering(void)
+{
+    // Present the frames the render thread waits for, until it has nothing left to render
+    while (true)
+    {
+        m_RenderThread.Wait();
+
+        if (!m_RenderThread.IsFrameRendered())
+            break;
+
+        UpdateScreen();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+const SDL_Surface* CVideoSDL::GetRenderedSurface(void)
+{
+    FinishRendering();
+
+    return m_pPrimary;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL::OnPaint(void)
+{
+    if (m_pPrimary == NULL)
+        return;
+
+    // Once the render thread is done, the primary surface holds the whole display
+    FinishRendering();
+
+    // The window needs the whole display, not just what changed
+    InvalidateAll();
+    PresentAll();
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+/**
+ *  The rectangle is blended at 50% straight into the target, as blitting
+ *  a surface of its color with an alpha of 128 would do, without making
+ *  any surface. The target must be a 32 bits surface with 8 bits per
+ *  component : the halves of the components are added, with the lowest
+ *  bits masked so that no carry goes to the next component.
+ */
+
+void CVideoSDL::FillTranslucentRect(SDL_Surface* pTarget, const SDebugDrawingRequest& DR, const SDL_Rect& Zone)
+{
+    const SDL_PixelFormat* pFormat = pTarget->format;
+
+    ASSERT (pFormat->BytesPerPixel == 4);
+    ASSERT (pFormat->Rloss == 0 && pFormat->Gloss == 0 && pFormat->Bloss == 0);
+
+    // Clip the rectangle to the zone, which is inside the target
+    int X1 = MAX(DR.PositionX, (int)Zone.x);
+    int Y1 = MAX(DR.PositionY, (int)Zone.y);
+    int X2 = MIN(DR.PositionX + DR.ZoneX2 - DR.ZoneX1, Zone.x + Zone.w);
+    int Y2 = MIN(DR.PositionY + DR.ZoneY2 - DR.ZoneY1, Zone.y + Zone.h);
+
+    if (X1 >= X2 || Y1 >= Y2)
+        return;
+
+    Uint32 ColorMask = pFormat->Rmask | pFormat->Gmask | pFormat->Bmask;
+    Uint32 LowBits = (1 << pFormat->Rshift) | (1 << pFormat->Gshift) | (1 << pFormat->Bshift);
+    Uint32 HighBits = ColorMask & ~LowBits;
+    Uint32 Color = SDL12_MapRGB(pTarget->format, DR.R, DR.G, DR.B) & ColorMask;
+    Uint32 HalfColor = (Color & HighBits) >> 1;
+
+    for (int Y = Y1; Y < Y2; Y++)
+    {
+        Uint32* pPixel = (Uint32*)((Uint8*)pTarget->pixels + Y * pTarget->pitch) + X1;
+
+        for (int X = X1; X < X2; X++, pPixel++)
+        {
+            Uint32 Pixel = *pPixel;
+
+            *pPixel = (Pixel & ~ColorMask) | (HalfColor + ((Pixel & HighBits) >> 1) + (Color & Pixel & LowBits));
+        }
+    }
 }
 
 //******************************************************************************************************************************
@@ -30,18 +30,38 @@
 
 #include "portable_stl/vector/vector.h"
 #include "portable_stl/list/list.h"
-#include "portable_stl/map/map.h"
 
 #include "SDL/SDL.h"
 #include "StdAfx.h"
 
+#include "CWorkerPool.h"
+#include "CRenderThread.h"
+#include "CFrameExporter.h"
+#include "CScaler.h"
+#include "CScalerXBR.h"
+
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+#include "CVideoSDL2.h"
+#endif
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#define SPRITETABLE_HANDLE_BITS     8       //!< Number of bits of the hash of a bitmap, there must be much more hashes than sprite tables
+#define SPRITETABLE_HASH_MULTIPLIER 11400714819323198485ULL     //!< Multiplier spreading the bitmap addresses over the hashes (2^64 / golden ratio)
+#define DRAWING_SORT_MAX_RANGE      1024    //!< Maximum number of layers between the lowest and the highest one, to bucket the drawing requests per layer
+#define SPRITERUN_CACHE_SIZE        256     //!< Number of sprite runs cached before the least recently drawn ones are released
+#define SPRITERUN_CACHE_LOW_WATER   192     //!< Number of sprite runs left in the cache when the least recently drawn ones are released
+#define SPRITERUN_SPRITETABLE       -1      //!< Sprite table handle of the drawing requests of the sprite runs, whose sprite is the serial number of the run
+
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
 struct SSprite
 {
-    int SurfaceNumber;          //!< Number of the surface in CDisplay that will be the source
+    SDL_Surface* pSurface;      //!< Surface that will be the source
     int ZoneX1;                 // Top-left corner in the source surface
     int ZoneY1;
     int ZoneX2;                 // Bottom-right corner in the source surface
@@ -78,7 +98,8 @@ struct SDrawingRequest
     int ZoneY1;
     int ZoneX2;
     int ZoneY2;
-    const void* SpriteTable;    //!< Number of the sprite page where to the sprite is
+    SDL_Surface* pSurface;      //!< Surface the zone is blitted from
+    int SpriteTable;            //!< Handle of the sprite table where the sprite is
     int Sprite;                 //!< Number of the sprite to draw
     int SpriteLayer;            //!< Number of the layer where the sprite has to be drawn
     int PriorityInLayer;        //!< PriorityInLayer value inside the layer.
@@ -138,10 +159,87 @@ struct SDebugDrawingRequest
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 
+//! What the game asked to draw in a frame, recorded by the game and drawn by the render thread
+
+struct SRenderFrame
+{
+    ::portable_stl::vector<SDrawingRequest> DrawingRequests;            //!< List of drawing requests
+    ::portable_stl::vector<SDrawingRequest> StaticDrawingRequests;      //!< List of static drawing requests
+    ::portable_stl::vector<SDebugDrawingRequest> DebugDrawingRequests;  //!< Debug rectangles shown in the frame
+    bool Clear;                                                         //!< Does the display have to be made black before drawing the frame?
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
 struct SSurface
 {
     struct SDL_Surface* pSurface;           //!< SDL surface
     DWORD               BlitParameters;     //!< Parameter when blitting, depends on if the surface is transparent
+    const void*         pBitmapData;        //!< Bitmap the surface was decoded from, to find it again when the display is recreated
+    bool                Transparent;        //!< Are the green pixels of the surface transparent?
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A sprite table to load from a bitmap embedded in the program
+struct SSpriteTableFile
+{
+    int                 SpriteTableWidth;   //!< Number of sprites on a row of the bitmap
+    int                 SpriteTableHeight;  //!< Number of rows of sprites in the bitmap
+    int                 SpriteWidth;        //!< Width of a sprite in pixels
+    int                 SpriteHeight;       //!< Height of a sprite in pixels
+    bool                Transparent;        //!< Are the green pixels transparent?
+    const uint8_t*      BitmapData;         //!< Content of the BMP file
+    uint32_t            BitmapSize;         //!< Size of the BMP file in bytes
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A sprite table, whose handle is its index in the sprite tables of CVideoSDL
+
+struct SSpriteTable
+{
+    const void*         pBitmapData;        //!< Bitmap the sprite table was loaded from, which the sprites are drawn with
+    int                 FirstSprite;        //!< Index of the first sprite of the table in the sprites of CVideoSDL
+    int                 NumberOfSprites;    //!< Number of sprites in the table
+    SDL_Surface*        pRunSource;         //!< Copy of the surface of the sprites that the sprite runs are drawn from, NULL until a run needs it
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A sprite of a sprite run, at a position relative to the position of the run
+struct SSpriteRunPart
+{
+    const void*         SpriteTable;        //!< Sprite table of the sprite
+    int                 Sprite;             //!< Number of the sprite in the table
+    int                 PositionX;          //!< Position of the sprite from the position of the run
+    int                 PositionY;
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Sprites drawn once in a surface of their own, so that they are drawn again with a single drawing request
+
+struct SSpriteRun
+{
+    Uint64              Hash;               //!< Hash of the key, compared before the key itself
+    char*               pKey;               //!< Copy of the key given by the caller, identifying what the run draws
+    int                 KeySize;            //!< Size of the key in bytes
+    SDL_Surface*        pSurface;           //!< Surface the sprites are drawn in, transparent where there is no sprite
+    int                 OffsetX;            //!< Position of the surface from the position of the run
+    int                 OffsetY;
+    int                 Serial;             //!< Number identifying the run in the drawing requests, never given to another run
+    int                 LastFrame;          //!< Number of the latest recorded frame the run was drawn in
 };
 
 //******************************************************************************************************************************
@@ -158,20 +256,99 @@ private:
     int                     m_Depth;                             //!< Display depth
     SDL_Surface*            m_pPrimary;                          //!< Primary surface
     SDL_Rect                m_PrimaryRect;                       //!< Window rect in client coordinates
-#ifdef BOMBERMAAAN_SCALE_2X
-    SDL_Surface*            m_pBackBuffer;                       //!< Backbuffer surface
+    SDL_Surface*            m_pBackBuffer;                       //!< Backbuffer surface, NULL if the display is not enlarged
     SDL_Rect                m_BackBufferRect;                    //!< Window rect in screen coordinates
+    CScalerNearest          m_ScalerNearest;                     //!< Scalers the back buffer can be enlarged with
+    CScalerHQ2x             m_ScalerHQ2x;
+    CScalerXBR              m_ScalerXBR;
+    EScaler                 m_Scaler;                            //!< Scaler asked for
+    int                     m_Scale;                             //!< Magnification of the display
+    const CScaler*          m_pScaler;                           //!< Scaler enlarging the back buffer, NULL if the display is not enlarged
+    int                     m_NumberOfScalePasses;               //!< Number of times the scaler is applied (twice to enlarge 4 times with a 2x scaler)
+    int                     m_ScalePass;                         //!< Pass the worker pool is doing
+    uint32_t*               m_pScaleBuffer;                      //!< Output of the first pass and input of the second one, NULL if there is one pass
+    CWorkerPool             m_WorkerPool;                        //!< Threads sharing the upscaling of the back buffer
+    CRenderThread           m_RenderThread;                      //!< Thread drawing and upscaling a frame while the game prepares the next one
+    SRenderFrame            m_Frames [RENDER_FRAMES];            //!< Frames recorded by the game and drawn by the render thread
+    SDL_Rect*               m_pPresentRects;                     //!< Zones of the primary surface to present for the rendered frame
+    int                     m_NumberOfPresentRects;              //!< Number of zones to present, 0 if nothing changed
+    bool                    m_PresentAll;                        //!< Does the whole display have to be presented for the rendered frame?
+    CFrameExporter*         m_pFrameExporter;                    //!< Writes the rendered frames to a video file instead of presenting them, NULL if they are presented
+    bool                    m_Offscreen;                         //!< Is the display drawn in a memory surface, without any window?
+    int                     m_NumberOfBands;                     //!< Number of horizontal bands the back buffer is upscaled in
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+    CVideoSDL2              m_VideoSDL2;                         //!< Presents the primary surface through SDL2 directly
+    bool                    m_PresentWithSDL2;                   //!< Could the SDL2 presentation be created? If not, sdl12_compat presents.
 #endif
+    CTimer                  m_PresentTimer;                      //!< Timer measuring the time spent presenting
+    CTimer                  m_RenderTimer;                       //!< Timer measuring the phases of the rendering (only used by the render thread)
+    double                  m_SortTime;                          //!< Time (in seconds) spent sorting the drawing requests
+    double                  m_BlitTime;                          //!< Time (in seconds) spent drawing the dirty zones
+    double                  m_ScaleTime;                         //!< Time (in seconds) spent upscaling the dirty zones
+    double                  m_FullPresentTime;                   //!< Time (in seconds) spent presenting the whole display
+    int                     m_NumberOfFullPresents;              //!< Number of times the whole display was presented
+    double                  m_PartialPresentTime;                //!< Time (in seconds) spent presenting the dirty zones of the display
+    int                     m_NumberOfPartialPresents;           //!< Number of times the dirty zones of the display were presented
     int                     m_OriginX;                           //!< Origin position where to draw from
     int                     m_OriginY;
-    ::portable_stl::vector<SSurface> m_Surfaces;                 //!< Surfaces
-    ::portable_stl::map<const void*, ::portable_stl::vector<SSprite>> m_SpriteTables; //!< Available sprite tables
-    ::portable_stl::vector<SDrawingRequest> m_DrawingRequests;   //!< List of drawing requests
-    ::portable_stl::vector<SDebugDrawingRequest> m_DebugDrawingRequests;    //!< vector of drawing requests for debugging purposes
+    int                     m_TilesX;                            //!< Number of dirty tiles from left to right
+    int                     m_TilesY;                            //!< Number of dirty tiles from top to bottom
+    Uint64*                 m_pTileHashes;                       //!< Hash of the drawing requests drawn on each tile in this frame
+    Uint64*                 m_pPreviousTileHashes;               //!< Hash of the drawing requests drawn on each tile in the previous frame
+    bool*                   m_pDirtyTiles;                       //!< Does the tile have to be drawn again in this frame?
+    SDL_Rect*               m_pDirtyRects;                       //!< Zones of the display drawn again in this frame (groups of dirty tiles)
+    int                     m_NumberOfDirtyRects;                //!< Number of zones drawn again in this frame
+    bool                    m_RedrawAll;                         //!< Does the next frame have to be drawn entirely?
+    bool                    m_PreviousFrameCleared;              //!< Was the display made black for the latest rendered frame?
+    int                     m_NumberOfFrames;                    //!< Number of frames drawn, for the statistics
+    int                     m_NumberOfRedrawnTiles;              //!< Number of tiles drawn in all the frames, for the statistics
+    SDL_Surface*            m_pStaticLayer;                      //!< Static sprites drawn over the transparent color, blitted under the other sprites
+    Uint64*                 m_pStaticTileHashes;                 //!< Hash of the static drawing requests drawn on each tile in this frame
+    Uint64*                 m_pCachedStaticTileHashes;           //!< Hash of the static drawing requests drawn on each tile of the static layer
+    bool                    m_RedrawStaticLayer;                 //!< Does the static layer have to be drawn entirely?
+    int                     m_NumberOfStaticTilesDrawn;          //!< Number of tiles of the static layer drawn, for the statistics
+    ::portable_stl::vector<SSurface> m_Surfaces;                 //!< Surfaces decoded from the bitmaps, kept when the display is recreated
+    ::portable_stl::vector<SSprite> m_Sprites;                   //!< Sprites of all the sprite tables, one table after the other
+    ::portable_stl::vector<SSpriteTable> m_SpriteTables;         //!< Available sprite tables, indexed by their handle
+    int                     m_SpriteTableHandles [1 << SPRITETABLE_HANDLE_BITS]; //!< Handle of the sprite table of each bitmap hash, -1 if none (open addressing)
+    ::portable_stl::vector<SDrawingRequest> m_SortedDrawingRequests; //!< Drawing requests being sorted, swapped with the sorted list so that both keep their capacity
+    int                     m_SortCounts [DRAWING_SORT_MAX_RANGE]; //!< Number of drawing requests of each layer, then index of the next one in the sorted list
+    ::portable_stl::vector<SDebugDrawingRequest> m_DebugDrawingRequests;    //!< vector of drawing requests for debugging purposes, copied to each frame
+    ::portable_stl::vector<SSpriteRun> m_SpriteRuns;             //!< Cached sprite runs
+    int                     m_NextSpriteRunSerial;               //!< Serial number of the next sprite run to create
+    int                     m_NumberOfRecordedFrames;            //!< Number of frames recorded, to know which sprite runs the recorded frame draws
+    int                     m_NumberOfSpriteRunsDrawn;           //!< Number of sprite runs drawn, for the statistics
+    int                     m_NumberOfSpriteRunsCreated;         //!< Number of sprite runs that were not in the cache and had to be drawn, for the statistics
 
 private:
 
     WORD                    GetNumberOfBits (DWORD dwMask);
+    bool                    SetVideoMode (void);                 //!< Open the window and get its surface as the primary surface
+    static inline int       HashBitmapData (const void* pBitmapData); //!< Return the first place to look for the handle of the sprite table of a bitmap
+    inline const SSprite*   GetSprite (const void* SpriteTable, int Sprite, int* pHandle) const; //!< Return a sprite and the handle of its sprite table
+    void                    InvalidateAll (void);                //!< Make the next frame draw and present the whole display
+    bool                    ClearDisplay (const SRenderFrame& Frame, SDL_Surface* pTarget); //!< Make the display black if the frame is cleared, return true if only the dirty zones have to be
+    void                    FindDirtyRects (const SRenderFrame& Frame); //!< Compare the drawing requests of each tile with the previous frame's and group the dirty tiles
+    int                     GroupDirtyTiles (void);              //!< Group the dirty tiles in rectangles and return their number
+    void                    UpdateStaticLayer (SRenderFrame& Frame); //!< Draw again the tiles of the static layer whose static drawing requests changed
+    void                    FillTranslucentRect (SDL_Surface* pTarget, const SDebugDrawingRequest& DR, const SDL_Rect& Zone); //!< Blend the rectangle of the debug drawing request with the zone of the target
+    void                    BlitDrawingRequests (::portable_stl::vector<SDrawingRequest>& DrawingRequests, const SDL_Rect& Zone, SDL_Surface* pTarget); //!< Blit the sorted drawing requests drawn on the zone
+    static Uint64           HashDrawingRequest (const SDrawingRequest& DR); //!< Return a hash of what gives the pixels of the drawing request
+    static Uint64           HashDebugDrawingRequest (const SDebugDrawingRequest& DR); //!< Return a hash of what gives the blended pixels of the debug drawing request
+    void                    GetScaleZone (const SDL_Rect& DirtyRect, int Pass, int& X1, int& Y1, int& X2, int& Y2) const; //!< Zone of the image of a scale pass that depends on a dirty zone
+    static void             ScaleBand (void* pParameter, int Band); //!< Upscale one horizontal band of the back buffer (a worker pool job)
+    static void             DecodeSpriteTable (void* pParameter, int Job); //!< Decode the bitmap of a sprite table in the pixel format of the display (a worker pool job)
+    bool                    AddSpriteTable (const SSpriteTableFile& File, SDL_Surface* pSurface); //!< Make the sprites of a sprite table whose bitmap is decoded
+    static Uint64           HashSpriteRunKey (const void* pKey, int KeySize); //!< Return the hash of the key of a sprite run
+    int                     FindSpriteRun (const void* pKey, int KeySize) const; //!< Return the index of the cached sprite run of the key, -1 if none
+    void                    FreeSpriteRuns (void);               //!< Release all the cached sprite runs
+    void                    EvictSpriteRuns (void);              //!< Release the least recently drawn sprite runs, down to SPRITERUN_CACHE_LOW_WATER
+    SDL_Surface*            GetRunSource (int Handle);           //!< Return the copy of the surface of a sprite table that the sprite runs are drawn from
+    static void             RenderFrame (void* pParameter, int Frame); //!< Draw and upscale a recorded frame (the render thread function)
+    void                    Render (SRenderFrame& Frame);        //!< Draw the frame on the dirty zones, upscale them and find what to present
+    void                    ScaleDirtyRects (void);              //!< Upscale the dirty zones and find the zones of the primary surface to present
+    void                    PresentAll (void);                   //!< Present the whole primary surface
+    void                    FinishRendering (void);              //!< Wait until every published frame is rendered and presented
 
 public:
 
@@ -179,7 +356,9 @@ public:
     ~CVideoSDL (void);
 
     inline void             SetWindowHandle (HWND hWnd);
-    bool                    Create(int Width, int Height, int Depth);
+    inline void             SetFrameExporter (CFrameExporter* pFrameExporter); //!< Export the frames instead of presenting them (NULL to present them). Call before Create().
+    inline void             SetOffscreen (bool Offscreen);       //!< Draw the display in a memory surface instead of a window. Call before Create().
+    bool                    Create(int Width, int Height, int Depth, EScaler Scaler, int Scale);
     void                    Destroy (void);
     bool                    SetTransparentColor (int Red, int Green, int Blue);
     bool                    LoadSprites(int SpriteTableWidth,
@@ -189,9 +368,11 @@ public:
                                         bool Transparent,
                                         const uint8_t* BitmapData,
                                         uint32_t BitmapSize);
+    bool                    LoadSpriteTables (const SSpriteTableFile* pFiles, int NumberOfFiles); //!< Load sprite tables, decoding the bitmaps that are not in the cache on every core
     void                    FreeSprites(void);
+    void                    FreeSurfaces (void);                 //!< Release the surfaces decoded from the bitmaps. Call after Destroy().
     void                    OnWindowMove (void);
-    inline void             OnPaint (void);
+    void                    OnPaint (void);
     void                    Clear (void);
     void                    UpdateAll (void);
     void                    UpdateScreen (void);
@@ -204,6 +385,12 @@ public:
                                        int Sprite,
                                        int SpriteLayer,
                                        int PriorityInLayer);
+    void                    DrawStaticSprite(int PositionX,
+                                             int PositionY,
+                                             const void* SpriteTable,
+                                             int Sprite,
+                                             int SpriteLayer,
+                                             int PriorityInLayer);
     void                    DrawDebugRectangle(int PositionX,
                                                int PositionY,
                                                int w,
@@ -213,8 +400,21 @@ public:
                                                Uint8 b,
                                                int SpriteLayer,
                                                int PriorityInLayer);
+    bool                    DrawSpriteRun(int PositionX,
+                                          int PositionY,
+                                          const void* pKey,
+                                          int KeySize,
+                                          int SpriteLayer,
+                                          int PriorityInLayer); //!< Record a drawing request for the cached sprite run of the key, return false if it is not cached
+    bool                    CreateSpriteRun(const void* pKey,
+                                            int KeySize,
+                                            const SSpriteRunPart* pParts,
+                                            int NumberOfParts); //!< Draw the sprites in a new sprite run cached with the key
     void                    RemoveAllDebugRectangles ();
-    inline bool             IsModeSet(int Width, int Height, int Depth) const;
+    void                    SortDrawingRequests (::portable_stl::vector<SDrawingRequest>& DrawingRequests); //!< Sort the drawing requests by layer and priority, keeping the order of the equal ones
+    inline bool             IsModeSet(int Width, int Height, int Depth, EScaler Scaler, int Scale) const;
+    const SDL_Surface*      GetRenderedSurface (void);           //!< Wait until the published frames are rendered and return the surface holding the display
+    inline void             GetRenderTimes (double& SortTime, double& BlitTime, double& ScaleTime) const; //!< Times (in seconds) spent in each phase of the rendering since the creation
 };
 
 //******************************************************************************************************************************
@@ -226,14 +426,26 @@ inline void CVideoSDL::SetWindowHandle (HWND hWnd)
     m_hWnd = hWnd;
 }
 
-inline bool CVideoSDL::IsModeSet(int Width, int Height, int Depth) const
+inline void CVideoSDL::SetFrameExporter (CFrameExporter* pFrameExporter)
 {
-    return m_Width == Width && m_Height == Height && m_Depth == Depth;
+    m_pFrameExporter = pFrameExporter;
 }
 
-inline void CVideoSDL::OnPaint (void)
+inline void CVideoSDL::SetOffscreen (bool Offscreen)
 {
-    UpdateScreen ();
+    m_Offscreen = Offscreen;
+}
+
+inline void CVideoSDL::GetRenderTimes (double& SortTime, double& BlitTime, double& ScaleTime) const
+{
+    SortTime = m_SortTime;
+    BlitTime = m_BlitTime;
+    ScaleTime = m_ScaleTime;
+}
+
+inline bool CVideoSDL::IsModeSet(int Width, int Height, int Depth, EScaler Scaler, int Scale) const
+{
+    return m_Width == Width && m_Height == Height && m_Depth == Depth && m_Scaler == Scaler && m_Scale == Scale;
 }
 
 inline void CVideoSDL::SetOrigin (int OriginX, int OriginY)
@@ -242,6 +454,29 @@ inline void CVideoSDL::SetOrigin (int OriginX, int OriginY)
     m_OriginY = OriginY;
 }
 
+inline int CVideoSDL::HashBitmapData (const void* pBitmapData)
+{
+    return (int)(((Uint64)(size_t)pBitmapData * SPRITETABLE_HASH_MULTIPLIER) >> (64 - SPRITETABLE_HANDLE_BITS));
+}
+
+inline const SSprite* CVideoSDL::GetSprite (const void* SpriteTable, int Sprite, int* pHandle) const
+{
+    // Look for the bitmap from its hash, there is almost never a collision
+    int Hash = HashBitmapData(SpriteTable);
+
+    while (m_SpriteTableHandles[Hash] != -1 && m_SpriteTables[m_SpriteTableHandles[Hash]].pBitmapData != SpriteTable)
+        Hash = (Hash + 1) & ((1 << SPRITETABLE_HANDLE_BITS) - 1);
+
+    int Handle = m_SpriteTableHandles[Hash];
+
+    ASSERT (Handle != -1);
+    ASSERT (Sprite >= 0 && Sprite < m_SpriteTables[Handle].NumberOfSprites);
+
+    *pHandle = Handle;
+
+    return &m_Sprites[m_SpriteTables[Handle].FirstSprite + Sprite];
+}
+
 //******************************************************************************************************************************
 //******************************************************************************************************************************
 //******************************************************************************************************************************
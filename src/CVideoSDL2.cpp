@@ -0,0 +1,175 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CVideoSDL2.cpp
+ *  \brief Presentation of the display through SDL2
+ */
+
+#include "StdAfx.h"
+#include "CVideoSDL2.h"
+
+#ifdef BOMBERMAAAN_SDL2_VIDEO
+
+#include "SDL2/SDL.h"
+
+// Declared by the SDL 1.2 header SDL_syswm.h of sdl12_compat, which can't be included here
+extern "C" SDL_Window* SDLCALL SDL12COMPAT_GetWindow (void);
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CVideoSDL2::CVideoSDL2 (void)
+{
+    m_pRenderer = NULL;
+    m_pTexture = NULL;
+    m_Width = 0;
+    m_Height = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CVideoSDL2::~CVideoSDL2 (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CVideoSDL2::Create (int Width, int Height, unsigned int RedMask, unsigned int GreenMask, unsigned int BlueMask, unsigned int AlphaMask)
+{
+    ASSERT (m_pTexture == NULL);
+
+    SDL_Window* pWindow = SDL12COMPAT_GetWindow();
+
+    if (pWindow == NULL)
+    {
+        theLog.WriteLine("SDL2Video       => !!! There is no window.");
+        return false;
+    }
+
+    m_pRenderer = SDL_GetRenderer(pWindow);
+
+    if (m_pRenderer == NULL)
+    {
+        theLog.WriteLine("SDL2Video       => !!! The window has no renderer.");
+        return false;
+    }
+
+    // Use the format of the display, so that uploading it never converts it
+    Uint32 Format = SDL_MasksToPixelFormatEnum(32, RedMask, GreenMask, BlueMask, AlphaMask);
+
+    m_pTexture = SDL_CreateTexture(m_pRenderer, Format, SDL_TEXTUREACCESS_STREAMING, Width, Height);
+
+    if (m_pTexture == NULL)
+    {
+        theLog.WriteLine("SDL2Video       => !!! Could not create the texture.");
+        theLog.WriteLine("SDL2Video       => !!! SDL2 error is : %s.", SDL_GetError());
+
+        m_pRenderer = NULL;
+        return false;
+    }
+
+    m_Width = Width;
+    m_Height = Height;
+
+    SDL_RendererInfo Info;
+
+    if (SDL_GetRendererInfo(m_pRenderer, &Info) == 0)
+    {
+        theLog.WriteLine("SDL2Video       => Presenting %dx%d %s through the %s renderer.",
+            Width, Height, SDL_GetPixelFormatName(Format), Info.name);
+    }
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL2::Destroy (void)
+{
+    // The renderer belongs to sdl12_compat
+    if (m_pTexture != NULL)
+    {
+        SDL_DestroyTexture(m_pTexture);
+        m_pTexture = NULL;
+    }
+
+    m_pRenderer = NULL;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CVideoSDL2::Update (const void* pPixels, int Pitch, int X, int Y, int Width, int Height)
+{
+    ASSERT (m_pTexture != NULL);
+    ASSERT (X >= 0 && Y >= 0 && X + Width <= m_Width && Y + Height <= m_Height);
+
+    SDL_Rect Rect;
+    Rect.x = X;
+    Rect.y = Y;
+    Rect.w = Width;
+    Rect.h = Height;
+
+    const Uint8* pZone = (const Uint8*)pPixels + Y * Pitch + X * 4;
+
+    if (SDL_UpdateTexture(m_pTexture, &Rect, pZone, Pitch) < 0)
+    {
+        theLog.WriteLine("SDL2Video       => !!! Could not update the texture.");
+        theLog.WriteLine("SDL2Video       => !!! SDL2 error is : %s.", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CVideoSDL2::Present (void)
+{
+    ASSERT (m_pTexture != NULL);
+
+    // The texture may not cover the whole window (fullscreen)
+    SDL_RenderClear(m_pRenderer);
+    SDL_RenderCopy(m_pRenderer, m_pTexture, NULL, NULL);
+    SDL_RenderPresent(m_pRenderer);
+}
+
+#endif // BOMBERMAAAN_SDL2_VIDEO
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
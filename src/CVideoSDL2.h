@@ -0,0 +1,75 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CVideoSDL2.h
+ *  \brief Header file of the presentation of the display through SDL2
+ */
+
+#ifndef __CVIDEOSDL2_H__
+#define __CVIDEOSDL2_H__
+
+// The SDL 1.2 headers of sdl12_compat and the SDL2 headers can't be
+// included together, so only the SDL2 types used here are declared.
+struct SDL_Renderer;
+struct SDL_Texture;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Presents the display with the renderer of the SDL2 window, without going through sdl12_compat.
+
+/**
+ * sdl12_compat copies the screen surface to its own texture on every
+ * update, converting it if the formats differ, and delays the present
+ * of partial updates to a later SDL12_Delay or event pump. This class
+ * uploads the changed zones of the display straight to a streaming
+ * texture of the same pixel format, and presents at once. The window
+ * and the renderer are still the ones sdl12_compat made, so the events
+ * and the window management don't change.
+ */
+
+class CVideoSDL2
+{
+private:
+
+    SDL_Renderer*   m_pRenderer;                    //!< Renderer of the window made by sdl12_compat
+    SDL_Texture*    m_pTexture;                     //!< Streaming texture holding the display
+    int             m_Width;                        //!< Width of the display in pixels
+    int             m_Height;                       //!< Height of the display in pixels
+
+public:
+
+                    CVideoSDL2 (void);              //!< Constructor. Initialize some members.
+                    ~CVideoSDL2 (void);             //!< Destructor. Does nothing.
+    bool            Create (int Width, int Height, unsigned int RedMask, unsigned int GreenMask, unsigned int BlueMask, unsigned int AlphaMask); //!< Make the texture of a 32 bits display, once the video mode is set
+    void            Destroy (void);                 //!< Free the texture
+    bool            Update (const void* pPixels, int Pitch, int X, int Y, int Width, int Height); //!< Upload a zone of the display (pPixels points to the top left corner of the display)
+    void            Present (void);                 //!< Show the texture in the window
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CVIDEOSDL2_H__
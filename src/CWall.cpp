@@ -391,20 +391,20 @@ bool CWall::Update (float DeltaTime)
 
 void CWall::Display (void)
 {
-    // If it's a hard wall
-    if (m_Type == WALL_HARD)
+    // If it's a hard wall, or a soft wall that is not burning
+    // (no item or arrow is drawn on their block, so they are
+    // below the sprites overlapping them and can be static)
+    if (m_Type == WALL_HARD || (m_Type == WALL_SOFT && !m_Burning))
     {
         // Add the sprite in the right layer.
-        m_pDisplay->DrawSprite (m_iX,                            // Top left corner of the wall's block
-                                m_iY, 
-                                NULL,                            // Draw entire sprite
-                                NULL,                            // No need to clip
-                                BMP_ARENA_WALL,
-                                m_Sprite, 
-                                WALL_SPRITELAYER, 
-                                WALL_PRIORITY);
+        m_pDisplay->DrawStaticSprite (m_iX,                      // Top left corner of the wall's block
+                                      m_iY, 
+                                      BMP_ARENA_WALL,
+                                      m_Sprite, 
+                                      WALL_SPRITELAYER, 
+                                      WALL_PRIORITY);
     }
-    // If it's a soft wall
+    // If it's a burning soft wall, the item it hides is drawn below it
     else if (m_Type == WALL_SOFT)
     {
         // Add the sprite in the right layer.
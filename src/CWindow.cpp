@@ -222,7 +222,6 @@ void CWindow::MessagePump()
         {
             // call the virtual activity method
             OnWindowActive();
-            SDL12_Delay(1); // rest for the cpu
         }
     }
 }
@@ -0,0 +1,230 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CWorkerPool.cpp
+ *  \brief Pool of worker threads
+ */
+
+#include "StdAfx.h"
+#include "CWorkerPool.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+struct SWorkerPoolThreads
+{
+    std::thread*            pThreads;                   //!< Worker threads
+    std::mutex              Mutex;                      //!< Protects the members of the pool
+    std::condition_variable WorkAvailable;              //!< Signaled when new jobs are available or when the workers have to quit
+    std::condition_variable WorkDone;                   //!< Signaled when the last job is done
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CWorkerPool::CWorkerPool (void)
+{
+    m_pThreads = NULL;
+    m_NumberOfThreads = 0;
+    m_pFunction = NULL;
+    m_pParameter = NULL;
+    m_NumberOfJobs = 0;
+    m_NextJob = 0;
+    m_FinishedJobs = 0;
+    m_Generation = 0;
+    m_Quit = false;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+CWorkerPool::~CWorkerPool (void)
+{
+    // Nothing to do
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+bool CWorkerPool::Create (int NumberOfThreads)
+{
+    ASSERT (m_pThreads == NULL);
+
+    // If the number of threads has to be determined
+    if (NumberOfThreads < 0)
+    {
+        // Keep one core for the calling thread, which takes jobs too
+        NumberOfThreads = (int)std::thread::hardware_concurrency() - 1;
+
+        if (NumberOfThreads < 0)
+            NumberOfThreads = 0;
+    }
+
+    m_Quit = false;
+    m_NumberOfJobs = 0;
+    m_NextJob = 0;
+    m_FinishedJobs = 0;
+    m_NumberOfThreads = 0;
+
+    m_pThreads = new SWorkerPoolThreads;
+    m_pThreads->pThreads = NULL;
+
+    if (NumberOfThreads > 0)
+    {
+        m_pThreads->pThreads = new std::thread [NumberOfThreads];
+
+        for (int Thread = 0; Thread < NumberOfThreads; Thread++)
+        {
+            m_pThreads->pThreads[Thread] = std::thread(&CWorkerPool::WorkerThread, this);
+            m_NumberOfThreads++;
+        }
+    }
+
+    theLog.WriteLine("WorkerPool      => Started %d worker thread(s).", m_NumberOfThreads);
+
+    return true;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CWorkerPool::Destroy (void)
+{
+    if (m_pThreads == NULL)
+        return;
+
+    // Wake the workers up and tell them to quit
+    {
+        std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+        m_Quit = true;
+    }
+
+    m_pThreads->WorkAvailable.notify_all();
+
+    for (int Thread = 0; Thread < m_NumberOfThreads; Thread++)
+        m_pThreads->pThreads[Thread].join();
+
+    delete [] m_pThreads->pThreads;
+    delete m_pThreads;
+    m_pThreads = NULL;
+    m_NumberOfThreads = 0;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CWorkerPool::Run (LPWORKERFUNCTION pFunction, void* pParameter, int NumberOfJobs)
+{
+    ASSERT (pFunction != NULL);
+    ASSERT (m_pThreads != NULL);
+
+    if (NumberOfJobs <= 0)
+        return;
+
+    std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+
+    // Hand the new jobs to the workers
+    m_pFunction = pFunction;
+    m_pParameter = pParameter;
+    m_NumberOfJobs = NumberOfJobs;
+    m_NextJob = 0;
+    m_FinishedJobs = 0;
+    m_Generation++;
+
+    if (m_NumberOfThreads > 0 && NumberOfJobs > 1)
+        m_pThreads->WorkAvailable.notify_all();
+
+    // Don't stay idle while the workers are busy
+    DoJobs();
+
+    // Wait for the jobs the workers are still doing
+    while (m_FinishedJobs < m_NumberOfJobs)
+        m_pThreads->WorkDone.wait(Lock);
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CWorkerPool::DoJobs (void)
+{
+    while (m_NextJob < m_NumberOfJobs)
+    {
+        int Job = m_NextJob++;
+        LPWORKERFUNCTION pFunction = m_pFunction;
+        void* pParameter = m_pParameter;
+
+        // Don't hold the lock while working
+        m_pThreads->Mutex.unlock();
+        pFunction(pParameter, Job);
+        m_pThreads->Mutex.lock();
+
+        m_FinishedJobs++;
+
+        // If this was the last job, wake the thread waiting in Run() up
+        if (m_FinishedJobs == m_NumberOfJobs)
+            m_pThreads->WorkDone.notify_all();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+void CWorkerPool::WorkerThread (void)
+{
+    std::unique_lock<std::mutex> Lock(m_pThreads->Mutex);
+
+    unsigned int Generation = m_Generation;
+
+    while (true)
+    {
+        // Wait for new jobs
+        while (!m_Quit && Generation == m_Generation)
+            m_pThreads->WorkAvailable.wait(Lock);
+
+        if (m_Quit)
+            break;
+
+        Generation = m_Generation;
+
+        DoJobs();
+    }
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
@@ -0,0 +1,98 @@
+/************************************************************************************
+
+    Copyright (C) 2000-2002, 2007 Thibaut Tollemer
+
+    This file is part of Bombermaaan.
+
+    Bombermaaan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Bombermaaan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Bombermaaan.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************************/
+
+
+/**
+ *  \file CWorkerPool.h
+ *  \brief Header file of the pool of worker threads
+ */
+
+#ifndef __CWORKERPOOL_H__
+#define __CWORKERPOOL_H__
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! Function executed by the workers. It receives the parameter given to Run() and the number of the job to do.
+typedef void (*LPWORKERFUNCTION) (void* pParameter, int Job);
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+// The standard thread classes are only used in CWorkerPool.cpp, because
+// the standard headers conflict with the portable STL ones included before.
+struct SWorkerPoolThreads;
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+//! A set of threads created once and kept alive to share independent jobs.
+
+/**
+ * Run() hands a number of jobs to the workers and returns when all of them
+ * are done. The calling thread takes jobs too, so a pool without any thread
+ * simply runs the jobs one after the other.
+ */
+
+class CWorkerPool
+{
+private:
+
+    SWorkerPoolThreads*     m_pThreads;                 //!< Worker threads and what they use to synchronize
+    int                     m_NumberOfThreads;          //!< Number of worker threads
+    LPWORKERFUNCTION        m_pFunction;                //!< Function to execute for each job
+    void*                   m_pParameter;               //!< Parameter to give to the function
+    int                     m_NumberOfJobs;             //!< Number of jobs to do
+    int                     m_NextJob;                  //!< Number of the next job to take
+    int                     m_FinishedJobs;             //!< Number of jobs that are done
+    unsigned int            m_Generation;               //!< Increased each time new jobs are handed to the workers
+    bool                    m_Quit;                     //!< Do the workers have to quit?
+
+    void                    WorkerThread (void);        //!< Main function of each worker thread
+    void                    DoJobs (void);              //!< Take and execute jobs until there are none left. The mutex must be locked.
+
+public:
+
+                            CWorkerPool (void);         //!< Constructor. Initialize some members.
+                            ~CWorkerPool (void);        //!< Destructor. Does nothing.
+    bool                    Create (int NumberOfThreads); //!< Start the worker threads. A negative number uses one thread per available core but one.
+    void                    Destroy (void);             //!< Stop the worker threads
+    void                    Run (LPWORKERFUNCTION pFunction, void* pParameter, int NumberOfJobs); //!< Execute the jobs and wait until they are all done
+    inline int              GetNumberOfThreads (void);  //!< Return the number of worker threads
+};
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+inline int CWorkerPool::GetNumberOfThreads (void)
+{
+    return m_NumberOfThreads;
+}
+
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+//******************************************************************************************************************************
+
+#endif  // __CWORKERPOOL_H__
@@ -59,8 +59,8 @@
 #define MAX(_x,_y)  ((_x) > (_y) ? (_x) : (_y))
 #endif // __ABSMINMAX__
 
-#define SEED_RANDOM(seed)   srand(seed)
-#define RANDOM(max)         (rand() % (max))
+#define SEED_RANDOM(seed)   CRandom::SeedCurrent(seed)
+#define RANDOM(max)         (CRandom::NextCurrent() % (max))
 
 #define PLAYER_WHITE            0       //!< Player number of the white bomber
 #define PLAYER_BLACK            1       //!< Player number of the black bomber
@@ -82,6 +82,7 @@
 #include "CLog.h"
 #include "CDebug.h"
 #include "CTimer.h"
+#include "CRandom.h"
 
 #define IDI_BOMBER              101
 
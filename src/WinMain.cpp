@@ -35,6 +35,11 @@
 
 #include "StdAfx.h"
 #include "CGame.h"
+#include "CBenchmark.h"
+
+#ifdef NETWORK_MODE
+#include "CServer.h"
+#endif
 
 #include "Bombermaaan.h"
 
@@ -91,6 +96,49 @@ int main(int argc, char **argv)
     char **lpCmdline = argv;
 #endif
 
+#ifdef NETWORK_MODE
+    // The dedicated server has no window, input or sound : don't create the game at all
+    CServer Server;
+
+#ifdef WIN32
+    if (Server.ParseCommandLine(lpCmdline))
+#else
+    if (Server.ParseCommandLine(argv, argc))
+#endif
+    {
+        if (!Server.Create())
+        {
+            Server.Destroy();
+            return -1;
+        }
+
+        // Host the games until the server is stopped
+        Server.Run();
+
+        Server.Destroy();
+
+        return 0;
+    }
+#endif
+
+    // The benchmarks measure parts of the game code without creating the game
+    CBenchmark Benchmark;
+
+#ifdef WIN32
+    if (Benchmark.ParseCommandLine(lpCmdline))
+#else
+    if (Benchmark.ParseCommandLine(argv, argc))
+#endif
+    {
+        Benchmark.Create();
+
+        bool Success = Benchmark.Run();
+
+        Benchmark.Destroy();
+
+        return (Success ? 0 : -1);
+    }
+
     // Create the CGame instance    
     CGame Game(hInstance, lpCmdline);
 
@@ -62,6 +62,7 @@
 #define VK_F3		SDLK_F3
 #define VK_F4		SDLK_F4
 #define VK_F5		SDLK_F5
+#define VK_F11		SDLK_F11
 #define VK_F12		SDLK_F12
 #define VK_RETURN	SDLK_RETURN
 #define VK_MULTIPLY	SDLK_KP_MULTIPLY
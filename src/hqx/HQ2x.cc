@@ -14,12 +14,16 @@
  * limitations under the License.
  */
 
-#ifdef BOMBERMAAAN_SCALE_2X
-
 #include <cstdlib>
 
 #include "HQ2x.hh"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
 
 #define MASK_RB   0x00FF00FF
 #define MASK_G    0x0000FF00
@@ -30,6 +34,15 @@ static constexpr uint32_t YMASK = 0x00FF0000;
 static constexpr uint32_t UMASK = 0x0000FF00;
 static constexpr uint32_t VMASK = 0x000000FF;
 
+/*
+ * Bits of the edges between two neighbors of the central pixel, used by
+ * some patterns. They are computed with the pattern, once per pixel.
+ */
+#define EDGE_3_1  1
+#define EDGE_1_5  2
+#define EDGE_5_7  4
+#define EDGE_7_3  8
+
 /**
  * @brief Mixes two colors using the given weights.
  */
@@ -139,7 +152,13 @@ static constexpr uint32_t VMASK = 0x000000FF;
 #define MIX_22_5_7_1_1		*(output + lineSize + lineSize + 2) = HQX_MIX_2(w[5],w[7],1U,1U);
 
 
-HQ2x::HQ2x()
+HQ2x::HQ2x() : reference(false)
+{
+	// nothing to do
+}
+
+
+HQ2x::HQ2x( bool reference ) : reference(reference)
 {
 	// nothing to do
 }
@@ -228,6 +247,226 @@ bool HQ2x::isDifferent(
 #endif
 
 
+/*
+ * Same result as isDifferent() for the smoothed images, on colors already
+ * converted to YUV and with the thresholds not shifted. The alpha is
+ * compared as isDifferent() does : the difference wraps around 8 bits.
+ */
+
+static inline bool isDifferentYUV(
+	uint32_t yuv1,
+	uint32_t yuv2,
+	uint32_t trY,
+	uint32_t trU,
+	uint32_t trV,
+	uint32_t trA )
+{
+	int dA = (int8_t) (uint8_t) ((yuv1 >> 24) - (yuv2 >> 24));
+
+	return (uint32_t) abs(int((yuv1 >> 16) & 0xFF) - int((yuv2 >> 16) & 0xFF)) > trY ||
+		   (uint32_t) abs(int((yuv1 >> 8) & 0xFF) - int((yuv2 >> 8) & 0xFF)) > trU ||
+		   (uint32_t) abs(int(yuv1 & 0xFF) - int(yuv2 & 0xFF)) > trV ||
+		   (uint32_t) abs(dA) > trA;
+}
+
+
+/*
+ * Converts the columns [firstCol, lastCol) of a row to YUV, with their
+ * neighbors. The row has one more pixel on each side holding the neighbor
+ * used at the borders.
+ */
+
+static void convertRow(
+	const uint32_t *image,
+	uint32_t width,
+	uint32_t *yuv,
+	uint32_t firstCol,
+	uint32_t lastCol,
+	bool wrapX )
+{
+	uint32_t first = (firstCol > 0) ? firstCol - 1 : 0;
+	uint32_t last = (lastCol < width) ? lastCol + 1 : width;
+
+	for (uint32_t col = first; col < last; col++)
+		yuv[col + 1] = HQ2x::ARGBtoAYUV(image[col]);
+
+	if (firstCol == 0)
+		yuv[0] = wrapX ? HQ2x::ARGBtoAYUV(image[width - 1]) : yuv[1];
+	if (lastCol == width)
+		yuv[width + 1] = wrapX ? HQ2x::ARGBtoAYUV(image[0]) : yuv[width];
+}
+
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+
+#if defined(__AVX2__)
+
+#define HQX_LANES           8
+#define HQX_VECTOR          __m256i
+#define HQX_LOAD(p)         _mm256_loadu_si256((const __m256i *) (p))
+#define HQX_SET1(v)         _mm256_set1_epi32(v)
+#define HQX_OR(a,b)         _mm256_or_si256(a, b)
+#define HQX_SUBS_U8(a,b)    _mm256_subs_epu8(a, b)
+#define HQX_SUB_8(a,b)      _mm256_sub_epi8(a, b)
+#define HQX_ABS_8(a)        _mm256_abs_epi8(a)
+#define HQX_BLEND(a,b,m)    _mm256_blendv_epi8(a, b, m)
+#define HQX_ZERO(a)         _mm256_cmpeq_epi32(a, _mm256_setzero_si256())
+#define HQX_MASK(a)         _mm256_movemask_ps(_mm256_castsi256_ps(a))
+
+#else
+
+#define HQX_LANES           4
+#define HQX_VECTOR          __m128i
+#define HQX_LOAD(p)         _mm_loadu_si128((const __m128i *) (p))
+#define HQX_SET1(v)         _mm_set1_epi32(v)
+#define HQX_OR(a,b)         _mm_or_si128(a, b)
+#define HQX_SUBS_U8(a,b)    _mm_subs_epu8(a, b)
+#define HQX_SUB_8(a,b)      _mm_sub_epi8(a, b)
+#define HQX_ABS_8(a)        _mm_abs_epi8(a)
+#define HQX_BLEND(a,b,m)    _mm_blendv_epi8(a, b, m)
+#define HQX_ZERO(a)         _mm_cmpeq_epi32(a, _mm_setzero_si128())
+#define HQX_MASK(a)         _mm_movemask_ps(_mm_castsi128_ps(a))
+
+#endif
+
+/*
+ * Returns one bit per lane, set when the two colors are different.
+ * The Y, U and V bytes are compared as unsigned bytes, the alpha byte
+ * as the wrapped signed difference, exactly as isDifferentYUV() does.
+ */
+
+static inline int differentLanes(
+	HQX_VECTOR yuv1,
+	HQX_VECTOR yuv2,
+	HQX_VECTOR thresholds,
+	HQX_VECTOR alphaMask )
+{
+	HQX_VECTOR unsignedDiff = HQX_OR(HQX_SUBS_U8(yuv1, yuv2), HQX_SUBS_U8(yuv2, yuv1));
+	HQX_VECTOR alphaDiff = HQX_ABS_8(HQX_SUB_8(yuv1, yuv2));
+	HQX_VECTOR diff = HQX_BLEND(unsignedDiff, alphaDiff, alphaMask);
+
+	// a byte above its threshold leaves something after the saturated subtraction
+	return ~HQX_MASK(HQX_ZERO(HQX_SUBS_U8(diff, thresholds))) & ((1 << HQX_LANES) - 1);
+}
+
+#endif
+
+
+/*
+ * Computes the pattern and the edges of every pixel of a row, from the
+ * YUV rows above, on and below it.
+ */
+
+static void computePatterns(
+	const uint32_t *previous,
+	const uint32_t *current,
+	const uint32_t *next,
+	uint32_t width,
+	uint8_t *patterns,
+	uint8_t *edges,
+	uint32_t trY,
+	uint32_t trU,
+	uint32_t trV,
+	uint32_t trA )
+{
+	uint32_t col = 0;
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+	if (trY < 256 && trU < 256 && trV < 256 && trA < 256)
+	{
+		HQX_VECTOR thresholds = HQX_SET1((int) ((trA << 24) | (trY << 16) | (trU << 8) | trV));
+		HQX_VECTOR alphaMask = HQX_SET1((int) AMASK);
+
+		for (; col + HQX_LANES <= width; col += HQX_LANES)
+		{
+			// the rows have one more pixel on the left, so col is the pixel on the left
+			HQX_VECTOR w0 = HQX_LOAD(previous + col);
+			HQX_VECTOR w1 = HQX_LOAD(previous + col + 1);
+			HQX_VECTOR w2 = HQX_LOAD(previous + col + 2);
+			HQX_VECTOR w3 = HQX_LOAD(current + col);
+			HQX_VECTOR w4 = HQX_LOAD(current + col + 1);
+			HQX_VECTOR w5 = HQX_LOAD(current + col + 2);
+			HQX_VECTOR w6 = HQX_LOAD(next + col);
+			HQX_VECTOR w7 = HQX_LOAD(next + col + 1);
+			HQX_VECTOR w8 = HQX_LOAD(next + col + 2);
+
+			int d0 = differentLanes(w4, w0, thresholds, alphaMask);
+			int d1 = differentLanes(w4, w1, thresholds, alphaMask);
+			int d2 = differentLanes(w4, w2, thresholds, alphaMask);
+			int d3 = differentLanes(w4, w3, thresholds, alphaMask);
+			int d5 = differentLanes(w4, w5, thresholds, alphaMask);
+			int d6 = differentLanes(w4, w6, thresholds, alphaMask);
+			int d7 = differentLanes(w4, w7, thresholds, alphaMask);
+			int d8 = differentLanes(w4, w8, thresholds, alphaMask);
+			int e31 = differentLanes(w3, w1, thresholds, alphaMask);
+			int e15 = differentLanes(w1, w5, thresholds, alphaMask);
+			int e57 = differentLanes(w5, w7, thresholds, alphaMask);
+			int e73 = differentLanes(w7, w3, thresholds, alphaMask);
+
+			for (int lane = 0; lane < HQX_LANES; lane++)
+			{
+				patterns[col + lane] = (uint8_t) (
+					((d0 >> lane) & 1) |
+					(((d1 >> lane) & 1) << 1) |
+					(((d2 >> lane) & 1) << 2) |
+					(((d3 >> lane) & 1) << 3) |
+					(((d5 >> lane) & 1) << 4) |
+					(((d6 >> lane) & 1) << 5) |
+					(((d7 >> lane) & 1) << 6) |
+					(((d8 >> lane) & 1) << 7));
+
+				edges[col + lane] = (uint8_t) (
+					(((e31 >> lane) & 1) ? EDGE_3_1 : 0) |
+					(((e15 >> lane) & 1) ? EDGE_1_5 : 0) |
+					(((e57 >> lane) & 1) ? EDGE_5_7 : 0) |
+					(((e73 >> lane) & 1) ? EDGE_7_3 : 0));
+			}
+		}
+	}
+#endif
+
+	// the pixels left, or all of them without SIMD
+	for (; col < width; col++)
+	{
+		uint32_t w[9] = {
+			previous[col], previous[col + 1], previous[col + 2],
+			current[col], current[col + 1], current[col + 2],
+			next[col], next[col + 1], next[col + 2] };
+
+		int pattern = 0;
+
+		for (int k = 0, flag = 1; k < 9; k++)
+		{
+			// ignores the central pixel
+			if (k == 4) continue;
+
+			if (isDifferentYUV(w[4], w[k], trY, trU, trV, trA)) pattern |= flag;
+			flag <<= 1;
+		}
+
+		patterns[col] = (uint8_t) pattern;
+
+		edges[col] = (uint8_t) (
+			(isDifferentYUV(w[3], w[1], trY, trU, trV, trA) ? EDGE_3_1 : 0) |
+			(isDifferentYUV(w[1], w[5], trY, trU, trV, trA) ? EDGE_1_5 : 0) |
+			(isDifferentYUV(w[5], w[7], trY, trU, trV, trA) ? EDGE_5_7 : 0) |
+			(isDifferentYUV(w[7], w[3], trY, trU, trV, trA) ? EDGE_7_3 : 0));
+	}
+}
+
+
+const char *HQ2x::kernelName()
+{
+#if defined(__AVX2__)
+	return "AVX2";
+#elif defined(__SSE4_1__)
+	return "SSE4.1";
+#else
+	return "scalar";
+#endif
+}
+
+
 uint32_t *HQ2x::resize(
 	const uint32_t *image,
 	uint32_t width,
@@ -239,19 +478,80 @@ uint32_t *HQ2x::resize(
 	uint32_t trA,
 	bool wrapX,
 	bool wrapY ) const
+{
+	resizeRows(image, width, height, output, 0, height, trY, trU, trV, trA, wrapX, wrapY);
+
+	// points after the last output pixel, as the loop used to leave it
+	return output + width * height * 4;
+}
+
+
+void HQ2x::resizeRows(
+	const uint32_t *image,
+	uint32_t width,
+	uint32_t height,
+	uint32_t *output,
+	uint32_t firstRow,
+	uint32_t lastRow,
+	uint32_t trY,
+	uint32_t trU,
+	uint32_t trV,
+	uint32_t trA,
+	bool wrapX,
+	bool wrapY ) const
+{
+	resizeRect(image, width, height, output, 0, firstRow, width, lastRow, trY, trU, trV, trA, wrapX, wrapY);
+}
+
+
+void HQ2x::resizeRect(
+	const uint32_t *image,
+	uint32_t width,
+	uint32_t height,
+	uint32_t *output,
+	uint32_t firstCol,
+	uint32_t firstRow,
+	uint32_t lastCol,
+	uint32_t lastRow,
+	uint32_t trY,
+	uint32_t trU,
+	uint32_t trV,
+	uint32_t trA,
+	bool wrapX,
+	bool wrapY ) const
 {
 	int lineSize = width * 2;
 
+	const uint32_t *source = image;
+	uint32_t *target = output;
+
 	int previous, next;
 	uint32_t w[9];
 
+	/*
+	 * Each source row is converted to YUV once, in a ring of three rows
+	 * with one more pixel on each side. The patterns and the edges of a
+	 * whole row are then computed at once, several pixels at a time.
+	 */
+	uint32_t *rows = (uint32_t *) malloc(3 * (width + 2) * sizeof(uint32_t));
+	uint8_t *patterns = (uint8_t *) malloc(width * 2);
+	uint8_t *rowEdges = patterns + width;
+	uint32_t ringRows[3] = { (uint32_t) -1, (uint32_t) -1, (uint32_t) -1 };
+
+	// thresholds as isDifferentYUV() uses them
+	uint32_t yuvTrY = trY, yuvTrU = trU, yuvTrV = trV, yuvTrA = trA;
+
 	trY <<= 16;
 	trU <<= 8;
 	trA <<= 24;
 
 	// iterates between the lines
-	for (uint32_t row = 0; row < height; row++)
+	for (uint32_t row = firstRow; row < lastRow; row++)
 	{
+		// each source row gives two output rows
+		image = source + row * width + firstCol;
+		output = target + row * lineSize * 2 + firstCol * 2;
+
 		/*
 		 * Note: this function uses a 3x3 sliding window over the original image.
 		 *
@@ -287,8 +587,41 @@ uint32_t *HQ2x::resize(
 				next = 0;
 		}
 
+		if (!reference)
+		{
+			// source rows giving the previous, current and next lines
+			uint32_t sourceRows[3] = {
+				row + previous / (int) width,
+				row,
+				row + next / (int) width };
+
+			uint32_t *yuvRows[3];
+
+			for (int line = 0; line < 3; line++)
+			{
+				// look for the row in the ring, or convert it in the slot of a row not needed anymore
+				int slot = -1;
+
+				for (int ring = 0; ring < 3 && slot < 0; ring++)
+					if (ringRows[ring] == sourceRows[line]) slot = ring;
+
+				for (int ring = 0; ring < 3 && slot < 0; ring++)
+					if (ringRows[ring] != sourceRows[0] && ringRows[ring] != sourceRows[1] && ringRows[ring] != sourceRows[2])
+					{
+						slot = ring;
+						convertRow(source + sourceRows[line] * width, width, rows + slot * (width + 2), firstCol, lastCol, wrapX);
+						ringRows[slot] = sourceRows[line];
+					}
+
+				yuvRows[line] = rows + slot * (width + 2);
+			}
+
+			computePatterns(yuvRows[0] + firstCol, yuvRows[1] + firstCol, yuvRows[2] + firstCol, lastCol - firstCol,
+				patterns, rowEdges, yuvTrY, yuvTrU, yuvTrV, yuvTrA);
+		}
+
 		// iterates between the columns
-		for (uint32_t col = 0; col < width; col++)
+		for (uint32_t col = firstCol; col < lastCol; col++)
 		{
 			w[1] = *(image + previous);
 			w[4] = *image;
@@ -339,16 +672,30 @@ uint32_t *HQ2x::resize(
 			}
 
 			int pattern = 0;
+			int edges = 0;
 
-			// computes the pattern to be used considering the neighbor pixels
-			for (int k = 0, flag = 1; k < 9; k++)
+			if (!reference)
 			{
-				// ignores the central pixel
-				if (k == 4) continue;
+				pattern = patterns[col - firstCol];
+				edges = rowEdges[col - firstCol];
+			}
+			else
+			{
+				// computes the pattern to be used considering the neighbor pixels
+				for (int k = 0, flag = 1; k < 9; k++)
+				{
+					// ignores the central pixel
+					if (k == 4) continue;
 
-				if (w[k] != w[4])
-					if (isDifferent(w[4], w[k], trY, trU, trV, trA)) pattern |= flag;
-				flag <<= 1;
+					if (w[k] != w[4])
+						if (isDifferent(w[4], w[k], trY, trU, trV, trA)) pattern |= flag;
+					flag <<= 1;
+				}
+
+				if (isDifferent(w[3], w[1], trY, trU, trV, trA)) edges |= EDGE_3_1;
+				if (isDifferent(w[1], w[5], trY, trU, trV, trA)) edges |= EDGE_1_5;
+				if (isDifferent(w[5], w[7], trY, trU, trV, trA)) edges |= EDGE_5_7;
+				if (isDifferent(w[7], w[3], trY, trU, trV, trA)) edges |= EDGE_7_3;
 			}
 
 			switch (pattern)
@@ -485,7 +832,7 @@ uint32_t *HQ2x::resize(
 				case 18:
 				case 50:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -501,7 +848,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_2_1_2_1_1
 					MIX_10_4_6_3_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -514,7 +861,7 @@ uint32_t *HQ2x::resize(
 				case 76:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -526,7 +873,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 10:
 				case 138:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -585,7 +932,7 @@ uint32_t *HQ2x::resize(
 				case 22:
 				case 54:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -601,7 +948,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_2_1_2_1_1
 					MIX_10_4_6_3_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -614,7 +961,7 @@ uint32_t *HQ2x::resize(
 				case 108:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -626,7 +973,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 11:
 				case 139:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -640,7 +987,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 19:
 				case 51:
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 					MIX_00_4_3_3_1
 					MIX_01_4_2_3_1
@@ -656,7 +1003,7 @@ uint32_t *HQ2x::resize(
 				case 146:
 				case 178:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 					MIX_01_4_2_3_1
 					MIX_11_4_7_3_1
@@ -671,7 +1018,7 @@ uint32_t *HQ2x::resize(
 				case 84:
 				case 85:
 					MIX_00_4_3_1_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 					MIX_01_4_1_3_1
 					MIX_11_4_8_3_1
@@ -687,7 +1034,7 @@ uint32_t *HQ2x::resize(
 				case 113:
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_2_1_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 					MIX_10_4_3_3_1
 					MIX_11_4_8_3_1
@@ -702,7 +1049,7 @@ uint32_t *HQ2x::resize(
 				case 204:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 					MIX_10_4_6_3_1
 					MIX_11_4_5_3_1
@@ -715,7 +1062,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 73:
 				case 77:
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 					MIX_00_4_1_3_1
 					MIX_10_4_6_3_1
@@ -730,7 +1077,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 42:
 				case 170:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 					MIX_00_4_0_3_1
 					MIX_10_4_7_3_1
@@ -745,7 +1092,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 14:
 				case 142:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 					MIX_00_4_0_3_1
 					MIX_01_4_5_3_1
@@ -808,7 +1155,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 26:
 				case 31:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -816,7 +1163,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -830,7 +1177,7 @@ uint32_t *HQ2x::resize(
 				case 82:
 				case 214:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -839,7 +1186,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_2_1_1
 					}
 					MIX_10_4_6_3_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -852,7 +1199,7 @@ uint32_t *HQ2x::resize(
 				case 248:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_2_1_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -860,7 +1207,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -871,7 +1218,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 74:
 				case 107:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -880,7 +1227,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_2_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -891,7 +1238,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 27:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -905,7 +1252,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 86:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -920,7 +1267,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_2_1_2_1_1
 					MIX_10_4_6_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -932,7 +1279,7 @@ uint32_t *HQ2x::resize(
 				case 106:
 					MIX_00_4_0_3_1
 					MIX_01_4_2_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -944,7 +1291,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 30:
 					MIX_00_4_0_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -959,7 +1306,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_0_3_2_1_1
 					MIX_01_4_2_3_1
 					MIX_10_4_6_3_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -971,7 +1318,7 @@ uint32_t *HQ2x::resize(
 				case 120:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_2_1_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -982,7 +1329,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 75:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -1067,7 +1414,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_7_3_1
 					break;
 				case 58:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1075,7 +1422,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1088,7 +1435,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 83:
 					MIX_00_4_3_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1097,7 +1444,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_6_1_1
 					}
 					MIX_10_4_6_3_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1109,7 +1456,7 @@ uint32_t *HQ2x::resize(
 				case 92:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1117,7 +1464,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1127,7 +1474,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 202:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1136,7 +1483,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_6_1_1
 					}
 					MIX_01_4_2_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1147,7 +1494,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_5_3_1
 					break;
 				case 78:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1156,7 +1503,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_6_1_1
 					}
 					MIX_01_4_5_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1167,7 +1514,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 154:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1175,7 +1522,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1188,7 +1535,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 114:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1197,7 +1544,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_6_1_1
 					}
 					MIX_10_4_3_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1209,7 +1556,7 @@ uint32_t *HQ2x::resize(
 				case 89:
 					MIX_00_4_1_3_1
 					MIX_01_4_2_1_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1217,7 +1564,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1227,7 +1574,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 90:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1235,7 +1582,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1243,7 +1590,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_6_1_1
 					}
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1251,7 +1598,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1262,7 +1609,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 55:
 				case 23:
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 					MIX_00_4_3_3_1
 					MIX_01_4
@@ -1278,7 +1625,7 @@ uint32_t *HQ2x::resize(
 				case 182:
 				case 150:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 					MIX_01_4
 					MIX_11_4_7_3_1
@@ -1293,7 +1640,7 @@ uint32_t *HQ2x::resize(
 				case 213:
 				case 212:
 					MIX_00_4_3_1_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 					MIX_01_4_1_3_1
 					MIX_11_4
@@ -1309,7 +1656,7 @@ uint32_t *HQ2x::resize(
 				case 240:
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_2_1_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 					MIX_10_4_3_3_1
 					MIX_11_4
@@ -1324,7 +1671,7 @@ uint32_t *HQ2x::resize(
 				case 232:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 					MIX_10_4
 					MIX_11_4_5_3_1
@@ -1337,7 +1684,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 109:
 				case 105:
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 					MIX_00_4_1_3_1
 					MIX_10_4
@@ -1352,7 +1699,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 171:
 				case 43:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 					MIX_00_4
 					MIX_10_4_7_3_1
@@ -1367,7 +1714,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 143:
 				case 15:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 					MIX_00_4
 					MIX_01_4_5_3_1
@@ -1383,7 +1730,7 @@ uint32_t *HQ2x::resize(
 				case 124:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -1394,7 +1741,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 203:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -1408,7 +1755,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 62:
 					MIX_00_4_0_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -1423,7 +1770,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_3_1
 					MIX_01_4_2_3_1
 					MIX_10_4_6_3_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -1434,7 +1781,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 118:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -1449,7 +1796,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_1_3_1
 					MIX_01_4_2_1_2_1_1
 					MIX_10_4_6_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -1461,7 +1808,7 @@ uint32_t *HQ2x::resize(
 				case 110:
 					MIX_00_4_0_3_1
 					MIX_01_4_5_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -1472,7 +1819,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 155:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -1535,7 +1882,7 @@ uint32_t *HQ2x::resize(
 				case 220:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1543,7 +1890,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -1553,7 +1900,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 158:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1561,7 +1908,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -1573,7 +1920,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_7_3_1
 					break;
 				case 234:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1582,7 +1929,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_6_1_1
 					}
 					MIX_01_4_2_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -1594,7 +1941,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 242:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1603,7 +1950,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_6_1_1
 					}
 					MIX_10_4_3_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -1613,7 +1960,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 59:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -1621,7 +1968,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1635,7 +1982,7 @@ uint32_t *HQ2x::resize(
 				case 121:
 					MIX_00_4_1_3_1
 					MIX_01_4_2_1_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -1643,7 +1990,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1654,7 +2001,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 87:
 					MIX_00_4_3_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -1663,7 +2010,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_2_1_1
 					}
 					MIX_10_4_6_3_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1673,7 +2020,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 79:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -1682,7 +2029,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_5_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1693,7 +2040,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 122:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1701,7 +2048,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1709,7 +2056,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_6_1_1
 					}
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -1717,7 +2064,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1727,7 +2074,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 94:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1735,7 +2082,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -1743,7 +2090,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_2_1_1
 					}
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1751,7 +2098,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1761,7 +2108,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 218:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1769,7 +2116,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1777,7 +2124,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_6_1_1
 					}
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1785,7 +2132,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -1795,7 +2142,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 91:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -1803,7 +2150,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1811,7 +2158,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_6_1_1
 					}
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1819,7 +2166,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1853,7 +2200,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_7_3_1
 					break;
 				case 186:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1861,7 +2208,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1874,7 +2221,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 115:
 					MIX_00_4_3_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1883,7 +2230,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_6_1_1
 					}
 					MIX_10_4_3_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1895,7 +2242,7 @@ uint32_t *HQ2x::resize(
 				case 93:
 					MIX_00_4_1_3_1
 					MIX_01_4_1_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1903,7 +2250,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1913,7 +2260,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 206:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1922,7 +2269,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_6_1_1
 					}
 					MIX_01_4_5_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1936,7 +2283,7 @@ uint32_t *HQ2x::resize(
 				case 201:
 					MIX_00_4_1_3_1
 					MIX_01_4_1_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1948,7 +2295,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 174:
 				case 46:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1963,7 +2310,7 @@ uint32_t *HQ2x::resize(
 				case 179:
 				case 147:
 					MIX_00_4_3_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1979,7 +2326,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_1_3_1
 					MIX_10_4_3_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4_8_3_1
 					}
@@ -2002,7 +2349,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 126:
 					MIX_00_4_0_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2010,7 +2357,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_2_1_1
 					}
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2021,7 +2368,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 219:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2031,7 +2378,7 @@ uint32_t *HQ2x::resize(
 					}
 					MIX_01_4_2_3_1
 					MIX_10_4_6_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2041,7 +2388,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 125:
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 					MIX_00_4_1_3_1
 					MIX_10_4
@@ -2056,7 +2403,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 221:
 					MIX_00_4_1_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 					MIX_01_4_1_3_1
 					MIX_11_4
@@ -2069,7 +2416,7 @@ uint32_t *HQ2x::resize(
 					MIX_10_4_6_3_1
 					break;
 				case 207:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 					MIX_00_4
 					MIX_01_4_5_3_1
@@ -2085,7 +2432,7 @@ uint32_t *HQ2x::resize(
 				case 238:
 					MIX_00_4_0_3_1
 					MIX_01_4_5_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 					MIX_10_4
 					MIX_11_4_5_3_1
@@ -2098,7 +2445,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 190:
 					MIX_00_4_0_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 					MIX_01_4
 					MIX_11_4_7_3_1
@@ -2111,7 +2458,7 @@ uint32_t *HQ2x::resize(
 					MIX_10_4_7_3_1
 					break;
 				case 187:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 					MIX_00_4
 					MIX_10_4_7_3_1
@@ -2127,7 +2474,7 @@ uint32_t *HQ2x::resize(
 				case 243:
 					MIX_00_4_3_3_1
 					MIX_01_4_2_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 					MIX_10_4_3_3_1
 					MIX_11_4
@@ -2139,7 +2486,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 119:
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 					MIX_00_4_3_3_1
 					MIX_01_4
@@ -2156,7 +2503,7 @@ uint32_t *HQ2x::resize(
 				case 233:
 					MIX_00_4_1_3_1
 					MIX_01_4_1_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2168,7 +2515,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 175:
 				case 47:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2183,7 +2530,7 @@ uint32_t *HQ2x::resize(
 				case 183:
 				case 151:
 					MIX_00_4_3_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2199,7 +2546,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_1_3_1
 					MIX_10_4_3_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2211,7 +2558,7 @@ uint32_t *HQ2x::resize(
 				case 250:
 					MIX_00_4_0_3_1
 					MIX_01_4_2_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2219,7 +2566,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2229,7 +2576,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 123:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2238,7 +2585,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_2_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2249,7 +2596,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 95:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2257,7 +2604,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2270,7 +2617,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 222:
 					MIX_00_4_0_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2279,7 +2626,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_2_1_1
 					}
 					MIX_10_4_6_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2291,7 +2638,7 @@ uint32_t *HQ2x::resize(
 				case 252:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2299,7 +2646,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2311,7 +2658,7 @@ uint32_t *HQ2x::resize(
 				case 249:
 					MIX_00_4_1_3_1
 					MIX_01_4_2_1_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2319,7 +2666,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_e_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2329,7 +2676,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 235:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2338,7 +2685,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_2_5_2_1_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2349,7 +2696,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_5_3_1
 					break;
 				case 111:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2358,7 +2705,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_e_1_1
 					}
 					MIX_01_4_5_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2369,7 +2716,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 63:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2377,7 +2724,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_e_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2389,7 +2736,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_7_2_1_1
 					break;
 				case 159:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2397,7 +2744,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2410,7 +2757,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 215:
 					MIX_00_4_3_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2419,7 +2766,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_e_1_1
 					}
 					MIX_10_4_6_3_2_1_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2430,7 +2777,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 246:
 					MIX_00_4_0_3_2_1_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2439,7 +2786,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_2_1_1
 					}
 					MIX_10_4_3_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2450,7 +2797,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 254:
 					MIX_00_4_0_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2458,7 +2805,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_2_1_1
 					}
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2466,7 +2813,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2478,7 +2825,7 @@ uint32_t *HQ2x::resize(
 				case 253:
 					MIX_00_4_1_3_1
 					MIX_01_4_1_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2486,7 +2833,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_e_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2496,7 +2843,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 251:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2505,7 +2852,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_2_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2513,7 +2860,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_e_1_1
 					}
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2523,7 +2870,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 239:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2532,7 +2879,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_e_1_1
 					}
 					MIX_01_4_5_3_1
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2543,7 +2890,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_5_3_1
 					break;
 				case 127:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2551,7 +2898,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_e_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2559,7 +2906,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_2_1_1
 					}
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 					{
 						MIX_10_4
 					}
@@ -2570,7 +2917,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 191:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2578,7 +2925,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_e_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2590,7 +2937,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_7_3_1
 					break;
 				case 223:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 					{
 						MIX_00_4
 					}
@@ -2598,7 +2945,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2607,7 +2954,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_e_1_1
 					}
 					MIX_10_4_6_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2618,7 +2965,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 247:
 					MIX_00_4_3_3_1
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 					{
 						MIX_01_4
 					}
@@ -2627,7 +2974,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_e_1_1
 					}
 					MIX_10_4_3_3_1
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 					{
 						MIX_11_4
 					}
@@ -2637,22 +2984,22 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 255:
-					if (isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if ((edges & EDGE_3_1))
 						MIX_00_4
 					else
 						MIX_00_4_3_1_e_1_1
 
-					if (isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if ((edges & EDGE_1_5))
 						MIX_01_4
 					else
 						MIX_01_4_1_5_e_1_1
 
-					if (isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if ((edges & EDGE_7_3))
 						MIX_10_4
 					else
 						MIX_10_4_7_3_e_1_1
 
-					if (isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if ((edges & EDGE_5_7))
 						MIX_11_4
 					else
 						MIX_11_4_5_7_e_1_1
@@ -2661,10 +3008,8 @@ uint32_t *HQ2x::resize(
 			image++;
 			output += 2;
 		}
-		output += lineSize;
 	}
 
-	return output;
+	free(patterns);
+	free(rows);
 }
-
-#endif
@@ -24,8 +24,21 @@ class HQ2x
 	public:
 		HQ2x();
 
+		/*
+		 * With reference set, the neighbors are compared one by one with
+		 * isDifferent() as the original algorithm does. It gives the same
+		 * output, more slowly, and is kept to check the faster version.
+		 */
+		HQ2x(
+			bool reference );
+
 		~HQ2x();
 
+		/*
+		 * Name of the instructions used to compare the neighbors.
+		 */
+		static const char *kernelName();
+
 		static uint32_t ARGBtoAYUV(
 			uint32_t value );
 
@@ -48,6 +61,49 @@ class HQ2x
 			uint32_t trA = 0x50,
 			bool wrapX = false,
 			bool wrapY = false ) const;
+
+		/*
+		 * Resizes only the rows [firstRow, lastRow) of the image. The rows
+		 * around them are read as neighbors, so several bands of the same
+		 * image can be resized at the same time into the same output.
+		 */
+		void resizeRows(
+			const uint32_t *image,
+			uint32_t width,
+			uint32_t height,
+			uint32_t *output,
+			uint32_t firstRow,
+			uint32_t lastRow,
+			uint32_t trY = 0x30,
+			uint32_t trU = 0x07,
+			uint32_t trV = 0x06,
+			uint32_t trA = 0x50,
+			bool wrapX = false,
+			bool wrapY = false ) const;
+
+		/*
+		 * Resizes only the pixels of the columns [firstCol, lastCol) in the
+		 * rows [firstRow, lastRow), so that the parts of an image that
+		 * changed can be resized again alone.
+		 */
+		void resizeRect(
+			const uint32_t *image,
+			uint32_t width,
+			uint32_t height,
+			uint32_t *output,
+			uint32_t firstCol,
+			uint32_t firstRow,
+			uint32_t lastCol,
+			uint32_t lastRow,
+			uint32_t trY = 0x30,
+			uint32_t trU = 0x07,
+			uint32_t trV = 0x06,
+			uint32_t trA = 0x50,
+			bool wrapX = false,
+			bool wrapY = false ) const;
+
+	private:
+		bool reference;
 };
 
 